@@ -4,97 +4,528 @@ const char* WINDOW_TITLE = "Example 00";
 const int WINDOW_WIDTH = 16 * 60;
 const int WINDOW_HEIGHT = 9 * 60;
 
+// シミュレーションの更新頻度（描画のフレームレートとは独立）
+const int SIMULATION_HZ = 120;
+// 遅れがこのティック数を超えたら、追いつくのをあきらめる
+const int MAX_CATCH_UP_TICKS = 8;
+// 計測結果をログに出す間隔
+const Uint32 STATS_INTERVAL_MS = 5000;
+
+/**
+ * @brief メインスレッドからシミュレーションへ渡す入力
+ */
+struct InputEvent {
+  SDL_Keycode m_key = SDLK_UNKNOWN;
+  Uint64 m_timestamp = 0;  ///< 受け取ったときのパフォーマンスカウンター
+};
+
+/**
+ * @brief シミュレーションから描画へ渡す状態
+ */
+struct SimState {
+  Uint64 m_tick = 0;
+  float m_x = 0.5f;  ///< 矩形の中心（画面に対する割合）
+  float m_y = 0.5f;
+  float m_vx = 0.25f;  ///< 1秒あたりの移動量（画面に対する割合）
+  float m_vy = 0.15f;
+  Uint64 m_input_timestamp = 0;  ///< 最後に反映した入力の受け取り時刻
+};
+
+/**
+ * @brief 矩形を動かすだけのシミュレーション
+ * 矢印キーで進む向きを変え、画面の端で跳ね返ります
+ */
+class Simulation {
+ public:
+  void apply(const InputEvent& input) {
+    switch (input.m_key) {
+      case SDLK_LEFT:
+        m_state.m_vx = -std::fabs(m_state.m_vx);
+        break;
+      case SDLK_RIGHT:
+        m_state.m_vx = std::fabs(m_state.m_vx);
+        break;
+      case SDLK_UP:
+        m_state.m_vy = -std::fabs(m_state.m_vy);
+        break;
+      case SDLK_DOWN:
+        m_state.m_vy = std::fabs(m_state.m_vy);
+        break;
+      default:
+        return;
+    }
+    m_state.m_input_timestamp = input.m_timestamp;
+  }
+
+  /** @brief 1ティック進め、結果をoutに書き出す */
+  void step(SimState& out) {
+    const float dt = 1.0f / SIMULATION_HZ;
+    ++m_state.m_tick;
+    m_state.m_x = bounce(m_state.m_x + m_state.m_vx * dt, m_state.m_vx);
+    m_state.m_y = bounce(m_state.m_y + m_state.m_vy * dt, m_state.m_vy);
+    out = m_state;
+  }
+
+ private:
+  static float bounce(float position, float& velocity) {
+    const float min = 0.1f;
+    const float max = 0.9f;
+    if (position < min) {
+      velocity = std::fabs(velocity);
+      return min;
+    }
+    if (position > max) {
+      velocity = -std::fabs(velocity);
+      return max;
+    }
+    return position;
+  }
+
+  SimState m_state;
+};
+
+double to_ms(Uint64 ticks) {
+  return static_cast<double>(ticks) * 1000.0 /
+         static_cast<double>(SDL_GetPerformanceFrequency());
+}
+
+/**
+ * @brief 間隔や遅延の集計（ミリ秒）
+ * 一定時間ごとにログへ出してリセットします
+ */
+class Stats {
+ public:
+  explicit Stats(const char* label) : m_label(label) {}
+
+  void add(double ms) {
+    m_min = m_count == 0 ? ms : std::min(m_min, ms);
+    m_max = m_count == 0 ? ms : std::max(m_max, ms);
+    m_sum += ms;
+    m_sum_sq += ms * ms;
+    ++m_count;
+  }
+
+  void report_every(Uint32 interval_ms) {
+    const Uint32 now = SDL_GetTicks();
+    if (now - m_last_report < interval_ms) {
+      return;
+    }
+    m_last_report = now;
+    if (m_count == 0) {
+      return;
+    }
+    const double avg = m_sum / m_count;
+    const double stddev =
+        std::sqrt(std::max(0.0, m_sum_sq / m_count - avg * avg));
+    S6I_LOG_INFO(SDL_LOG_CATEGORY_APPLICATION,
+                 "%s: n=%d avg=%.3fms stddev=%.3fms min=%.3fms max=%.3fms",
+                 m_label, m_count, avg, stddev, m_min, m_max);
+    *this = Stats(m_label);
+    m_last_report = now;
+  }
+
+ private:
+  const char* m_label;
+  int m_count = 0;
+  double m_sum = 0.0;
+  double m_sum_sq = 0.0;
+  double m_min = 0.0;
+  double m_max = 0.0;
+  Uint32 m_last_report = SDL_GetTicks();
+};
+
+/**
+ * @brief メインスレッドとシミュレーションスレッドが共有するもの
+ */
+struct Shared {
+  s6i_sync::SpscRing<InputEvent, 256> m_inputs;  ///< メイン → シミュレーション
+  s6i_sync::TripleBuffer<SimState> m_states;     ///< シミュレーション → メイン
+  std::atomic<bool> m_stop{false};
+};
+
+/** @brief 指定した時刻まで待つ（最後の1ms未満はスリープせずに譲る） */
+void wait_until(Uint64 deadline) {
+  for (;;) {
+    const Uint64 now = SDL_GetPerformanceCounter();
+    if (now >= deadline) {
+      return;
+    }
+    const double remaining_ms = to_ms(deadline - now);
+    SDL_Delay(remaining_ms > 2.0 ? static_cast<Uint32>(remaining_ms) - 1 : 0);
+  }
+}
+
+/**
+ * @brief 固定ティックでシミュレーションを進めるスレッドの本体
+ * 入力をまとめて反映し、1ティックごとに状態を公開します
+ */
+void run_simulation(Shared& shared) {
+  const Uint64 period = SDL_GetPerformanceFrequency() / SIMULATION_HZ;
+  Simulation simulation;
+  Stats tick_stats("Simulation tick interval");
+  Uint64 next = SDL_GetPerformanceCounter();
+  Uint64 last = 0;
+  while (!shared.m_stop.load(std::memory_order_relaxed)) {
+    wait_until(next);
+    const Uint64 now = SDL_GetPerformanceCounter();
+    if (last != 0) {
+      tick_stats.add(to_ms(now - last));
+    }
+    last = now;
+
+    while (auto input = shared.m_inputs.try_pop()) {
+      simulation.apply(*input);
+    }
+    simulation.step(shared.m_states.back());
+    shared.m_states.publish();
+
+    next += period;
+    if (now > next + period * MAX_CATCH_UP_TICKS) {
+      next = now + period;
+    }
+    tick_stats.report_every(STATS_INTERVAL_MS);
+  }
+}
+
+/**
+ * @brief イベントを処理する
+ * @param on_key キーが押されたときに呼ぶ関数 void(const InputEvent&)
+ * @return 終了が要求された場合はfalse
+ */
+template <typename F>
+bool poll_events(SDL_Window* window, F&& on_key) {
+  bool running = true;
+  SDL_Event e;
+  while (SDL_PollEvent(&e)) {
+    switch (e.type) {
+      case SDL_QUIT:
+        running = false;
+        break;
+      case SDL_WINDOWEVENT:
+        if (e.window.event == SDL_WINDOWEVENT_CLOSE &&
+            e.window.windowID == SDL_GetWindowID(window)) {
+          running = false;
+        }
+        break;
+      case SDL_KEYDOWN:
+        if (!e.key.repeat) {
+          InputEvent input;
+          input.m_key = e.key.keysym.sym;
+          input.m_timestamp = SDL_GetPerformanceCounter();
+          on_key(input);
+        }
+        break;
+      default:
+        break;
+    }
+  }
+  return running;
+}
+
+/**
+ * @brief 描画する矩形
+ */
+struct DrawRect {
+  SDL_Rect m_rect;
+  SDL_Color m_color;
+};
+
+/**
+ * @brief 状態から描画する矩形の一覧を作る
+ * SDLを呼ばないので、どのスレッドで実行してもよい
+ */
+void build_draw_list(const SimState& state,
+                     int width,
+                     int height,
+                     std::vector<DrawRect>& draw_list) {
+  draw_list.clear();
+  const int w = width / 5;
+  const int h = height / 5;
+  const SDL_Rect rect = {static_cast<int>(state.m_x * width) - w / 2,
+                         static_cast<int>(state.m_y * height) - h / 2, w, h};
+  draw_list.push_back({rect, {0xfb, 0xfa, 0xf5, 0xff}});
+}
+
+/** @brief 画面をクリアして矩形の一覧を描画する */
+void draw(SDL_Renderer* renderer, const std::vector<DrawRect>& draw_list) {
+  // 画面をクリアする
+  SDL_SetRenderDrawColor(renderer, 0x2b, 0x2b, 0x2b, 0xff);
+  SDL_RenderClear(renderer);
+
+  // 矩形を描画する
+  for (const DrawRect& item : draw_list) {
+    SDL_SetRenderDrawColor(renderer, item.m_color.r, item.m_color.g,
+                           item.m_color.b, item.m_color.a);
+    SDL_RenderFillRect(renderer, &item.m_rect);
+  }
+}
+
+/** @brief 状態を描画する */
+void render(SDL_Renderer* renderer,
+            const SimState& state,
+            std::vector<DrawRect>& draw_list) {
+  // レンダラーの出力サイズを取得する
+  int width, height;
+  SDL_GetRendererOutputSize(renderer, &width, &height);
+
+  build_draw_list(state, width, height, draw_list);
+  draw(renderer, draw_list);
+}
+
+/**
+ * @brief 入力から、それを反映した状態の表示までの遅延を記録する
+ */
+class InputLatency {
+ public:
+  void presented(const SimState& state) {
+    if (state.m_input_timestamp == m_last_input) {
+      return;
+    }
+    m_last_input = state.m_input_timestamp;
+    m_stats.add(to_ms(SDL_GetPerformanceCounter() - m_last_input));
+  }
+
+  void report_every(Uint32 interval_ms) { m_stats.report_every(interval_ms); }
+
+ private:
+  Uint64 m_last_input = 0;
+  Stats m_stats{"Input to present latency"};
+};
+
+/**
+ * @brief タスクグラフの各段が読み書きする1フレーム分のデータ
+ */
+struct FrameData {
+  bool m_running = true;
+  SimState m_state;
+  int m_width = 0;
+  int m_height = 0;
+  std::vector<DrawRect> m_draw_list;
+};
+
+/**
+ * @brief シミュレーションを別スレッドで動かし、メインスレッドは
+ *        入力と描画だけを行う（どちらも相手を待たない）
+ *
+ * フレームの各段はタスクグラフとして宣言し、毎フレーム同じグラフを
+ * 実行します。SDLを呼ぶ段はメインスレッドで、それ以外の段は
+ * ジョブシステムのワーカーで、依存がなければ並列に実行されます。
+ */
+bool run_threaded(SDL_Window* window, SDL_Renderer* renderer) {
+  auto inputs_result = s6i_sync::SpscRing<InputEvent, 256>::make();
+  auto states_result = s6i_sync::TripleBuffer<SimState>::make();
+  if (inputs_result.is_err() || states_result.is_err()) {
+    S6I_LOG_CRITICAL(SDL_LOG_CATEGORY_APPLICATION,
+                     "Failed to create simulation channels.");
+    return false;
+  }
+  Shared shared{std::move(inputs_result.unwrap()),
+                std::move(states_result.unwrap())};
+
+  s6i_sync::ThreadDesc desc;
+  desc.m_name = "simulation";
+  auto thread_result = s6i_sync::Thread<>::make(
+      desc, [&shared]() { run_simulation(shared); });
+  if (thread_result.is_err()) {
+    S6I_LOG_CRITICAL(SDL_LOG_CATEGORY_APPLICATION,
+                     "Failed to create simulation thread.");
+    return false;
+  }
+  auto thread = std::move(thread_result.unwrap());
+
+  auto jobs_result = s6i_job::JobSystem::make();
+  if (jobs_result.is_err()) {
+    S6I_LOG_CRITICAL(SDL_LOG_CATEGORY_APPLICATION,
+                     "Failed to create job system.");
+    shared.m_stop = true;
+    return false;
+  }
+  auto jobs = std::move(jobs_result.unwrap());
+
+  // 1フレームの各段と、それぞれが読み書きするものを宣言する
+  FrameData frame;
+  InputLatency latency;
+  s6i_job::TaskGraphBuilder builder;
+  const auto events = builder.add_resource("events");
+  const auto sim_state = builder.add_resource("sim_state");
+  const auto output_size = builder.add_resource("output_size");
+  const auto draw_list = builder.add_resource("draw_list");
+  const auto target = builder.add_resource("render_target");
+  builder.add_task({"poll_events", {}, {events}, true}, [&]() {
+    frame.m_running = poll_events(window, [&shared](const InputEvent& input) {
+      if (!shared.m_inputs.try_push(input)) {
+        S6I_LOG_WARN(SDL_LOG_CATEGORY_INPUT, "Input queue is full.");
+      }
+    });
+  });
+  builder.add_task({"fetch_state", {}, {sim_state}},
+                   [&]() { frame.m_state = shared.m_states.read(); });
+  builder.add_task({"query_output_size", {}, {output_size}, true}, [&]() {
+    SDL_GetRendererOutputSize(renderer, &frame.m_width, &frame.m_height);
+  });
+  builder.add_task({"build_draw_list", {sim_state, output_size}, {draw_list}},
+                   [&]() {
+                     build_draw_list(frame.m_state, frame.m_width,
+                                     frame.m_height, frame.m_draw_list);
+                   });
+  builder.add_task({"draw", {draw_list}, {target}, true},
+                   [&]() { draw(renderer, frame.m_draw_list); });
+  builder.add_task({"present", {sim_state}, {target}, true}, [&]() {
+    SDL_RenderPresent(renderer);
+    latency.presented(frame.m_state);
+  });
+  auto graph_result = builder.build();
+  if (graph_result.is_err()) {
+    S6I_LOG_CRITICAL(SDL_LOG_CATEGORY_APPLICATION,
+                     "Failed to build frame graph.");
+    shared.m_stop = true;
+    return false;
+  }
+  auto graph = std::move(graph_result.unwrap());
+
+  Stats critical_path_stats("Frame critical path");
+  Stats work_stats("Frame work");
+  while (frame.m_running) {
+    auto report_result = graph.run(jobs);
+    if (report_result.is_err()) {
+      S6I_LOG_CRITICAL(SDL_LOG_CATEGORY_APPLICATION,
+                       "Failed to run frame graph.");
+      break;
+    }
+    const auto& report = report_result.unwrap();
+    critical_path_stats.add(report.m_critical_path_ms);
+    work_stats.add(report.m_work_ms);
+    critical_path_stats.report_every(STATS_INTERVAL_MS);
+    work_stats.report_every(STATS_INTERVAL_MS);
+    latency.report_every(STATS_INTERVAL_MS);
+    s6i_memory::tracking::end_frame();
+  }
+
+  shared.m_stop = true;
+  thread.join().unwrap();
+  return true;
+}
+
+/**
+ * @brief 比較用: 入力・更新・描画を1つのスレッドで順に行う
+ * 更新は経過時間分のティックをまとめて進めるため、
+ * ティックの間隔は描画（VSync待ち）に引きずられます
+ */
+bool run_single_thread(SDL_Window* window, SDL_Renderer* renderer) {
+  const Uint64 period = SDL_GetPerformanceFrequency() / SIMULATION_HZ;
+  Simulation simulation;
+  SimState state;
+  std::vector<DrawRect> draw_list;
+  Stats tick_stats("Simulation tick interval");
+  InputLatency latency;
+  Uint64 next = SDL_GetPerformanceCounter();
+  Uint64 last = 0;
+  while (poll_events(window, [&simulation](const InputEvent& input) {
+    simulation.apply(input);
+  })) {
+    Uint64 now = SDL_GetPerformanceCounter();
+    if (now > next + period * MAX_CATCH_UP_TICKS) {
+      next = now;
+    }
+    while (now >= next) {
+      if (last != 0) {
+        tick_stats.add(to_ms(now - last));
+      }
+      last = now;
+      simulation.step(state);
+      next += period;
+      now = SDL_GetPerformanceCounter();
+    }
+    tick_stats.report_every(STATS_INTERVAL_MS);
+
+    render(renderer, state, draw_list);
+    SDL_RenderPresent(renderer);
+    latency.presented(state);
+    latency.report_every(STATS_INTERVAL_MS);
+    s6i_memory::tracking::end_frame();
+  }
+  return true;
+}
+
 }  // namespace
 
-int main(int /*argc*/, char* /*argv*/[]) {
+// メモリ確保を追跡するビルドでは、operator newも数える
+S6I_MEMORY_TRACK_GLOBAL_NEW();
+
+int main(int argc, char* argv[]) {
 #if defined(_DEBUG)
   SDL_LogSetAllPriority(SDL_LOG_PRIORITY_VERBOSE);
 #endif
 
+  // ログの整形と出力を別スレッドで行う
+  auto logger_result = s6i_log::Logger::make();
+  if (logger_result.is_err()) {
+    SDL_LogCritical(SDL_LOG_CATEGORY_SYSTEM, "Failed to create logger.");
+    return EXIT_FAILURE;
+  }
+  auto logger = std::move(logger_result.unwrap());
+
+  // --single-threadで従来の1スレッドのループを使う（計測の比較用）
+  bool single_thread = false;
+  for (int i = 1; i < argc; ++i) {
+    if (std::strcmp(argv[i], "--single-thread") == 0) {
+      single_thread = true;
+    }
+  }
+
   // SDLを初期化する
-  SDL_LogInfo(SDL_LOG_CATEGORY_SYSTEM, "Initialize SDL.");
+  S6I_LOG_INFO(SDL_LOG_CATEGORY_SYSTEM, "Initialize SDL.");
   if (SDL_Init(SDL_INIT_VIDEO) < 0) {
-    SDL_LogCritical(SDL_LOG_CATEGORY_SYSTEM, "Failed to initialize SDL: %s",
-                    SDL_GetError());
+    S6I_LOG_CRITICAL(SDL_LOG_CATEGORY_SYSTEM, "Failed to initialize SDL: %s",
+                     SDL_GetError());
     return EXIT_FAILURE;
   }
 
   // ウィンドウを生成する
-  SDL_LogInfo(SDL_LOG_CATEGORY_VIDEO, "Create window: %s (%d x %d)",
-              WINDOW_TITLE, WINDOW_WIDTH, WINDOW_HEIGHT);
+  S6I_LOG_INFO(SDL_LOG_CATEGORY_VIDEO, "Create window: %s (%d x %d)",
+               WINDOW_TITLE, WINDOW_WIDTH, WINDOW_HEIGHT);
   auto* window = SDL_CreateWindow(WINDOW_TITLE, SDL_WINDOWPOS_UNDEFINED,
                                   SDL_WINDOWPOS_UNDEFINED, WINDOW_WIDTH,
                                   WINDOW_HEIGHT, SDL_WINDOW_RESIZABLE);
   if (!window) {
-    SDL_LogCritical(SDL_LOG_CATEGORY_VIDEO, "Failed to create window: %s",
-                    SDL_GetError());
+    S6I_LOG_CRITICAL(SDL_LOG_CATEGORY_VIDEO, "Failed to create window: %s",
+                     SDL_GetError());
     SDL_Quit();
     return EXIT_FAILURE;
   }
 
   // レンダラーを生成する
-  SDL_LogInfo(SDL_LOG_CATEGORY_RENDER, "Create renderer.");
+  S6I_LOG_INFO(SDL_LOG_CATEGORY_RENDER, "Create renderer.");
   auto* renderer = SDL_CreateRenderer(
       window, -1, SDL_RENDERER_ACCELERATED | SDL_RENDERER_PRESENTVSYNC);
   if (!renderer) {
-    SDL_LogCritical(SDL_LOG_CATEGORY_RENDER, "Failed to create renderer: %s",
-                    SDL_GetError());
+    S6I_LOG_CRITICAL(SDL_LOG_CATEGORY_RENDER, "Failed to create renderer: %s",
+                     SDL_GetError());
     SDL_DestroyWindow(window);
     SDL_Quit();
     return EXIT_FAILURE;
   }
 
-  bool running = true;
-  while (running) {
-    {
-      SDL_Event e;
-      while (SDL_PollEvent(&e)) {
-        switch (e.type) {
-          case SDL_QUIT:
-            running = false;
-            break;
-          case SDL_WINDOWEVENT:
-            if (e.window.event == SDL_WINDOWEVENT_CLOSE &&
-                e.window.windowID == SDL_GetWindowID(window)) {
-              running = false;
-            }
-            break;
-          default:
-            break;
-        }
-      }
-    }
-
-    // レンダラーの出力サイズを取得する
-    int width, height;
-    SDL_GetRendererOutputSize(renderer, &width, &height);
-
-    // 画面をクリアする
-    SDL_SetRenderDrawColor(renderer, 0x2b, 0x2b, 0x2b, 0xff);
-    SDL_RenderClear(renderer);
-
-    // 矩形を描画する
-    {
-      const SDL_Rect rect = {width / 4, height / 4, width / 2, height / 2};
-      SDL_SetRenderDrawColor(renderer, 0xfb, 0xfa, 0xf5, 0xff);
-      SDL_RenderFillRect(renderer, &rect);
-    }
-
-    // レンダラーを更新する
-    SDL_RenderPresent(renderer);
-  }
+  // メインループ
+  S6I_LOG_INFO(SDL_LOG_CATEGORY_APPLICATION, "Run simulation at %d Hz (%s).",
+               SIMULATION_HZ,
+               single_thread ? "single thread" : "simulation thread");
+  const bool succeeded = single_thread ? run_single_thread(window, renderer)
+                                       : run_threaded(window, renderer);
+  s6i_memory::tracking::dump();
 
   // レンダラーを破棄する
-  SDL_LogInfo(SDL_LOG_CATEGORY_RENDER, "Destroy renderer.");
+  S6I_LOG_INFO(SDL_LOG_CATEGORY_RENDER, "Destroy renderer.");
   SDL_DestroyRenderer(renderer);
 
   // ウィンドウを破棄する
-  SDL_LogInfo(SDL_LOG_CATEGORY_VIDEO, "Destroy window.");
+  S6I_LOG_INFO(SDL_LOG_CATEGORY_VIDEO, "Destroy window.");
   SDL_DestroyWindow(window);
 
   // SDLを終了する
-  SDL_LogInfo(SDL_LOG_CATEGORY_SYSTEM, "Shutdown SDL.");
+  S6I_LOG_INFO(SDL_LOG_CATEGORY_SYSTEM, "Shutdown SDL.");
+  logger.flush().unwrap();
   SDL_Quit();
 
-  return EXIT_SUCCESS;
+  return succeeded ? EXIT_SUCCESS : EXIT_FAILURE;
 }
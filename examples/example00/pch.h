@@ -1,4 +1,14 @@
 #pragma once
 
 #include <SDL.h>
+#include <s6i_job/prelude.h>
+#include <s6i_log/prelude.h>
+#include <s6i_memory/prelude.h>
+#include <s6i_sync/prelude.h>
+#include <algorithm>
+#include <atomic>
+#include <cmath>
 #include <cstdlib>
+#include <cstring>
+#include <utility>
+#include <vector>
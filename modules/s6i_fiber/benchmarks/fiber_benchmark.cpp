@@ -0,0 +1,236 @@
+#include <benchmark/benchmark.h>
+#include <cmath>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <thread>
+#include <vector>
+#include "s6i_fiber/scheduler.h"
+#include "s6i_sync/cond_var.h"
+#include "s6i_sync/mutex.h"
+
+namespace {
+
+using namespace s6i_fiber;
+
+// ワーカースレッド数
+constexpr uint32_t WORKER_COUNT = 4;
+
+// 葉のジョブ1つあたりの計算
+inline float compute(float v) {
+  for (int i = 0; i < 64; ++i) {
+    v = std::sqrt(v * v + 1.0f) * 0.5f;
+  }
+  return v;
+}
+
+/** 比較用: Mutex + CondVarで待つカウンター（待つ間スレッドが眠る） */
+class BlockingCounter {
+ public:
+  BlockingCounter()
+      : m_value(s6i_sync::Mutex<uint32_t>::make(0).unwrap()),
+        m_cond(s6i_sync::CondVar::make().unwrap()) {}
+
+  void add(uint32_t n) { *m_value.lock().unwrap() += n; }
+
+  void done() {
+    auto guard = m_value.lock().unwrap();
+    if (--*guard == 0) {
+      m_cond.broadcast(guard).unwrap();
+    }
+  }
+
+  void wait() {
+    auto guard = m_value.lock().unwrap();
+    while (*guard != 0) {
+      m_cond.wait(guard).unwrap();
+    }
+  }
+
+ private:
+  s6i_sync::Mutex<uint32_t> m_value;
+  s6i_sync::CondVar m_cond;
+};
+
+/**
+ * 比較用: 待機でスレッドを塞ぐジョブプール
+ * 待っているジョブはスレッドを1本占有するため、同時に待つジョブの数より
+ * 多くのスレッドを用意しないとデッドロックする
+ */
+class BlockingPool {
+ public:
+  explicit BlockingPool(uint32_t thread_count)
+      : m_state(s6i_sync::Mutex<State>::make().unwrap()),
+        m_cond(s6i_sync::CondVar::make().unwrap()) {
+    for (uint32_t i = 0; i < thread_count; ++i) {
+      m_threads.emplace_back([this]() { worker_loop(); });
+    }
+  }
+
+  ~BlockingPool() {
+    {
+      auto guard = m_state.lock().unwrap();
+      guard->m_stop = true;
+      m_cond.broadcast(guard).unwrap();
+    }
+    for (auto& thread : m_threads) {
+      thread.join();
+    }
+  }
+
+  void spawn(std::function<void()> f, BlockingCounter* counter) {
+    counter->add(1);
+    auto guard = m_state.lock().unwrap();
+    guard->m_jobs.push_back([f = std::move(f), counter]() {
+      f();
+      counter->done();
+    });
+    m_cond.signal(guard).unwrap();
+  }
+
+ private:
+  struct State {
+    std::deque<std::function<void()>> m_jobs;
+    bool m_stop = false;
+  };
+
+  void worker_loop() {
+    for (;;) {
+      std::function<void()> job;
+      {
+        auto guard = m_state.lock().unwrap();
+        while (guard->m_jobs.empty() && !guard->m_stop) {
+          m_cond.wait(guard).unwrap();
+        }
+        if (guard->m_jobs.empty()) {
+          return;
+        }
+        job = std::move(guard->m_jobs.front());
+        guard->m_jobs.pop_front();
+      }
+      job();
+    }
+  }
+
+  s6i_sync::Mutex<State> m_state;
+  s6i_sync::CondVar m_cond;
+  std::vector<std::thread> m_threads;
+};
+
+FiberScheduler make_scheduler() {
+  FiberSchedulerDesc desc;
+  desc.m_worker_count = WORKER_COUNT;
+  desc.m_fiber_stack_size = 16 * 1024;
+  return FiberScheduler::make(desc).unwrap();
+}
+
+/** 各ジョブが次のジョブを投入して待つ深い鎖: ファイバー */
+void BM_DeepChainFiber(benchmark::State& state) {
+  const auto depth = static_cast<int>(state.range(0));
+  auto scheduler = make_scheduler();
+
+  std::function<void(int)> link = [&](int level) {
+    if (level < depth) {
+      FiberCounter next;
+      scheduler.spawn([&link, level]() { link(level + 1); }, &next).unwrap();
+      next.wait();
+    }
+  };
+  for (auto _ : state) {
+    FiberCounter root;
+    scheduler.spawn([&link]() { link(1); }, &root).unwrap();
+    root.wait();
+  }
+  state.SetItemsProcessed(state.iterations() * depth);
+  state.counters["fibers"] = static_cast<double>(scheduler.fiber_count());
+}
+BENCHMARK(BM_DeepChainFiber)->Arg(64)->Arg(512)->UseRealTime();
+
+/** 各ジョブが次のジョブを投入して待つ深い鎖: スレッドを塞ぐ待機 */
+void BM_DeepChainBlocking(benchmark::State& state) {
+  const auto depth = static_cast<int>(state.range(0));
+  BlockingPool pool(static_cast<uint32_t>(depth) + WORKER_COUNT);
+
+  std::function<void(int)> link = [&](int level) {
+    if (level < depth) {
+      BlockingCounter next;
+      pool.spawn([&link, level]() { link(level + 1); }, &next);
+      next.wait();
+    }
+  };
+  for (auto _ : state) {
+    BlockingCounter root;
+    pool.spawn([&link]() { link(1); }, &root);
+    root.wait();
+  }
+  state.SetItemsProcessed(state.iterations() * depth);
+  state.counters["threads"] = depth + WORKER_COUNT;
+}
+BENCHMARK(BM_DeepChainBlocking)->Arg(64)->Arg(512)->UseRealTime();
+
+// 分岐: 中間のジョブ数と、中間1つあたりの葉のジョブ数
+constexpr int FAN_OUT = 16;
+constexpr int LEAVES_PER_NODE = 64;
+
+/** 中間のジョブがそれぞれ葉を投入して待つ2段の分岐と合流: ファイバー */
+void BM_FanOutFanInFiber(benchmark::State& state) {
+  auto scheduler = make_scheduler();
+  std::vector<float> values(FAN_OUT * LEAVES_PER_NODE, 1.0f);
+
+  for (auto _ : state) {
+    FiberCounter root;
+    scheduler
+        .spawn_n(FAN_OUT,
+                 [&](size_t node) {
+                   FiberCounter leaves;
+                   scheduler
+                       .spawn_n(LEAVES_PER_NODE,
+                                [&values, node](size_t leaf) {
+                                  float& v =
+                                      values[node * LEAVES_PER_NODE + leaf];
+                                  v = compute(v);
+                                },
+                                &leaves)
+                       .unwrap();
+                   leaves.wait();
+                 },
+                 &root)
+        .unwrap();
+    root.wait();
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.iterations() * FAN_OUT * LEAVES_PER_NODE);
+}
+BENCHMARK(BM_FanOutFanInFiber)->UseRealTime();
+
+/** 中間のジョブがそれぞれ葉を投入して待つ2段の分岐と合流: スレッドを塞ぐ待機 */
+void BM_FanOutFanInBlocking(benchmark::State& state) {
+  BlockingPool pool(FAN_OUT + WORKER_COUNT);
+  std::vector<float> values(FAN_OUT * LEAVES_PER_NODE, 1.0f);
+
+  for (auto _ : state) {
+    BlockingCounter root;
+    for (int node = 0; node < FAN_OUT; ++node) {
+      pool.spawn(
+          [&pool, &values, node]() {
+            BlockingCounter leaves;
+            for (int leaf = 0; leaf < LEAVES_PER_NODE; ++leaf) {
+              pool.spawn(
+                  [&values, node, leaf]() {
+                    float& v = values[node * LEAVES_PER_NODE + leaf];
+                    v = compute(v);
+                  },
+                  &leaves);
+            }
+            leaves.wait();
+          },
+          &root);
+    }
+    root.wait();
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.iterations() * FAN_OUT * LEAVES_PER_NODE);
+}
+BENCHMARK(BM_FanOutFanInBlocking)->UseRealTime();
+
+}  // namespace
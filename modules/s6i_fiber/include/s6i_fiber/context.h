@@ -0,0 +1,325 @@
+#pragma once
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <utility>
+
+/**
+ * 実行コンテキストの切り替え方式
+ *
+ * - x86-64 Linux: 呼び出し先保存レジスタだけを退避するアセンブリ
+ * - Windows: Win32のファイバーAPI（スタックはOSが確保する）
+ * - その他のPOSIX: ucontext（切り替えのたびにシグナルマスクの
+ *   システムコールが入るため遅い）
+ *
+ * S6I_FIBER_USE_UCONTEXTを1にすると、x86-64 Linuxでもucontextを使います
+ * （デバッガーやサニタイザーでの確認用）。
+ */
+#if defined(_WIN32)
+#define S6I_FIBER_CONTEXT_WIN32 1
+#elif defined(__x86_64__) && defined(__linux__) && \
+    !(defined(S6I_FIBER_USE_UCONTEXT) && S6I_FIBER_USE_UCONTEXT)
+#define S6I_FIBER_CONTEXT_X86_64 1
+#else
+#define S6I_FIBER_CONTEXT_UCONTEXT 1
+#endif
+
+#if defined(S6I_FIBER_CONTEXT_WIN32)
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#else
+#if defined(__APPLE__) && !defined(_XOPEN_SOURCE)
+#define _XOPEN_SOURCE 600  // macOSのucontextに必要
+#endif
+#include <sys/mman.h>
+#include <unistd.h>
+#if defined(S6I_FIBER_CONTEXT_UCONTEXT)
+#include <ucontext.h>
+#endif
+#endif
+
+#if defined(S6I_FIBER_CONTEXT_X86_64)
+extern "C" {
+void s6i_fiber_switch_x86_64(void** from_sp, void* to_sp);
+void s6i_fiber_start_x86_64();
+}
+
+// ヘッダーから各翻訳単位に出力されるため、weakシンボルにして1つにまとめる
+//
+// switch: 呼び出し先保存レジスタとMXCSR/x87制御ワードを積み、
+//         スタックポインターを*from_spに保存してto_spへ切り替える
+// start:  新しいファイバーの最初の戻り先。r12を引数にr13を呼ぶ
+asm(R"(
+  .text
+  .weak s6i_fiber_switch_x86_64
+  .type s6i_fiber_switch_x86_64, @function
+  .p2align 4
+s6i_fiber_switch_x86_64:
+  pushq %rbp
+  pushq %rbx
+  pushq %r12
+  pushq %r13
+  pushq %r14
+  pushq %r15
+  subq $16, %rsp
+  stmxcsr 8(%rsp)
+  fnstcw (%rsp)
+  movq %rsp, (%rdi)
+  movq %rsi, %rsp
+  ldmxcsr 8(%rsp)
+  fldcw (%rsp)
+  addq $16, %rsp
+  popq %r15
+  popq %r14
+  popq %r13
+  popq %r12
+  popq %rbx
+  popq %rbp
+  ret
+  .size s6i_fiber_switch_x86_64, .-s6i_fiber_switch_x86_64
+
+  .weak s6i_fiber_start_x86_64
+  .type s6i_fiber_start_x86_64, @function
+  .p2align 4
+s6i_fiber_start_x86_64:
+  movq %r12, %rdi
+  andq $-16, %rsp
+  callq *%r13
+  ud2
+  .size s6i_fiber_start_x86_64, .-s6i_fiber_start_x86_64
+)");
+#endif
+
+namespace s6i_fiber {
+
+namespace detail {
+
+/** @brief ファイバーの入口（戻ってはいけない） */
+using EntryFunc = void (*)(void* arg);
+
+#if !defined(S6I_FIBER_CONTEXT_WIN32)
+
+/** @brief ページサイズ（ガードページの大きさ） */
+inline size_t page_size() {
+  static const size_t s_size = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+  return s_size;
+}
+
+/**
+ * @brief ガードページ付きのスタック領域
+ *
+ * mmapで確保し、下端（スタックが伸びていく側）の1ページを
+ * PROT_NONEにします。スタックが溢れるとそのページに触れて
+ * その場でSIGSEGVになり、隣のメモリを静かに壊すことはありません。
+ * 確保するのは仮想アドレスだけで、物理メモリは触れたページの分だけです。
+ */
+struct StackMemory {
+  void* m_base = nullptr;  ///< 領域の先頭（ガードページ）
+  size_t m_size = 0;       ///< ガードページを含む大きさ
+
+  /** @brief スタックの上端（ここから下へ伸びる） */
+  void* top() const { return static_cast<char*>(m_base) + m_size; }
+
+  /**
+   * @brief スタックを確保する
+   * @param usable_size 使える大きさ（ページ単位に切り上げる）
+   * @return 失敗時はm_baseがnullptr
+   */
+  static StackMemory allocate(size_t usable_size) {
+    const size_t page = page_size();
+    const size_t size = (usable_size + page - 1) / page * page + page;
+    void* base = mmap(nullptr, size, PROT_READ | PROT_WRITE,
+                      MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (base == MAP_FAILED) {
+      return {};
+    }
+    if (mprotect(base, page, PROT_NONE) != 0) {
+      munmap(base, size);
+      return {};
+    }
+    return {base, size};
+  }
+
+  void release() {
+    if (m_base) {
+      munmap(m_base, m_size);
+      m_base = nullptr;
+      m_size = 0;
+    }
+  }
+};
+
+#endif
+
+/**
+ * @brief 実行コンテキスト（レジスタとスタック）
+ *
+ * 既定構築したものはスレッド自身のコンテキストを表し、
+ * 最初にswitch_to()で離れるときに保存されます。
+ * create()したものは自前のスタックを持ち、
+ * 最初に切り替えたときに入口関数から実行を始めます。
+ *
+ * 同じスレッド上でのみ切り替えられますが、保存されたファイバーの
+ * コンテキストは別のスレッドから再開しても構いません。
+ */
+class ExecutionContext {
+ public:
+  ExecutionContext() = default;
+
+  // コピー・ムーブ禁止（保存したスタックポインターが自身を指すため）
+  ExecutionContext(const ExecutionContext&) = delete;
+  ExecutionContext& operator=(const ExecutionContext&) = delete;
+
+  ~ExecutionContext() { destroy(); }
+
+  /**
+   * @brief 自前のスタックを確保し、入口関数から始まるコンテキストにする
+   * @param stack_size スタックサイズ（ガードページを除く）
+   * @param entry 入口関数（戻ってはいけない）
+   * @param arg 入口関数の引数
+   * @return 成功時true
+   */
+  bool create(size_t stack_size, EntryFunc entry, void* arg) {
+    assert(!has_stack() && "ExecutionContext is already created");
+    m_entry = entry;
+    m_arg = arg;
+#if defined(S6I_FIBER_CONTEXT_WIN32)
+    // スタックとガードページはOSが確保する
+    m_handle = CreateFiberEx(stack_size, stack_size, FIBER_FLAG_FLOAT_SWITCH,
+                             &ExecutionContext::win32_entry, this);
+    return m_handle != nullptr;
+#else
+    m_stack = StackMemory::allocate(stack_size);
+    if (!m_stack.m_base) {
+      return false;
+    }
+#if defined(S6I_FIBER_CONTEXT_X86_64)
+    // s6i_fiber_switch_x86_64が復元する形に初期フレームを積む
+    auto top = reinterpret_cast<uintptr_t>(m_stack.top()) & ~uintptr_t{15};
+    auto* frame = reinterpret_cast<uint64_t*>(top) - 10;
+    frame[0] = 0x037f;  // x87制御ワード（既定値）
+    frame[1] = 0x1f80;  // MXCSR（既定値）
+    frame[2] = 0;       // r15
+    frame[3] = 0;       // r14
+    frame[4] = reinterpret_cast<uint64_t>(entry);  // r13
+    frame[5] = reinterpret_cast<uint64_t>(arg);    // r12
+    frame[6] = 0;                                  // rbx
+    frame[7] = 0;                                  // rbp
+    frame[8] = reinterpret_cast<uint64_t>(&s6i_fiber_start_x86_64);
+    frame[9] = 0;
+    m_sp = frame;
+#else
+    getcontext(&m_context);
+    m_context.uc_stack.ss_sp = m_stack.m_base;
+    m_context.uc_stack.ss_size = m_stack.m_size;
+    m_context.uc_link = nullptr;
+    // makecontextの引数はintなので、ポインターを2つに分けて渡す
+    const auto self = reinterpret_cast<uintptr_t>(this);
+    makecontext(&m_context,
+                reinterpret_cast<void (*)()>(&ExecutionContext::ucontext_entry),
+                2, static_cast<unsigned>(static_cast<uint64_t>(self) >> 32),
+                static_cast<unsigned>(self & 0xffffffffu));
+#endif
+    return true;
+#endif
+  }
+
+  /** @brief 自前のスタックを持つかどうか */
+  bool has_stack() const {
+#if defined(S6I_FIBER_CONTEXT_WIN32)
+    return m_handle != nullptr && m_entry != nullptr;
+#else
+    return m_stack.m_base != nullptr;
+#endif
+  }
+
+  /**
+   * @brief 現在のスレッドをファイバーへ切り替えられる状態にする
+   * ファイバーへ切り替えるスレッドで、最初の切り替えの前に呼ぶこと
+   * @return 成功時true
+   */
+  bool attach_thread() {
+#if defined(S6I_FIBER_CONTEXT_WIN32)
+    m_handle = ConvertThreadToFiber(nullptr);
+    return m_handle != nullptr;
+#else
+    return true;
+#endif
+  }
+
+  /** @brief attach_thread()を元に戻す */
+  void detach_thread() {
+#if defined(S6I_FIBER_CONTEXT_WIN32)
+    if (m_handle) {
+      ConvertFiberToThread();
+      m_handle = nullptr;
+    }
+#endif
+  }
+
+  /**
+   * @brief 現在のコンテキストをfromに保存し、toへ切り替える
+   * fromへ誰かが切り替え直したときに戻ってきます
+   */
+  static void switch_to(ExecutionContext& from, ExecutionContext& to) {
+#if defined(S6I_FIBER_CONTEXT_WIN32)
+    (void)from;
+    SwitchToFiber(to.m_handle);
+#elif defined(S6I_FIBER_CONTEXT_X86_64)
+    s6i_fiber_switch_x86_64(&from.m_sp, to.m_sp);
+#else
+    swapcontext(&from.m_context, &to.m_context);
+#endif
+  }
+
+ private:
+  void destroy() {
+#if defined(S6I_FIBER_CONTEXT_WIN32)
+    if (has_stack()) {
+      DeleteFiber(m_handle);
+      m_handle = nullptr;
+    }
+#else
+    m_stack.release();
+#endif
+  }
+
+#if defined(S6I_FIBER_CONTEXT_WIN32)
+  static void WINAPI win32_entry(void* param) {
+    auto* self = static_cast<ExecutionContext*>(param);
+    self->m_entry(self->m_arg);
+    std::abort();
+  }
+#elif defined(S6I_FIBER_CONTEXT_UCONTEXT)
+  static void ucontext_entry(unsigned high, unsigned low) {
+    auto* self = reinterpret_cast<ExecutionContext*>(
+        static_cast<uintptr_t>((static_cast<uint64_t>(high) << 32) | low));
+    self->m_entry(self->m_arg);
+    std::abort();
+  }
+#endif
+
+  EntryFunc m_entry = nullptr;
+  void* m_arg = nullptr;
+#if defined(S6I_FIBER_CONTEXT_WIN32)
+  void* m_handle = nullptr;
+#else
+  StackMemory m_stack;
+#if defined(S6I_FIBER_CONTEXT_X86_64)
+  void* m_sp = nullptr;
+#else
+  ucontext_t m_context{};
+#endif
+#endif
+};
+
+}  // namespace detail
+
+}  // namespace s6i_fiber
@@ -0,0 +1,29 @@
+#pragma once
+
+#include <s6i_result/niche.h>
+
+namespace s6i_fiber {
+
+/**
+ * @brief ファイバースケジューラーに関するエラー型
+ */
+enum class FiberError {
+  // FiberScheduler関連エラー
+  WorkerCreationError,    ///< ワーカースレッドの作成に失敗
+  InvalidSchedulerError,  ///< 無効なFiberSchedulerへの操作
+
+  // スタック関連エラー
+  StackAllocationError,  ///< ファイバーのスタックの確保に失敗
+};
+
+}  // namespace s6i_fiber
+
+/**
+ * @brief FiberErrorの範囲外の値をResultのタグとして使う
+ */
+template <>
+struct s6i_result::NicheTraits<s6i_fiber::FiberError> {
+  static constexpr bool enabled = true;
+  static constexpr s6i_fiber::FiberError value =
+      static_cast<s6i_fiber::FiberError>(-1);
+};
@@ -0,0 +1,5 @@
+#pragma once
+
+#include "context.h"
+#include "error.h"
+#include "scheduler.h"
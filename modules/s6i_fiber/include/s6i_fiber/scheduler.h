@@ -0,0 +1,800 @@
+#pragma once
+
+#include <SDL.h>
+#include <s6i_log/log.h>
+#include <s6i_result/result.h>
+#include <s6i_sync/backoff.h>
+#include <s6i_sync/futex.h>
+#include <s6i_sync/mutex.h>
+#include <s6i_sync/thread.h>
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "context.h"
+#include "error.h"
+
+#if defined(_MSC_VER)
+#define S6I_FIBER_NOINLINE __declspec(noinline)
+#else
+#define S6I_FIBER_NOINLINE __attribute__((noinline))
+#endif
+
+namespace s6i_fiber {
+
+/**
+ * @brief FiberSchedulerの作成設定
+ */
+struct FiberSchedulerDesc {
+  /** @brief ワーカースレッド数（0はCPU数 - 1、最低1） */
+  uint32_t m_worker_count = 0;
+  /**
+   * @brief ワーカーをCPUに固定するかどうか（ワーカーiをCPU i + 1に固定）
+   * CPUがs6i_sync::MAX_AFFINITY_CPU_COUNTより多い環境では固定しません。
+   */
+  bool m_pin_workers = true;
+  /** @brief ファイバー1本のスタックサイズ（ガードページを除く） */
+  size_t m_fiber_stack_size = 64 * 1024;
+  /** @brief 作成時に確保しておくファイバー数 */
+  uint32_t m_initial_fiber_count = 0;
+};
+
+class FiberCounter;
+
+namespace detail {
+
+class Scheduler;
+struct Worker;
+
+/** @brief 型を消したジョブ */
+class Task {
+ public:
+  virtual ~Task() = default;
+  virtual void execute() = 0;
+
+  /** @brief 完了時に1減らすカウンター */
+  FiberCounter* m_counter = nullptr;
+};
+
+template <typename F>
+class FunctionTask final : public Task {
+ public:
+  explicit FunctionTask(F&& f) : m_func(std::move(f)) {}
+  void execute() override { m_func(); }
+
+ private:
+  F m_func;
+};
+
+template <typename F>
+Task* make_task(F&& f, FiberCounter* counter) {
+  Task* task = new FunctionTask<std::decay_t<F>>(std::forward<F>(f));
+  task->m_counter = counter;
+  return task;
+}
+
+/** @brief ファイバーがワーカーへ制御を返した理由 */
+enum class FiberState {
+  Running,   ///< 実行中
+  Finished,  ///< ジョブが完了した（プールへ戻す）
+  Waiting,   ///< カウンターを待つ
+  Yielded,   ///< 実行を譲った（すぐに再開待ちへ戻す）
+};
+
+/**
+ * @brief ジョブを実行するファイバー
+ * ジョブが完了してもスタックは解放せず、プールへ戻して次のジョブに使います
+ */
+struct Fiber {
+  /** @brief 実行を中断し、ワーカーへ制御を返す */
+  void suspend(FiberState state);
+
+  ExecutionContext m_context;
+  Scheduler* m_scheduler = nullptr;
+  Worker* m_worker = nullptr;  ///< 実行しているワーカー（再開のたびに変わる）
+  Task* m_task = nullptr;
+  FiberState m_state = FiberState::Running;
+  FiberCounter* m_wait_counter = nullptr;
+};
+
+/** @brief ワーカーごとの状態 */
+struct Worker {
+  ExecutionContext m_context;  ///< ワーカースレッド自身のコンテキスト
+  Fiber* m_current = nullptr;  ///< 実行中のファイバー
+};
+
+/** @brief ファイバーのFIFOキュー */
+class FiberQueue {
+ public:
+  FiberQueue()
+      : m_queue(s6i_sync::Mutex<std::deque<Fiber*>,
+                                s6i_sync::SpinMutexPolicy>::make()
+                    .unwrap()) {}
+
+  void push(Fiber* fiber) {
+    auto guard = m_queue.lock().unwrap();
+    guard->push_back(fiber);
+    m_size.store(guard->size(), std::memory_order_relaxed);
+  }
+
+  Fiber* pop() {
+    if (empty()) {
+      return nullptr;
+    }
+    auto guard = m_queue.lock().unwrap();
+    if (guard->empty()) {
+      return nullptr;
+    }
+    Fiber* fiber = guard->front();
+    guard->pop_front();
+    m_size.store(guard->size(), std::memory_order_relaxed);
+    return fiber;
+  }
+
+  bool empty() const { return m_size.load(std::memory_order_relaxed) == 0; }
+
+ private:
+  s6i_sync::Mutex<std::deque<Fiber*>, s6i_sync::SpinMutexPolicy> m_queue;
+  std::atomic<size_t> m_size{0};
+};
+
+inline void Fiber::suspend(FiberState state) {
+  m_state = state;
+  ExecutionContext::switch_to(m_context, m_worker->m_context);
+}
+
+inline thread_local Worker* t_worker = nullptr;
+
+/**
+ * @brief 現在のスレッドで実行中のファイバー（ファイバー外はnullptr）
+ * ファイバーは別のワーカーで再開されることがあるため、
+ * スレッドローカル変数のアドレスを呼び出し元にキャッシュさせない
+ */
+S6I_FIBER_NOINLINE inline Fiber* current_fiber() {
+  Worker* worker = t_worker;
+  return worker ? worker->m_current : nullptr;
+}
+
+}  // namespace detail
+
+/**
+ * @brief ジョブの完了を数える依存カウンター
+ *
+ * spawn()に渡すと投入時に1増え、ジョブの完了時に1減ります。
+ * wait()は0になるまで待ちます。ファイバー上で呼ぶとファイバーだけが
+ * 中断され、ワーカースレッドはその間に他のジョブを実行します。
+ * ファイバー外のスレッドから呼ぶとfutexで眠ります。
+ *
+ * カウンターは、それを待つwait()がすべて戻り、
+ * 数えているジョブがすべて完了するまで破棄しないこと。
+ */
+class FiberCounter {
+ public:
+  explicit FiberCounter(uint32_t initial = 0)
+      : m_value(initial),
+        m_waiters(s6i_sync::Mutex<std::vector<detail::Fiber*>,
+                                  s6i_sync::SpinMutexPolicy>::make()
+                      .unwrap()) {}
+
+  // コピー・ムーブ禁止（待機中のファイバーが参照するため）
+  FiberCounter(const FiberCounter&) = delete;
+  FiberCounter& operator=(const FiberCounter&) = delete;
+
+  /** @brief 現在の値 */
+  uint32_t value() const { return m_value.load(std::memory_order_acquire); }
+
+  /** @brief 0になったかどうか */
+  bool is_done() const { return value() == 0; }
+
+  /** @brief n増やす（ジョブ以外の完了を数えるとき用） */
+  void add(uint32_t n = 1) { m_value.fetch_add(n, std::memory_order_relaxed); }
+
+  /** @brief 1減らし、0になったら待っているファイバーとスレッドを起こす */
+  void done();
+
+  /** @brief 0になるまで待つ */
+  void wait();
+
+ private:
+  void wait_thread();
+
+  std::atomic<uint32_t> m_value;
+  std::atomic<uint32_t> m_thread_waiters{0};
+  std::atomic<uint32_t> m_busy{0};  ///< done()がカウンターに触れている間は非0
+  s6i_sync::Mutex<std::vector<detail::Fiber*>, s6i_sync::SpinMutexPolicy>
+      m_waiters;
+
+  friend class detail::Scheduler;
+};
+
+namespace detail {
+
+/**
+ * @brief ワーカー、ファイバーのプール、キューをまとめた共有状態
+ *
+ * ワーカーは待機が解けたファイバーを優先し、次に新しいジョブを
+ * プールから取ったファイバーで実行し、最後に実行を譲ったファイバーを
+ * 再開します（譲ったファイバーが待っている相手を先に進めるため）。
+ * ファイバーが中断してワーカーへ戻ると、ワーカーのスタック上で
+ * 理由に応じた後始末（プールへ戻す、カウンターに登録する）をします。
+ * 中断したファイバーのスタックから離れた後で登録するため、
+ * 別のワーカーがまだ動いているスタックで再開することはありません。
+ */
+class Scheduler {
+ public:
+  Scheduler(uint32_t worker_count, size_t fiber_stack_size)
+      : m_fiber_stack_size(fiber_stack_size),
+        m_tasks(s6i_sync::Mutex<std::deque<Task*>,
+                                s6i_sync::SpinMutexPolicy>::make()
+                    .unwrap()),
+        m_free_fibers(
+            s6i_sync::Mutex<FreeFibers, s6i_sync::SpinMutexPolicy>::make()
+                .unwrap()),
+        m_fibers(s6i_sync::Mutex<std::vector<std::unique_ptr<Fiber>>,
+                                 s6i_sync::SpinMutexPolicy>::make()
+                     .unwrap()) {
+    m_workers.reserve(worker_count);
+    for (uint32_t i = 0; i < worker_count; ++i) {
+      m_workers.push_back(std::make_unique<Worker>());
+    }
+  }
+
+  ~Scheduler() {
+    // 実行されなかったジョブは捨てる（待っているスレッドは起こす）
+    auto tasks = m_tasks.lock().unwrap();
+    discard_tasks(*tasks);
+    discard_tasks(m_free_fibers.lock().unwrap()->m_starved);
+  }
+
+  /** @brief ジョブを投入する */
+  void submit(Task* const* tasks, size_t count) {
+    if (count == 0) {
+      return;
+    }
+    {
+      auto guard = m_tasks.lock().unwrap();
+      guard->insert(guard->end(), tasks, tasks + count);
+      m_task_size.store(guard->size(), std::memory_order_relaxed);
+    }
+    notify(count);
+  }
+
+  /** @brief 中断していたファイバーを再開待ちにする */
+  void push_ready(Fiber* fiber) {
+    m_ready.push(fiber);
+    notify(1);
+  }
+
+  /**
+   * @brief ファイバーを作ってプールに入れておく
+   * @return すべて作れたらtrue
+   */
+  bool prepare_fibers(size_t count) {
+    for (size_t i = 0; i < count; ++i) {
+      Fiber* fiber = create_fiber();
+      if (!fiber) {
+        return false;
+      }
+      release_fiber(fiber);
+    }
+    return true;
+  }
+
+  /** @brief ワーカースレッドの本体 */
+  void worker_loop(uint32_t index) {
+    Worker& self = *m_workers[index];
+    if (!self.m_context.attach_thread()) {
+      S6I_LOG_ERROR(SDL_LOG_CATEGORY_SYSTEM,
+                    "Failed to attach fiber worker %u", index);
+      return;
+    }
+    t_worker = &self;
+
+    s6i_sync::Backoff backoff;
+    while (!m_stop.load(std::memory_order_acquire)) {
+      if (run_next(self)) {
+        backoff.reset();
+        continue;
+      }
+      if (!backoff.is_completed()) {
+        backoff.snooze();
+        continue;
+      }
+      sleep();
+      backoff.reset();
+    }
+    t_worker = nullptr;
+    self.m_context.detach_thread();
+  }
+
+  /** @brief ワーカーを止める */
+  void stop() {
+    m_stop.store(true, std::memory_order_release);
+    m_wake_seq.fetch_add(1, std::memory_order_seq_cst);
+    s6i_sync::futex_wake_all(m_wake_seq);
+  }
+
+  size_t worker_count() const { return m_workers.size(); }
+
+  size_t fiber_count() const {
+    return m_fiber_count.load(std::memory_order_relaxed);
+  }
+
+ private:
+  /** @brief 次の仕事を1つ実行する（なければfalse） */
+  bool run_next(Worker& self) {
+    // 再開待ちを優先する（中断中のファイバーのスタックを早く空けるため）
+    if (Fiber* fiber = m_ready.pop()) {
+      resume(self, fiber);
+      return true;
+    }
+    if (Task* task = pop_task()) {
+      Fiber* fiber = acquire_fiber();
+      if (!fiber && !(fiber = park_task(task))) {
+        return false;
+      }
+      fiber->m_task = task;
+      resume(self, fiber);
+      return true;
+    }
+    if (Fiber* fiber = m_yielded.pop()) {
+      resume(self, fiber);
+      return true;
+    }
+    return false;
+  }
+
+  /** @brief ファイバーへ切り替え、戻ってきたら理由に応じて後始末をする */
+  void resume(Worker& self, Fiber* fiber) {
+    fiber->m_worker = &self;
+    fiber->m_state = FiberState::Running;
+    self.m_current = fiber;
+    ExecutionContext::switch_to(self.m_context, fiber->m_context);
+    self.m_current = nullptr;
+
+    switch (fiber->m_state) {
+      case FiberState::Finished:
+        release_fiber(fiber);
+        break;
+      case FiberState::Waiting:
+        park(fiber);
+        break;
+      case FiberState::Yielded:
+        m_yielded.push(fiber);
+        break;
+      case FiberState::Running:
+        assert(false && "Fiber returned without suspending");
+        break;
+    }
+  }
+
+  /**
+   * @brief 待機するファイバーをカウンターに登録する
+   * 既に0なら、登録せずにすぐ再開待ちへ戻す
+   */
+  void park(Fiber* fiber) {
+    FiberCounter* counter = std::exchange(fiber->m_wait_counter, nullptr);
+    {
+      auto guard = counter->m_waiters.lock().unwrap();
+      if (counter->m_value.load(std::memory_order_seq_cst) != 0) {
+        guard->push_back(fiber);
+        return;
+      }
+    }
+    push_ready(fiber);
+  }
+
+  /** @brief ファイバーの入口: ジョブを実行してはワーカーへ戻る */
+  static void fiber_main(void* arg) {
+    auto* self = static_cast<Fiber*>(arg);
+    for (;;) {
+      Task* task = std::exchange(self->m_task, nullptr);
+      task->execute();
+      FiberCounter* counter = task->m_counter;
+      delete task;
+      if (counter) {
+        counter->done();
+      }
+      self->suspend(FiberState::Finished);
+    }
+  }
+
+  Fiber* create_fiber() {
+    auto fiber = std::make_unique<Fiber>();
+    fiber->m_scheduler = this;
+    if (!fiber->m_context.create(m_fiber_stack_size, &Scheduler::fiber_main,
+                                 fiber.get())) {
+      // 確保できない間は何度も試すので、続けて失敗している間は1度だけ出す
+      if (!m_stack_failed.exchange(true, std::memory_order_relaxed)) {
+        S6I_LOG_ERROR(SDL_LOG_CATEGORY_SYSTEM,
+                      "Failed to allocate fiber stack (%zu bytes)",
+                      m_fiber_stack_size);
+      }
+      return nullptr;
+    }
+    m_stack_failed.store(false, std::memory_order_relaxed);
+    Fiber* raw = fiber.get();
+    m_fibers.lock().unwrap()->push_back(std::move(fiber));
+    m_fiber_count.fetch_add(1, std::memory_order_relaxed);
+    return raw;
+  }
+
+  static void discard_tasks(const std::deque<Task*>& tasks) {
+    for (Task* task : tasks) {
+      FiberCounter* counter = task->m_counter;
+      delete task;
+      if (counter) {
+        counter->done();
+      }
+    }
+  }
+
+  Fiber* acquire_fiber() {
+    {
+      auto guard = m_free_fibers.lock().unwrap();
+      if (!guard->m_fibers.empty()) {
+        Fiber* fiber = guard->m_fibers.back();
+        guard->m_fibers.pop_back();
+        return fiber;
+      }
+    }
+    return create_fiber();
+  }
+
+  /**
+   * @brief スタックを確保できなかったジョブを、ファイバーが空くまで預ける
+   * 預けたジョブは投入待ちに数えないため、ワーカーは空回りせずに眠れる
+   * @return 預ける前にファイバーが空いていれば、そのファイバー
+   */
+  Fiber* park_task(Task* task) {
+    auto guard = m_free_fibers.lock().unwrap();
+    if (!guard->m_fibers.empty()) {
+      Fiber* fiber = guard->m_fibers.back();
+      guard->m_fibers.pop_back();
+      return fiber;
+    }
+    guard->m_starved.push_back(task);
+    return nullptr;
+  }
+
+  /** @brief ファイバーを空きに戻し、預けていたジョブがあれば1つ投入し直す */
+  void release_fiber(Fiber* fiber) {
+    Task* starved = nullptr;
+    {
+      auto guard = m_free_fibers.lock().unwrap();
+      guard->m_fibers.push_back(fiber);
+      if (!guard->m_starved.empty()) {
+        starved = guard->m_starved.front();
+        guard->m_starved.pop_front();
+      }
+    }
+    if (starved) {
+      // 後から投入されたジョブより先に実行する
+      {
+        auto guard = m_tasks.lock().unwrap();
+        guard->push_front(starved);
+        m_task_size.store(guard->size(), std::memory_order_relaxed);
+      }
+      notify(1);
+    }
+  }
+
+  Task* pop_task() {
+    if (m_task_size.load(std::memory_order_relaxed) == 0) {
+      return nullptr;
+    }
+    auto guard = m_tasks.lock().unwrap();
+    if (guard->empty()) {
+      return nullptr;
+    }
+    Task* task = guard->front();
+    guard->pop_front();
+    m_task_size.store(guard->size(), std::memory_order_relaxed);
+    return task;
+  }
+
+  bool has_work() const {
+    return !m_ready.empty() || !m_yielded.empty() ||
+           m_task_size.load(std::memory_order_relaxed) > 0;
+  }
+
+  /**
+   * @brief 仕事が投入されるまで眠る
+   * 眠る印を付けた後にもう一度確認することで、投入側との行き違いを防ぐ
+   */
+  void sleep() {
+    const uint32_t seq = m_wake_seq.load(std::memory_order_seq_cst);
+    m_sleepers.fetch_add(1, std::memory_order_seq_cst);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (!has_work() && !m_stop.load(std::memory_order_acquire)) {
+      s6i_sync::futex_wait(m_wake_seq, seq);
+    }
+    m_sleepers.fetch_sub(1, std::memory_order_relaxed);
+  }
+
+  void notify(size_t count) {
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (m_sleepers.load(std::memory_order_seq_cst) == 0) {
+      return;
+    }
+    m_wake_seq.fetch_add(1, std::memory_order_seq_cst);
+    if (count == 1) {
+      s6i_sync::futex_wake_one(m_wake_seq);
+    } else {
+      s6i_sync::futex_wake_all(m_wake_seq);
+    }
+  }
+
+  size_t m_fiber_stack_size;
+  std::vector<std::unique_ptr<Worker>> m_workers;
+  FiberQueue m_ready;
+  FiberQueue m_yielded;
+  s6i_sync::Mutex<std::deque<Task*>, s6i_sync::SpinMutexPolicy> m_tasks;
+  std::atomic<size_t> m_task_size{0};
+  /** @brief 空いているファイバーと、ファイバーを待っているジョブ */
+  struct FreeFibers {
+    std::vector<Fiber*> m_fibers;
+    std::deque<Task*> m_starved;
+  };
+  s6i_sync::Mutex<FreeFibers, s6i_sync::SpinMutexPolicy> m_free_fibers;
+  s6i_sync::Mutex<std::vector<std::unique_ptr<Fiber>>,
+                  s6i_sync::SpinMutexPolicy>
+      m_fibers;
+  std::atomic<size_t> m_fiber_count{0};
+  std::atomic<bool> m_stack_failed{false};  ///< スタックの確保に失敗し続けている
+  std::atomic<bool> m_stop{false};
+  std::atomic<uint32_t> m_wake_seq{0};
+  std::atomic<uint32_t> m_sleepers{0};
+};
+
+}  // namespace detail
+
+inline void FiberCounter::done() {
+  m_busy.fetch_add(1, std::memory_order_seq_cst);
+  const uint32_t prev = m_value.fetch_sub(1, std::memory_order_seq_cst);
+  assert(prev > 0 && "FiberCounter underflow");
+
+  std::vector<detail::Fiber*> waiters;
+  if (prev == 1) {
+    m_waiters.lock().unwrap()->swap(waiters);
+    if (m_thread_waiters.load(std::memory_order_seq_cst) > 0) {
+      s6i_sync::futex_wake_all(m_value);
+    }
+  }
+  // ここから先はカウンターに触れない（待機側が破棄できるようになる）
+  m_busy.fetch_sub(1, std::memory_order_release);
+
+  for (detail::Fiber* fiber : waiters) {
+    fiber->m_scheduler->push_ready(fiber);
+  }
+}
+
+inline void FiberCounter::wait() {
+  if (m_value.load(std::memory_order_acquire) != 0) {
+    if (detail::Fiber* fiber = detail::current_fiber()) {
+      // 登録はワーカーがファイバーのスタックから離れた後に行う
+      fiber->m_wait_counter = this;
+      fiber->suspend(detail::FiberState::Waiting);
+    } else {
+      wait_thread();
+    }
+  }
+  // 0にしたdone()が終わるまで戻らない
+  s6i_sync::Backoff backoff;
+  while (m_busy.load(std::memory_order_acquire) != 0) {
+    backoff.snooze();
+  }
+}
+
+inline void FiberCounter::wait_thread() {
+  s6i_sync::Backoff backoff;
+  for (;;) {
+    const uint32_t value = m_value.load(std::memory_order_acquire);
+    if (value == 0) {
+      return;
+    }
+    if (!backoff.is_completed()) {
+      backoff.snooze();
+      continue;
+    }
+    m_thread_waiters.fetch_add(1, std::memory_order_seq_cst);
+    const uint32_t current = m_value.load(std::memory_order_seq_cst);
+    if (current != 0) {
+      s6i_sync::futex_wait(m_value, current);
+    }
+    m_thread_waiters.fetch_sub(1, std::memory_order_relaxed);
+  }
+}
+
+namespace this_fiber {
+
+/** @brief 現在のスレッドがファイバーを実行中かどうか */
+inline bool is_fiber() {
+  return detail::current_fiber() != nullptr;
+}
+
+/**
+ * @brief 実行を譲る
+ * ファイバー上では待機が解けたファイバーと新しいジョブの後に回り、
+ * ワーカーはそれらを先に実行します。
+ * ファイバー外ではスレッドのタイムスライスを譲ります。
+ */
+inline void yield() {
+  if (detail::Fiber* fiber = detail::current_fiber()) {
+    fiber->suspend(detail::FiberState::Yielded);
+  } else {
+    std::this_thread::yield();
+  }
+}
+
+}  // namespace this_fiber
+
+/**
+ * @brief ファイバーによるジョブスケジューラー
+ *
+ * ジョブはそれぞれファイバー（自前のスタックを持つ実行コンテキスト）で
+ * 実行され、FiberCounter::wait()で依存を待つ間はファイバーだけが
+ * 中断されます。固定数のワーカースレッドはその間に他のジョブや
+ * 再開できるファイバーを実行するため、待機中のジョブが何千あっても
+ * スレッドは増えず、費用はファイバーのスタックだけです。
+ *
+ * スタックはガードページ付きで確保し、ジョブが終わってもプールに戻して
+ * 再利用します。スタックが溢れるとガードページで即座に落ちるため、
+ * 深い再帰や大きな配列を置くジョブにはm_fiber_stack_sizeを大きくすること。
+ *
+ * 破棄する前に、投入したジョブの完了を待つこと
+ * （実行されていないジョブは捨てられ、待機中のファイバーは再開されません）。
+ */
+class FiberScheduler {
+ public:
+  /**
+   * @brief 新しいFiberSchedulerを作成し、ワーカーを起動する
+   * @param desc 作成設定
+   * @return 成功時: 作成されたFiberScheduler、失敗時: エラー
+   */
+  static s6i_result::Result<FiberScheduler, FiberError> make(
+      const FiberSchedulerDesc& desc = {}) {
+    uint32_t worker_count = desc.m_worker_count;
+    if (worker_count == 0) {
+      worker_count = static_cast<uint32_t>(std::max(1, SDL_GetCPUCount() - 1));
+    }
+    const auto cpu_count = static_cast<uint32_t>(SDL_GetCPUCount());
+    const bool pin_workers = desc.m_pin_workers && cpu_count > 1 &&
+                             cpu_count <= s6i_sync::MAX_AFFINITY_CPU_COUNT;
+    if (desc.m_pin_workers && cpu_count > s6i_sync::MAX_AFFINITY_CPU_COUNT) {
+      S6I_LOG_WARN(SDL_LOG_CATEGORY_SYSTEM,
+                   "Not pinning workers: %u CPUs exceed the mask limit (%u).",
+                   cpu_count, s6i_sync::MAX_AFFINITY_CPU_COUNT);
+    }
+
+    FiberScheduler scheduler(std::make_unique<detail::Scheduler>(
+        worker_count, desc.m_fiber_stack_size));
+    if (!scheduler.m_scheduler->prepare_fibers(desc.m_initial_fiber_count)) {
+      return s6i_result::make_err(FiberError::StackAllocationError);
+    }
+
+    scheduler.m_threads.reserve(worker_count);
+    for (uint32_t i = 0; i < worker_count; ++i) {
+      s6i_sync::ThreadDesc thread_desc;
+      thread_desc.m_name = "s6i_fiber_worker";
+      if (pin_workers) {
+        thread_desc.m_affinity_mask = uint64_t{1} << ((i + 1) % cpu_count);
+      }
+      detail::Scheduler* state = scheduler.m_scheduler.get();
+      auto thread = s6i_sync::Thread<>::make(
+          thread_desc, [state, i]() { state->worker_loop(i); });
+      if (thread.is_err()) {
+        return s6i_result::make_err(FiberError::WorkerCreationError);
+      }
+      scheduler.m_threads.push_back(thread.unwrap());
+    }
+    return s6i_result::make_ok(std::move(scheduler));
+  }
+
+  // コピー禁止
+  FiberScheduler(const FiberScheduler&) = delete;
+  FiberScheduler& operator=(const FiberScheduler&) = delete;
+
+  // ムーブ可能
+  FiberScheduler(FiberScheduler&& other)
+      : m_scheduler(std::move(other.m_scheduler)),
+        m_threads(std::move(other.m_threads)) {}
+
+  FiberScheduler& operator=(FiberScheduler&& other) {
+    FiberScheduler(std::move(other)).swap(*this);
+    return *this;
+  }
+
+  ~FiberScheduler() {
+    if (m_scheduler) {
+      m_scheduler->stop();
+    }
+    m_threads.clear();  // ワーカーの終了を待つ
+  }
+
+  /** @brief 有効なスケジューラーかどうか（ムーブ元は無効） */
+  bool is_valid() const { return m_scheduler != nullptr; }
+
+  /** @brief ワーカースレッド数 */
+  size_t worker_count() const {
+    return m_scheduler ? m_scheduler->worker_count() : 0;
+  }
+
+  /** @brief 作成済みのファイバー数（確保したスタックの数） */
+  size_t fiber_count() const {
+    return m_scheduler ? m_scheduler->fiber_count() : 0;
+  }
+
+  /**
+   * @brief ジョブを投入する
+   * @param f ファイバーで実行する関数（引数なし）
+   * @param counter 完了を数えるカウンター（投入時に1増え、完了時に1減る）
+   * @return 成功時: void、失敗時: エラー
+   */
+  template <typename F>
+  s6i_result::Result<void, FiberError> spawn(F&& f,
+                                             FiberCounter* counter = nullptr) {
+    if (!m_scheduler) {
+      return s6i_result::make_err(FiberError::InvalidSchedulerError);
+    }
+    if (counter) {
+      counter->add(1);
+    }
+    detail::Task* task = detail::make_task(std::forward<F>(f), counter);
+    m_scheduler->submit(&task, 1);
+    return s6i_result::make_ok();
+  }
+
+  /**
+   * @brief [0, count)の各インデックスについてfを呼ぶジョブをまとめて投入する
+   * @param count ジョブ数
+   * @param f void(size_t index) ジョブごとにコピーされる
+   * @param counter 完了を数えるカウンター（投入時にcount増える）
+   * @return 成功時: void、失敗時: エラー
+   */
+  template <typename F>
+  s6i_result::Result<void, FiberError> spawn_n(
+      size_t count,
+      const F& f,
+      FiberCounter* counter = nullptr) {
+    if (!m_scheduler) {
+      return s6i_result::make_err(FiberError::InvalidSchedulerError);
+    }
+    if (counter) {
+      counter->add(static_cast<uint32_t>(count));
+    }
+    std::vector<detail::Task*> tasks;
+    tasks.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+      tasks.push_back(detail::make_task([f, i]() mutable { f(i); }, counter));
+    }
+    m_scheduler->submit(tasks.data(), tasks.size());
+    return s6i_result::make_ok();
+  }
+
+  void swap(FiberScheduler& other) {
+    using std::swap;
+    swap(m_scheduler, other.m_scheduler);
+    swap(m_threads, other.m_threads);
+  }
+
+ private:
+  explicit FiberScheduler(std::unique_ptr<detail::Scheduler>&& scheduler)
+      : m_scheduler(std::move(scheduler)) {}
+
+  std::unique_ptr<detail::Scheduler> m_scheduler;
+  std::vector<s6i_sync::Thread<>> m_threads;
+};
+
+inline void swap(FiberScheduler& lhs, FiberScheduler& rhs) {
+  lhs.swap(rhs);
+}
+
+}  // namespace s6i_fiber
@@ -0,0 +1,99 @@
+#include <thread>
+#include <vector>
+
+#include "pch.h"
+
+namespace {
+
+using namespace s6i_fiber::detail;
+
+// 入口関数は戻れないため、値を記録してはメインへ切り替え直す
+struct PingPong {
+  ExecutionContext m_main;
+  ExecutionContext m_fiber;
+  std::vector<int> m_log;
+  int m_next = 0;
+};
+
+void ping_pong_entry(void* arg) {
+  auto* state = static_cast<PingPong*>(arg);
+  for (;;) {
+    state->m_log.push_back(state->m_next * 10);
+    ExecutionContext::switch_to(state->m_fiber, state->m_main);
+  }
+}
+
+TEST(ExecutionContextTest, SwitchBackAndForth) {
+  PingPong state;
+  ASSERT_TRUE(state.m_main.attach_thread());
+  ASSERT_TRUE(state.m_fiber.create(16 * 1024, &ping_pong_entry, &state));
+  EXPECT_TRUE(state.m_fiber.has_stack());
+  EXPECT_FALSE(state.m_main.has_stack());
+
+  for (int i = 1; i <= 3; ++i) {
+    state.m_next = i;
+    ExecutionContext::switch_to(state.m_main, state.m_fiber);
+  }
+  state.m_main.detach_thread();
+  EXPECT_EQ(state.m_log, (std::vector<int>{10, 20, 30}));
+}
+
+// ファイバーのスタック上の値は、別のスレッドから再開しても保たれる
+struct Migration {
+  ExecutionContext m_threads[2];
+  ExecutionContext m_fiber;
+  int m_resumer = 0;
+  double m_result = 0.0;
+};
+
+void migration_entry(void* arg) {
+  auto* state = static_cast<Migration*>(arg);
+  double local = 1.5;
+  ExecutionContext::switch_to(state->m_fiber,
+                              state->m_threads[state->m_resumer]);
+  local *= 2.0;
+  state->m_result = local;
+  ExecutionContext::switch_to(state->m_fiber,
+                              state->m_threads[state->m_resumer]);
+  std::abort();
+}
+
+TEST(ExecutionContextTest, ResumeOnAnotherThread) {
+  Migration state;
+  ASSERT_TRUE(state.m_fiber.create(16 * 1024, &migration_entry, &state));
+
+  auto run_on = [&state](int index) {
+    std::thread thread([&state, index]() {
+      state.m_resumer = index;
+      ASSERT_TRUE(state.m_threads[index].attach_thread());
+      ExecutionContext::switch_to(state.m_threads[index], state.m_fiber);
+      state.m_threads[index].detach_thread();
+    });
+    thread.join();
+  };
+  run_on(0);
+  EXPECT_EQ(state.m_result, 0.0);
+  run_on(1);
+  EXPECT_EQ(state.m_result, 3.0);
+}
+
+#if !defined(_WIN32)
+// スタックの下端はガードページなので、触れると即座に落ちる
+TEST(StackMemoryTest, GuardPageTraps) {
+  StackMemory stack = StackMemory::allocate(16 * 1024);
+  ASSERT_NE(stack.m_base, nullptr);
+  EXPECT_EQ(stack.m_size, 16 * 1024 + page_size());
+
+  // ガードページの上は読み書きできる
+  auto* usable = static_cast<volatile char*>(stack.m_base) + page_size();
+  usable[0] = 1;
+  static_cast<volatile char*>(stack.top())[-1] = 1;
+
+  auto* guard = static_cast<volatile char*>(stack.m_base);
+  EXPECT_DEATH(guard[page_size() - 1] = 1, "");
+  stack.release();
+  EXPECT_EQ(stack.m_base, nullptr);
+}
+#endif
+
+}  // namespace
@@ -0,0 +1,201 @@
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <thread>
+#include <vector>
+
+#include "pch.h"
+
+namespace {
+
+using namespace s6i_fiber;
+
+FiberScheduler make_scheduler(uint32_t worker_count = 4,
+                              uint32_t initial_fiber_count = 0) {
+  FiberSchedulerDesc desc;
+  desc.m_worker_count = worker_count;
+  desc.m_fiber_stack_size = 32 * 1024;
+  desc.m_initial_fiber_count = initial_fiber_count;
+  auto scheduler_result = FiberScheduler::make(desc);
+  EXPECT_TRUE(scheduler_result.is_ok());
+  return scheduler_result.unwrap();
+}
+
+TEST(FiberSchedulerTest, SpawnAndWait) {
+  auto scheduler = make_scheduler();
+  EXPECT_EQ(scheduler.worker_count(), 4u);
+
+  std::atomic<int> sum{0};
+  FiberCounter counter;
+  for (int i = 1; i <= 100; ++i) {
+    ASSERT_TRUE(scheduler.spawn([&sum, i]() { sum += i; }, &counter).is_ok());
+  }
+  counter.wait();
+  EXPECT_TRUE(counter.is_done());
+  EXPECT_EQ(sum.load(), 5050);
+
+  std::vector<int> values(64, 0);
+  FiberCounter batch;
+  ASSERT_TRUE(scheduler
+                  .spawn_n(values.size(),
+                           [&values](size_t i) {
+                             values[i] = static_cast<int>(i) * 2;
+                           },
+                           &batch)
+                  .is_ok());
+  batch.wait();
+  for (size_t i = 0; i < values.size(); ++i) {
+    EXPECT_EQ(values[i], static_cast<int>(i) * 2);
+  }
+}
+
+TEST(FiberSchedulerTest, MoveSemantics) {
+  auto scheduler1 = make_scheduler(1, 8);
+  EXPECT_EQ(scheduler1.fiber_count(), 8u);
+
+  FiberScheduler scheduler2 = std::move(scheduler1);
+  EXPECT_FALSE(scheduler1.is_valid());
+  EXPECT_EQ(scheduler1.worker_count(), 0u);
+  auto result = scheduler1.spawn([]() {});
+  ASSERT_TRUE(result.is_err());
+  EXPECT_EQ(result.unwrap_err(), FiberError::InvalidSchedulerError);
+
+  FiberCounter counter;
+  ASSERT_TRUE(scheduler2.spawn([]() {}, &counter).is_ok());
+  counter.wait();
+  EXPECT_EQ(scheduler2.fiber_count(), 8u);
+}
+
+// ファイバー内で子ジョブを待つ間も、ワーカー1本で子が実行される
+TEST(FiberSchedulerTest, FanOutFanInOnSingleWorker) {
+  auto scheduler = make_scheduler(1);
+  std::atomic<int> leaves{0};
+  std::atomic<bool> in_fiber{false};
+
+  FiberCounter root;
+  scheduler
+      .spawn(
+          [&]() {
+            in_fiber = this_fiber::is_fiber();
+            FiberCounter children;
+            for (int i = 0; i < 8; ++i) {
+              scheduler
+                  .spawn(
+                      [&]() {
+                        FiberCounter grandchildren;
+                        scheduler
+                            .spawn_n(8, [&](size_t) { ++leaves; },
+                                     &grandchildren)
+                            .unwrap();
+                        grandchildren.wait();
+                      },
+                      &children)
+                  .unwrap();
+            }
+            children.wait();
+          },
+          &root)
+      .unwrap();
+  root.wait();
+
+  EXPECT_TRUE(in_fiber.load());
+  EXPECT_FALSE(this_fiber::is_fiber());
+  EXPECT_EQ(leaves.load(), 64);
+}
+
+// 各ジョブが次のジョブを待つ深い鎖でも、スレッドは増えずファイバーが増える
+TEST(FiberSchedulerTest, DeepDependencyChain) {
+  auto scheduler = make_scheduler(2);
+  const int depth = 1000;
+  std::atomic<int> finished{0};
+
+  std::function<void(int)> link = [&](int level) {
+    if (level < depth) {
+      FiberCounter next;
+      scheduler.spawn([&link, level]() { link(level + 1); }, &next).unwrap();
+      next.wait();
+    }
+    ++finished;
+  };
+  FiberCounter root;
+  scheduler.spawn([&link]() { link(1); }, &root).unwrap();
+  root.wait();
+
+  EXPECT_EQ(finished.load(), depth);
+  EXPECT_GE(scheduler.fiber_count(), static_cast<size_t>(depth));
+
+  // 終わったファイバーはプールに戻り、再利用される
+  const size_t fibers = scheduler.fiber_count();
+  FiberCounter again;
+  scheduler.spawn_n(100, [](size_t) {}, &again).unwrap();
+  again.wait();
+  EXPECT_EQ(scheduler.fiber_count(), fibers);
+}
+
+// yieldは他のファイバーに実行を譲る（ワーカー1本でも待ち合わせられる）
+TEST(FiberSchedulerTest, YieldLetsOthersRun) {
+  auto scheduler = make_scheduler(1);
+  std::atomic<bool> flag{false};
+  std::atomic<int> spins{0};
+
+  FiberCounter counter;
+  scheduler
+      .spawn(
+          [&]() {
+            while (!flag.load()) {
+              ++spins;
+              this_fiber::yield();
+            }
+          },
+          &counter)
+      .unwrap();
+  scheduler.spawn([&]() { flag = true; }, &counter).unwrap();
+  counter.wait();
+
+  EXPECT_TRUE(flag.load());
+  EXPECT_GE(spins.load(), 1);
+}
+
+// スタックを確保できないジョブは預けられ、破棄するときにカウンターへ通知される
+TEST(FiberSchedulerTest, TaskWithoutStackIsParked) {
+  FiberSchedulerDesc desc;
+  desc.m_worker_count = 1;
+  desc.m_fiber_stack_size = SIZE_MAX / 2;
+  std::atomic<bool> ran{false};
+  FiberCounter counter;
+  {
+    auto scheduler = FiberScheduler::make(desc).unwrap();
+    scheduler.spawn([&]() { ran = true; }, &counter).unwrap();
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    EXPECT_EQ(scheduler.fiber_count(), 0u);
+    EXPECT_FALSE(counter.is_done());
+  }
+  EXPECT_TRUE(counter.is_done());
+  EXPECT_FALSE(ran.load());
+}
+
+// ジョブ以外の完了もカウンターで待てる
+TEST(FiberCounterTest, ManualSignal) {
+  auto scheduler = make_scheduler(2);
+  FiberCounter gate(1);
+  std::atomic<int> passed{0};
+
+  FiberCounter waiters;
+  scheduler
+      .spawn_n(16,
+               [&](size_t) {
+                 gate.wait();
+                 ++passed;
+               },
+               &waiters)
+      .unwrap();
+  EXPECT_EQ(gate.value(), 1u);
+  EXPECT_EQ(passed.load(), 0);
+
+  gate.done();
+  waiters.wait();
+  EXPECT_EQ(passed.load(), 16);
+}
+
+}  // namespace
@@ -0,0 +1,77 @@
+#include <benchmark/benchmark.h>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+#include "s6i_job/job_system.h"
+
+namespace {
+
+using namespace s6i_job;
+
+// 処理する要素数
+constexpr size_t ELEMENT_COUNT = 1 << 20;
+
+// 1要素あたりの計算（パーティクルの更新程度の重さ）
+inline float compute(float v) {
+  for (int i = 0; i < 16; ++i) {
+    v = std::sqrt(v * v + 1.0f) * 0.5f;
+  }
+  return v;
+}
+
+/** 比較用: 1スレッドでループする */
+void BM_SerialFor(benchmark::State& state) {
+  std::vector<float> values(ELEMENT_COUNT, 1.0f);
+  for (auto _ : state) {
+    for (size_t i = 0; i < values.size(); ++i) {
+      values[i] = compute(values[i]);
+    }
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.iterations() *
+                          static_cast<int64_t>(ELEMENT_COUNT));
+}
+BENCHMARK(BM_SerialFor)->UseRealTime();
+
+/** ワーカー数ごとのparallel_forのスケーリング */
+void BM_ParallelFor(benchmark::State& state) {
+  JobSystemDesc desc;
+  desc.m_worker_count = static_cast<uint32_t>(state.range(0));
+  auto system = JobSystem::make(desc).unwrap();
+
+  std::vector<float> values(ELEMENT_COUNT, 1.0f);
+  for (auto _ : state) {
+    system
+        .parallel_for(0, values.size(),
+                      [&values](size_t i) { values[i] = compute(values[i]); })
+        .unwrap();
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.iterations() *
+                          static_cast<int64_t>(ELEMENT_COUNT));
+}
+BENCHMARK(BM_ParallelFor)->RangeMultiplier(2)->Range(1, 64)->UseRealTime();
+
+/** 小さなジョブを大量に投入して待つ（投入と待機のオーバーヘッド） */
+void BM_SpawnWait(benchmark::State& state) {
+  JobSystemDesc desc;
+  desc.m_worker_count = static_cast<uint32_t>(state.range(0));
+  auto system = JobSystem::make(desc).unwrap();
+
+  constexpr int JOB_COUNT = 1024;
+  std::vector<JobHandle<int>> handles;
+  handles.reserve(JOB_COUNT);
+  for (auto _ : state) {
+    for (int i = 0; i < JOB_COUNT; ++i) {
+      handles.push_back(system.spawn([i]() { return i; }).unwrap());
+    }
+    for (auto& handle : handles) {
+      benchmark::DoNotOptimize(handle.wait().unwrap());
+    }
+    handles.clear();
+  }
+  state.SetItemsProcessed(state.iterations() * JOB_COUNT);
+}
+BENCHMARK(BM_SpawnWait)->RangeMultiplier(2)->Range(1, 64)->UseRealTime();
+
+}  // namespace
@@ -0,0 +1,125 @@
+#include <benchmark/benchmark.h>
+#include <cmath>
+#include <cstdint>
+#include <functional>
+#include <vector>
+#include "s6i_job/task_graph.h"
+
+namespace {
+
+using namespace s6i_job;
+
+// 並列に処理するチャンク数と、チャンクあたりの要素数
+constexpr int CHUNK_COUNT = 8;
+constexpr size_t CHUNK_SIZE = 1 << 14;
+
+inline float compute(float v) {
+  for (int i = 0; i < 16; ++i) {
+    v = std::sqrt(v * v + 1.0f) * 0.5f;
+  }
+  return v;
+}
+
+/**
+ * フレームを模した処理
+ * シミュレーション → チャンクごとのカリング → 描画リストの生成 → 提出
+ */
+struct Frame {
+  std::vector<float> m_state = std::vector<float>(CHUNK_COUNT * CHUNK_SIZE);
+  std::vector<float> m_visible = std::vector<float>(CHUNK_COUNT);
+  float m_draw_list = 0.0f;
+
+  void simulate() {
+    for (float& v : m_state) {
+      v += 1.0f;
+    }
+  }
+
+  void cull(int chunk) {
+    float sum = 0.0f;
+    for (size_t i = 0; i < CHUNK_SIZE; ++i) {
+      sum += compute(m_state[chunk * CHUNK_SIZE + i]);
+    }
+    m_visible[chunk] = sum;
+  }
+
+  void build_draw_list() {
+    m_draw_list = 0.0f;
+    for (float v : m_visible) {
+      m_draw_list += v;
+    }
+  }
+};
+
+/** 比較用: 各段を1スレッドで順に実行する */
+void BM_FrameSerial(benchmark::State& state) {
+  Frame frame;
+  for (auto _ : state) {
+    frame.simulate();
+    for (int i = 0; i < CHUNK_COUNT; ++i) {
+      frame.cull(i);
+    }
+    frame.build_draw_list();
+    benchmark::DoNotOptimize(frame.m_draw_list);
+  }
+}
+BENCHMARK(BM_FrameSerial)->UseRealTime();
+
+/** 各段をタスクグラフで実行する（カリングはチャンクごとに並列） */
+void BM_FrameTaskGraph(benchmark::State& state) {
+  JobSystemDesc desc;
+  desc.m_worker_count = static_cast<uint32_t>(state.range(0));
+  auto system = JobSystem::make(desc).unwrap();
+
+  Frame frame;
+  TaskGraphBuilder builder;
+  const ResourceId sim_state = builder.add_resource("state");
+  const ResourceId draw_list = builder.add_resource("draw_list");
+  std::vector<ResourceId> visible;
+  for (int i = 0; i < CHUNK_COUNT; ++i) {
+    visible.push_back(builder.add_resource("visible"));
+  }
+  builder.add_task({"simulate", {}, {sim_state}}, [&]() { frame.simulate(); });
+  for (int i = 0; i < CHUNK_COUNT; ++i) {
+    builder.add_task({"cull", {sim_state}, {visible[i]}},
+                     [&frame, i]() { frame.cull(i); });
+  }
+  builder.add_task({"build_draw_list", visible, {draw_list}},
+                   [&]() { frame.build_draw_list(); });
+  builder.add_task({"submit", {draw_list}, {}, true},
+                   [&]() { benchmark::DoNotOptimize(frame.m_draw_list); });
+  auto graph = builder.build().unwrap();
+
+  double critical_path_ms = 0.0;
+  for (auto _ : state) {
+    critical_path_ms += graph.run(system).unwrap().m_critical_path_ms;
+  }
+  state.counters["critical_path_ms"] =
+      critical_path_ms / static_cast<double>(state.iterations());
+}
+BENCHMARK(BM_FrameTaskGraph)->RangeMultiplier(2)->Range(1, 8)->UseRealTime();
+
+/** 何もしないタスクを並べたグラフ1回分の実行費用（依存の解決と投入） */
+void BM_EmptyTaskGraph(benchmark::State& state) {
+  JobSystemDesc desc;
+  desc.m_worker_count = 4;
+  auto system = JobSystem::make(desc).unwrap();
+
+  TaskGraphBuilder builder;
+  const ResourceId resource = builder.add_resource("resource");
+  const auto width = static_cast<int>(state.range(0));
+  builder.add_task({"root", {}, {resource}}, []() {});
+  for (int i = 0; i < width; ++i) {
+    builder.add_task({"leaf", {resource}, {}}, []() {});
+  }
+  builder.add_task({"join", {}, {resource}}, []() {});
+  auto graph = builder.build().unwrap();
+
+  for (auto _ : state) {
+    graph.run(system).unwrap();
+  }
+  state.SetItemsProcessed(state.iterations() * (width + 2));
+}
+BENCHMARK(BM_EmptyTaskGraph)->Arg(16)->Arg(256)->UseRealTime();
+
+}  // namespace
@@ -0,0 +1,159 @@
+#pragma once
+
+#include <atomic>
+#include <cassert>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace s6i_job {
+
+/**
+ * @brief Chase-Levの作業スティーリング両端キュー
+ *
+ * 所有スレッドだけがpush/popで底側を操作し、
+ * 他のスレッドはstealで頂上側から取り出します。
+ * 所有スレッドの操作は通常ロックなしのロード・ストアだけで済み、
+ * 最後の1要素を取り合うときだけCASを使います。
+ *
+ * 容量が足りなくなると倍に拡張します。
+ * 古い配列はstealが参照している可能性があるため、破棄時まで保持します。
+ *
+ * 参考: Lê, Pop, Cohen, Zappa Nardelli,
+ * "Correct and Efficient Work-Stealing for Weak Memory Models" (PPoPP 2013)
+ *
+ * @tparam T 要素の型（ポインタとして保持します）
+ */
+template <typename T>
+class ChaseLevDeque {
+ public:
+  /**
+   * @brief 空のキューを作成
+   * @param capacity 初期容量（2の累乗）
+   */
+  explicit ChaseLevDeque(int64_t capacity = 256) {
+    assert(capacity > 0 && (capacity & (capacity - 1)) == 0 &&
+           "Capacity must be a power of two");
+    m_arrays.push_back(std::make_unique<Array>(capacity));
+    m_array.store(m_arrays.back().get(), std::memory_order_relaxed);
+  }
+
+  // コピー・ムーブ禁止（他のスレッドから参照されるため）
+  ChaseLevDeque(const ChaseLevDeque&) = delete;
+  ChaseLevDeque& operator=(const ChaseLevDeque&) = delete;
+
+  /**
+   * @brief 底に要素を積む（所有スレッドのみ）
+   * @param item 積む要素（nullptr不可）
+   */
+  void push(T* item) {
+    assert(item);
+    const int64_t b = m_bottom.load(std::memory_order_relaxed);
+    const int64_t t = m_top.load(std::memory_order_acquire);
+    Array* array = m_array.load(std::memory_order_relaxed);
+    if (b - t > array->m_capacity - 1) {
+      array = grow(array, b, t);
+    }
+    array->put(b, item);
+    std::atomic_thread_fence(std::memory_order_release);
+    m_bottom.store(b + 1, std::memory_order_relaxed);
+  }
+
+  /**
+   * @brief 底から要素を取り出す（所有スレッドのみ）
+   * @return 取り出した要素、空ならnullptr
+   */
+  T* pop() {
+    const int64_t b = m_bottom.load(std::memory_order_relaxed) - 1;
+    Array* array = m_array.load(std::memory_order_relaxed);
+    m_bottom.store(b, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    int64_t t = m_top.load(std::memory_order_relaxed);
+
+    if (t > b) {
+      // 空だった
+      m_bottom.store(b + 1, std::memory_order_relaxed);
+      return nullptr;
+    }
+    T* item = array->get(b);
+    if (t == b) {
+      // 最後の1要素はstealと取り合う
+      if (!m_top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst,
+                                         std::memory_order_relaxed)) {
+        item = nullptr;
+      }
+      m_bottom.store(b + 1, std::memory_order_relaxed);
+    }
+    return item;
+  }
+
+  /**
+   * @brief 頂上から要素を盗む（任意のスレッド）
+   * @return 盗んだ要素、空か取り合いに負けた場合はnullptr
+   */
+  T* steal() {
+    int64_t t = m_top.load(std::memory_order_acquire);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    const int64_t b = m_bottom.load(std::memory_order_acquire);
+    if (t >= b) {
+      return nullptr;
+    }
+    Array* array = m_array.load(std::memory_order_acquire);
+    T* item = array->get(t);
+    if (!m_top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst,
+                                       std::memory_order_relaxed)) {
+      return nullptr;
+    }
+    return item;
+  }
+
+  /** @brief おおよその要素数 */
+  int64_t size() const {
+    const int64_t b = m_bottom.load(std::memory_order_relaxed);
+    const int64_t t = m_top.load(std::memory_order_relaxed);
+    return b > t ? b - t : 0;
+  }
+
+  bool empty() const { return size() == 0; }
+
+ private:
+  /** @brief 循環配列 */
+  struct Array {
+    explicit Array(int64_t capacity)
+        : m_capacity(capacity),
+          m_buffer(std::make_unique<std::atomic<T*>[]>(
+              static_cast<size_t>(capacity))) {}
+
+    T* get(int64_t i) const {
+      return m_buffer[static_cast<size_t>(i & (m_capacity - 1))].load(
+          std::memory_order_relaxed);
+    }
+
+    void put(int64_t i, T* item) {
+      m_buffer[static_cast<size_t>(i & (m_capacity - 1))].store(
+          item, std::memory_order_relaxed);
+    }
+
+    int64_t m_capacity;
+    std::unique_ptr<std::atomic<T*>[]> m_buffer;
+  };
+
+  /** @brief 容量を倍にした配列へ移す（所有スレッドのみ） */
+  Array* grow(Array* array, int64_t bottom, int64_t top) {
+    m_arrays.push_back(std::make_unique<Array>(array->m_capacity * 2));
+    Array* next = m_arrays.back().get();
+    for (int64_t i = top; i < bottom; ++i) {
+      next->put(i, array->get(i));
+    }
+    m_array.store(next, std::memory_order_release);
+    return next;
+  }
+
+  // 盗む側が書き換えるtopと所有スレッドが書き換えるbottomは別のキャッシュラインに置く
+  alignas(64) std::atomic<int64_t> m_top{0};
+  alignas(64) std::atomic<int64_t> m_bottom{0};
+  std::atomic<Array*> m_array{nullptr};
+  std::vector<std::unique_ptr<Array>> m_arrays;  ///< 所有スレッドのみが触る
+};
+
+}  // namespace s6i_job
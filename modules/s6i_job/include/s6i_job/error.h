@@ -0,0 +1,33 @@
+#pragma once
+
+#include <s6i_result/niche.h>
+
+namespace s6i_job {
+
+/**
+ * @brief ジョブシステムに関するエラー型
+ */
+enum class JobError {
+  // JobSystem関連エラー
+  WorkerCreationError,    ///< ワーカースレッドの作成に失敗
+  InvalidJobSystemError,  ///< 無効なJobSystemへの操作
+
+  // JobHandle関連エラー
+  InvalidJobHandleError,  ///< 無効な（取得済みの）ハンドルへの操作
+
+  // TaskGraph関連エラー
+  InvalidResourceError,   ///< 登録されていないリソースを参照した
+  InvalidTaskGraphError,  ///< 無効なTaskGraphへの操作
+};
+
+}  // namespace s6i_job
+
+/**
+ * @brief JobErrorの範囲外の値をResultのタグとして使う
+ */
+template <>
+struct s6i_result::NicheTraits<s6i_job::JobError> {
+  static constexpr bool enabled = true;
+  static constexpr s6i_job::JobError value =
+      static_cast<s6i_job::JobError>(-1);
+};
@@ -0,0 +1,517 @@
+#pragma once
+
+#include <SDL.h>
+#include <s6i_log/log.h>
+#include <s6i_result/result.h>
+#include <s6i_sync/backoff.h>
+#include <s6i_sync/futex.h>
+#include <s6i_sync/mutex.h>
+#include <s6i_sync/thread.h>
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <optional>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "chase_lev_deque.h"
+#include "error.h"
+
+namespace s6i_job {
+
+/**
+ * @brief JobSystemの作成設定
+ */
+struct JobSystemDesc {
+  /** @brief ワーカースレッド数（0はCPU数 - 1、最低1） */
+  uint32_t m_worker_count = 0;
+  /**
+   * @brief ワーカーをCPUに固定するかどうか（ワーカーiをCPU i + 1に固定）
+   * CPUがs6i_sync::MAX_AFFINITY_CPU_COUNTより多い環境では固定しません。
+   */
+  bool m_pin_workers = false;
+  /** @brief ワーカーのスタックサイズ（0はSDLの既定値） */
+  size_t m_stack_size = 0;
+};
+
+namespace detail {
+
+/** @brief 型を消したジョブ */
+class Job {
+ public:
+  virtual ~Job() = default;
+  virtual void execute() = 0;
+};
+
+template <typename F>
+class FunctionJob final : public Job {
+ public:
+  explicit FunctionJob(F&& f) : m_func(std::move(f)) {}
+  void execute() override { m_func(); }
+
+ private:
+  F m_func;
+};
+
+template <typename F>
+Job* make_job(F&& f) {
+  return new FunctionJob<std::decay_t<F>>(std::forward<F>(f));
+}
+
+/** @brief ワーカーごとの状態 */
+struct Worker {
+  ChaseLevDeque<Job> m_deque;
+  uint32_t m_index = 0;
+  uint32_t m_rng = 0;
+};
+
+class Context;
+
+/** @brief 現在のスレッドが属するContextとWorker（ワーカー以外はnullptr） */
+struct CurrentWorker {
+  const Context* m_context = nullptr;
+  Worker* m_worker = nullptr;
+};
+inline thread_local CurrentWorker t_current;
+
+/**
+ * @brief ワーカーとキューをまとめた共有状態
+ *
+ * ジョブの探索順は、自分のキュー（LIFO）→ 外部からの投入キュー →
+ * 他のワーカーからのスティール（FIFO）です。
+ * 仕事がなくなったワーカーはfutexで眠り、投入時に起こされます。
+ */
+class Context {
+ public:
+  explicit Context(uint32_t worker_count)
+      : m_injector(s6i_sync::Mutex<std::deque<Job*>,
+                                   s6i_sync::SpinMutexPolicy>::make()
+                       .unwrap()) {
+    m_workers.reserve(worker_count);
+    for (uint32_t i = 0; i < worker_count; ++i) {
+      auto worker = std::make_unique<Worker>();
+      worker->m_index = i;
+      worker->m_rng = i * 2654435761u + 1;
+      m_workers.push_back(std::move(worker));
+    }
+  }
+
+  ~Context() {
+    // 残っているジョブを実行してから破棄する（ハンドルの待機を解放するため）
+    while (Job* job = find_job(nullptr)) {
+      run(job);
+    }
+  }
+
+  /** @brief 現在のスレッドがこのContextのワーカーならそのWorker */
+  Worker* current_worker() const {
+    return t_current.m_context == this ? t_current.m_worker : nullptr;
+  }
+
+  /** @brief ジョブを投入する */
+  void submit(Job* const* jobs, size_t count) {
+    if (count == 0) {
+      return;
+    }
+    if (Worker* self = current_worker()) {
+      for (size_t i = 0; i < count; ++i) {
+        self->m_deque.push(jobs[i]);
+      }
+    } else {
+      auto guard = m_injector.lock().unwrap();
+      guard->insert(guard->end(), jobs, jobs + count);
+      m_injector_size.store(guard->size(), std::memory_order_relaxed);
+    }
+    notify(count);
+  }
+
+  /** @brief ジョブを1つ探して実行する（見つからなければfalse） */
+  bool run_one() {
+    if (Job* job = find_job(current_worker())) {
+      run(job);
+      return true;
+    }
+    return false;
+  }
+
+  /** @brief ワーカースレッドの本体 */
+  void worker_loop(uint32_t index) {
+    Worker* self = m_workers[index].get();
+    t_current = {this, self};
+
+    s6i_sync::Backoff backoff;
+    while (!m_stop.load(std::memory_order_acquire)) {
+      if (Job* job = find_job(self)) {
+        run(job);
+        backoff.reset();
+        continue;
+      }
+      if (!backoff.is_completed()) {
+        backoff.snooze();
+        continue;
+      }
+      sleep(self);
+      backoff.reset();
+    }
+    t_current = {};
+  }
+
+  /** @brief ワーカーを止める */
+  void stop() {
+    m_stop.store(true, std::memory_order_release);
+    m_wake_seq.fetch_add(1, std::memory_order_seq_cst);
+    s6i_sync::futex_wake_all(m_wake_seq);
+  }
+
+  size_t worker_count() const { return m_workers.size(); }
+
+ private:
+  static void run(Job* job) {
+    job->execute();
+    delete job;
+  }
+
+  Job* find_job(Worker* self) {
+    if (self) {
+      if (Job* job = self->m_deque.pop()) {
+        return job;
+      }
+    }
+    if (m_injector_size.load(std::memory_order_relaxed) > 0) {
+      auto guard = m_injector.lock().unwrap();
+      if (!guard->empty()) {
+        Job* job = guard->front();
+        guard->pop_front();
+        m_injector_size.store(guard->size(), std::memory_order_relaxed);
+        return job;
+      }
+    }
+    return steal(self);
+  }
+
+  /** @brief 他のワーカーから盗む（開始位置は乱数で散らす） */
+  Job* steal(Worker* self) {
+    const size_t count = m_workers.size();
+    size_t start = 0;
+    if (self) {
+      self->m_rng ^= self->m_rng << 13;
+      self->m_rng ^= self->m_rng >> 17;
+      self->m_rng ^= self->m_rng << 5;
+      start = self->m_rng % count;
+    }
+    for (size_t i = 0; i < count; ++i) {
+      Worker* victim = m_workers[(start + i) % count].get();
+      if (victim == self) {
+        continue;
+      }
+      if (Job* job = victim->m_deque.steal()) {
+        return job;
+      }
+    }
+    return nullptr;
+  }
+
+  /**
+   * @brief 仕事が投入されるまで眠る
+   * 眠る印を付けた後にもう一度探すことで、投入側との行き違いを防ぐ
+   */
+  void sleep(Worker* self) {
+    const uint32_t seq = m_wake_seq.load(std::memory_order_seq_cst);
+    m_sleepers.fetch_add(1, std::memory_order_seq_cst);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (Job* job = find_job(self)) {
+      m_sleepers.fetch_sub(1, std::memory_order_relaxed);
+      run(job);
+      return;
+    }
+    if (!m_stop.load(std::memory_order_acquire)) {
+      s6i_sync::futex_wait(m_wake_seq, seq);
+    }
+    m_sleepers.fetch_sub(1, std::memory_order_relaxed);
+  }
+
+  void notify(size_t count) {
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (m_sleepers.load(std::memory_order_seq_cst) == 0) {
+      return;
+    }
+    m_wake_seq.fetch_add(1, std::memory_order_seq_cst);
+    if (count == 1) {
+      s6i_sync::futex_wake_one(m_wake_seq);
+    } else {
+      s6i_sync::futex_wake_all(m_wake_seq);
+    }
+  }
+
+  std::vector<std::unique_ptr<Worker>> m_workers;
+  s6i_sync::Mutex<std::deque<Job*>, s6i_sync::SpinMutexPolicy> m_injector;
+  std::atomic<size_t> m_injector_size{0};
+  std::atomic<bool> m_stop{false};
+  std::atomic<uint32_t> m_wake_seq{0};
+  std::atomic<uint32_t> m_sleepers{0};
+};
+
+/** @brief ジョブの戻り値の格納先 */
+template <typename R>
+struct JobState {
+  std::atomic<bool> m_done{false};
+  std::optional<std::conditional_t<std::is_void_v<R>, char, R>> m_value;
+};
+
+/**
+ * @brief 条件を満たすまで、他のジョブを手伝いながら待つ
+ */
+template <typename Done>
+void help_until(Context& context, Done&& done) {
+  s6i_sync::Backoff backoff;
+  while (!done()) {
+    if (context.run_one()) {
+      backoff.reset();
+    } else {
+      backoff.snooze();
+    }
+  }
+}
+
+}  // namespace detail
+
+class JobSystem;
+
+/**
+ * @brief 投入したジョブの完了を待ち、戻り値を受け取るハンドル
+ * @tparam R ジョブの戻り値の型
+ */
+template <typename R>
+class JobHandle {
+ public:
+  // コピー禁止
+  JobHandle(const JobHandle&) = delete;
+  JobHandle& operator=(const JobHandle&) = delete;
+
+  // ムーブ可能
+  JobHandle(JobHandle&&) = default;
+  JobHandle& operator=(JobHandle&&) = default;
+
+  /** @brief ジョブが完了したかどうか */
+  bool is_done() const {
+    return m_state && m_state->m_done.load(std::memory_order_acquire);
+  }
+
+  /**
+   * @brief ジョブの完了を待ち、戻り値を受け取る
+   * 待っている間は他のジョブを実行します
+   * @return 成功時: ジョブの戻り値、失敗時: エラー
+   */
+  s6i_result::Result<R, JobError> wait() {
+    if (!m_state) {
+      return s6i_result::make_err(JobError::InvalidJobHandleError);
+    }
+    detail::help_until(*m_context, [this]() { return is_done(); });
+    auto state = std::move(m_state);
+    if constexpr (std::is_void_v<R>) {
+      return s6i_result::make_ok();
+    } else {
+      return s6i_result::make_ok(std::move(*state->m_value));
+    }
+  }
+
+ private:
+  JobHandle(detail::Context* context,
+            std::shared_ptr<detail::JobState<R>> state)
+      : m_context(context), m_state(std::move(state)) {}
+
+  detail::Context* m_context = nullptr;
+  std::shared_ptr<detail::JobState<R>> m_state;
+
+  friend class JobSystem;
+};
+
+/**
+ * @brief 作業スティーリングによるジョブシステム
+ *
+ * 固定数のワーカースレッドがそれぞれChase-Levキューを持ち、
+ * 自分のキューが空になると他のワーカーから仕事を盗みます。
+ * ワーカー上で投入したジョブはそのワーカーのキューに積まれるため、
+ * 入れ子の並列処理でもキャッシュの局所性が保たれます。
+ */
+class JobSystem {
+ public:
+  /**
+   * @brief 新しいJobSystemを作成し、ワーカーを起動する
+   * @param desc 作成設定
+   * @return 成功時: 作成されたJobSystem、失敗時: エラー
+   */
+  static s6i_result::Result<JobSystem, JobError> make(
+      const JobSystemDesc& desc = {}) {
+    uint32_t worker_count = desc.m_worker_count;
+    if (worker_count == 0) {
+      worker_count = static_cast<uint32_t>(std::max(1, SDL_GetCPUCount() - 1));
+    }
+    const auto cpu_count = static_cast<uint32_t>(SDL_GetCPUCount());
+    const bool pin_workers = desc.m_pin_workers && cpu_count > 1 &&
+                             cpu_count <= s6i_sync::MAX_AFFINITY_CPU_COUNT;
+    if (desc.m_pin_workers && cpu_count > s6i_sync::MAX_AFFINITY_CPU_COUNT) {
+      S6I_LOG_WARN(SDL_LOG_CATEGORY_SYSTEM,
+                   "Not pinning workers: %u CPUs exceed the mask limit (%u).",
+                   cpu_count, s6i_sync::MAX_AFFINITY_CPU_COUNT);
+    }
+
+    JobSystem system(std::make_unique<detail::Context>(worker_count));
+    system.m_threads.reserve(worker_count);
+    for (uint32_t i = 0; i < worker_count; ++i) {
+      s6i_sync::ThreadDesc thread_desc;
+      thread_desc.m_name = "s6i_job_worker";
+      thread_desc.m_stack_size = desc.m_stack_size;
+      if (pin_workers) {
+        thread_desc.m_affinity_mask = uint64_t{1} << ((i + 1) % cpu_count);
+      }
+      detail::Context* context = system.m_context.get();
+      auto thread = s6i_sync::Thread<>::make(
+          thread_desc, [context, i]() { context->worker_loop(i); });
+      if (thread.is_err()) {
+        return s6i_result::make_err(JobError::WorkerCreationError);
+      }
+      system.m_threads.push_back(thread.unwrap());
+    }
+    return s6i_result::make_ok(std::move(system));
+  }
+
+  // コピー禁止
+  JobSystem(const JobSystem&) = delete;
+  JobSystem& operator=(const JobSystem&) = delete;
+
+  // ムーブ可能
+  JobSystem(JobSystem&& other)
+      : m_context(std::move(other.m_context)),
+        m_threads(std::move(other.m_threads)) {}
+
+  JobSystem& operator=(JobSystem&& other) {
+    JobSystem(std::move(other)).swap(*this);
+    return *this;
+  }
+
+  ~JobSystem() {
+    if (m_context) {
+      m_context->stop();
+    }
+    m_threads.clear();  // ワーカーの終了を待つ
+  }
+
+  /** @brief ワーカースレッド数 */
+  size_t worker_count() const {
+    return m_context ? m_context->worker_count() : 0;
+  }
+
+  /**
+   * @brief ジョブを投入する
+   * @param f スレッドで実行する関数（引数なし）
+   * @return 成功時: ジョブのハンドル、失敗時: エラー
+   */
+  template <typename F, typename R = std::invoke_result_t<std::decay_t<F>&>>
+  s6i_result::Result<JobHandle<R>, JobError> spawn(F&& f) {
+    if (!m_context) {
+      return s6i_result::make_err(JobError::InvalidJobSystemError);
+    }
+    auto state = std::make_shared<detail::JobState<R>>();
+    detail::Job* job = detail::make_job(
+        [state, f = std::forward<F>(f)]() mutable {
+          if constexpr (std::is_void_v<R>) {
+            f();
+          } else {
+            state->m_value.emplace(f());
+          }
+          state->m_done.store(true, std::memory_order_release);
+        });
+    m_context->submit(&job, 1);
+    return s6i_result::make_ok(JobHandle<R>(m_context.get(), std::move(state)));
+  }
+
+  /**
+   * @brief [begin, end)の各インデックスについてfを並列に呼び出す
+   *
+   * 範囲を粒度ごとのチャンクに分けてジョブとして投入し、
+   * 呼び出したスレッドもチャンクを処理しながら完了を待ちます。
+   *
+   * @param begin 範囲の先頭
+   * @param end 範囲の終端
+   * @param f void(size_t index)
+   * @param grain 1つのジョブが処理するインデックス数（0は自動）
+   * @return 成功時: void、失敗時: エラー
+   */
+  template <typename F>
+  s6i_result::Result<void, JobError> parallel_for(size_t begin,
+                                                  size_t end,
+                                                  F&& f,
+                                                  size_t grain = 0) {
+    if (!m_context) {
+      return s6i_result::make_err(JobError::InvalidJobSystemError);
+    }
+    if (begin >= end) {
+      return s6i_result::make_ok();
+    }
+    const size_t count = end - begin;
+    if (grain == 0) {
+      grain = auto_grain(count);
+    }
+    const size_t chunks = (count + grain - 1) / grain;
+
+    std::atomic<size_t> remaining{chunks};
+    auto run_chunk = [&f, &remaining, begin, end, grain](size_t chunk) {
+      const size_t first = begin + chunk * grain;
+      const size_t last = std::min(end, first + grain);
+      for (size_t i = first; i < last; ++i) {
+        f(i);
+      }
+      remaining.fetch_sub(1, std::memory_order_release);
+    };
+
+    // 先頭のチャンクは呼び出し側で処理する
+    std::vector<detail::Job*> jobs;
+    jobs.reserve(chunks - 1);
+    for (size_t chunk = chunks - 1; chunk > 0; --chunk) {
+      jobs.push_back(detail::make_job([&run_chunk, chunk]() {
+        run_chunk(chunk);
+      }));
+    }
+    m_context->submit(jobs.data(), jobs.size());
+    run_chunk(0);
+
+    detail::help_until(*m_context, [&remaining]() {
+      return remaining.load(std::memory_order_acquire) == 0;
+    });
+    return s6i_result::make_ok();
+  }
+
+  void swap(JobSystem& other) {
+    using std::swap;
+    swap(m_context, other.m_context);
+    swap(m_threads, other.m_threads);
+  }
+
+ private:
+  explicit JobSystem(std::unique_ptr<detail::Context>&& context)
+      : m_context(std::move(context)) {}
+
+  /**
+   * @brief 自動の粒度
+   * 各スレッドに8チャンク程度行き渡るように分け、偏りをスティールで均す
+   */
+  size_t auto_grain(size_t count) const {
+    const size_t threads = m_context->worker_count() + 1;
+    return std::max<size_t>(1, count / (threads * 8));
+  }
+
+  std::unique_ptr<detail::Context> m_context;
+  std::vector<s6i_sync::Thread<>> m_threads;
+
+  friend class TaskGraph;
+};
+
+inline void swap(JobSystem& lhs, JobSystem& rhs) {
+  lhs.swap(rhs);
+}
+
+}  // namespace s6i_job
@@ -0,0 +1,6 @@
+#pragma once
+
+#include "chase_lev_deque.h"
+#include "error.h"
+#include "job_system.h"
+#include "task_graph.h"
@@ -0,0 +1,395 @@
+#pragma once
+
+#include <SDL.h>
+#include <s6i_result/result.h>
+#include <s6i_sync/backoff.h>
+#include <s6i_sync/mutex.h>
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <utility>
+#include <vector>
+#include "error.h"
+#include "job_system.h"
+
+namespace s6i_job {
+
+/** @brief タスクグラフのリソース（タスクが読み書きするもの）のID */
+using ResourceId = uint32_t;
+
+/** @brief タスクグラフのタスクのID（追加した順の通し番号） */
+using TaskId = uint32_t;
+
+/**
+ * @brief タスクの宣言
+ * 読み書きするリソースから、タスク間の依存が決まります
+ */
+struct TaskDesc {
+  /** @brief タスク名（計測結果の表示用） */
+  const char* m_name = "";
+  /** @brief 読むリソース */
+  std::vector<ResourceId> m_reads;
+  /** @brief 書くリソース（読んでから書く場合もこちらだけでよい） */
+  std::vector<ResourceId> m_writes;
+  /**
+   * @brief run()を呼んだスレッドで実行するかどうか
+   * SDLのイベント処理や描画など、メインスレッドでしか呼べない処理に使います
+   */
+  bool m_main_thread = false;
+};
+
+/**
+ * @brief 1回のrun()の計測結果
+ */
+struct TaskGraphReport {
+  /** @brief run()の開始から全タスクの完了まで（ミリ秒） */
+  double m_wall_ms = 0.0;
+  /** @brief 全タスクの実行時間の合計（ミリ秒） */
+  double m_work_ms = 0.0;
+  /**
+   * @brief クリティカルパスの長さ（ミリ秒）
+   * 依存を辿った経路のうち、実行時間の合計が最長のもの。
+   * コアがいくらあっても、フレームはこれより短くなりません
+   */
+  double m_critical_path_ms = 0.0;
+  /** @brief クリティカルパス上のタスク（実行順） */
+  std::vector<TaskId> m_critical_path;
+};
+
+namespace detail {
+
+/** @brief グラフ内のタスク */
+struct TaskNode {
+  const char* m_name = "";
+  std::unique_ptr<Job> m_job;
+  std::vector<TaskId> m_successors;
+  uint32_t m_dependency_count = 0;
+  bool m_main_thread = false;
+  // 直近のrun()での実行区間（パフォーマンスカウンター）
+  Uint64 m_start = 0;
+  Uint64 m_end = 0;
+};
+
+/**
+ * @brief 構築済みのグラフと、実行中の状態
+ * ジョブから参照するため、TaskGraphをムーブしても動かないように分けて持つ
+ */
+class TaskGraphState {
+ public:
+  explicit TaskGraphState(std::vector<TaskNode>&& nodes)
+      : m_nodes(std::move(nodes)),
+        m_pending(std::make_unique<std::atomic<uint32_t>[]>(m_nodes.size())),
+        m_main_queue(s6i_sync::Mutex<std::vector<TaskId>,
+                                     s6i_sync::SpinMutexPolicy>::make()
+                         .unwrap()) {
+    m_main_queue.lock().unwrap()->reserve(m_nodes.size());
+  }
+
+  /**
+   * @brief 全タスクを1回実行する
+   * 依存のないタスクから投入し、完了したタスクが後続を投入します。
+   * 呼び出したスレッドは、メインスレッド指定のタスクと
+   * 他のジョブを実行しながら完了を待ちます。
+   */
+  TaskGraphReport run(Context& context) {
+    assert(!m_context && "TaskGraph::run() is not reentrant");
+    m_context = &context;
+    const Uint64 start = SDL_GetPerformanceCounter();
+    m_remaining.store(static_cast<uint32_t>(m_nodes.size()),
+                      std::memory_order_relaxed);
+    for (size_t i = 0; i < m_nodes.size(); ++i) {
+      m_pending[i].store(m_nodes[i].m_dependency_count,
+                         std::memory_order_relaxed);
+    }
+    for (size_t i = 0; i < m_nodes.size(); ++i) {
+      if (m_nodes[i].m_dependency_count == 0) {
+        dispatch(static_cast<TaskId>(i));
+      }
+    }
+
+    s6i_sync::Backoff backoff;
+    while (m_remaining.load(std::memory_order_acquire) != 0) {
+      if (auto id = pop_main()) {
+        execute(*id);
+        backoff.reset();
+      } else if (context.run_one()) {
+        backoff.reset();
+      } else {
+        backoff.snooze();
+      }
+    }
+    const Uint64 end = SDL_GetPerformanceCounter();
+    m_context = nullptr;
+    return make_report(start, end);
+  }
+
+  const std::vector<TaskNode>& nodes() const { return m_nodes; }
+
+ private:
+  void dispatch(TaskId id) {
+    if (m_nodes[id].m_main_thread) {
+      auto guard = m_main_queue.lock().unwrap();
+      guard->push_back(id);
+      m_main_size.store(guard->size(), std::memory_order_release);
+      return;
+    }
+    Job* job = make_job([this, id]() { execute(id); });
+    m_context->submit(&job, 1);
+  }
+
+  std::optional<TaskId> pop_main() {
+    if (m_main_size.load(std::memory_order_acquire) == 0) {
+      return std::nullopt;
+    }
+    auto guard = m_main_queue.lock().unwrap();
+    if (guard->empty()) {
+      return std::nullopt;
+    }
+    const TaskId id = guard->back();
+    guard->pop_back();
+    m_main_size.store(guard->size(), std::memory_order_relaxed);
+    return id;
+  }
+
+  void execute(TaskId id) {
+    TaskNode& node = m_nodes[id];
+    node.m_start = SDL_GetPerformanceCounter();
+    node.m_job->execute();
+    node.m_end = SDL_GetPerformanceCounter();
+    for (TaskId successor : node.m_successors) {
+      if (m_pending[successor].fetch_sub(1, std::memory_order_acq_rel) == 1) {
+        dispatch(successor);
+      }
+    }
+    m_remaining.fetch_sub(1, std::memory_order_release);
+  }
+
+  /**
+   * @brief 計測結果をまとめる
+   * 追加順は依存の順（トポロジカル順）なので、前から1回辿れば
+   * 各タスクで終わる最長の経路が求まる
+   */
+  TaskGraphReport make_report(Uint64 start, Uint64 end) const {
+    const double ms_per_tick =
+        1000.0 / static_cast<double>(SDL_GetPerformanceFrequency());
+    const size_t count = m_nodes.size();
+    std::vector<Uint64> longest(count);
+    std::vector<TaskId> previous(count, NO_TASK);
+
+    TaskGraphReport report;
+    report.m_wall_ms = static_cast<double>(end - start) * ms_per_tick;
+    Uint64 work = 0;
+    for (size_t i = 0; i < count; ++i) {
+      const Uint64 duration = m_nodes[i].m_end - m_nodes[i].m_start;
+      work += duration;
+      longest[i] += duration;
+      for (TaskId successor : m_nodes[i].m_successors) {
+        if (longest[i] > longest[successor]) {
+          longest[successor] = longest[i];
+          previous[successor] = static_cast<TaskId>(i);
+        }
+      }
+    }
+    report.m_work_ms = static_cast<double>(work) * ms_per_tick;
+    if (count == 0) {
+      return report;
+    }
+
+    auto last = static_cast<TaskId>(
+        std::max_element(longest.begin(), longest.end()) - longest.begin());
+    report.m_critical_path_ms =
+        static_cast<double>(longest[last]) * ms_per_tick;
+    for (TaskId id = last; id != NO_TASK; id = previous[id]) {
+      report.m_critical_path.push_back(id);
+    }
+    std::reverse(report.m_critical_path.begin(), report.m_critical_path.end());
+    return report;
+  }
+
+  static constexpr TaskId NO_TASK = ~TaskId{0};
+
+  std::vector<TaskNode> m_nodes;
+  std::unique_ptr<std::atomic<uint32_t>[]> m_pending;
+  std::atomic<uint32_t> m_remaining{0};
+  s6i_sync::Mutex<std::vector<TaskId>, s6i_sync::SpinMutexPolicy>
+      m_main_queue;
+  std::atomic<size_t> m_main_size{0};
+  Context* m_context = nullptr;
+};
+
+}  // namespace detail
+
+/**
+ * @brief 構築済みのタスクグラフ
+ *
+ * TaskGraphBuilderで一度だけ構築し、毎フレームrun()で実行します。
+ * 依存のないタスクはJobSystemのワーカーで並列に実行され、
+ * メインスレッド指定のタスクはrun()を呼んだスレッドで実行されます。
+ * 同じグラフのrun()を同時に呼ぶことはできません。
+ */
+class TaskGraph {
+ public:
+  // コピー禁止
+  TaskGraph(const TaskGraph&) = delete;
+  TaskGraph& operator=(const TaskGraph&) = delete;
+
+  // ムーブ可能
+  TaskGraph(TaskGraph&&) = default;
+  TaskGraph& operator=(TaskGraph&&) = default;
+
+  /** @brief 有効なグラフかどうか（ムーブ元は無効） */
+  bool is_valid() const { return m_state != nullptr; }
+
+  /** @brief タスク数 */
+  size_t task_count() const { return m_state ? m_state->nodes().size() : 0; }
+
+  /** @brief タスク名 */
+  const char* task_name(TaskId id) const {
+    assert(id < task_count() && "TaskId is out of range");
+    return m_state->nodes()[id].m_name;
+  }
+
+  /** @brief idの完了を待つタスク（重複なし、昇順） */
+  const std::vector<TaskId>& successors(TaskId id) const {
+    assert(id < task_count() && "TaskId is out of range");
+    return m_state->nodes()[id].m_successors;
+  }
+
+  /**
+   * @brief 全タスクを依存の順に1回実行し、完了まで待つ
+   * @param system タスクを実行するJobSystem
+   * @return 成功時: 計測結果、失敗時: エラー
+   */
+  s6i_result::Result<TaskGraphReport, JobError> run(JobSystem& system) {
+    if (!m_state) {
+      return s6i_result::make_err(JobError::InvalidTaskGraphError);
+    }
+    if (!system.m_context) {
+      return s6i_result::make_err(JobError::InvalidJobSystemError);
+    }
+    return s6i_result::make_ok(m_state->run(*system.m_context));
+  }
+
+ private:
+  explicit TaskGraph(std::unique_ptr<detail::TaskGraphState>&& state)
+      : m_state(std::move(state)) {}
+
+  std::unique_ptr<detail::TaskGraphState> m_state;
+
+  friend class TaskGraphBuilder;
+};
+
+/**
+ * @brief タスクとリソースを宣言してTaskGraphを構築する
+ *
+ * 依存は追加した順とリソースの読み書きから決まります。
+ * - 読むタスクは、それより前に同じリソースを最後に書いたタスクの後
+ * - 書くタスクは、それより前に同じリソースを最後に書いたタスクと、
+ *   その後に読んだすべてのタスクの後
+ * 依存は常に前に追加したタスクへ向くため、循環は起きません。
+ */
+class TaskGraphBuilder {
+ public:
+  /**
+   * @brief リソースを登録する
+   * @param name リソース名（表示用）
+   * @return リソースのID
+   */
+  ResourceId add_resource(const char* name) {
+    m_resource_names.push_back(name);
+    return static_cast<ResourceId>(m_resource_names.size() - 1);
+  }
+
+  /**
+   * @brief タスクを追加する
+   * @param desc タスクの宣言
+   * @param f 実行する関数（引数なし、毎回のrun()で呼ばれる）
+   * @return タスクのID
+   */
+  template <typename F>
+  TaskId add_task(TaskDesc desc, F&& f) {
+    detail::TaskNode node;
+    node.m_name = desc.m_name;
+    node.m_job.reset(detail::make_job(std::forward<F>(f)));
+    node.m_main_thread = desc.m_main_thread;
+    m_nodes.push_back(std::move(node));
+    m_descs.push_back(std::move(desc));
+    return static_cast<TaskId>(m_nodes.size() - 1);
+  }
+
+  /**
+   * @brief 宣言から依存を求めてグラフを構築する
+   * 構築後のビルダーは空になります
+   * @return 成功時: 構築されたTaskGraph、失敗時: エラー
+   */
+  s6i_result::Result<TaskGraph, JobError> build() {
+    const size_t resource_count = m_resource_names.size();
+    for (const TaskDesc& desc : m_descs) {
+      for (const auto* ids : {&desc.m_reads, &desc.m_writes}) {
+        for (ResourceId id : *ids) {
+          if (id >= resource_count) {
+            return s6i_result::make_err(JobError::InvalidResourceError);
+          }
+        }
+      }
+    }
+
+    std::vector<TaskId> last_writer(resource_count, NO_TASK);
+    std::vector<std::vector<TaskId>> readers(resource_count);
+    for (size_t i = 0; i < m_nodes.size(); ++i) {
+      const auto task = static_cast<TaskId>(i);
+      const TaskDesc& desc = m_descs[i];
+      for (ResourceId id : desc.m_reads) {
+        if (std::find(desc.m_writes.begin(), desc.m_writes.end(), id) !=
+            desc.m_writes.end()) {
+          continue;  // 書く側で扱う
+        }
+        add_edge(last_writer[id], task);
+        readers[id].push_back(task);
+      }
+      for (ResourceId id : desc.m_writes) {
+        add_edge(last_writer[id], task);
+        for (TaskId reader : readers[id]) {
+          add_edge(reader, task);
+        }
+        readers[id].clear();
+        last_writer[id] = task;
+      }
+    }
+
+    for (detail::TaskNode& node : m_nodes) {
+      auto& successors = node.m_successors;
+      std::sort(successors.begin(), successors.end());
+      successors.erase(std::unique(successors.begin(), successors.end()),
+                       successors.end());
+      for (TaskId successor : successors) {
+        ++m_nodes[successor].m_dependency_count;
+      }
+    }
+
+    auto state = std::make_unique<detail::TaskGraphState>(std::move(m_nodes));
+    m_nodes.clear();
+    m_descs.clear();
+    m_resource_names.clear();
+    return s6i_result::make_ok(TaskGraph(std::move(state)));
+  }
+
+ private:
+  static constexpr TaskId NO_TASK = ~TaskId{0};
+
+  void add_edge(TaskId from, TaskId to) {
+    if (from != NO_TASK && from != to) {
+      m_nodes[from].m_successors.push_back(to);
+    }
+  }
+
+  std::vector<detail::TaskNode> m_nodes;
+  std::vector<TaskDesc> m_descs;
+  std::vector<const char*> m_resource_names;
+};
+
+}  // namespace s6i_job
@@ -0,0 +1,98 @@
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include "pch.h"
+
+namespace {
+
+using namespace s6i_job;
+
+TEST(ChaseLevDequeTest, OwnerIsLifo) {
+  ChaseLevDeque<int> deque;
+  int values[3] = {1, 2, 3};
+  for (int& v : values) {
+    deque.push(&v);
+  }
+  EXPECT_EQ(deque.size(), 3);
+  EXPECT_EQ(deque.pop(), &values[2]);
+  EXPECT_EQ(deque.pop(), &values[1]);
+  EXPECT_EQ(deque.pop(), &values[0]);
+  EXPECT_EQ(deque.pop(), nullptr);
+  EXPECT_TRUE(deque.empty());
+}
+
+TEST(ChaseLevDequeTest, StealIsFifo) {
+  ChaseLevDeque<int> deque;
+  int values[3] = {1, 2, 3};
+  for (int& v : values) {
+    deque.push(&v);
+  }
+  EXPECT_EQ(deque.steal(), &values[0]);
+  EXPECT_EQ(deque.steal(), &values[1]);
+  EXPECT_EQ(deque.pop(), &values[2]);
+  EXPECT_EQ(deque.steal(), nullptr);
+}
+
+TEST(ChaseLevDequeTest, Grow) {
+  ChaseLevDeque<int> deque(4);
+  std::vector<int> values(100);
+  for (int& v : values) {
+    deque.push(&v);
+  }
+  EXPECT_EQ(deque.size(), 100);
+  for (size_t i = 0; i < 50; ++i) {
+    EXPECT_EQ(deque.steal(), &values[i]);
+  }
+  for (size_t i = 100; i > 50; --i) {
+    EXPECT_EQ(deque.pop(), &values[i - 1]);
+  }
+  EXPECT_TRUE(deque.empty());
+}
+
+// 所有スレッドのpush/popと複数のstealが競合しても、各要素はちょうど1回だけ取り出される
+TEST(ChaseLevDequeTest, ConcurrentSteal) {
+  const int num_items = 100000;
+  const int num_thieves = 3;
+  ChaseLevDeque<int> deque(16);
+  std::vector<int> items(num_items);
+  std::vector<std::atomic<int>> taken(num_items);
+  std::atomic<bool> done{false};
+
+  auto take = [&](int* item) {
+    ++taken[static_cast<size_t>(item - &items[0])];
+  };
+
+  std::vector<std::thread> thieves;
+  for (int i = 0; i < num_thieves; ++i) {
+    thieves.emplace_back([&]() {
+      while (!done.load()) {
+        if (int* item = deque.steal()) {
+          take(item);
+        }
+      }
+    });
+  }
+
+  for (int i = 0; i < num_items; ++i) {
+    deque.push(&items[static_cast<size_t>(i)]);
+    if (i % 3 == 0) {
+      if (int* item = deque.pop()) {
+        take(item);
+      }
+    }
+  }
+  while (int* item = deque.pop()) {
+    take(item);
+  }
+  done = true;
+  for (auto& thief : thieves) {
+    thief.join();
+  }
+
+  for (int i = 0; i < num_items; ++i) {
+    ASSERT_EQ(taken[static_cast<size_t>(i)].load(), 1) << "item " << i;
+  }
+}
+
+}  // namespace
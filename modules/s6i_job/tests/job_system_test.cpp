@@ -0,0 +1,174 @@
+#include <atomic>
+#include <memory>
+#include <numeric>
+#include <string>
+#include <vector>
+
+#include "pch.h"
+
+namespace {
+
+using namespace s6i_job;
+
+JobSystem make_system(uint32_t worker_count = 4) {
+  JobSystemDesc desc;
+  desc.m_worker_count = worker_count;
+  auto system_result = JobSystem::make(desc);
+  EXPECT_TRUE(system_result.is_ok());
+  return system_result.unwrap();
+}
+
+TEST(JobSystemTest, SpawnReturnsValue) {
+  auto system = make_system();
+  EXPECT_EQ(system.worker_count(), 4u);
+
+  auto handle_result = system.spawn([]() { return 42; });
+  ASSERT_TRUE(handle_result.is_ok());
+  auto handle = handle_result.unwrap();
+
+  auto wait_result = handle.wait();
+  ASSERT_TRUE(wait_result.is_ok());
+  EXPECT_EQ(wait_result.unwrap(), 42);
+
+  // 受け取り済みのハンドルはエラー
+  auto again_result = handle.wait();
+  ASSERT_TRUE(again_result.is_err());
+  EXPECT_EQ(again_result.unwrap_err(), JobError::InvalidJobHandleError);
+}
+
+TEST(JobSystemTest, SpawnVoidAndMoveOnly) {
+  auto system = make_system();
+
+  std::atomic<bool> ran{false};
+  auto void_handle = system.spawn([&]() { ran = true; }).unwrap();
+  ASSERT_TRUE(void_handle.wait().is_ok());
+  EXPECT_TRUE(ran.load());
+
+  auto ptr_handle =
+      system.spawn([]() { return std::make_unique<std::string>("job"); })
+          .unwrap();
+  auto wait_result = ptr_handle.wait();
+  ASSERT_TRUE(wait_result.is_ok());
+  EXPECT_EQ(*wait_result.unwrap(), "job");
+}
+
+TEST(JobSystemTest, ManyJobs) {
+  auto system = make_system();
+
+  const int num_jobs = 10000;
+  std::vector<JobHandle<int>> handles;
+  handles.reserve(num_jobs);
+  for (int i = 0; i < num_jobs; ++i) {
+    handles.push_back(system.spawn([i]() { return i * 2; }).unwrap());
+  }
+  for (int i = 0; i < num_jobs; ++i) {
+    auto wait_result = handles[static_cast<size_t>(i)].wait();
+    ASSERT_TRUE(wait_result.is_ok());
+    EXPECT_EQ(wait_result.unwrap(), i * 2);
+  }
+}
+
+// ジョブの中から投入したジョブを待てる（待つ間は他のジョブを手伝う）
+TEST(JobSystemTest, NestedSpawn) {
+  auto system = make_system(2);
+
+  auto handle = system
+                    .spawn([&system]() {
+                      std::vector<JobHandle<int>> children;
+                      for (int i = 1; i <= 100; ++i) {
+                        children.push_back(
+                            system.spawn([i]() { return i; }).unwrap());
+                      }
+                      int sum = 0;
+                      for (auto& child : children) {
+                        sum += child.wait().unwrap();
+                      }
+                      return sum;
+                    })
+                    .unwrap();
+  auto wait_result = handle.wait();
+  ASSERT_TRUE(wait_result.is_ok());
+  EXPECT_EQ(wait_result.unwrap(), 5050);
+}
+
+TEST(JobSystemTest, ParallelFor) {
+  auto system = make_system();
+
+  const size_t count = 100000;
+  std::vector<int> values(count, 0);
+  auto result =
+      system.parallel_for(0, count, [&](size_t i) { values[i] += 1; });
+  ASSERT_TRUE(result.is_ok());
+  for (size_t i = 0; i < count; ++i) {
+    ASSERT_EQ(values[i], 1) << "index " << i;
+  }
+}
+
+TEST(JobSystemTest, ParallelForGrainAndRange) {
+  auto system = make_system();
+
+  std::atomic<uint64_t> sum{0};
+  ASSERT_TRUE(system
+                  .parallel_for(10, 1010, [&](size_t i) { sum += i; }, 7)
+                  .is_ok());
+  EXPECT_EQ(sum.load(), (10u + 1009u) * 1000u / 2u);
+
+  // 空の範囲は何もしない
+  bool called = false;
+  ASSERT_TRUE(
+      system.parallel_for(5, 5, [&](size_t) { called = true; }).is_ok());
+  EXPECT_FALSE(called);
+}
+
+TEST(JobSystemTest, NestedParallelFor) {
+  auto system = make_system();
+
+  const size_t rows = 64;
+  const size_t cols = 256;
+  std::vector<int> grid(rows * cols, 0);
+  ASSERT_TRUE(system
+                  .parallel_for(0, rows,
+                                [&](size_t r) {
+                                  system
+                                      .parallel_for(0, cols,
+                                                    [&](size_t c) {
+                                                      grid[r * cols + c] = 1;
+                                                    })
+                                      .unwrap();
+                                })
+                  .is_ok());
+  EXPECT_EQ(std::accumulate(grid.begin(), grid.end(), 0),
+            static_cast<int>(rows * cols));
+}
+
+TEST(JobSystemTest, MoveSemantics) {
+  auto system1 = make_system();
+  JobSystem system2 = std::move(system1);
+  EXPECT_EQ(system1.worker_count(), 0u);
+
+  auto spawn_result = system1.spawn([]() { return 1; });
+  ASSERT_TRUE(spawn_result.is_err());
+  EXPECT_EQ(spawn_result.unwrap_err(), JobError::InvalidJobSystemError);
+
+  auto for_result = system1.parallel_for(0, 10, [](size_t) {});
+  ASSERT_TRUE(for_result.is_err());
+  EXPECT_EQ(for_result.unwrap_err(), JobError::InvalidJobSystemError);
+
+  auto wait_result = system2.spawn([]() { return 2; }).unwrap().wait();
+  ASSERT_TRUE(wait_result.is_ok());
+  EXPECT_EQ(wait_result.unwrap(), 2);
+}
+
+// 破棄時に残っているジョブもすべて実行される
+TEST(JobSystemTest, DrainsOnDestruction) {
+  std::atomic<int> ran{0};
+  {
+    auto system = make_system(1);
+    for (int i = 0; i < 1000; ++i) {
+      system.spawn([&]() { ++ran; }).unwrap();
+    }
+  }
+  EXPECT_EQ(ran.load(), 1000);
+}
+
+}  // namespace
@@ -0,0 +1,153 @@
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#include "pch.h"
+
+namespace {
+
+using namespace s6i_job;
+
+JobSystem make_system(uint32_t worker_count = 4) {
+  JobSystemDesc desc;
+  desc.m_worker_count = worker_count;
+  return JobSystem::make(desc).unwrap();
+}
+
+TEST(TaskGraphTest, DependenciesFromReadsAndWrites) {
+  TaskGraphBuilder builder;
+  const ResourceId x = builder.add_resource("x");
+  const ResourceId y = builder.add_resource("y");
+
+  const TaskId write_x = builder.add_task({"write_x", {}, {x}}, []() {});
+  const TaskId read_x1 = builder.add_task({"read_x1", {x}, {}}, []() {});
+  const TaskId read_x2 = builder.add_task({"read_x2", {x}, {y}}, []() {});
+  const TaskId rewrite_x = builder.add_task({"rewrite_x", {x}, {x}}, []() {});
+  const TaskId read_y = builder.add_task({"read_y", {y}, {}}, []() {});
+  const TaskId unrelated = builder.add_task({"unrelated", {}, {}}, []() {});
+
+  auto graph_result = builder.build();
+  ASSERT_TRUE(graph_result.is_ok());
+  auto graph = std::move(graph_result.unwrap());
+  EXPECT_EQ(graph.task_count(), 6u);
+  EXPECT_STREQ(graph.task_name(read_y), "read_y");
+
+  // 読む側は直前の書き込みの後、書く側はそれまでの読み込みの後
+  using Ids = std::vector<TaskId>;
+  EXPECT_EQ(graph.successors(write_x), (Ids{read_x1, read_x2, rewrite_x}));
+  EXPECT_EQ(graph.successors(read_x1), (Ids{rewrite_x}));
+  EXPECT_EQ(graph.successors(read_x2), (Ids{rewrite_x, read_y}));
+  EXPECT_TRUE(graph.successors(rewrite_x).empty());
+  EXPECT_TRUE(graph.successors(unrelated).empty());
+}
+
+TEST(TaskGraphTest, InvalidResource) {
+  TaskGraphBuilder builder;
+  builder.add_resource("x");
+  builder.add_task({"bad", {1}, {}}, []() {});
+  auto result = builder.build();
+  ASSERT_TRUE(result.is_err());
+  EXPECT_EQ(result.unwrap_err(), JobError::InvalidResourceError);
+}
+
+// 構築したグラフを繰り返し実行しても、毎回依存の順に実行される
+TEST(TaskGraphTest, RunsInDependencyOrderEveryFrame) {
+  auto system = make_system();
+  TaskGraphBuilder builder;
+  const ResourceId state = builder.add_resource("state");
+  const ResourceId draw_list = builder.add_resource("draw_list");
+
+  std::atomic<int> clock{0};
+  int simulate_at = 0;
+  int cull_at[4] = {};
+  int build_at = 0;
+  builder.add_task({"simulate", {}, {state}},
+                   [&]() { simulate_at = ++clock; });
+  for (int i = 0; i < 4; ++i) {
+    builder.add_task({"cull", {state}, {}}, [&, i]() { cull_at[i] = ++clock; });
+  }
+  builder.add_task({"build_draw_list", {state}, {draw_list}},
+                   [&]() { build_at = ++clock; });
+  builder.add_task({"rewind", {}, {state}}, [&]() { ++clock; });
+  auto graph = builder.build().unwrap();
+
+  for (int frame = 0; frame < 100; ++frame) {
+    clock = 0;
+    auto report = graph.run(system);
+    ASSERT_TRUE(report.is_ok());
+    EXPECT_EQ(clock.load(), 7);
+    for (int at : cull_at) {
+      EXPECT_GT(at, simulate_at);
+    }
+    EXPECT_GT(build_at, simulate_at);
+  }
+}
+
+TEST(TaskGraphTest, MainThreadTasksRunOnCaller) {
+  auto system = make_system(2);
+  TaskGraphBuilder builder;
+  const ResourceId target = builder.add_resource("target");
+  const ResourceId list = builder.add_resource("list");
+
+  std::thread::id build_thread;
+  std::thread::id present_thread;
+  builder.add_task({"build", {}, {list}},
+                   [&]() { build_thread = std::this_thread::get_id(); });
+  builder.add_task({"present", {list}, {target}, true}, [&]() {
+    present_thread = std::this_thread::get_id();
+  });
+  auto graph = builder.build().unwrap();
+
+  for (int frame = 0; frame < 20; ++frame) {
+    graph.run(system).unwrap();
+    EXPECT_EQ(present_thread, std::this_thread::get_id());
+  }
+  EXPECT_NE(build_thread, std::thread::id());
+}
+
+TEST(TaskGraphTest, ReportsCriticalPath) {
+  auto system = make_system(4);
+  TaskGraphBuilder builder;
+  const ResourceId a = builder.add_resource("a");
+  const ResourceId b = builder.add_resource("b");
+  auto sleep_ms = [](int ms) {
+    return [ms]() {
+      std::this_thread::sleep_for(std::chrono::milliseconds(ms));
+    };
+  };
+
+  // start → long → finish が最長、start → short → finish は短い
+  const TaskId start = builder.add_task({"start", {}, {a, b}}, sleep_ms(2));
+  const TaskId long_task = builder.add_task({"long", {a}, {}}, sleep_ms(20));
+  builder.add_task({"short", {b}, {}}, sleep_ms(1));
+  const TaskId finish = builder.add_task({"finish", {}, {a, b}}, sleep_ms(2));
+  auto graph = builder.build().unwrap();
+
+  auto report = graph.run(system).unwrap();
+  EXPECT_EQ(report.m_critical_path,
+            (std::vector<TaskId>{start, long_task, finish}));
+  EXPECT_GE(report.m_critical_path_ms, 24.0);
+  EXPECT_GE(report.m_work_ms, report.m_critical_path_ms);
+  EXPECT_GE(report.m_wall_ms, report.m_critical_path_ms);
+}
+
+TEST(TaskGraphTest, MoveSemantics) {
+  auto system = make_system(1);
+  TaskGraphBuilder builder;
+  int runs = 0;
+  builder.add_task({"count", {}, {}}, [&]() { ++runs; });
+  auto graph1 = builder.build().unwrap();
+
+  TaskGraph graph2 = std::move(graph1);
+  EXPECT_FALSE(graph1.is_valid());
+  EXPECT_EQ(graph1.task_count(), 0u);
+  auto result = graph1.run(system);
+  ASSERT_TRUE(result.is_err());
+  EXPECT_EQ(result.unwrap_err(), JobError::InvalidTaskGraphError);
+
+  graph2.run(system).unwrap();
+  EXPECT_EQ(runs, 1);
+}
+
+}  // namespace
@@ -0,0 +1,118 @@
+#include <SDL.h>
+#include <benchmark/benchmark.h>
+#include <cstdint>
+#include <cstdio>
+#include "s6i_log/log.h"
+#include "s6i_log/logger.h"
+
+namespace {
+
+using namespace s6i_log;
+
+/**
+ * SDLの出力先を一時ファイルに差し替える
+ * （コンソールを埋めずに、整形と書き込みの費用は含めて測る）
+ */
+class SdlOutputToFile {
+ public:
+  SdlOutputToFile() : m_file(std::tmpfile()) {
+    SDL_LogGetOutputFunction(&m_prev_func, &m_prev_user_data);
+    SDL_LogSetOutputFunction(&SdlOutputToFile::output, m_file);
+    m_prev_priority = SDL_LogGetPriority(SDL_LOG_CATEGORY_APPLICATION);
+    SDL_LogSetAllPriority(SDL_LOG_PRIORITY_VERBOSE);
+  }
+
+  ~SdlOutputToFile() {
+    SDL_LogSetOutputFunction(m_prev_func, m_prev_user_data);
+    SDL_LogSetAllPriority(m_prev_priority);
+    if (m_file) {
+      std::fclose(m_file);
+    }
+  }
+
+ private:
+  static void output(void* user_data,
+                     int /*category*/,
+                     SDL_LogPriority /*priority*/,
+                     const char* message) {
+    if (auto* file = static_cast<std::FILE*>(user_data)) {
+      std::fputs(message, file);
+      std::fputc('\n', file);
+    }
+  }
+
+  std::FILE* m_file;
+  SDL_LogOutputFunction m_prev_func = nullptr;
+  void* m_prev_user_data = nullptr;
+  SDL_LogPriority m_prev_priority = SDL_LOG_PRIORITY_INFO;
+};
+
+/** 比較用: これまでの同期的なSDL_LogInfo */
+void BM_SdlLogInfo(benchmark::State& state) {
+  static SdlOutputToFile* output = nullptr;
+  if (state.thread_index() == 0) {
+    output = new SdlOutputToFile();
+  }
+  int frame = 0;
+  for (auto _ : state) {
+    SDL_LogInfo(SDL_LOG_CATEGORY_APPLICATION, "Frame %d: %s %.3f", ++frame,
+                "update", 16.667);
+  }
+  if (state.thread_index() == 0) {
+    delete output;
+  }
+}
+BENCHMARK(BM_SdlLogInfo)->Threads(1)->Threads(4)->UseRealTime();
+
+/** Loggerなし: 呼び出したスレッドで整形してSDLに渡す */
+void BM_LogSync(benchmark::State& state) {
+  SdlOutputToFile output;
+  int frame = 0;
+  for (auto _ : state) {
+    S6I_LOG_INFO(SDL_LOG_CATEGORY_APPLICATION, "Frame %d: %s %.3f", ++frame,
+                 "update", 16.667);
+  }
+}
+BENCHMARK(BM_LogSync);
+
+/**
+ * Loggerあり: リングに積むだけ（整形と書き込みは出力スレッド）
+ * droppedはリングが満杯で捨てた数
+ */
+void BM_LogAsync(benchmark::State& state) {
+  static SdlOutputToFile* output = nullptr;
+  static Logger* logger = nullptr;
+  static uint64_t dropped_before = 0;
+  if (state.thread_index() == 0) {
+    output = new SdlOutputToFile();
+    logger = new Logger(Logger::make().unwrap());
+    dropped_before = Logger::dropped_count();
+  }
+  int frame = 0;
+  for (auto _ : state) {
+    S6I_LOG_INFO(SDL_LOG_CATEGORY_APPLICATION, "Frame %d: %s %.3f", ++frame,
+                 "update", 16.667);
+  }
+  if (state.thread_index() == 0) {
+    delete logger;
+    delete output;
+    state.counters["dropped"] =
+        static_cast<double>(Logger::dropped_count() - dropped_before);
+  }
+}
+BENCHMARK(BM_LogAsync)->Threads(1)->Threads(4)->UseRealTime();
+
+/** 実行時のレベルで弾かれる呼び出し */
+void BM_LogFilteredAtRuntime(benchmark::State& state) {
+  set_min_level(Level::Warn);
+  int frame = 0;
+  for (auto _ : state) {
+    S6I_LOG_INFO(SDL_LOG_CATEGORY_APPLICATION, "Frame %d: %s %.3f", ++frame,
+                 "update", 16.667);
+  }
+  benchmark::DoNotOptimize(frame);
+  set_min_level(Level::Verbose);
+}
+BENCHMARK(BM_LogFilteredAtRuntime);
+
+}  // namespace
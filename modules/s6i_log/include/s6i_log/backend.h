@@ -0,0 +1,302 @@
+#pragma once
+
+#include <SDL.h>
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+#include "format.h"
+#include "level.h"
+#include "record.h"
+
+namespace s6i_log {
+
+/**
+ * @brief 整形済みのログメッセージ
+ * Sinkに渡され、呼び出しの間だけ有効です
+ */
+struct Message {
+  uint64_t m_timestamp = 0;  ///< SDL_GetPerformanceCounter()の値
+  SDL_threadID m_thread_id = 0;
+  int m_category = 0;  ///< SDL_LOG_CATEGORY_*
+  Level m_level = Level::Info;
+  const char* m_text = "";
+};
+
+/**
+ * @brief 整形済みのメッセージの出力先
+ * Loggerの出力スレッドから呼ばれます
+ */
+using Sink = void (*)(void* user_data, const Message& message);
+
+/**
+ * @brief 既定の出力先
+ * 経過時間を付けてSDL_LogMessageに渡します（優先度の絞り込みはSDLが行う）
+ */
+inline void sdl_sink(void* /*user_data*/, const Message& message) {
+  static const uint64_t base = SDL_GetPerformanceCounter();
+  static const uint64_t frequency = SDL_GetPerformanceFrequency();
+  // 浮動小数点の整形は遅いので、整数で秒とマイクロ秒に分ける
+  const uint64_t elapsed =
+      message.m_timestamp - std::min(base, message.m_timestamp);
+  const uint64_t seconds = elapsed / frequency;
+  const uint64_t micros = (elapsed % frequency) * 1000000 / frequency;
+  SDL_LogMessage(message.m_category, to_sdl_priority(message.m_level),
+                 "[%4llu.%06llu] %s", static_cast<unsigned long long>(seconds),
+                 static_cast<unsigned long long>(micros), message.m_text);
+}
+
+namespace detail {
+
+/** @brief 1つのメッセージの最大文字数（超えた分は切り捨て） */
+constexpr size_t MAX_MESSAGE_SIZE = 1024;
+
+/**
+ * @brief スレッドごとのリングバッファ（書き込み1、読み出し1）
+ *
+ * 書き込むのは所有スレッド、読み出すのは出力スレッドだけです。
+ * レコードは終端で折り返して連続しないことがあるため、
+ * 読み出し側で一度コピーしてから解釈します。
+ * 登録したバッファは解放せず、スレッド終了後は次に作られたスレッドが
+ * 再利用します。
+ */
+struct ThreadBuffer {
+  static constexpr size_t CAPACITY = 64 * 1024;
+  static_assert((CAPACITY & (CAPACITY - 1)) == 0,
+                "CAPACITY must be a power of two");
+
+  // 書き込み側が更新する値
+  alignas(64) std::atomic<uint64_t> m_tail{0};
+  uint64_t m_cached_head = 0;
+  std::atomic<uint64_t> m_dropped{0};  ///< 満杯で書けなかったレコード数
+
+  // 読み出し側が更新する値
+  alignas(64) std::atomic<uint64_t> m_head{0};
+
+  alignas(64) uint8_t m_data[CAPACITY];
+  std::atomic<SDL_threadID> m_thread_id{0};
+  std::atomic<bool> m_in_use{true};
+  ThreadBuffer* m_next = nullptr;
+
+  /** @brief レコードを書き込む（空きがなければ捨ててfalse） */
+  bool push(const uint8_t* record, size_t size) {
+    const uint64_t tail = m_tail.load(std::memory_order_relaxed);
+    if (tail + size - m_cached_head > CAPACITY) {
+      m_cached_head = m_head.load(std::memory_order_acquire);
+      if (tail + size - m_cached_head > CAPACITY) {
+        m_dropped.fetch_add(1, std::memory_order_relaxed);
+        return false;
+      }
+    }
+    copy_in(tail, record, size);
+    m_tail.store(tail + size, std::memory_order_release);
+    return true;
+  }
+
+  /** @brief 半分以上埋まっているかどうか（書き込み側から呼ぶ） */
+  bool is_half_full() {
+    const uint64_t tail = m_tail.load(std::memory_order_relaxed);
+    if (tail - m_cached_head < CAPACITY / 2) {
+      return false;
+    }
+    m_cached_head = m_head.load(std::memory_order_acquire);
+    return tail - m_cached_head >= CAPACITY / 2;
+  }
+
+  void copy_in(uint64_t pos, const uint8_t* src, size_t size) {
+    const size_t offset = static_cast<size_t>(pos & (CAPACITY - 1));
+    const size_t first = std::min(size, CAPACITY - offset);
+    std::memcpy(m_data + offset, src, first);
+    std::memcpy(m_data, src + first, size - first);
+  }
+
+  void copy_out(uint64_t pos, uint8_t* dst, size_t size) const {
+    const size_t offset = static_cast<size_t>(pos & (CAPACITY - 1));
+    const size_t first = std::min(size, CAPACITY - offset);
+    std::memcpy(dst, m_data + offset, first);
+    std::memcpy(dst + first, m_data, size - first);
+  }
+};
+
+/** @brief 登録済みのバッファの連結リスト（追加のみ） */
+inline std::atomic<ThreadBuffer*> g_buffers{nullptr};
+
+/** @brief 空いているバッファを再利用するか、新しく登録する */
+inline ThreadBuffer* claim_buffer() {
+  ThreadBuffer* buffer = nullptr;
+  for (ThreadBuffer* it = g_buffers.load(std::memory_order_acquire); it;
+       it = it->m_next) {
+    bool in_use = false;
+    if (it->m_in_use.compare_exchange_strong(in_use, true,
+                                             std::memory_order_acquire)) {
+      buffer = it;
+      break;
+    }
+  }
+  if (!buffer) {
+    buffer = new ThreadBuffer();
+    buffer->m_next = g_buffers.load(std::memory_order_relaxed);
+    while (!g_buffers.compare_exchange_weak(buffer->m_next, buffer,
+                                            std::memory_order_release,
+                                            std::memory_order_relaxed)) {
+    }
+  }
+  buffer->m_thread_id.store(SDL_ThreadID(), std::memory_order_relaxed);
+  buffer->m_cached_head = buffer->m_head.load(std::memory_order_acquire);
+  return buffer;
+}
+
+/** @brief スレッド終了時にバッファを返す */
+struct BufferHolder {
+  ThreadBuffer* m_buffer = claim_buffer();
+
+  ~BufferHolder() {
+    m_buffer->m_in_use.store(false, std::memory_order_release);
+  }
+};
+
+inline ThreadBuffer& current_buffer() {
+  static thread_local BufferHolder holder;
+  return *holder.m_buffer;
+}
+
+/**
+ * @brief Loggerと書き込み側が共有する状態
+ * Loggerは同時に1つだけ動かせます
+ */
+struct Backend {
+  std::atomic<bool> m_running{false};
+  std::atomic<int> m_min_level{static_cast<int>(Level::Verbose)};
+  std::atomic<Sink> m_sink{&sdl_sink};
+  std::atomic<void*> m_user_data{nullptr};
+  std::atomic<bool> m_wake_pending{false};
+  std::atomic<uint64_t> m_dropped{0};  ///< 出力スレッドが集計した破棄数
+
+  // 以下はm_mutexで保護する
+  SDL_mutex* m_mutex = nullptr;
+  SDL_cond* m_cond = nullptr;
+  bool m_stop = false;
+  uint64_t m_flush_requested = 0;
+  uint64_t m_flush_done = 0;
+};
+
+inline Backend g_backend;
+
+/** @brief レコードを整形してSinkに渡す */
+inline void emit(const uint8_t* record, SDL_threadID thread_id) {
+  RecordHeader header;
+  std::memcpy(&header, record, sizeof(header));
+  ArgReader reader(record + sizeof(header), header.m_size - sizeof(header));
+  char text[MAX_MESSAGE_SIZE];
+  format_message(header.m_format, reader, text, sizeof(text));
+
+  Message message;
+  message.m_timestamp = header.m_timestamp;
+  message.m_thread_id = thread_id;
+  message.m_category = header.m_category;
+  message.m_level = header.m_level;
+  message.m_text = text;
+  g_backend.m_sink.load(std::memory_order_acquire)(
+      g_backend.m_user_data.load(std::memory_order_acquire), message);
+}
+
+/** @brief 出力スレッドを起こす（書き込み側から、1回だけ） */
+inline void wake_output_thread() {
+  if (!g_backend.m_wake_pending.exchange(true, std::memory_order_acq_rel)) {
+    SDL_CondBroadcast(g_backend.m_cond);
+  }
+}
+
+/**
+ * @brief ログを1件書く（S6I_LOG_*から呼ばれる）
+ *
+ * Loggerが動いていれば自スレッドのリングにレコードを積むだけで戻ります。
+ * 動いていなければ、これまでどおりSDL_LogMessageにそのまま渡します。
+ */
+template <typename... Args>
+void write(Level level, int category, const char* format, const Args&... args) {
+  if (static_cast<int>(level) <
+      g_backend.m_min_level.load(std::memory_order_relaxed)) {
+    return;
+  }
+  if (!g_backend.m_running.load(std::memory_order_acquire)) {
+    if constexpr (sizeof...(Args) > 0) {
+      SDL_LogMessage(category, to_sdl_priority(level), format, args...);
+    } else {
+      // 書式文字列をそのまま渡すと警告になるので、%%だけ変換して渡す
+      ArgReader reader(nullptr, 0);
+      char text[MAX_MESSAGE_SIZE];
+      format_message(format, reader, text, sizeof(text));
+      SDL_LogMessage(category, to_sdl_priority(level), "%s", text);
+    }
+    return;
+  }
+  uint8_t record[MAX_RECORD_SIZE];
+  const size_t size = encode_record(record, SDL_GetPerformanceCounter(),
+                                    level, category, format, args...);
+  ThreadBuffer& buffer = current_buffer();
+  if (!buffer.push(record, size) || buffer.is_half_full()) {
+    // 溢れたか半分を超えたら、間隔を待たずに出力させる
+    wake_output_thread();
+  }
+}
+
+/**
+ * @brief すべてのバッファを読み出し、時刻順に出力する
+ * 出力スレッドだけが呼びます
+ */
+inline void drain(std::vector<ThreadBuffer*>& buffers,
+                  std::vector<uint64_t>& tails) {
+  buffers.clear();
+  tails.clear();
+  uint64_t dropped = 0;
+  for (ThreadBuffer* buffer = g_buffers.load(std::memory_order_acquire); buffer;
+       buffer = buffer->m_next) {
+    buffers.push_back(buffer);
+    tails.push_back(buffer->m_tail.load(std::memory_order_acquire));
+    dropped += buffer->m_dropped.exchange(0, std::memory_order_relaxed);
+  }
+
+  // 各バッファの先頭のうち、最も古いレコードから順に出力する
+  uint8_t record[MAX_RECORD_SIZE];
+  for (;;) {
+    ThreadBuffer* oldest = nullptr;
+    uint64_t oldest_time = 0;
+    for (size_t i = 0; i < buffers.size(); ++i) {
+      ThreadBuffer* buffer = buffers[i];
+      const uint64_t head = buffer->m_head.load(std::memory_order_relaxed);
+      if (head == tails[i]) {
+        continue;
+      }
+      uint64_t timestamp = 0;
+      buffer->copy_out(head, reinterpret_cast<uint8_t*>(&timestamp),
+                       sizeof(timestamp));
+      if (!oldest || timestamp < oldest_time) {
+        oldest = buffer;
+        oldest_time = timestamp;
+      }
+    }
+    if (!oldest) {
+      break;
+    }
+    const uint64_t head = oldest->m_head.load(std::memory_order_relaxed);
+    RecordHeader header;
+    oldest->copy_out(head, reinterpret_cast<uint8_t*>(&header),
+                     sizeof(header));
+    oldest->copy_out(head, record, header.m_size);
+    oldest->m_head.store(head + header.m_size, std::memory_order_release);
+    emit(record, oldest->m_thread_id.load(std::memory_order_relaxed));
+  }
+
+  if (dropped > 0) {
+    g_backend.m_dropped.fetch_add(dropped, std::memory_order_relaxed);
+    write(Level::Warn, SDL_LOG_CATEGORY_SYSTEM,
+          "s6i_log: %llu messages dropped (buffer full).",
+          static_cast<unsigned long long>(dropped));
+  }
+}
+
+}  // namespace detail
+}  // namespace s6i_log
@@ -0,0 +1,27 @@
+#pragma once
+
+#include <s6i_result/niche.h>
+
+namespace s6i_log {
+
+/**
+ * @brief ログ出力に関するエラー型
+ */
+enum class LogError {
+  // Logger関連エラー
+  ThreadCreationError,  ///< 出力スレッドの作成に失敗
+  AlreadyRunningError,  ///< 別のLoggerがすでに動いている
+  InvalidLoggerError,   ///< 無効なLoggerへの操作
+};
+
+}  // namespace s6i_log
+
+/**
+ * @brief LogErrorの範囲外の値をResultのタグとして使う
+ */
+template <>
+struct s6i_result::NicheTraits<s6i_log::LogError> {
+  static constexpr bool enabled = true;
+  static constexpr s6i_log::LogError value =
+      static_cast<s6i_log::LogError>(-1);
+};
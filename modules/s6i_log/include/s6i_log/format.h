@@ -0,0 +1,246 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include "record.h"
+
+namespace s6i_log {
+namespace detail {
+
+/**
+ * @brief 出力先の文字列バッファ（溢れた分は切り捨て）
+ */
+class TextBuffer {
+ public:
+  TextBuffer(char* data, size_t capacity) : m_data(data), m_capacity(capacity) {
+    if (m_capacity > 0) {
+      m_data[0] = '\0';
+    }
+  }
+
+  size_t size() const { return m_size; }
+
+  void append(const char* text, size_t length) {
+    if (m_size + 1 >= m_capacity) {
+      return;
+    }
+    length = std::min(length, m_capacity - 1 - m_size);
+    std::memcpy(m_data + m_size, text, length);
+    m_size += length;
+    m_data[m_size] = '\0';
+  }
+
+  /** @brief 1つの変換指定をsnprintfで書き込む */
+  template <typename V>
+  void append_format(const char* spec, V value) {
+    if (m_size + 1 >= m_capacity) {
+      return;
+    }
+    const int written =
+        std::snprintf(m_data + m_size, m_capacity - m_size, spec, value);
+    if (written > 0) {
+      m_size = std::min(m_size + static_cast<size_t>(written), m_capacity - 1);
+    }
+  }
+
+ private:
+  char* m_data;
+  size_t m_capacity;
+  size_t m_size = 0;
+};
+
+/** @brief 整数の引数をlong longとして取り出す */
+inline long long arg_as_signed(const Arg& arg) {
+  switch (arg.m_kind) {
+    case ArgKind::Int:
+      return static_cast<long long>(arg.m_int);
+    case ArgKind::Double:
+      return static_cast<long long>(arg.m_double);
+    default:
+      return static_cast<long long>(arg.m_uint);
+  }
+}
+
+/**
+ * @brief 整数の引数をunsigned long longとして取り出す
+ * 符号付きの値は元の型の幅に切り詰めます（%xに-1を渡した場合など）
+ */
+inline unsigned long long arg_as_unsigned(const Arg& arg) {
+  switch (arg.m_kind) {
+    case ArgKind::Int: {
+      auto value = static_cast<uint64_t>(arg.m_int);
+      if (arg.m_width > 0 && arg.m_width < sizeof(uint64_t)) {
+        value &= (uint64_t{1} << (arg.m_width * 8)) - 1;
+      }
+      return value;
+    }
+    case ArgKind::Double:
+      return static_cast<unsigned long long>(arg.m_double);
+    default:
+      return arg.m_uint;
+  }
+}
+
+inline double arg_as_double(const Arg& arg) {
+  switch (arg.m_kind) {
+    case ArgKind::Double:
+      return arg.m_double;
+    case ArgKind::Int:
+      return static_cast<double>(arg.m_int);
+    default:
+      return static_cast<double>(arg.m_uint);
+  }
+}
+
+/**
+ * @brief printf形式の書式文字列と引数の列から文字列を組み立てる
+ *
+ * 変換指定を1つずつ切り出し、長さ修飾子を保持している型に合わせて
+ * 書き換えてからsnprintfに渡します。
+ * 引数が足りない変換指定はそのまま出力します。%nは無視します。
+ *
+ * @return 書き込んだ文字数（終端文字を除く）
+ */
+inline size_t format_message(const char* format,
+                             ArgReader& reader,
+                             char* out,
+                             size_t capacity) {
+  TextBuffer text(out, capacity);
+  const char* p = format;
+  while (*p) {
+    const char* percent = std::strchr(p, '%');
+    if (!percent) {
+      text.append(p, std::strlen(p));
+      break;
+    }
+    text.append(p, static_cast<size_t>(percent - p));
+    p = percent + 1;
+    if (*p == '%') {
+      text.append("%", 1);
+      ++p;
+      continue;
+    }
+
+    // %[flags][width][.precision][length]conversion
+    char spec[32] = "%";
+    size_t spec_size = 1;
+    bool missing = false;
+    const auto push = [&](char c) {
+      if (spec_size + 1 < sizeof(spec) - 3) {
+        spec[spec_size++] = c;
+      }
+    };
+    const auto push_star = [&]() {
+      Arg arg;
+      if (!reader.next(arg)) {
+        missing = true;
+        return;
+      }
+      char number[24];
+      std::snprintf(number, sizeof(number), "%lld", arg_as_signed(arg));
+      for (const char* n = number; *n; ++n) {
+        push(*n);
+      }
+    };
+    while (*p && std::strchr("-+ #0", *p)) {
+      push(*p++);
+    }
+    if (*p == '*') {
+      push_star();
+      ++p;
+    }
+    while (*p >= '0' && *p <= '9') {
+      push(*p++);
+    }
+    if (*p == '.') {
+      push(*p++);
+      if (*p == '*') {
+        push_star();
+        ++p;
+      }
+      while (*p >= '0' && *p <= '9') {
+        push(*p++);
+      }
+    }
+    while (*p && std::strchr("hlLqjzt", *p)) {
+      ++p;  // 長さ修飾子は型に合わせて付け直す
+    }
+    const char conversion = *p;
+    if (!conversion) {
+      break;
+    }
+    ++p;
+
+    Arg arg;
+    if (missing || conversion == 'n' || !reader.next(arg)) {
+      if (conversion != 'n') {
+        text.append(percent, static_cast<size_t>(p - percent));
+      }
+      continue;
+    }
+    switch (conversion) {
+      case 'd':
+      case 'i':
+        spec[spec_size++] = 'l';
+        spec[spec_size++] = 'l';
+        spec[spec_size++] = conversion;
+        spec[spec_size] = '\0';
+        text.append_format(spec, arg_as_signed(arg));
+        break;
+      case 'u':
+      case 'o':
+      case 'x':
+      case 'X':
+        spec[spec_size++] = 'l';
+        spec[spec_size++] = 'l';
+        spec[spec_size++] = conversion;
+        spec[spec_size] = '\0';
+        text.append_format(spec, arg_as_unsigned(arg));
+        break;
+      case 'c':
+        spec[spec_size++] = 'c';
+        spec[spec_size] = '\0';
+        text.append_format(spec, static_cast<int>(arg_as_signed(arg)));
+        break;
+      case 'f':
+      case 'F':
+      case 'e':
+      case 'E':
+      case 'g':
+      case 'G':
+      case 'a':
+      case 'A':
+        spec[spec_size++] = conversion;
+        spec[spec_size] = '\0';
+        text.append_format(spec, arg_as_double(arg));
+        break;
+      case 'p':
+        spec[spec_size++] = 'p';
+        spec[spec_size] = '\0';
+        text.append_format(spec, reinterpret_cast<const void*>(
+                                     static_cast<uintptr_t>(arg.m_uint)));
+        break;
+      case 's': {
+        char value[MAX_STRING_SIZE + 1] = "";
+        if (arg.m_kind == ArgKind::String) {
+          std::memcpy(value, arg.m_string, arg.m_length);
+          value[arg.m_length] = '\0';
+        }
+        spec[spec_size++] = 's';
+        spec[spec_size] = '\0';
+        text.append_format(spec, static_cast<const char*>(value));
+        break;
+      }
+      default:
+        text.append(percent, static_cast<size_t>(p - percent));
+        break;
+    }
+  }
+  return text.size();
+}
+
+}  // namespace detail
+}  // namespace s6i_log
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <SDL.h>
+#include <cstdint>
+
+/**
+ * @name ログレベルの値
+ * S6I_LOG_LEVELの指定に使います（SDL_LogPriorityと同じ値）
+ * @{
+ */
+#define S6I_LOG_LEVEL_VERBOSE 1
+#define S6I_LOG_LEVEL_DEBUG 2
+#define S6I_LOG_LEVEL_INFO 3
+#define S6I_LOG_LEVEL_WARN 4
+#define S6I_LOG_LEVEL_ERROR 5
+#define S6I_LOG_LEVEL_CRITICAL 6
+#define S6I_LOG_LEVEL_OFF 7
+/** @} */
+
+/**
+ * @brief コンパイル時に残すログの最低レベル
+ *
+ * これより低いレベルのS6I_LOG_*は、引数の評価も含めて取り除かれます。
+ * 既定ではNDEBUGのときINFO、それ以外はVERBOSEです。
+ */
+#ifndef S6I_LOG_LEVEL
+#if defined(NDEBUG)
+#define S6I_LOG_LEVEL S6I_LOG_LEVEL_INFO
+#else
+#define S6I_LOG_LEVEL S6I_LOG_LEVEL_VERBOSE
+#endif
+#endif
+
+namespace s6i_log {
+
+/**
+ * @brief ログレベル
+ * SDL_LogPriorityと同じ値です
+ */
+enum class Level : uint8_t {
+  Verbose = S6I_LOG_LEVEL_VERBOSE,
+  Debug = S6I_LOG_LEVEL_DEBUG,
+  Info = S6I_LOG_LEVEL_INFO,
+  Warn = S6I_LOG_LEVEL_WARN,
+  Error = S6I_LOG_LEVEL_ERROR,
+  Critical = S6I_LOG_LEVEL_CRITICAL,
+};
+
+/** @brief SDL_LogPriorityに変換 */
+constexpr SDL_LogPriority to_sdl_priority(Level level) {
+  return static_cast<SDL_LogPriority>(level);
+}
+
+/** @brief コンパイル時に残るレベルかどうか */
+constexpr bool is_compiled(Level level) {
+  return static_cast<int>(level) >= S6I_LOG_LEVEL;
+}
+
+}  // namespace s6i_log
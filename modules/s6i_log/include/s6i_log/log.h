@@ -0,0 +1,86 @@
+#pragma once
+
+#include "backend.h"
+#include "level.h"
+
+namespace s6i_log::detail {
+
+/**
+ * @brief 書式と引数の組み合わせをコンパイル時に検査する
+ * sizeofの中でだけ使い、呼び出されることはありません
+ */
+#if defined(__GNUC__)
+[[gnu::format(printf, 1, 2)]]
+#endif
+int check_format(const char* format, ...);
+
+}  // namespace s6i_log::detail
+
+/**
+ * @brief 引数を評価せずに書式だけを検査する
+ * 取り除いたログの引数も「使われた」扱いになり、未使用変数の警告が出ません
+ */
+#define S6I_LOG_CHECK_FORMAT(...) \
+  static_cast<void>(sizeof(::s6i_log::detail::check_format(__VA_ARGS__)))
+
+/**
+ * @brief レベルを指定してログを書く
+ * S6I_LOG_LEVEL未満のレベルでも取り除かれないので、通常は下の各マクロを
+ * 使います
+ */
+#define S6I_LOG(level, category, ...)                           \
+  do {                                                          \
+    S6I_LOG_CHECK_FORMAT(__VA_ARGS__);                          \
+    ::s6i_log::detail::write((level), (category), __VA_ARGS__); \
+  } while (false)
+
+/**
+ * @name レベルごとのログマクロ
+ * S6I_LOG_XXX(category, format, args...) の形で使います。
+ * formatは文字列リテラルにしてください（アドレスだけを保持するため）。
+ * S6I_LOG_LEVELより低いレベルのマクロはコードを生成せず、
+ * 引数も評価しません（書式の検査だけ行います）。
+ * @{
+ */
+#if S6I_LOG_LEVEL <= S6I_LOG_LEVEL_VERBOSE
+#define S6I_LOG_VERBOSE(category, ...) \
+  S6I_LOG(::s6i_log::Level::Verbose, category, __VA_ARGS__)
+#else
+#define S6I_LOG_VERBOSE(category, ...) S6I_LOG_CHECK_FORMAT(__VA_ARGS__)
+#endif
+
+#if S6I_LOG_LEVEL <= S6I_LOG_LEVEL_DEBUG
+#define S6I_LOG_DEBUG(category, ...) \
+  S6I_LOG(::s6i_log::Level::Debug, category, __VA_ARGS__)
+#else
+#define S6I_LOG_DEBUG(category, ...) S6I_LOG_CHECK_FORMAT(__VA_ARGS__)
+#endif
+
+#if S6I_LOG_LEVEL <= S6I_LOG_LEVEL_INFO
+#define S6I_LOG_INFO(category, ...) \
+  S6I_LOG(::s6i_log::Level::Info, category, __VA_ARGS__)
+#else
+#define S6I_LOG_INFO(category, ...) S6I_LOG_CHECK_FORMAT(__VA_ARGS__)
+#endif
+
+#if S6I_LOG_LEVEL <= S6I_LOG_LEVEL_WARN
+#define S6I_LOG_WARN(category, ...) \
+  S6I_LOG(::s6i_log::Level::Warn, category, __VA_ARGS__)
+#else
+#define S6I_LOG_WARN(category, ...) S6I_LOG_CHECK_FORMAT(__VA_ARGS__)
+#endif
+
+#if S6I_LOG_LEVEL <= S6I_LOG_LEVEL_ERROR
+#define S6I_LOG_ERROR(category, ...) \
+  S6I_LOG(::s6i_log::Level::Error, category, __VA_ARGS__)
+#else
+#define S6I_LOG_ERROR(category, ...) S6I_LOG_CHECK_FORMAT(__VA_ARGS__)
+#endif
+
+#if S6I_LOG_LEVEL <= S6I_LOG_LEVEL_CRITICAL
+#define S6I_LOG_CRITICAL(category, ...) \
+  S6I_LOG(::s6i_log::Level::Critical, category, __VA_ARGS__)
+#else
+#define S6I_LOG_CRITICAL(category, ...) S6I_LOG_CHECK_FORMAT(__VA_ARGS__)
+#endif
+/** @} */
@@ -0,0 +1,205 @@
+#pragma once
+
+#include <SDL.h>
+#include <s6i_result/result.h>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <vector>
+#include "backend.h"
+#include "error.h"
+#include "level.h"
+
+namespace s6i_log {
+
+/**
+ * @brief Loggerの作成設定
+ */
+struct LoggerDesc {
+  /** @brief 出力スレッドがバッファを読み出す間隔（ミリ秒） */
+  uint32_t m_flush_interval_ms = 10;
+  /** @brief 出力先（nullptrは既定のsdl_sink） */
+  Sink m_sink = nullptr;
+  /** @brief 出力先に渡す値 */
+  void* m_user_data = nullptr;
+};
+
+/**
+ * @brief 非同期ログ出力
+ *
+ * 存在する間、S6I_LOG_*はスレッドごとのリングにバイナリレコードを
+ * 積むだけで戻り、整形と出力は出力スレッドがまとめて行います。
+ * Loggerがないときは呼び出したスレッドでその場で出力します。
+ * リングが満杯のときはレコードを捨て、後でその件数を出力します。
+ *
+ * 破棄時に出力スレッドを止め、残っているレコードをすべて出力します。
+ * 同時に動かせるLoggerは1つだけです。
+ */
+class Logger {
+ public:
+  /**
+   * @brief 新しいLoggerを作成し、出力スレッドを起動する
+   * @param desc 作成設定
+   * @return 成功時: 作成されたLogger、失敗時: エラー
+   */
+  static s6i_result::Result<Logger, LogError> make(
+      const LoggerDesc& desc = {}) {
+    detail::Backend& backend = detail::g_backend;
+    bool running = false;
+    if (!backend.m_running.compare_exchange_strong(running, true,
+                                                   std::memory_order_acq_rel)) {
+      return s6i_result::make_err(LogError::AlreadyRunningError);
+    }
+    // 書き込み側が参照するため、一度作ったら破棄しない
+    if (!backend.m_mutex) {
+      backend.m_mutex = SDL_CreateMutex();
+    }
+    if (!backend.m_cond) {
+      backend.m_cond = SDL_CreateCond();
+    }
+    if (!backend.m_mutex || !backend.m_cond) {
+      backend.m_running.store(false, std::memory_order_release);
+      return s6i_result::make_err(LogError::ThreadCreationError);
+    }
+    backend.m_sink.store(desc.m_sink ? desc.m_sink : &sdl_sink,
+                         std::memory_order_release);
+    backend.m_user_data.store(desc.m_user_data, std::memory_order_release);
+    backend.m_stop = false;
+
+    auto state = std::make_unique<State>();
+    state->m_flush_interval_ms = desc.m_flush_interval_ms;
+    state->m_thread =
+        SDL_CreateThread(&Logger::entry, "s6i_log_writer", state.get());
+    if (!state->m_thread) {
+      backend.m_running.store(false, std::memory_order_release);
+      return s6i_result::make_err(LogError::ThreadCreationError);
+    }
+    return s6i_result::make_ok(Logger(std::move(state)));
+  }
+
+  // コピー禁止
+  Logger(const Logger&) = delete;
+  Logger& operator=(const Logger&) = delete;
+
+  // ムーブ可能
+  Logger(Logger&& other) : m_state(std::move(other.m_state)) {}
+
+  Logger& operator=(Logger&& other) {
+    Logger(std::move(other)).swap(*this);
+    return *this;
+  }
+
+  ~Logger() { stop(); }
+
+  /** @brief 有効なLoggerかどうか（ムーブ元は無効） */
+  bool is_valid() const { return m_state != nullptr; }
+
+  /**
+   * @brief 呼び出し時点までに書かれたレコードがすべて出力されるまで待つ
+   * @return 成功時: void、失敗時: エラー
+   */
+  s6i_result::Result<void, LogError> flush() {
+    if (!m_state) {
+      return s6i_result::make_err(LogError::InvalidLoggerError);
+    }
+    detail::Backend& backend = detail::g_backend;
+    SDL_LockMutex(backend.m_mutex);
+    const uint64_t request = ++backend.m_flush_requested;
+    SDL_CondBroadcast(backend.m_cond);
+    while (backend.m_flush_done < request) {
+      SDL_CondWait(backend.m_cond, backend.m_mutex);
+    }
+    SDL_UnlockMutex(backend.m_mutex);
+    return s6i_result::make_ok();
+  }
+
+  /** @brief 満杯で捨てたレコード数（起動してからの合計） */
+  static uint64_t dropped_count() {
+    return detail::g_backend.m_dropped.load(std::memory_order_relaxed);
+  }
+
+  void swap(Logger& other) {
+    using std::swap;
+    swap(m_state, other.m_state);
+  }
+
+ private:
+  struct State {
+    SDL_Thread* m_thread = nullptr;
+    uint32_t m_flush_interval_ms = 0;
+    std::vector<detail::ThreadBuffer*> m_buffers;
+    std::vector<uint64_t> m_tails;
+  };
+
+  explicit Logger(std::unique_ptr<State> state) : m_state(std::move(state)) {}
+
+  /** @brief 出力スレッドの本体 */
+  static int entry(void* data) {
+    auto* state = static_cast<State*>(data);
+    detail::Backend& backend = detail::g_backend;
+    SDL_LockMutex(backend.m_mutex);
+    for (;;) {
+      if (!backend.m_stop &&
+          backend.m_flush_done == backend.m_flush_requested &&
+          !backend.m_wake_pending.load(std::memory_order_acquire)) {
+        SDL_CondWaitTimeout(backend.m_cond, backend.m_mutex,
+                            state->m_flush_interval_ms);
+      }
+      const bool stopping = backend.m_stop;
+      const uint64_t request = backend.m_flush_requested;
+      backend.m_wake_pending.store(false, std::memory_order_release);
+      SDL_UnlockMutex(backend.m_mutex);
+
+      detail::drain(state->m_buffers, state->m_tails);
+
+      SDL_LockMutex(backend.m_mutex);
+      backend.m_flush_done = request;
+      SDL_CondBroadcast(backend.m_cond);
+      if (stopping) {
+        break;
+      }
+    }
+    SDL_UnlockMutex(backend.m_mutex);
+    return 0;
+  }
+
+  /** @brief 出力スレッドを止め、残りを出力する */
+  void stop() {
+    if (!m_state) {
+      return;
+    }
+    detail::Backend& backend = detail::g_backend;
+    SDL_LockMutex(backend.m_mutex);
+    backend.m_stop = true;
+    SDL_CondBroadcast(backend.m_cond);
+    SDL_UnlockMutex(backend.m_mutex);
+    SDL_WaitThread(m_state->m_thread, nullptr);
+
+    // 停止と入れ違いに積まれたレコードは、その場で出力する
+    backend.m_running.store(false, std::memory_order_release);
+    detail::drain(m_state->m_buffers, m_state->m_tails);
+    backend.m_sink.store(&sdl_sink, std::memory_order_release);
+    backend.m_user_data.store(nullptr, std::memory_order_release);
+    m_state.reset();
+  }
+
+  std::unique_ptr<State> m_state;
+};
+
+/**
+ * @brief 実行時の最低レベルを設定する
+ * これより低いレベルのログは、コンパイル時に残っていても出力しません
+ */
+inline void set_min_level(Level level) {
+  detail::g_backend.m_min_level.store(static_cast<int>(level),
+                                      std::memory_order_relaxed);
+}
+
+/** @brief 実行時の最低レベル */
+inline Level min_level() {
+  return static_cast<Level>(
+      detail::g_backend.m_min_level.load(std::memory_order_relaxed));
+}
+
+}  // namespace s6i_log
@@ -0,0 +1,9 @@
+#pragma once
+
+#include "backend.h"
+#include "error.h"
+#include "format.h"
+#include "level.h"
+#include "log.h"
+#include "logger.h"
+#include "record.h"
@@ -0,0 +1,200 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+#include "level.h"
+
+namespace s6i_log {
+namespace detail {
+
+/**
+ * @brief バイナリレコードの先頭部分
+ *
+ * レコードは RecordHeader + 引数の列 で、書式文字列は文字列リテラルの
+ * アドレスだけを持ちます（書式IDの代わり）。
+ * 整形は出力スレッドが行います。
+ */
+struct RecordHeader {
+  uint64_t m_timestamp = 0;        ///< SDL_GetPerformanceCounter()の値
+  const char* m_format = nullptr;  ///< 書式文字列（静的な寿命が必要）
+  int32_t m_category = 0;          ///< SDL_LOG_CATEGORY_*
+  uint16_t m_size = 0;             ///< ヘッダーを含むレコード全体のバイト数
+  Level m_level = Level::Info;
+};
+
+// 出力スレッドはタイムスタンプだけを先に読んで並べ替える
+static_assert(offsetof(RecordHeader, m_timestamp) == 0,
+              "m_timestamp must be the first member");
+
+/** @brief 1レコードの最大バイト数 */
+constexpr size_t MAX_RECORD_SIZE = 1024;
+
+/** @brief 1つの文字列引数の最大バイト数（超えた分は切り詰め） */
+constexpr size_t MAX_STRING_SIZE = 255;
+
+/** @brief 引数の種類 */
+enum class ArgKind : uint8_t {
+  Int,      ///< 符号付き整数（int64_tで保持）
+  UInt,     ///< 符号なし整数（uint64_tで保持）
+  Double,   ///< 浮動小数点数
+  Pointer,  ///< ポインター（%p）
+  String,   ///< 文字列（内容をコピー）
+};
+
+/**
+ * @brief 引数をレコードへ書き込む
+ *
+ * 各引数は 種類(1) + 元の型のバイト数(1) + 値 の形で書き込みます。
+ * 文字列は長さ(2) + 内容で、書き込める分だけ残して切り詰めます。
+ */
+class ArgWriter {
+ public:
+  ArgWriter(uint8_t* data, size_t capacity)
+      : m_data(data), m_capacity(capacity) {}
+
+  size_t size() const { return m_size; }
+
+  template <typename T>
+  void write(T value) {
+    using U = std::decay_t<T>;
+    if constexpr (std::is_same_v<U, const char*> || std::is_same_v<U, char*>) {
+      write_string(value ? value : "(null)");
+    } else if constexpr (std::is_pointer_v<U> ||
+                         std::is_same_v<U, std::nullptr_t>) {
+      write_value(ArgKind::Pointer, sizeof(void*),
+                  static_cast<uint64_t>(reinterpret_cast<uintptr_t>(
+                      static_cast<const void*>(value))));
+    } else if constexpr (std::is_floating_point_v<U>) {
+      write_value(ArgKind::Double, sizeof(double), static_cast<double>(value));
+    } else if constexpr (std::is_integral_v<U> && std::is_signed_v<U>) {
+      write_value(ArgKind::Int, sizeof(U), static_cast<int64_t>(value));
+    } else if constexpr (std::is_integral_v<U>) {
+      write_value(ArgKind::UInt, sizeof(U), static_cast<uint64_t>(value));
+    } else {
+      static_assert(std::is_integral_v<U>, "unsupported log argument type");
+    }
+  }
+
+ private:
+  template <typename V>
+  void write_value(ArgKind kind, size_t width, V value) {
+    if (m_size + 2 + sizeof(V) > m_capacity) {
+      return;
+    }
+    m_data[m_size++] = static_cast<uint8_t>(kind);
+    m_data[m_size++] = static_cast<uint8_t>(width);
+    std::memcpy(m_data + m_size, &value, sizeof(V));
+    m_size += sizeof(V);
+  }
+
+  void write_string(const char* value) {
+    if (m_size + 2 + sizeof(uint16_t) > m_capacity) {
+      return;
+    }
+    const size_t room = m_capacity - m_size - 2 - sizeof(uint16_t);
+    const auto length = static_cast<uint16_t>(
+        strnlen(value, std::min(room, MAX_STRING_SIZE)));
+    m_data[m_size++] = static_cast<uint8_t>(ArgKind::String);
+    m_data[m_size++] = 0;
+    std::memcpy(m_data + m_size, &length, sizeof(length));
+    m_size += sizeof(length);
+    std::memcpy(m_data + m_size, value, length);
+    m_size += length;
+  }
+
+  uint8_t* m_data;
+  size_t m_capacity;
+  size_t m_size = 0;
+};
+
+/** @brief 読み出した1つの引数 */
+struct Arg {
+  ArgKind m_kind = ArgKind::Int;
+  uint8_t m_width = 0;  ///< 元の型のバイト数（整数のみ）
+  int64_t m_int = 0;
+  uint64_t m_uint = 0;
+  double m_double = 0.0;
+  const char* m_string = nullptr;  ///< 終端文字はないのでm_lengthを使う
+  uint16_t m_length = 0;
+};
+
+/**
+ * @brief レコードから引数を順に読み出す
+ */
+class ArgReader {
+ public:
+  ArgReader(const uint8_t* data, size_t size) : m_data(data), m_size(size) {}
+
+  /** @brief 次の引数を読み出す（残っていなければfalse） */
+  bool next(Arg& arg) {
+    if (m_pos + 2 > m_size) {
+      return false;
+    }
+    arg.m_kind = static_cast<ArgKind>(m_data[m_pos++]);
+    arg.m_width = m_data[m_pos++];
+    switch (arg.m_kind) {
+      case ArgKind::Int:
+        return read(arg.m_int);
+      case ArgKind::UInt:
+      case ArgKind::Pointer:
+        return read(arg.m_uint);
+      case ArgKind::Double:
+        return read(arg.m_double);
+      case ArgKind::String:
+        if (!read(arg.m_length) || m_pos + arg.m_length > m_size) {
+          return false;
+        }
+        arg.m_string = reinterpret_cast<const char*>(m_data + m_pos);
+        m_pos += arg.m_length;
+        return true;
+    }
+    return false;
+  }
+
+ private:
+  template <typename V>
+  bool read(V& value) {
+    if (m_pos + sizeof(V) > m_size) {
+      return false;
+    }
+    std::memcpy(&value, m_data + m_pos, sizeof(V));
+    m_pos += sizeof(V);
+    return true;
+  }
+
+  const uint8_t* m_data;
+  size_t m_size;
+  size_t m_pos = 0;
+};
+
+/**
+ * @brief レコードを組み立てる
+ * @param buffer MAX_RECORD_SIZEバイト以上の領域
+ * @return レコード全体のバイト数
+ */
+template <typename... Args>
+size_t encode_record(uint8_t* buffer,
+                     uint64_t timestamp,
+                     Level level,
+                     int category,
+                     const char* format,
+                     const Args&... args) {
+  ArgWriter writer(buffer + sizeof(RecordHeader),
+                   MAX_RECORD_SIZE - sizeof(RecordHeader));
+  (writer.write(args), ...);
+
+  RecordHeader header;
+  header.m_timestamp = timestamp;
+  header.m_format = format;
+  header.m_category = static_cast<int32_t>(category);
+  header.m_size = static_cast<uint16_t>(sizeof(RecordHeader) + writer.size());
+  header.m_level = level;
+  std::memcpy(buffer, &header, sizeof(header));
+  return header.m_size;
+}
+
+}  // namespace detail
+}  // namespace s6i_log
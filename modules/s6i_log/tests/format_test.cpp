@@ -0,0 +1,90 @@
+#include <cstdint>
+#include <string>
+
+#include "pch.h"
+
+namespace {
+
+using namespace s6i_log;
+
+/** レコードに組み立ててから整形し直す（出力スレッドと同じ経路） */
+template <typename... Args>
+std::string round_trip(const char* format, const Args&... args) {
+  uint8_t record[detail::MAX_RECORD_SIZE];
+  const size_t size = detail::encode_record(record, 0, Level::Info, 0, format,
+                                            args...);
+  detail::RecordHeader header;
+  std::memcpy(&header, record, sizeof(header));
+  EXPECT_EQ(header.m_size, size);
+  EXPECT_EQ(header.m_format, format);
+
+  detail::ArgReader reader(record + sizeof(header), size - sizeof(header));
+  char text[detail::MAX_MESSAGE_SIZE];
+  const size_t length =
+      detail::format_message(header.m_format, reader, text, sizeof(text));
+  EXPECT_EQ(length, std::strlen(text));
+  return text;
+}
+
+TEST(FormatTest, Integers) {
+  EXPECT_EQ(round_trip("no args"), "no args");
+  EXPECT_EQ(round_trip("%d %i", -42, 7), "-42 7");
+  EXPECT_EQ(round_trip("%u %lu %llu", 1u, 2ul, 3ull), "1 2 3");
+  EXPECT_EQ(round_trip("%zu", sizeof(int64_t)), "8");
+  EXPECT_EQ(round_trip("%5d|%-5d|%05d", 12, 12, 12), "   12|12   |00012");
+  EXPECT_EQ(round_trip("%c%c", 'o', 'k'), "ok");
+  // 符号付きの値を%xで出すと元の型の幅になる
+  EXPECT_EQ(round_trip("%x %hhx", -1, static_cast<signed char>(-1)),
+            "ffffffff ff");
+  EXPECT_EQ(round_trip("%lld", INT64_MIN), std::to_string(INT64_MIN));
+  EXPECT_EQ(round_trip("%d%%", 100), "100%");
+}
+
+TEST(FormatTest, FloatsPointersAndStrings) {
+  EXPECT_EQ(round_trip("%.3f %g", 3.14159, 0.5f), "3.142 0.5");
+  EXPECT_EQ(round_trip("%*.*f", 8, 2, 1.5), "    1.50");
+
+  int value = 0;
+  char expected[32];
+  std::snprintf(expected, sizeof(expected), "%p", static_cast<void*>(&value));
+  EXPECT_EQ(round_trip("%p", static_cast<void*>(&value)), expected);
+
+  // 文字列は内容をコピーするので、呼び出し後に書き換えても影響しない
+  char name[] = "window";
+  uint8_t record[detail::MAX_RECORD_SIZE];
+  const size_t size =
+      detail::encode_record(record, 0, Level::Info, 0, "[%s]", name);
+  name[0] = 'W';
+  detail::ArgReader reader(record + sizeof(detail::RecordHeader),
+                           size - sizeof(detail::RecordHeader));
+  char text[64];
+  detail::format_message("[%s]", reader, text, sizeof(text));
+  EXPECT_STREQ(text, "[window]");
+
+  EXPECT_EQ(round_trip("%-8s|%.3s", "ab", "abcdef"), "ab      |abc");
+  EXPECT_EQ(round_trip("%s", static_cast<const char*>(nullptr)), "(null)");
+}
+
+TEST(FormatTest, Truncation) {
+  // 長すぎる文字列は切り詰める
+  const std::string long_text(1000, 'x');
+  EXPECT_EQ(round_trip("%s", long_text.c_str()),
+            std::string(detail::MAX_STRING_SIZE, 'x'));
+
+  // 出力先が小さいときは切り捨てて終端する
+  uint8_t record[detail::MAX_RECORD_SIZE];
+  const size_t size =
+      detail::encode_record(record, 0, Level::Info, 0, "%d-%s", 12345, "abc");
+  detail::ArgReader reader(record + sizeof(detail::RecordHeader),
+                           size - sizeof(detail::RecordHeader));
+  char text[6];
+  EXPECT_EQ(detail::format_message("%d-%s", reader, text, sizeof(text)), 5u);
+  EXPECT_STREQ(text, "12345");
+}
+
+TEST(FormatTest, MissingArguments) {
+  // 引数が足りない変換指定はそのまま出力する
+  EXPECT_EQ(round_trip("%d and %s", 1), "1 and %s");
+}
+
+}  // namespace
@@ -0,0 +1,127 @@
+#include <benchmark/benchmark.h>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <random>
+#include <vector>
+#include "s6i_memory/frame_arena.h"
+#include "s6i_memory/linear_arena.h"
+
+#if defined(__GLIBC__)
+#include <malloc.h>
+#endif
+
+namespace {
+
+using namespace s6i_memory;
+
+// 1フレームあたりの確保回数
+constexpr size_t ALLOCATIONS_PER_FRAME = 10000;
+// 次のフレームまで生き残る確保の割合（1/n）
+constexpr size_t SURVIVOR_INTERVAL = 16;
+
+/** 1フレーム分の確保の大きさ（16〜256バイト、毎フレーム同じ並び） */
+std::vector<size_t> make_sizes() {
+  std::mt19937 rng(12345);
+  std::uniform_int_distribution<size_t> dist(16, 256);
+  std::vector<size_t> sizes(ALLOCATIONS_PER_FRAME);
+  for (auto& size : sizes) {
+    size = dist(rng);
+  }
+  return sizes;
+}
+
+size_t total_size(const std::vector<size_t>& sizes) {
+  size_t total = 0;
+  for (size_t size : sizes) {
+    total += size;
+  }
+  return total;
+}
+
+#if defined(__GLIBC__)
+/** ヒープのうち空きとして抱えている割合（断片化の目安） */
+double heap_fragmentation() {
+  const struct mallinfo2 info = mallinfo2();
+  const size_t heap = info.uordblks + info.fordblks;
+  return heap == 0 ? 0.0 : static_cast<double>(info.fordblks) / heap;
+}
+#endif
+
+/**
+ * 1フレーム: システムアロケーター
+ * 一部の確保は次のフレームまで残し、フレームをまたぐデータを再現する
+ */
+void BM_FrameSystemAllocator(benchmark::State& state) {
+  const auto sizes = make_sizes();
+  std::vector<void*> frame(ALLOCATIONS_PER_FRAME, nullptr);
+  std::vector<void*> survivors;
+  std::vector<void*> previous;
+
+  for (auto _ : state) {
+    for (size_t i = 0; i < ALLOCATIONS_PER_FRAME; ++i) {
+      void* p = ::operator new(sizes[i]);
+      std::memset(p, 0, 16);
+      frame[i] = p;
+    }
+    benchmark::DoNotOptimize(frame.data());
+
+    // 前のフレームの生き残りを捨て、今のフレームの一部を残す
+    for (void* p : previous) {
+      ::operator delete(p);
+    }
+    previous.clear();
+    for (size_t i = 0; i < ALLOCATIONS_PER_FRAME; ++i) {
+      if (i % SURVIVOR_INTERVAL == 0) {
+        previous.push_back(frame[i]);
+      } else {
+        ::operator delete(frame[i]);
+      }
+    }
+  }
+
+#if defined(__GLIBC__)
+  // 生き残りが散らばっているため、空いた領域をOSに返せず抱えたままになる
+  state.counters["fragmentation"] = heap_fragmentation();
+#endif
+  for (void* p : previous) {
+    ::operator delete(p);
+  }
+  state.SetItemsProcessed(state.iterations() * ALLOCATIONS_PER_FRAME);
+  state.counters["requested_bytes"] = static_cast<double>(total_size(sizes));
+}
+BENCHMARK(BM_FrameSystemAllocator);
+
+/**
+ * 1フレーム: FrameArena
+ * 生き残りはprevious()側にそのまま残るので、個別の解放はない
+ */
+void BM_FrameLinearArena(benchmark::State& state) {
+  const auto sizes = make_sizes();
+  const size_t requested = total_size(sizes);
+  auto frames = FrameArena::make(requested + requested / 8).unwrap();
+  std::vector<void*> frame(ALLOCATIONS_PER_FRAME, nullptr);
+
+  for (auto _ : state) {
+    frames.next_frame();
+    LinearArena& arena = frames.current();
+    for (size_t i = 0; i < ALLOCATIONS_PER_FRAME; ++i) {
+      void* p = arena.allocate(sizes[i]).unwrap();
+      std::memset(p, 0, 16);
+      frame[i] = p;
+    }
+    benchmark::DoNotOptimize(frame.data());
+  }
+
+  // 穴はできず、無駄になるのは詰め物と使わなかった容量だけ
+  const LinearArena& arena = frames.current();
+  state.counters["padding"] =
+      static_cast<double>(arena.peak() - requested) / arena.peak();
+  state.counters["unused_capacity"] =
+      static_cast<double>(arena.capacity() - arena.peak()) / arena.capacity();
+  state.SetItemsProcessed(state.iterations() * ALLOCATIONS_PER_FRAME);
+  state.counters["requested_bytes"] = static_cast<double>(requested);
+}
+BENCHMARK(BM_FrameLinearArena);
+
+}  // namespace
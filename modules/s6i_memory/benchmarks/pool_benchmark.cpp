@@ -0,0 +1,84 @@
+#include <benchmark/benchmark.h>
+#include <cstdint>
+#include <optional>
+#include "s6i_memory/pool.h"
+
+namespace {
+
+using namespace s6i_memory;
+
+// 最大スレッド数
+constexpr int MAX_THREADS = 32;
+// 1スレッドが1回にまとめて作って捨てる個数
+constexpr int BATCH = 64;
+
+/** パーティクル程度の大きさのオブジェクト */
+struct Particle {
+  float m_position[3];
+  float m_velocity[3];
+  float m_color[4];
+  int32_t m_life;
+  int32_t m_flags;
+};
+
+/** 作って捨てるのを繰り返す（allocateとfreeの組を1件と数える） */
+template <typename Create, typename Destroy>
+void churn(benchmark::State& state, Create create, Destroy destroy) {
+  Particle* objects[BATCH];
+  for (auto _ : state) {
+    for (int i = 0; i < BATCH; ++i) {
+      objects[i] = create();
+      objects[i]->m_life = i;
+    }
+    benchmark::DoNotOptimize(objects);
+    for (int i = 0; i < BATCH; ++i) {
+      destroy(objects[i]);
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * BATCH);
+}
+
+/** 比較用: new/delete */
+void BM_ChurnNewDelete(benchmark::State& state) {
+  churn(
+      state, []() { return new Particle(); },
+      [](Particle* p) { delete p; });
+}
+BENCHMARK(BM_ChurnNewDelete)->ThreadRange(1, MAX_THREADS)->UseRealTime();
+
+std::optional<Pool<Particle>>& shared_pool() {
+  static std::optional<Pool<Particle>> pool;
+  return pool;
+}
+
+void churn_pool(benchmark::State& state, uint32_t cache_size) {
+  if (state.thread_index() == 0) {
+    PoolDesc desc;
+    desc.m_capacity = MAX_THREADS * (BATCH + cache_size) * 2;
+    desc.m_thread_count = MAX_THREADS;
+    desc.m_cache_size = cache_size;
+    shared_pool().emplace(Pool<Particle>::make(desc).unwrap());
+  }
+  churn(
+      state, []() { return shared_pool()->create().unwrap(); },
+      [](Particle* p) { shared_pool()->destroy(p); });
+  // ループの後は他のスレッドを待たないため、スレッド0以外はプールに触れない
+  if (state.thread_index() == 0) {
+    state.counters["chunks"] = shared_pool()->chunk_count();
+    shared_pool().reset();
+  }
+}
+
+/** Pool: スレッドごとのキャッシュあり */
+void BM_ChurnPool(benchmark::State& state) {
+  churn_pool(state, 32);
+}
+BENCHMARK(BM_ChurnPool)->ThreadRange(1, MAX_THREADS)->UseRealTime();
+
+/** Pool: キャッシュなし（毎回共有の空きリストを使う） */
+void BM_ChurnPoolNoCache(benchmark::State& state) {
+  churn_pool(state, 0);
+}
+BENCHMARK(BM_ChurnPoolNoCache)->ThreadRange(1, MAX_THREADS)->UseRealTime();
+
+}  // namespace
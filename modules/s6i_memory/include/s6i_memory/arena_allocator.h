@@ -0,0 +1,109 @@
+#pragma once
+
+#include <SDL.h>
+#include <s6i_log/log.h>
+#include <cstddef>
+#include <cstdlib>
+#include <type_traits>
+#include <vector>
+#include "linear_arena.h"
+
+namespace s6i_memory {
+
+/**
+ * @brief LinearArenaから確保する標準コンテナ用のアロケーター
+ *
+ * deallocate()は何もしません。コンテナが伸びるたびに古い領域は
+ * アリーナに残るため、要素数の見当が付くならreserve()してください。
+ * コンテナはアリーナのreset()より前に使い終えること。
+ *
+ * 例外を使わないため、アリーナが足りなければログを出して終了します。
+ * 代入やswapではアロケーターも移るので、別のフレームのアリーナから
+ * 作ったコンテナを代入し直して使い回せます。
+ *
+ * @tparam T 要素の型
+ */
+template <typename T>
+class ArenaAllocator {
+ public:
+  using value_type = T;
+  using propagate_on_container_copy_assignment = std::true_type;
+  using propagate_on_container_move_assignment = std::true_type;
+  using propagate_on_container_swap = std::true_type;
+
+  /**
+   * @param arena 確保元のアリーナ
+   * @param site 確保した場所として記録する場所（既定はアロケーターを作った場所）
+   */
+  explicit ArenaAllocator(
+      LinearArena& arena,
+      [[maybe_unused]] const tracking::AllocSite& site =
+          tracking::AllocSite::current())
+      : m_arena(&arena) {
+#if S6I_MEMORY_TRACKING
+    m_site = site;
+#endif
+  }
+
+  template <typename U>
+  ArenaAllocator(const ArenaAllocator<U>& other) : m_arena(other.arena()) {
+#if S6I_MEMORY_TRACKING
+    m_site = other.site();
+#endif
+  }
+
+  T* allocate(size_t n) {
+    if (n > static_cast<size_t>(-1) / sizeof(T)) {
+      fail(n);
+    }
+    auto memory = m_arena->allocate(n * sizeof(T), alignof(T), site());
+    if (memory.is_err()) {
+      fail(n);
+    }
+    return static_cast<T*>(memory.unwrap());
+  }
+
+  void deallocate(T*, size_t) {}
+
+  /** @brief 確保元のアリーナ */
+  LinearArena* arena() const { return m_arena; }
+
+  /** @brief 確保した場所として記録する場所 */
+  tracking::AllocSite site() const {
+#if S6I_MEMORY_TRACKING
+    return m_site;
+#else
+    return tracking::AllocSite("");
+#endif
+  }
+
+  template <typename U>
+  bool operator==(const ArenaAllocator<U>& other) const {
+    return m_arena == other.arena();
+  }
+
+  template <typename U>
+  bool operator!=(const ArenaAllocator<U>& other) const {
+    return m_arena != other.arena();
+  }
+
+ private:
+  [[noreturn]] void fail(size_t n) const {
+    S6I_LOG_CRITICAL(SDL_LOG_CATEGORY_SYSTEM,
+                     "LinearArena is full: %zu bytes requested, %zu of %zu "
+                     "bytes used",
+                     n * sizeof(T), m_arena->used(), m_arena->capacity());
+    std::abort();
+  }
+
+  LinearArena* m_arena;
+#if S6I_MEMORY_TRACKING
+  tracking::AllocSite m_site = tracking::AllocSite("");
+#endif
+};
+
+/** @brief LinearArenaから確保するstd::vector */
+template <typename T>
+using ArenaVector = std::vector<T, ArenaAllocator<T>>;
+
+}  // namespace s6i_memory
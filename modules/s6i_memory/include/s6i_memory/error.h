@@ -0,0 +1,34 @@
+#pragma once
+
+#include <s6i_result/niche.h>
+
+namespace s6i_memory {
+
+/**
+ * @brief メモリ管理に関するエラー型
+ */
+enum class MemoryError {
+  // アリーナ関連エラー
+  AllocationError,    ///< アリーナやプールの領域の確保に失敗
+  ArenaFullError,     ///< アリーナの残りが足りない
+  InvalidArenaError,  ///< 無効なアリーナへの操作
+
+  // ThreadArenas関連エラー
+  NoThreadSlotError,  ///< スレッドに割り当てるアリーナが残っていない
+
+  // Pool関連エラー
+  InvalidPoolError,  ///< 無効なプールへの操作、または不正な設定
+  PoolFullError,     ///< プールの容量を使い切った
+};
+
+}  // namespace s6i_memory
+
+/**
+ * @brief MemoryErrorの範囲外の値をResultのタグとして使う
+ */
+template <>
+struct s6i_result::NicheTraits<s6i_memory::MemoryError> {
+  static constexpr bool enabled = true;
+  static constexpr s6i_memory::MemoryError value =
+      static_cast<s6i_memory::MemoryError>(-1);
+};
@@ -0,0 +1,100 @@
+#pragma once
+
+#include <s6i_result/result.h>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include "error.h"
+#include "linear_arena.h"
+
+namespace s6i_memory {
+
+/**
+ * @brief フレームごとに交互に使う2つのLinearArena
+ *
+ * next_frame()で使うアリーナを入れ替え、新しく使う側だけをreset()します。
+ * 前のフレームで確保したデータはprevious()側に残るため、
+ * 1フレーム遅れて読まれるデータ（描画スレッドに渡すコマンドや、
+ * 前フレームとの差分を取る結果など）をそのまま置けます。
+ * 2フレーム前のデータは上書きされます。
+ */
+class FrameArena {
+ public:
+  /**
+   * @brief 新しいFrameArenaを作成
+   * @param capacity 1フレーム分の容量（バイト、同じ大きさを2つ確保する）
+   * @param tag 使用量を数えるタグ（S6I_MEMORY_TRACKINGが有効なとき）
+   * @return 成功時: 作成されたFrameArena、失敗時: エラー
+   */
+  static s6i_result::Result<FrameArena, MemoryError> make(
+      size_t capacity,
+      tracking::MemoryTag tag = tracking::ARENA_TAG) {
+    auto first = LinearArena::make(capacity, tag);
+    if (first.is_err()) {
+      return s6i_result::make_err(first.unwrap_err());
+    }
+    auto second = LinearArena::make(capacity, tag);
+    if (second.is_err()) {
+      return s6i_result::make_err(second.unwrap_err());
+    }
+    return s6i_result::make_ok(
+        FrameArena(std::move(first.unwrap()), std::move(second.unwrap())));
+  }
+
+  // コピー禁止
+  FrameArena(const FrameArena&) = delete;
+  FrameArena& operator=(const FrameArena&) = delete;
+
+  // ムーブ可能
+  FrameArena(FrameArena&& other)
+      : m_arenas{std::move(other.m_arenas[0]), std::move(other.m_arenas[1])},
+        m_frame(std::exchange(other.m_frame, 0)) {}
+
+  FrameArena& operator=(FrameArena&& other) {
+    FrameArena(std::move(other)).swap(*this);
+    return *this;
+  }
+
+  /** @brief 有効なアリーナかどうか（ムーブ元は無効） */
+  bool is_valid() const { return m_arenas[0].is_valid(); }
+
+  /** @brief 今のフレームのアリーナ */
+  LinearArena& current() { return m_arenas[m_frame & 1]; }
+  const LinearArena& current() const { return m_arenas[m_frame & 1]; }
+
+  /** @brief 前のフレームのアリーナ（前のフレームで確保したデータが残る） */
+  LinearArena& previous() { return m_arenas[(m_frame + 1) & 1]; }
+  const LinearArena& previous() const { return m_arenas[(m_frame + 1) & 1]; }
+
+  /**
+   * @brief 次のフレームへ進める
+   * 2フレーム前のアリーナをreset()して今のフレームのアリーナにします
+   */
+  void next_frame() {
+    ++m_frame;
+    current().reset();
+  }
+
+  /** @brief next_frame()を呼んだ回数 */
+  uint64_t frame() const { return m_frame; }
+
+  void swap(FrameArena& other) {
+    using std::swap;
+    swap(m_arenas[0], other.m_arenas[0]);
+    swap(m_arenas[1], other.m_arenas[1]);
+    swap(m_frame, other.m_frame);
+  }
+
+ private:
+  FrameArena(LinearArena&& first, LinearArena&& second)
+      : m_arenas{std::move(first), std::move(second)} {}
+
+  LinearArena m_arenas[2];
+  uint64_t m_frame = 0;
+};
+
+inline void swap(FrameArena& lhs, FrameArena& rhs) {
+  lhs.swap(rhs);
+}
+
+}  // namespace s6i_memory
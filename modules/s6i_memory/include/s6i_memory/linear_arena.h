@@ -0,0 +1,237 @@
+#pragma once
+
+#include <s6i_result/result.h>
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include "error.h"
+#include "tracking.h"
+
+namespace s6i_memory {
+
+/**
+ * @brief 先頭から順に切り出すだけのアリーナ（バンプアロケーター）
+ *
+ * 確保は位置を進めるだけで、個別の解放はありません。
+ * reset()で全体をまとめて捨てるため、フレームごとの描画リストや
+ * 作業用バッファのように、寿命が揃った一時データに向いています。
+ * 断片化は起きず、無駄になるのはアラインメントの詰め物だけです。
+ *
+ * 容量は作成時に固定され、足りなければArenaFullErrorになります。
+ * peak()で実際に使った最大量を確認して容量を決めてください。
+ * デストラクターは呼ばれないため、create()できるのは
+ * トリビアルに破棄できる型だけです。
+ * スレッドセーフではありません（スレッドごとにはThreadArenasを使う）。
+ */
+class LinearArena {
+ public:
+  /**
+   * @brief 新しいLinearArenaを作成
+   * @param capacity 容量（バイト）
+   * @param tag 使用量を数えるタグ（S6I_MEMORY_TRACKINGが有効なとき）
+   * @return 成功時: 作成されたLinearArena、失敗時: エラー
+   */
+  static s6i_result::Result<LinearArena, MemoryError> make(
+      size_t capacity,
+      tracking::MemoryTag tag = tracking::ARENA_TAG) {
+    std::unique_ptr<std::byte[]> buffer(new (std::nothrow) std::byte[capacity]);
+    if (!buffer) {
+      return s6i_result::make_err(MemoryError::AllocationError);
+    }
+    return s6i_result::make_ok(LinearArena(std::move(buffer), capacity, tag));
+  }
+
+#if S6I_MEMORY_TRACKING
+  ~LinearArena() { tracking::on_free(m_tag, m_offset); }
+#endif
+
+  // コピー禁止
+  LinearArena(const LinearArena&) = delete;
+  LinearArena& operator=(const LinearArena&) = delete;
+
+  // ムーブ可能（ムーブ元から確保した領域はムーブ先に引き継がれる）
+  LinearArena(LinearArena&& other)
+      : m_buffer(std::move(other.m_buffer)),
+        m_capacity(std::exchange(other.m_capacity, 0)),
+        m_offset(std::exchange(other.m_offset, 0)),
+        m_peak(std::exchange(other.m_peak, 0)) {
+#if S6I_MEMORY_TRACKING
+    m_tag = other.m_tag;
+#endif
+  }
+
+  LinearArena& operator=(LinearArena&& other) {
+    LinearArena(std::move(other)).swap(*this);
+    return *this;
+  }
+
+  /** @brief 有効なアリーナかどうか（ムーブ元は無効） */
+  bool is_valid() const { return m_buffer != nullptr; }
+
+  /**
+   * @brief 領域を切り出す
+   * @param size 大きさ（バイト）
+   * @param align アラインメント（2の累乗）
+   * @param site 確保した場所（S6I_MEMORY_TRACKINGが有効なときに記録）
+   * @return 成功時: 領域の先頭、失敗時: エラー
+   */
+  s6i_result::Result<void*, MemoryError> allocate(
+      size_t size,
+      size_t align = alignof(std::max_align_t),
+      [[maybe_unused]] const tracking::AllocSite& site =
+          tracking::AllocSite::current()) {
+    assert(align != 0 && (align & (align - 1)) == 0 &&
+           "Alignment must be a power of two");
+    if (!m_buffer) {
+      return s6i_result::make_err(MemoryError::InvalidArenaError);
+    }
+    const auto base = reinterpret_cast<uintptr_t>(m_buffer.get());
+    const uintptr_t aligned = (base + m_offset + align - 1) & ~(align - 1);
+    const size_t begin = aligned - base;
+    if (begin > m_capacity || size > m_capacity - begin) {
+      return s6i_result::make_err(MemoryError::ArenaFullError);
+    }
+#if S6I_MEMORY_TRACKING
+    // 詰め物も含めて数え、reset()で捨てる量と揃える
+    tracking::on_allocate(m_tag, begin + size - m_offset, site);
+#endif
+    m_offset = begin + size;
+    m_peak = std::max(m_peak, m_offset);
+    return s6i_result::make_ok(static_cast<void*>(m_buffer.get() + begin));
+  }
+
+  /**
+   * @brief Tを1つ構築する
+   * 確保した場所はTごとにまとめて記録します（場所を分けるならcreate_at()）
+   * @param args Tのコンストラクター引数
+   * @return 成功時: 構築したT、失敗時: エラー
+   */
+  template <typename T, typename... Args>
+  s6i_result::Result<T*, MemoryError> create(Args&&... args) {
+    return create_at<T>(tracking::AllocSite::of_type<T>(),
+                        std::forward<Args>(args)...);
+  }
+
+  /**
+   * @brief 確保した場所を指定してTを1つ構築する
+   * @param site 確保した場所（AllocSite::current()など）
+   * @param args Tのコンストラクター引数
+   * @return 成功時: 構築したT、失敗時: エラー
+   */
+  template <typename T, typename... Args>
+  s6i_result::Result<T*, MemoryError> create_at(
+      const tracking::AllocSite& site,
+      Args&&... args) {
+    static_assert(std::is_trivially_destructible_v<T>,
+                  "LinearArena never runs destructors");
+    auto memory = allocate(sizeof(T), alignof(T), site);
+    if (memory.is_err()) {
+      return s6i_result::make_err(memory.unwrap_err());
+    }
+    return s6i_result::make_ok(new (memory.unwrap())
+                                   T(std::forward<Args>(args)...));
+  }
+
+  /**
+   * @brief Tの配列を確保し、値初期化する
+   * @param count 要素数
+   * @param site 確保した場所（S6I_MEMORY_TRACKINGが有効なときに記録）
+   * @return 成功時: 配列の先頭、失敗時: エラー
+   */
+  template <typename T>
+  s6i_result::Result<T*, MemoryError> create_array(
+      size_t count,
+      const tracking::AllocSite& site = tracking::AllocSite::current()) {
+    static_assert(std::is_trivially_destructible_v<T>,
+                  "LinearArena never runs destructors");
+    if (count > m_capacity / std::max<size_t>(sizeof(T), 1)) {
+      return s6i_result::make_err(MemoryError::ArenaFullError);
+    }
+    auto memory = allocate(sizeof(T) * count, alignof(T), site);
+    if (memory.is_err()) {
+      return s6i_result::make_err(memory.unwrap_err());
+    }
+    auto* array = static_cast<T*>(memory.unwrap());
+    for (size_t i = 0; i < count; ++i) {
+      new (array + i) T();
+    }
+    return s6i_result::make_ok(array);
+  }
+
+  /**
+   * @brief 全体を捨てて先頭から使い直す
+   * デバッグビルドでは捨てた領域を0xcdで埋め、
+   * reset()後に古いポインターを使うと気付けるようにします
+   */
+  void reset() {
+#if S6I_MEMORY_TRACKING
+    tracking::on_free(m_tag, m_offset);
+#endif
+#if !defined(NDEBUG)
+    if (m_buffer) {
+      std::memset(m_buffer.get(), 0xcd, m_offset);
+    }
+#endif
+    m_offset = 0;
+  }
+
+  /** @brief 容量（バイト） */
+  size_t capacity() const { return m_capacity; }
+
+  /** @brief 使用量（バイト、詰め物を含む） */
+  size_t used() const { return m_offset; }
+
+  /** @brief 残り（バイト、次の確保の詰め物で減ることがある） */
+  size_t remaining() const { return m_capacity - m_offset; }
+
+  /** @brief 作成してからの使用量の最大値（バイト） */
+  size_t peak() const { return m_peak; }
+
+  /** @brief pがこのアリーナの領域を指しているかどうか */
+  bool owns(const void* p) const {
+    const auto* bytes = static_cast<const std::byte*>(p);
+    return m_buffer && bytes >= m_buffer.get() &&
+           bytes < m_buffer.get() + m_capacity;
+  }
+
+  void swap(LinearArena& other) {
+    using std::swap;
+    swap(m_buffer, other.m_buffer);
+    swap(m_capacity, other.m_capacity);
+    swap(m_offset, other.m_offset);
+    swap(m_peak, other.m_peak);
+#if S6I_MEMORY_TRACKING
+    swap(m_tag, other.m_tag);
+#endif
+  }
+
+ private:
+  LinearArena(std::unique_ptr<std::byte[]>&& buffer,
+              size_t capacity,
+              [[maybe_unused]] tracking::MemoryTag tag)
+      : m_buffer(std::move(buffer)), m_capacity(capacity) {
+#if S6I_MEMORY_TRACKING
+    m_tag = tag;
+#endif
+  }
+
+  std::unique_ptr<std::byte[]> m_buffer;
+  size_t m_capacity = 0;
+  size_t m_offset = 0;
+  size_t m_peak = 0;
+#if S6I_MEMORY_TRACKING
+  tracking::MemoryTag m_tag;
+#endif
+};
+
+inline void swap(LinearArena& lhs, LinearArena& rhs) {
+  lhs.swap(rhs);
+}
+
+}  // namespace s6i_memory
@@ -0,0 +1,513 @@
+#pragma once
+
+#include <s6i_result/result.h>
+#include <s6i_sync/backoff.h>
+#include <s6i_sync/cache_padded.h>
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <thread>
+#include <utility>
+#include "error.h"
+#include "tracking.h"
+
+namespace s6i_memory {
+
+/**
+ * @brief Poolの設定
+ */
+struct PoolDesc {
+  /** @brief 最大の個数（チャンクの大きさの倍数に切り上げる） */
+  size_t m_capacity = 4096;
+  /** @brief 1チャンクの個数（足りなくなるとチャンク単位で確保する） */
+  uint32_t m_chunk_size = 256;
+  /** @brief キャッシュを持てるスレッド数（0ならハードウェアスレッド数） */
+  uint32_t m_thread_count = 0;
+  /** @brief 1スレッドのキャッシュの個数（0ならキャッシュを使わない） */
+  uint32_t m_cache_size = 32;
+  /** @brief 使用量を数えるタグ（S6I_MEMORY_TRACKINGが有効なとき） */
+  tracking::MemoryTag m_tag = tracking::POOL_TAG;
+};
+
+namespace detail {
+
+/** @brief Poolごとの通し番号（アドレスの再利用と区別するため） */
+inline uint64_t next_pool_serial() {
+  static std::atomic<uint64_t> s_next{1};
+  return s_next.fetch_add(1, std::memory_order_relaxed);
+}
+
+/** @brief 直近に使ったPoolと、そこでのこのスレッドのキャッシュ */
+struct PoolCacheEntry {
+  uint64_t m_serial = 0;
+  void* m_cache = nullptr;
+};
+
+/** @brief スレッドごとに覚えておくPoolの数 */
+constexpr size_t POOL_CACHE_ENTRY_COUNT = 8;
+
+/**
+ * @brief スレッドが直近に使ったPoolの表
+ * すべてのエントリーを探し、なければ順番に上書きする
+ */
+struct PoolCacheEntries {
+  PoolCacheEntry m_entries[POOL_CACHE_ENTRY_COUNT];
+  size_t m_next = 0;  ///< 次に上書きするエントリー
+
+  PoolCacheEntry* find(uint64_t serial) {
+    for (PoolCacheEntry& entry : m_entries) {
+      if (entry.m_serial == serial) {
+        return &entry;
+      }
+    }
+    return nullptr;
+  }
+
+  void insert(uint64_t serial, void* cache) {
+    m_entries[m_next] = {serial, cache};
+    m_next = (m_next + 1) % POOL_CACHE_ENTRY_COUNT;
+  }
+};
+inline thread_local PoolCacheEntries t_pool_caches;
+
+}  // namespace detail
+
+/**
+ * @brief 固定サイズのオブジェクトプール（スレッドセーフ）
+ *
+ * エンティティやパーティクルのように頻繁に作っては捨てる型のためのものです。
+ * 領域はチャンク単位でまとめて確保し、空きはロックフリーの
+ * 空きリストで管理します。空きリストの先頭には世代を持たせ、
+ * 取り出しと戻しが交差しても取り違えません（ABA対策）。
+ *
+ * 各スレッドは空きを少しだけ手元のキャッシュに持ち、
+ * 大半のcreate()/destroy()は共有の空きリストに触れずに済みます。
+ * キャッシュを持てるのは最初の m_thread_count スレッドだけで、
+ * それ以外のスレッドは共有の空きリストを直接使います。
+ * 他のスレッドのキャッシュに残っている空きは使えないため、
+ * 容量ちょうどまで使い切る前にPoolFullErrorになることがあります。
+ *
+ * 終了するスレッドはflush_local()でキャッシュを返却してください。
+ * プールを破棄する前に、作ったオブジェクトはすべてdestroy()すること。
+ *
+ * @tparam T 要素の型
+ */
+template <typename T>
+class Pool {
+ public:
+  /**
+   * @brief 新しいPoolを作成
+   * 最初のチャンクは初めてcreate()したときに確保します
+   * @param desc 設定
+   * @return 成功時: 作成されたPool、失敗時: エラー
+   */
+  static s6i_result::Result<Pool, MemoryError> make(
+      const PoolDesc& desc = PoolDesc()) {
+    if (desc.m_capacity == 0 || desc.m_chunk_size == 0) {
+      return s6i_result::make_err(MemoryError::InvalidPoolError);
+    }
+    const size_t chunk_count =
+        (desc.m_capacity + desc.m_chunk_size - 1) / desc.m_chunk_size;
+    if (chunk_count > NIL / desc.m_chunk_size) {
+      return s6i_result::make_err(MemoryError::InvalidPoolError);
+    }
+    uint32_t thread_count = desc.m_thread_count;
+    if (thread_count == 0) {
+      thread_count = std::max(1u, std::thread::hardware_concurrency());
+    }
+    if (desc.m_cache_size == 0) {
+      thread_count = 0;
+    }
+
+    Pool pool;
+    pool.m_chunks.reset(new (std::nothrow)
+                            std::unique_ptr<Slot[]>[chunk_count]);
+    if (!pool.m_chunks) {
+      return s6i_result::make_err(MemoryError::AllocationError);
+    }
+    pool.m_max_chunks = static_cast<uint32_t>(chunk_count);
+    pool.m_chunk_size = desc.m_chunk_size;
+    if (thread_count > 0) {
+      pool.m_caches.reset(
+          new (std::nothrow) s6i_sync::CachePadded<ThreadCache>[thread_count]);
+      if (!pool.m_caches) {
+        return s6i_result::make_err(MemoryError::AllocationError);
+      }
+      for (uint32_t i = 0; i < thread_count; ++i) {
+        pool.m_caches[i]->m_items.reset(new (std::nothrow)
+                                            uint32_t[desc.m_cache_size]);
+        if (!pool.m_caches[i]->m_items) {
+          return s6i_result::make_err(MemoryError::AllocationError);
+        }
+      }
+      pool.m_cache_count = thread_count;
+      pool.m_cache_size = desc.m_cache_size;
+    }
+    pool.m_serial = detail::next_pool_serial();
+#if S6I_MEMORY_TRACKING
+    pool.m_tag = desc.m_tag;
+#endif
+    return s6i_result::make_ok(std::move(pool));
+  }
+
+  // コピー禁止
+  Pool(const Pool&) = delete;
+  Pool& operator=(const Pool&) = delete;
+
+  // ムーブ可能（ムーブ中に他のスレッドが使っていてはいけない）
+  Pool(Pool&& other)
+      : m_head(std::in_place,
+               other.m_head->exchange(pack(NIL, 0),
+                                      std::memory_order_relaxed)),
+        m_chunk_count(
+            other.m_chunk_count.exchange(0, std::memory_order_relaxed)),
+        m_chunks(std::move(other.m_chunks)),
+        m_max_chunks(std::exchange(other.m_max_chunks, 0)),
+        m_chunk_size(std::exchange(other.m_chunk_size, 0)),
+        m_caches(std::move(other.m_caches)),
+        m_cache_count(std::exchange(other.m_cache_count, 0)),
+        m_cache_size(std::exchange(other.m_cache_size, 0)),
+        m_serial(std::exchange(other.m_serial, 0)) {
+#if S6I_MEMORY_TRACKING
+    m_tag = other.m_tag;
+#endif
+  }
+
+  Pool& operator=(Pool&& other) {
+    Pool(std::move(other)).swap(*this);
+    return *this;
+  }
+
+  /** @brief 有効なプールかどうか（ムーブ元は無効） */
+  bool is_valid() const { return m_chunks != nullptr; }
+
+  /**
+   * @brief Tを1つ構築する
+   * 確保した場所はTごとにまとめて記録します（場所を分けるならcreate_at()）
+   * @param args Tのコンストラクター引数
+   * @return 成功時: 構築したT、失敗時: エラー
+   */
+  template <typename... Args>
+  s6i_result::Result<T*, MemoryError> create(Args&&... args) {
+    return create_at(tracking::AllocSite::of_type<T>(),
+                     std::forward<Args>(args)...);
+  }
+
+  /**
+   * @brief 確保した場所を指定してTを1つ構築する
+   * @param site 確保した場所（AllocSite::current()など）
+   * @param args Tのコンストラクター引数
+   * @return 成功時: 構築したT、失敗時: エラー
+   */
+  template <typename... Args>
+  s6i_result::Result<T*, MemoryError> create_at(
+      [[maybe_unused]] const tracking::AllocSite& site,
+      Args&&... args) {
+    if (!m_chunks) {
+      return s6i_result::make_err(MemoryError::InvalidPoolError);
+    }
+    auto index = acquire();
+    if (index.is_err()) {
+      return s6i_result::make_err(index.unwrap_err());
+    }
+#if S6I_MEMORY_TRACKING
+    tracking::on_allocate(m_tag, sizeof(T), site);
+#endif
+    Slot& slot = slot_at(index.unwrap());
+    return s6i_result::make_ok(new (slot.m_storage)
+                                   T(std::forward<Args>(args)...));
+  }
+
+  /**
+   * @brief create()したTを破棄してプールに戻す
+   * 作ったスレッドとは別のスレッドから呼んでもかまいません
+   * @param object 破棄するオブジェクト
+   */
+  void destroy(T* object) {
+    assert(object && "Cannot destroy null object");
+    Slot* slot = reinterpret_cast<Slot*>(object);
+    assert(slot_at(slot->m_index).m_storage ==
+               reinterpret_cast<std::byte*>(object) &&
+           "Object was not created by this pool");
+    object->~T();
+#if S6I_MEMORY_TRACKING
+    tracking::on_free(m_tag, sizeof(T));
+#endif
+    release(slot->m_index);
+  }
+
+  /**
+   * @brief このスレッドのキャッシュを共有の空きリストに戻す
+   * キャッシュの枠も手放すので、終了するスレッドから呼んでください
+   */
+  void flush_local() {
+    ThreadCache* cache = local_cache();
+    if (!cache) {
+      return;
+    }
+    push_chain(cache->m_items.get(), cache->m_count);
+    cache->m_count = 0;
+    cache->m_owner.store(std::thread::id(), std::memory_order_release);
+    if (detail::PoolCacheEntry* entry = detail::t_pool_caches.find(m_serial)) {
+      *entry = detail::PoolCacheEntry();
+    }
+  }
+
+  /** @brief 最大の個数 */
+  size_t capacity() const {
+    return static_cast<size_t>(m_max_chunks) * m_chunk_size;
+  }
+
+  /** @brief 確保済みのチャンク数 */
+  uint32_t chunk_count() const {
+    return std::min(m_chunk_count.load(std::memory_order_relaxed),
+                    m_max_chunks);
+  }
+
+  void swap(Pool& other) {
+    using std::swap;
+    const uint64_t head = m_head->load(std::memory_order_relaxed);
+    m_head->store(other.m_head->load(std::memory_order_relaxed),
+                  std::memory_order_relaxed);
+    other.m_head->store(head, std::memory_order_relaxed);
+    const uint32_t chunk_count = m_chunk_count.load(std::memory_order_relaxed);
+    m_chunk_count.store(other.m_chunk_count.load(std::memory_order_relaxed),
+                        std::memory_order_relaxed);
+    other.m_chunk_count.store(chunk_count, std::memory_order_relaxed);
+    swap(m_chunks, other.m_chunks);
+    swap(m_max_chunks, other.m_max_chunks);
+    swap(m_chunk_size, other.m_chunk_size);
+    swap(m_caches, other.m_caches);
+    swap(m_cache_count, other.m_cache_count);
+    swap(m_cache_size, other.m_cache_size);
+    swap(m_serial, other.m_serial);
+#if S6I_MEMORY_TRACKING
+    swap(m_tag, other.m_tag);
+#endif
+  }
+
+ private:
+  /** @brief 空きリストの終端 */
+  static constexpr uint32_t NIL = 0xffffffff;
+
+  /**
+   * @brief 1要素分の領域
+   * m_nextはTの領域とは別に置き、古い先頭を読んだスレッドが
+   * 構築中のTと競合しないようにする
+   */
+  struct Slot {
+    alignas(T) std::byte m_storage[sizeof(T)];
+    std::atomic<uint32_t> m_next{NIL};
+    uint32_t m_index = 0;
+  };
+
+  /** @brief 1スレッド分のキャッシュ（空きの番号を積んでおく） */
+  struct ThreadCache {
+    std::atomic<std::thread::id> m_owner{};
+    uint32_t m_count = 0;
+    std::unique_ptr<uint32_t[]> m_items;
+  };
+
+  Pool() = default;
+
+  /** @brief 先頭の番号と世代を1ワードにまとめる */
+  static uint64_t pack(uint32_t index, uint32_t tag) {
+    return (static_cast<uint64_t>(tag) << 32) | index;
+  }
+  static uint32_t index_of(uint64_t head) {
+    return static_cast<uint32_t>(head);
+  }
+  static uint32_t tag_of(uint64_t head) {
+    return static_cast<uint32_t>(head >> 32);
+  }
+
+  Slot& slot_at(uint32_t index) const {
+    return m_chunks[index / m_chunk_size][index % m_chunk_size];
+  }
+
+  /** @brief このスレッドのキャッシュ（持てなければnullptr） */
+  ThreadCache* local_cache() {
+    if (!m_caches) {
+      return nullptr;
+    }
+    if (detail::PoolCacheEntry* entry = detail::t_pool_caches.find(m_serial)) {
+      return static_cast<ThreadCache*>(entry->m_cache);
+    }
+    ThreadCache* cache = find_or_claim(std::this_thread::get_id());
+    detail::t_pool_caches.insert(m_serial, cache);
+    return cache;
+  }
+
+  ThreadCache* find_or_claim(std::thread::id self) {
+    for (uint32_t i = 0; i < m_cache_count; ++i) {
+      if (m_caches[i]->m_owner.load(std::memory_order_acquire) == self) {
+        return &m_caches[i].get();
+      }
+    }
+    for (uint32_t i = 0; i < m_cache_count; ++i) {
+      std::thread::id expected{};
+      if (m_caches[i]->m_owner.compare_exchange_strong(
+              expected, self, std::memory_order_acq_rel)) {
+        return &m_caches[i].get();
+      }
+    }
+    return nullptr;
+  }
+
+  /** @brief 空きを1つ取る（キャッシュ、共有の空きリスト、新しいチャンクの順） */
+  s6i_result::Result<uint32_t, MemoryError> acquire() {
+    ThreadCache* cache = local_cache();
+    if (!cache) {
+      return pop_or_grow();
+    }
+    if (cache->m_count == 0) {
+      // 半分だけ補充し、すぐに戻しても溢れないようにする
+      auto first = pop_or_grow();
+      if (first.is_err()) {
+        return first;
+      }
+      cache->m_items[cache->m_count++] = first.unwrap();
+      const uint32_t refill = std::max(1u, m_cache_size / 2);
+      while (cache->m_count < refill) {
+        const uint32_t index = pop();
+        if (index == NIL) {
+          break;
+        }
+        cache->m_items[cache->m_count++] = index;
+      }
+    }
+    return s6i_result::make_ok(cache->m_items[--cache->m_count]);
+  }
+
+  /** @brief 空きを戻す（キャッシュが一杯なら半分を共有の空きリストへ） */
+  void release(uint32_t index) {
+    ThreadCache* cache = local_cache();
+    if (!cache) {
+      push_chain(&index, 1);
+      return;
+    }
+    if (cache->m_count == m_cache_size) {
+      const uint32_t keep = m_cache_size / 2;
+      push_chain(cache->m_items.get() + keep, cache->m_count - keep);
+      cache->m_count = keep;
+    }
+    cache->m_items[cache->m_count++] = index;
+  }
+
+  s6i_result::Result<uint32_t, MemoryError> pop_or_grow() {
+    const uint32_t index = pop();
+    if (index != NIL) {
+      return s6i_result::make_ok(index);
+    }
+    uint32_t chunk = m_chunk_count.load(std::memory_order_relaxed);
+    do {
+      if (chunk >= m_max_chunks) {
+        // 他のスレッドが戻したばかりの空きがあるかもしれない
+        const uint32_t last = pop();
+        if (last != NIL) {
+          return s6i_result::make_ok(last);
+        }
+        return s6i_result::make_err(MemoryError::PoolFullError);
+      }
+    } while (!m_chunk_count.compare_exchange_weak(
+        chunk, chunk + 1, std::memory_order_relaxed));
+    return grow(chunk);
+  }
+
+  /**
+   * @brief chunk番目のチャンクを確保する
+   * 先頭の要素は呼び出し元に渡し、残りを共有の空きリストに積む
+   */
+  s6i_result::Result<uint32_t, MemoryError> grow(uint32_t chunk) {
+    std::unique_ptr<Slot[]> slots(new (std::nothrow) Slot[m_chunk_size]);
+    if (!slots) {
+      // 番号は予約済みのまま、このチャンクは使わない
+      return s6i_result::make_err(MemoryError::AllocationError);
+    }
+    const uint32_t first = chunk * m_chunk_size;
+    for (uint32_t i = 0; i < m_chunk_size; ++i) {
+      slots[i].m_index = first + i;
+      slots[i].m_next.store(first + i + 1, std::memory_order_relaxed);
+    }
+    m_chunks[chunk] = std::move(slots);
+    if (m_chunk_size > 1) {
+      push_range(first + 1, first + m_chunk_size - 1);
+    }
+    return s6i_result::make_ok(first);
+  }
+
+  /** @brief 空きリストの先頭から1つ取る（空ならNIL） */
+  uint32_t pop() {
+    s6i_sync::Backoff backoff;
+    uint64_t head = m_head->load(std::memory_order_acquire);
+    for (;;) {
+      const uint32_t index = index_of(head);
+      if (index == NIL) {
+        return NIL;
+      }
+      // 他のスレッドに取られた後の古い値を読んでも、世代が変わるのでCASが失敗する
+      const uint32_t next =
+          slot_at(index).m_next.load(std::memory_order_relaxed);
+      if (m_head->compare_exchange_weak(head, pack(next, tag_of(head) + 1),
+                                       std::memory_order_acquire,
+                                       std::memory_order_acquire)) {
+        return index;
+      }
+      backoff.snooze();
+    }
+  }
+
+  /** @brief indicesをつないで空きリストの先頭にまとめて積む */
+  void push_chain(const uint32_t* indices, uint32_t count) {
+    if (count == 0) {
+      return;
+    }
+    for (uint32_t i = 0; i + 1 < count; ++i) {
+      slot_at(indices[i]).m_next.store(indices[i + 1],
+                                       std::memory_order_relaxed);
+    }
+    push_range(indices[0], indices[count - 1]);
+  }
+
+  /** @brief firstからlastまでつながった列を空きリストの先頭に積む */
+  void push_range(uint32_t first, uint32_t last) {
+    s6i_sync::Backoff backoff;
+    std::atomic<uint32_t>& tail = slot_at(last).m_next;
+    uint64_t head = m_head->load(std::memory_order_relaxed);
+    for (;;) {
+      tail.store(index_of(head), std::memory_order_relaxed);
+      if (m_head->compare_exchange_weak(head, pack(first, tag_of(head) + 1),
+                                       std::memory_order_release,
+                                       std::memory_order_relaxed)) {
+        return;
+      }
+      backoff.snooze();
+    }
+  }
+
+  // 空きリストの先頭（スレッド間で奪い合うので他のメンバーと別のラインに置く）
+  s6i_sync::CachePadded<std::atomic<uint64_t>> m_head{std::in_place,
+                                                      pack(NIL, 0)};
+  std::atomic<uint32_t> m_chunk_count{0};
+  std::unique_ptr<std::unique_ptr<Slot[]>[]> m_chunks;
+  uint32_t m_max_chunks = 0;
+  uint32_t m_chunk_size = 0;
+  std::unique_ptr<s6i_sync::CachePadded<ThreadCache>[]> m_caches;
+  uint32_t m_cache_count = 0;
+  uint32_t m_cache_size = 0;
+  uint64_t m_serial = 0;
+#if S6I_MEMORY_TRACKING
+  tracking::MemoryTag m_tag;
+#endif
+};
+
+template <typename T>
+inline void swap(Pool<T>& lhs, Pool<T>& rhs) {
+  lhs.swap(rhs);
+}
+
+}  // namespace s6i_memory
@@ -0,0 +1,9 @@
+#pragma once
+
+#include "arena_allocator.h"
+#include "error.h"
+#include "frame_arena.h"
+#include "linear_arena.h"
+#include "pool.h"
+#include "thread_arenas.h"
+#include "tracking.h"
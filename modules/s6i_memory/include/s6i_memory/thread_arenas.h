@@ -0,0 +1,178 @@
+#pragma once
+
+#include <s6i_result/result.h>
+#include <s6i_sync/cache_padded.h>
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <thread>
+#include <utility>
+#include "error.h"
+#include "linear_arena.h"
+
+namespace s6i_memory {
+
+namespace detail {
+
+/** @brief ThreadArenasごとの通し番号（アドレスの再利用と区別するため） */
+inline uint64_t next_thread_arenas_serial() {
+  static std::atomic<uint64_t> s_next{1};
+  return s_next.fetch_add(1, std::memory_order_relaxed);
+}
+
+/** @brief 直前に使ったThreadArenasと、そこでのこのスレッドのアリーナ */
+struct ThreadArenaCache {
+  uint64_t m_serial = 0;
+  LinearArena* m_arena = nullptr;
+};
+inline thread_local ThreadArenaCache t_thread_arena;
+
+}  // namespace detail
+
+/**
+ * @brief スレッドごとのLinearArena
+ *
+ * ワーカーがジョブの中で一時データを確保するためのものです。
+ * 各スレッドは最初にlocal()を呼んだときに空いているアリーナを1つ受け取り、
+ * 以降は同じアリーナを使います。アリーナはスレッドごとに別なので、
+ * 確保にロックは要りません。
+ *
+ * reset()は全アリーナを捨てます。フレームの終わりなど、
+ * どのスレッドも確保していないときに呼ぶこと。
+ * スレッドが終了してもアリーナは返却されないため、
+ * 長く動くワーカーのように決まったスレッドで使ってください。
+ */
+class ThreadArenas {
+ public:
+  /**
+   * @brief 新しいThreadArenasを作成
+   * @param thread_count 使うスレッドの最大数
+   * @param capacity 1スレッド分の容量（バイト）
+   * @param tag 使用量を数えるタグ（S6I_MEMORY_TRACKINGが有効なとき）
+   * @return 成功時: 作成されたThreadArenas、失敗時: エラー
+   */
+  static s6i_result::Result<ThreadArenas, MemoryError> make(
+      size_t thread_count,
+      size_t capacity,
+      tracking::MemoryTag tag = tracking::ARENA_TAG) {
+    ThreadArenas arenas(thread_count);
+    for (size_t i = 0; i < thread_count; ++i) {
+      auto arena = LinearArena::make(capacity, tag);
+      if (arena.is_err()) {
+        return s6i_result::make_err(arena.unwrap_err());
+      }
+      arenas.m_slots[i]->m_arena.emplace(std::move(arena.unwrap()));
+    }
+    return s6i_result::make_ok(std::move(arenas));
+  }
+
+  // コピー禁止
+  ThreadArenas(const ThreadArenas&) = delete;
+  ThreadArenas& operator=(const ThreadArenas&) = delete;
+
+  // ムーブ可能（各スレッドのアリーナはムーブ先に引き継がれる）
+  ThreadArenas(ThreadArenas&& other)
+      : m_slots(std::move(other.m_slots)),
+        m_slot_count(std::exchange(other.m_slot_count, 0)),
+        m_serial(std::exchange(other.m_serial, 0)) {}
+
+  ThreadArenas& operator=(ThreadArenas&& other) {
+    ThreadArenas(std::move(other)).swap(*this);
+    return *this;
+  }
+
+  /** @brief 有効かどうか（ムーブ元は無効） */
+  bool is_valid() const { return m_slots != nullptr; }
+
+  /** @brief スレッドの最大数 */
+  size_t thread_count() const { return m_slot_count; }
+
+  /**
+   * @brief 現在のスレッドのアリーナ
+   * 初めて呼んだスレッドには空いているアリーナを割り当てます
+   * @return 成功時: アリーナ、失敗時: エラー
+   */
+  s6i_result::Result<LinearArena*, MemoryError> local() {
+    if (!m_slots) {
+      return s6i_result::make_err(MemoryError::InvalidArenaError);
+    }
+    detail::ThreadArenaCache& cache = detail::t_thread_arena;
+    if (cache.m_serial == m_serial) {
+      return s6i_result::make_ok(cache.m_arena);
+    }
+    LinearArena* arena = find_or_claim(std::this_thread::get_id());
+    if (!arena) {
+      return s6i_result::make_err(MemoryError::NoThreadSlotError);
+    }
+    cache = {m_serial, arena};
+    return s6i_result::make_ok(arena);
+  }
+
+  /** @brief 全スレッドのアリーナを捨てる（確保中のスレッドがないときに呼ぶ） */
+  void reset() {
+    for (size_t i = 0; i < m_slot_count; ++i) {
+      m_slots[i]->m_arena->reset();
+    }
+  }
+
+  /** @brief 全スレッドの使用量の合計（バイト） */
+  size_t used() const {
+    size_t total = 0;
+    for (size_t i = 0; i < m_slot_count; ++i) {
+      total += m_slots[i]->m_arena->used();
+    }
+    return total;
+  }
+
+  void swap(ThreadArenas& other) {
+    using std::swap;
+    swap(m_slots, other.m_slots);
+    swap(m_slot_count, other.m_slot_count);
+    swap(m_serial, other.m_serial);
+  }
+
+ private:
+  /** @brief 1スレッド分（隣のスレッドの確保位置と同じラインに乗らない） */
+  struct Slot {
+    std::atomic<std::thread::id> m_owner{};
+    std::optional<LinearArena> m_arena;
+  };
+
+  explicit ThreadArenas(size_t thread_count)
+      : m_slots(std::make_unique<s6i_sync::CachePadded<Slot>[]>(thread_count)),
+        m_slot_count(thread_count),
+        m_serial(detail::next_thread_arenas_serial()) {}
+
+  /**
+   * @brief このスレッドのアリーナを探し、なければ空きを取る
+   * キャッシュが他のThreadArenasに上書きされた後もここで見つかる
+   */
+  LinearArena* find_or_claim(std::thread::id self) {
+    for (size_t i = 0; i < m_slot_count; ++i) {
+      if (m_slots[i]->m_owner.load(std::memory_order_acquire) == self) {
+        return &*m_slots[i]->m_arena;
+      }
+    }
+    for (size_t i = 0; i < m_slot_count; ++i) {
+      std::thread::id expected{};
+      if (m_slots[i]->m_owner.compare_exchange_strong(
+              expected, self, std::memory_order_acq_rel)) {
+        return &*m_slots[i]->m_arena;
+      }
+    }
+    return nullptr;
+  }
+
+  std::unique_ptr<s6i_sync::CachePadded<Slot>[]> m_slots;
+  size_t m_slot_count = 0;
+  uint64_t m_serial = 0;
+};
+
+inline void swap(ThreadArenas& lhs, ThreadArenas& rhs) {
+  lhs.swap(rhs);
+}
+
+}  // namespace s6i_memory
@@ -0,0 +1,764 @@
+#pragma once
+
+#include <SDL.h>
+#include <s6i_log/log.h>
+#include <s6i_sync/mutex_policy.h>
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <utility>
+#include <vector>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+/**
+ * @brief メモリ確保の追跡を有効にするかどうか
+ *
+ * 1にするとタグごとの使用量、フレームごとの確保回数、確保した場所の
+ * ヒストグラムを集計し、予算を超えたタグをログに出します。
+ * 0（既定）では追跡用のコードとメンバーはすべて取り除かれます。
+ * 翻訳単位ごとに値が異なるとODR違反になるため、CMakeの
+ * SDL_SANDBOX_ENABLE_MEMORY_TRACKINGで一括して切り替えてください
+ * （cpp_baseがRelease/MinSizeRel以外のときだけ1にします）。
+ */
+#ifndef S6I_MEMORY_TRACKING
+#define S6I_MEMORY_TRACKING 0
+#endif
+
+namespace s6i_memory {
+namespace tracking {
+
+/**
+ * @brief 使用量を分けて数えるためのタグ
+ * register_tag()で作ります。追跡が無効なときは空の構造体です。
+ */
+struct MemoryTag {
+#if S6I_MEMORY_TRACKING
+  uint32_t m_index = 0;
+
+  constexpr explicit MemoryTag(uint32_t index = 0) : m_index(index) {}
+#else
+  constexpr explicit MemoryTag(uint32_t /*index*/ = 0) {}
+#endif
+};
+
+/** @brief どのタグにも属さないグローバルなoperator newの確保 */
+inline constexpr MemoryTag GLOBAL_TAG{0};
+/** @brief タグを指定しなかったLinearArenaの確保 */
+inline constexpr MemoryTag ARENA_TAG{1};
+/** @brief タグを指定しなかったPoolの確保 */
+inline constexpr MemoryTag POOL_TAG{2};
+
+/**
+ * @brief 確保した場所
+ *
+ * 既定引数のAllocSite::current()で呼び出し元のファイルと行を記録します。
+ * 文字列を渡すと、その文字列をラベルとして使います（行は0）。
+ * 追跡が無効なときは空の構造体です。
+ */
+struct AllocSite {
+#if S6I_MEMORY_TRACKING
+  const char* m_label = "";
+  uint32_t m_line = 0;
+  const void* m_address = nullptr;  ///< operator newの呼び出し元のアドレス
+
+  constexpr AllocSite(const char* label, uint32_t line = 0)
+      : m_label(label), m_line(line) {}
+
+  static constexpr AllocSite current(const char* file = __builtin_FILE(),
+                                     uint32_t line = __builtin_LINE()) {
+    return AllocSite(file, line);
+  }
+
+  /** @brief ファイルと行の分からない呼び出し元（operator new） */
+  static constexpr AllocSite from_address(const void* address) {
+    AllocSite site("");
+    site.m_address = address;
+    return site;
+  }
+
+  /**
+   * @brief 呼び出し元の分からない型付きの確保（Tごとにまとめる）
+   * ラベルは型名を含む関数名です
+   */
+  template <typename T>
+  static AllocSite of_type() {
+#if defined(_MSC_VER)
+    return AllocSite(__FUNCSIG__);
+#else
+    return AllocSite(__PRETTY_FUNCTION__);
+#endif
+  }
+#else
+  constexpr AllocSite(const char* /*label*/, uint32_t /*line*/ = 0) {}
+
+  static constexpr AllocSite current() { return AllocSite(""); }
+
+  static constexpr AllocSite from_address(const void* /*address*/) {
+    return AllocSite("");
+  }
+
+  template <typename T>
+  static constexpr AllocSite of_type() {
+    return AllocSite("");
+  }
+#endif
+};
+
+/**
+ * @brief 1つのタグの集計結果
+ * 最大使用量はend_frame()の時点で見た値の最大です
+ */
+struct TagStats {
+  MemoryTag m_tag = GLOBAL_TAG;
+  const char* m_name = "";
+  size_t m_live_bytes = 0;         ///< 使用中のバイト数
+  size_t m_peak_bytes = 0;         ///< 使用中のバイト数の最大値
+  size_t m_budget_bytes = 0;       ///< 予算（0なら無制限）
+  uint64_t m_allocations = 0;      ///< 確保回数の合計
+  uint64_t m_frame_allocations = 0;  ///< 直前のフレームの確保回数
+};
+
+/** @brief 1つの場所の集計結果 */
+struct SiteStats {
+  const char* m_label = "";
+  uint32_t m_line = 0;
+  const void* m_address = nullptr;
+  uint64_t m_allocations = 0;  ///< 確保回数
+  uint64_t m_bytes = 0;        ///< 確保したバイト数の合計
+};
+
+/** @brief 追跡が有効かどうか */
+constexpr bool is_enabled() {
+  return S6I_MEMORY_TRACKING != 0;
+}
+
+#if S6I_MEMORY_TRACKING
+
+namespace detail {
+
+/** @brief 登録できるタグの数 */
+constexpr uint32_t MAX_TAGS = 32;
+
+/**
+ * @brief タグの名前と、フレームをまたいで持つ集計値
+ * operator newが静的初期化より先に呼ばれても使えるよう、定数で初期化する
+ */
+struct TagTable {
+  std::atomic<uint32_t> m_count{3};
+  const char* m_names[MAX_TAGS] = {"global", "arena", "pool"};
+  std::atomic<size_t> m_budgets[MAX_TAGS] = {};
+  std::atomic<size_t> m_peaks[MAX_TAGS] = {};
+  std::atomic<uint64_t> m_frame_base[MAX_TAGS] = {};
+  std::atomic<uint64_t> m_frame_allocations[MAX_TAGS] = {};
+  std::atomic<bool> m_over_budget[MAX_TAGS] = {};
+};
+inline TagTable g_tags;
+
+/**
+ * @brief 所有スレッドだけが書き込むカウンター
+ * 読むのは集計するスレッドだけなので、ロック付きの加算は要らない
+ */
+inline void add(std::atomic<uint64_t>& counter, uint64_t value) {
+  counter.store(counter.load(std::memory_order_relaxed) + value,
+                std::memory_order_relaxed);
+}
+
+struct TagCounters {
+  std::atomic<uint64_t> m_allocated_bytes{0};
+  std::atomic<uint64_t> m_freed_bytes{0};
+  std::atomic<uint64_t> m_allocations{0};
+};
+
+struct SiteRecord {
+  std::atomic<const char*> m_label{nullptr};
+  uint32_t m_line = 0;
+  const void* m_address = nullptr;
+  std::atomic<uint64_t> m_allocations{0};
+  std::atomic<uint64_t> m_bytes{0};
+};
+
+/** @brief 表に入りきらなかった場所をまとめるラベル */
+inline constexpr const char OTHER_SITE_LABEL[] = "(other)";
+
+/**
+ * @brief スレッドごとの集計バッファ
+ *
+ * 確保した場所は開番地法のハッシュ表に記録します。
+ * operator newのたびに引くため、探すのはMAX_PROBES個までとし、
+ * 見つからず空きもなければ「その他」の枠にまとめて
+ * m_droppedを数えます（dump()に出力されます）。
+ * 登録したバッファは解放せず、スレッド終了後は次に作られたスレッドが
+ * 集計値を引き継いで再利用します。
+ */
+struct ThreadBuffer {
+  static constexpr size_t SITE_CAPACITY = 512;
+  static constexpr size_t MAX_PROBES = 16;
+
+  TagCounters m_tags[MAX_TAGS];
+  SiteRecord m_sites[SITE_CAPACITY];
+  SiteRecord m_other;  ///< 表に入りきらなかった場所の合計
+  std::atomic<uint64_t> m_dropped{0};  ///< m_otherにまとめた回数
+  std::atomic<bool> m_in_use{true};
+  ThreadBuffer* m_next = nullptr;
+
+  ThreadBuffer() { m_other.m_label.store(OTHER_SITE_LABEL); }
+
+  /** @brief siteのエントリーを探す（なければ追加、表が埋まっていればm_other） */
+  SiteRecord* find(const AllocSite& site) {
+    const auto hash = reinterpret_cast<uintptr_t>(site.m_label) ^
+                      reinterpret_cast<uintptr_t>(site.m_address) ^
+                      site.m_line;
+    const size_t index =
+        static_cast<size_t>((hash * 0x9E3779B97F4A7C15ull) >> 32) %
+        SITE_CAPACITY;
+    for (size_t i = 0; i < MAX_PROBES; ++i) {
+      SiteRecord& record = m_sites[(index + i) % SITE_CAPACITY];
+      const char* label = record.m_label.load(std::memory_order_relaxed);
+      if (label == site.m_label && record.m_line == site.m_line &&
+          record.m_address == site.m_address) {
+        return &record;
+      }
+      if (!label) {
+        record.m_line = site.m_line;
+        record.m_address = site.m_address;
+        record.m_label.store(site.m_label, std::memory_order_release);
+        return &record;
+      }
+    }
+    add(m_dropped, 1);
+    return &m_other;
+  }
+};
+
+/** @brief 登録済みのバッファの連結リスト（追加のみ） */
+inline std::atomic<ThreadBuffer*> g_buffers{nullptr};
+
+/**
+ * @brief バッファを返した後のスレッドが使うカウンター
+ * 他のthread_localの破棄で解放されるものなど、複数のスレッドから
+ * 書き込まれるためfetch_addで加算する（場所は記録しない）
+ */
+inline TagCounters g_late_counters[MAX_TAGS];
+
+/** @brief このスレッドのバッファ（返した後はnullptr） */
+inline thread_local ThreadBuffer* t_buffer = nullptr;
+inline thread_local bool t_buffer_released = false;
+
+/**
+ * @brief 空いているバッファを再利用するか、新しく登録する
+ * operator newの中から呼ばれるため、mallocで確保する
+ */
+inline ThreadBuffer* claim_buffer() {
+  for (ThreadBuffer* buffer = g_buffers.load(std::memory_order_acquire);
+       buffer; buffer = buffer->m_next) {
+    bool in_use = false;
+    if (buffer->m_in_use.compare_exchange_strong(in_use, true,
+                                                 std::memory_order_acquire)) {
+      return buffer;
+    }
+  }
+  void* memory = std::malloc(sizeof(ThreadBuffer));
+  if (!memory) {
+    std::abort();
+  }
+  auto* buffer = new (memory) ThreadBuffer();
+  buffer->m_next = g_buffers.load(std::memory_order_relaxed);
+  while (!g_buffers.compare_exchange_weak(buffer->m_next, buffer,
+                                          std::memory_order_release,
+                                          std::memory_order_relaxed)) {
+  }
+  return buffer;
+}
+
+/** @brief スレッド終了時にバッファを返す */
+struct BufferHolder {
+  BufferHolder() { t_buffer = claim_buffer(); }
+
+  ~BufferHolder() {
+    ThreadBuffer* buffer = std::exchange(t_buffer, nullptr);
+    t_buffer_released = true;
+    buffer->m_in_use.store(false, std::memory_order_release);
+  }
+};
+
+/** @brief このスレッドのバッファ（スレッドの終了処理中はnullptr） */
+inline ThreadBuffer* current_buffer() {
+  if (t_buffer || t_buffer_released) {
+    return t_buffer;
+  }
+  static thread_local BufferHolder holder;
+  return t_buffer;
+}
+
+/** @brief TagScopeで指定された、このスレッドのoperator newのタグ */
+inline thread_local uint32_t t_current_tag = 0;
+
+/** @brief 全スレッドのタグごとの値を合計する */
+template <typename Getter>
+uint64_t sum(uint32_t tag, Getter getter) {
+  uint64_t total =
+      getter(g_late_counters[tag]).load(std::memory_order_relaxed);
+  for (ThreadBuffer* buffer = g_buffers.load(std::memory_order_acquire);
+       buffer; buffer = buffer->m_next) {
+    total += getter(buffer->m_tags[tag]).load(std::memory_order_relaxed);
+  }
+  return total;
+}
+
+/** @brief タグの使用中のバイト数（他のスレッドが解放した分を含めて合計する） */
+inline size_t live_bytes(uint32_t tag) {
+  const uint64_t allocated = sum(
+      tag, [](TagCounters& c) -> auto& { return c.m_allocated_bytes; });
+  const uint64_t freed =
+      sum(tag, [](TagCounters& c) -> auto& { return c.m_freed_bytes; });
+  // 読んでいる間に確保と解放が進むと、一時的に解放が上回ることがある
+  return allocated > freed ? static_cast<size_t>(allocated - freed) : 0;
+}
+
+inline uint64_t allocations(uint32_t tag) {
+  return sum(tag, [](TagCounters& c) -> auto& { return c.m_allocations; });
+}
+
+/**
+ * @brief operator newで確保した領域の直前に置く情報
+ * アラインメントを指定した確保では、mallocの結果と返す領域の間に
+ * 詰め物が入るため、解放用にmallocの結果を覚えておく
+ */
+struct alignas(std::max_align_t) AllocHeader {
+  void* m_block;
+  size_t m_size;
+  uint32_t m_tag;
+};
+
+inline void* tracked_new(size_t size,
+                         size_t alignment,
+                         bool nothrow,
+                         const void* caller);
+inline void tracked_delete(void* pointer);
+
+}  // namespace detail
+
+/**
+ * @brief タグを登録する
+ * 同じ名前のタグがあればそれを返します（予算は上書きしない）
+ * @param name タグの名前（文字列リテラルなど、ずっと有効なもの）
+ * @param budget_bytes 予算（0なら無制限）
+ * @return タグ（登録できる数を超えたらGLOBAL_TAG）
+ */
+inline MemoryTag register_tag(const char* name, size_t budget_bytes = 0) {
+  static s6i_sync::SpinMutexPolicy s_lock =
+      std::move(s6i_sync::SpinMutexPolicy::make().unwrap());
+  detail::TagTable& tags = detail::g_tags;
+  s_lock.lock();
+  const uint32_t count = tags.m_count.load(std::memory_order_relaxed);
+  for (uint32_t i = 0; i < count; ++i) {
+    if (std::strcmp(tags.m_names[i], name) == 0) {
+      s_lock.unlock();
+      return MemoryTag(i);
+    }
+  }
+  if (count == detail::MAX_TAGS) {
+    s_lock.unlock();
+    S6I_LOG_WARN(SDL_LOG_CATEGORY_SYSTEM,
+                 "Too many memory tags, '%s' is counted as global", name);
+    return GLOBAL_TAG;
+  }
+  tags.m_names[count] = name;
+  tags.m_budgets[count].store(budget_bytes, std::memory_order_relaxed);
+  tags.m_count.store(count + 1, std::memory_order_release);
+  s_lock.unlock();
+  return MemoryTag(count);
+}
+
+/**
+ * @brief タグの予算を設定する
+ * 使用量が予算を超えると、end_frame()で1度だけ警告を出します
+ * （予算内に戻ると、次に超えたときにまた出します）
+ * @param budget_bytes 予算（0なら無制限）
+ */
+inline void set_budget(MemoryTag tag, size_t budget_bytes) {
+  detail::g_tags.m_budgets[tag.m_index].store(budget_bytes,
+                                              std::memory_order_relaxed);
+}
+
+/**
+ * @brief 確保を記録する（独自のアロケーターから呼ぶ）
+ * @param tag 確保したタグ
+ * @param bytes バイト数
+ * @param site 確保した場所
+ */
+inline void on_allocate(MemoryTag tag,
+                        size_t bytes,
+                        const AllocSite& site = AllocSite::current()) {
+  detail::ThreadBuffer* buffer = detail::current_buffer();
+  if (!buffer) {
+    detail::TagCounters& late = detail::g_late_counters[tag.m_index];
+    late.m_allocated_bytes.fetch_add(bytes, std::memory_order_relaxed);
+    late.m_allocations.fetch_add(1, std::memory_order_relaxed);
+    return;
+  }
+  detail::TagCounters& counters = buffer->m_tags[tag.m_index];
+  detail::add(counters.m_allocated_bytes, bytes);
+  detail::add(counters.m_allocations, 1);
+  detail::SiteRecord* record = buffer->find(site);
+  detail::add(record->m_allocations, 1);
+  detail::add(record->m_bytes, bytes);
+}
+
+/**
+ * @brief 解放を記録する（確保したスレッドと別のスレッドでもよい）
+ * @param tag 確保したときのタグ
+ * @param bytes バイト数
+ */
+inline void on_free(MemoryTag tag, size_t bytes) {
+  detail::ThreadBuffer* buffer = detail::current_buffer();
+  if (!buffer) {
+    detail::g_late_counters[tag.m_index].m_freed_bytes.fetch_add(
+        bytes, std::memory_order_relaxed);
+    return;
+  }
+  detail::add(buffer->m_tags[tag.m_index].m_freed_bytes, bytes);
+}
+
+/**
+ * @brief このスコープの間、このスレッドのoperator newを指定のタグで数える
+ */
+class TagScope {
+ public:
+  explicit TagScope(MemoryTag tag)
+      : m_previous(std::exchange(detail::t_current_tag, tag.m_index)) {}
+
+  ~TagScope() { detail::t_current_tag = m_previous; }
+
+  // コピー・ムーブ禁止
+  TagScope(const TagScope&) = delete;
+  TagScope& operator=(const TagScope&) = delete;
+
+ private:
+  uint32_t m_previous;
+};
+
+/**
+ * @brief フレームの終わりに呼ぶ
+ * 最大使用量とフレームごとの確保回数を更新し、予算を確かめます
+ * 呼ぶのは1つのスレッド（メインスレッドなど）だけにしてください
+ */
+inline void end_frame() {
+  detail::TagTable& tags = detail::g_tags;
+  const uint32_t count = tags.m_count.load(std::memory_order_acquire);
+  for (uint32_t i = 0; i < count; ++i) {
+    const size_t live = detail::live_bytes(i);
+    if (live > tags.m_peaks[i].load(std::memory_order_relaxed)) {
+      tags.m_peaks[i].store(live, std::memory_order_relaxed);
+    }
+    const uint64_t total = detail::allocations(i);
+    tags.m_frame_allocations[i].store(
+        total - tags.m_frame_base[i].load(std::memory_order_relaxed),
+        std::memory_order_relaxed);
+    tags.m_frame_base[i].store(total, std::memory_order_relaxed);
+
+    const size_t budget = tags.m_budgets[i].load(std::memory_order_relaxed);
+    const bool over = budget != 0 && live > budget;
+    if (over != tags.m_over_budget[i].load(std::memory_order_relaxed)) {
+      tags.m_over_budget[i].store(over, std::memory_order_relaxed);
+      if (over) {
+        S6I_LOG_WARN(SDL_LOG_CATEGORY_SYSTEM,
+                     "Memory tag '%s' is over budget: %zu / %zu bytes",
+                     tags.m_names[i], live, budget);
+      }
+    }
+  }
+}
+
+/** @brief 全タグの集計を取得 */
+inline std::vector<TagStats> tag_stats() {
+  const detail::TagTable& tags = detail::g_tags;
+  const uint32_t count = tags.m_count.load(std::memory_order_acquire);
+  std::vector<TagStats> result;
+  result.reserve(count);
+  for (uint32_t i = 0; i < count; ++i) {
+    TagStats stats;
+    stats.m_tag = MemoryTag(i);
+    stats.m_name = tags.m_names[i];
+    stats.m_live_bytes = detail::live_bytes(i);
+    stats.m_peak_bytes = std::max(
+        stats.m_live_bytes, tags.m_peaks[i].load(std::memory_order_relaxed));
+    stats.m_budget_bytes = tags.m_budgets[i].load(std::memory_order_relaxed);
+    stats.m_allocations = detail::allocations(i);
+    stats.m_frame_allocations =
+        tags.m_frame_allocations[i].load(std::memory_order_relaxed);
+    result.push_back(stats);
+  }
+  return result;
+}
+
+/** @brief タグの集計を取得 */
+inline TagStats tag_stats(MemoryTag tag) {
+  return tag_stats()[tag.m_index];
+}
+
+/**
+ * @brief 確保回数の多い順に、上位n個の場所の集計を取得
+ * 全スレッドのバッファを場所ごとにまとめます
+ */
+inline std::vector<SiteStats> top_sites(size_t n) {
+  std::vector<SiteStats> entries;
+  for (detail::ThreadBuffer* buffer =
+           detail::g_buffers.load(std::memory_order_acquire);
+       buffer; buffer = buffer->m_next) {
+    auto merge = [&](detail::SiteRecord& record) {
+      const char* label = record.m_label.load(std::memory_order_acquire);
+      if (!label) {
+        return;
+      }
+      auto it = std::find_if(
+          entries.begin(), entries.end(), [&](const SiteStats& entry) {
+            return entry.m_label == label && entry.m_line == record.m_line &&
+                   entry.m_address == record.m_address;
+          });
+      if (it == entries.end()) {
+        entries.push_back({label, record.m_line, record.m_address, 0, 0});
+        it = entries.end() - 1;
+      }
+      it->m_allocations +=
+          record.m_allocations.load(std::memory_order_relaxed);
+      it->m_bytes += record.m_bytes.load(std::memory_order_relaxed);
+    };
+    for (detail::SiteRecord& record : buffer->m_sites) {
+      merge(record);
+    }
+    if (buffer->m_other.m_allocations.load(std::memory_order_relaxed) != 0) {
+      merge(buffer->m_other);
+    }
+  }
+  std::sort(entries.begin(), entries.end(),
+            [](const SiteStats& lhs, const SiteStats& rhs) {
+              return lhs.m_allocations > rhs.m_allocations;
+            });
+  if (entries.size() > n) {
+    entries.resize(n);
+  }
+  return entries;
+}
+
+/**
+ * @brief 場所の表が埋まっていて、「(other)」にまとめた確保の回数
+ */
+inline uint64_t dropped_sites() {
+  uint64_t total = 0;
+  for (detail::ThreadBuffer* buffer =
+           detail::g_buffers.load(std::memory_order_acquire);
+       buffer; buffer = buffer->m_next) {
+    total += buffer->m_dropped.load(std::memory_order_relaxed);
+  }
+  return total;
+}
+
+/**
+ * @brief タグごとの使用量と、確保回数の多い上位n個の場所をログに出力
+ */
+inline void dump(size_t n = 10) {
+  S6I_LOG_INFO(SDL_LOG_CATEGORY_SYSTEM, "Memory tags:");
+  for (const TagStats& stats : tag_stats()) {
+    S6I_LOG_INFO(SDL_LOG_CATEGORY_SYSTEM,
+                 "  %-12s live=%zu peak=%zu budget=%zu allocations=%llu "
+                 "last_frame=%llu",
+                 stats.m_name, stats.m_live_bytes, stats.m_peak_bytes,
+                 stats.m_budget_bytes,
+                 static_cast<unsigned long long>(stats.m_allocations),
+                 static_cast<unsigned long long>(stats.m_frame_allocations));
+  }
+  S6I_LOG_INFO(SDL_LOG_CATEGORY_SYSTEM, "Top %u allocation sites:",
+               static_cast<unsigned>(n));
+  for (const SiteStats& stats : top_sites(n)) {
+    const char* slash = std::strrchr(stats.m_label, '/');
+    S6I_LOG_INFO(SDL_LOG_CATEGORY_SYSTEM, "  %s:%u %p allocations=%llu "
+                 "bytes=%llu",
+                 slash ? slash + 1 : stats.m_label,
+                 static_cast<unsigned>(stats.m_line), stats.m_address,
+                 static_cast<unsigned long long>(stats.m_allocations),
+                 static_cast<unsigned long long>(stats.m_bytes));
+  }
+  if (const uint64_t count = dropped_sites()) {
+    S6I_LOG_INFO(SDL_LOG_CATEGORY_SYSTEM,
+                 "  (%llu allocations counted as %s: site table full)",
+                 static_cast<unsigned long long>(count),
+                 detail::OTHER_SITE_LABEL);
+  }
+}
+
+namespace detail {
+
+/**
+ * @brief 追跡付きのoperator new（確保したタグと大きさを直前に置く）
+ * @param size バイト数
+ * @param alignment アラインメント（2のべき乗）
+ * @param nothrow trueなら確保できないときにnullptrを返す（falseなら終了する）
+ * @param caller 呼び出し元のアドレス
+ */
+inline void* tracked_new(size_t size,
+                         size_t alignment,
+                         bool nothrow,
+                         const void* caller) {
+  // mallocはalignof(AllocHeader)までしか揃えないので、超える分は詰め物を足す
+  alignment = std::max(alignment, alignof(AllocHeader));
+  const size_t padding =
+      alignment > alignof(AllocHeader) ? alignment - alignof(AllocHeader) : 0;
+  void* block = std::malloc(sizeof(AllocHeader) + padding + size);
+  if (!block) {
+    if (nothrow) {
+      return nullptr;
+    }
+    // 例外を使わないため、確保できなければ終了する
+    std::abort();
+  }
+  const uintptr_t address =
+      (reinterpret_cast<uintptr_t>(block) + sizeof(AllocHeader) +
+       alignment - 1) &
+      ~static_cast<uintptr_t>(alignment - 1);
+  auto* header = reinterpret_cast<AllocHeader*>(address) - 1;
+  header->m_block = block;
+  header->m_size = size;
+  header->m_tag = t_current_tag;
+  on_allocate(MemoryTag(header->m_tag), size, AllocSite::from_address(caller));
+  return header + 1;
+}
+
+inline void tracked_delete(void* pointer) {
+  if (!pointer) {
+    return;
+  }
+  auto* header = static_cast<AllocHeader*>(pointer) - 1;
+  on_free(MemoryTag(header->m_tag), header->m_size);
+  std::free(header->m_block);
+}
+
+}  // namespace detail
+
+#else
+
+inline MemoryTag register_tag(const char* /*name*/,
+                              size_t /*budget_bytes*/ = 0) {
+  return GLOBAL_TAG;
+}
+
+constexpr void set_budget(MemoryTag /*tag*/, size_t /*budget_bytes*/) {}
+
+constexpr void on_allocate(MemoryTag /*tag*/,
+                           size_t /*bytes*/,
+                           const AllocSite& /*site*/ = AllocSite::current()) {}
+
+constexpr void on_free(MemoryTag /*tag*/, size_t /*bytes*/) {}
+
+class TagScope {
+ public:
+  constexpr explicit TagScope(MemoryTag /*tag*/) {}
+
+  // コピー・ムーブ禁止
+  TagScope(const TagScope&) = delete;
+  TagScope& operator=(const TagScope&) = delete;
+};
+
+constexpr void end_frame() {}
+
+inline std::vector<TagStats> tag_stats() {
+  return {};
+}
+
+inline TagStats tag_stats(MemoryTag /*tag*/) {
+  return {};
+}
+
+inline std::vector<SiteStats> top_sites(size_t /*n*/) {
+  return {};
+}
+
+constexpr uint64_t dropped_sites() {
+  return 0;
+}
+
+inline void dump(size_t /*n*/ = 10) {
+  S6I_LOG_INFO(SDL_LOG_CATEGORY_SYSTEM,
+               "Memory tracking is disabled (S6I_MEMORY_TRACKING=0).");
+}
+
+#endif
+
+}  // namespace tracking
+}  // namespace s6i_memory
+
+/**
+ * @brief グローバルなoperator new/deleteを追跡付きに置き換える
+ *
+ * 配列、nothrow、std::align_val_tを取るものを含め、置き換えられる
+ * operator new/deleteをすべて定義します（一部だけ置き換えると、
+ * 置き換えていない側で確保した領域が追跡付きのdeleteに渡ることがあるため）。
+ * 置き換えはプログラム全体で1つしか定義できないため、
+ * main()のある翻訳単位のグローバル名前空間で1度だけ使ってください。
+ * 追跡が無効なときは何も定義しません。
+ */
+#if S6I_MEMORY_TRACKING
+#if defined(_MSC_VER)
+#define S6I_MEMORY_RETURN_ADDRESS() _ReturnAddress()
+#else
+#define S6I_MEMORY_RETURN_ADDRESS() __builtin_return_address(0)
+#endif
+#define S6I_MEMORY_DETAIL_DEFINE_NEW(NAME)                       \
+  void* NAME(std::size_t size) {                                 \
+    return ::s6i_memory::tracking::detail::tracked_new(          \
+        size, alignof(std::max_align_t), false,                  \
+        S6I_MEMORY_RETURN_ADDRESS());                            \
+  }                                                              \
+  void* NAME(std::size_t size, const std::nothrow_t&) noexcept { \
+    return ::s6i_memory::tracking::detail::tracked_new(          \
+        size, alignof(std::max_align_t), true,                   \
+        S6I_MEMORY_RETURN_ADDRESS());                            \
+  }                                                              \
+  void* NAME(std::size_t size, std::align_val_t alignment) {     \
+    return ::s6i_memory::tracking::detail::tracked_new(          \
+        size, static_cast<std::size_t>(alignment), false,        \
+        S6I_MEMORY_RETURN_ADDRESS());                            \
+  }                                                              \
+  void* NAME(std::size_t size, std::align_val_t alignment,       \
+             const std::nothrow_t&) noexcept {                   \
+    return ::s6i_memory::tracking::detail::tracked_new(          \
+        size, static_cast<std::size_t>(alignment), true,         \
+        S6I_MEMORY_RETURN_ADDRESS());                            \
+  }                                                              \
+  static_assert(true, "")
+#define S6I_MEMORY_DETAIL_DEFINE_DELETE(NAME)                        \
+  void NAME(void* pointer) noexcept {                                \
+    ::s6i_memory::tracking::detail::tracked_delete(pointer);         \
+  }                                                                  \
+  void NAME(void* pointer, std::size_t) noexcept {                   \
+    ::s6i_memory::tracking::detail::tracked_delete(pointer);         \
+  }                                                                  \
+  void NAME(void* pointer, const std::nothrow_t&) noexcept {         \
+    ::s6i_memory::tracking::detail::tracked_delete(pointer);         \
+  }                                                                  \
+  void NAME(void* pointer, std::align_val_t) noexcept {              \
+    ::s6i_memory::tracking::detail::tracked_delete(pointer);         \
+  }                                                                  \
+  void NAME(void* pointer, std::size_t, std::align_val_t) noexcept { \
+    ::s6i_memory::tracking::detail::tracked_delete(pointer);         \
+  }                                                                  \
+  void NAME(void* pointer, std::align_val_t,                         \
+            const std::nothrow_t&) noexcept {                        \
+    ::s6i_memory::tracking::detail::tracked_delete(pointer);         \
+  }                                                                  \
+  static_assert(true, "")
+#define S6I_MEMORY_TRACK_GLOBAL_NEW()               \
+  S6I_MEMORY_DETAIL_DEFINE_NEW(operator new);       \
+  S6I_MEMORY_DETAIL_DEFINE_NEW(operator new[]);     \
+  S6I_MEMORY_DETAIL_DEFINE_DELETE(operator delete); \
+  S6I_MEMORY_DETAIL_DEFINE_DELETE(operator delete[])
+#else
+#define S6I_MEMORY_TRACK_GLOBAL_NEW() static_assert(true, "")
+#endif
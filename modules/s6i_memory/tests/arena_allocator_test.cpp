@@ -0,0 +1,66 @@
+#include <algorithm>
+#include <map>
+
+#include "pch.h"
+
+namespace {
+
+using namespace s6i_memory;
+
+TEST(ArenaAllocatorTest, Vector) {
+  auto arena = LinearArena::make(4096).unwrap();
+  ArenaVector<int> values{ArenaAllocator<int>(arena)};
+  values.reserve(100);
+  const size_t used = arena.used();
+  for (int i = 0; i < 100; ++i) {
+    values.push_back(i);
+  }
+  // reserve()済みなら伸びても確保しない
+  EXPECT_EQ(arena.used(), used);
+  EXPECT_TRUE(arena.owns(values.data()));
+  EXPECT_EQ(values[99], 99);
+
+  // 解放しても領域は戻らない
+  values.clear();
+  values.shrink_to_fit();
+  EXPECT_EQ(arena.used(), used);
+}
+
+TEST(ArenaAllocatorTest, NodeContainer) {
+  auto arena = LinearArena::make(4096).unwrap();
+  using Allocator = ArenaAllocator<std::pair<const int, int>>;
+  std::map<int, int, std::less<int>, Allocator> map{Allocator(arena)};
+  for (int i = 0; i < 10; ++i) {
+    map[i] = i * i;
+  }
+  EXPECT_EQ(map.size(), 10u);
+  EXPECT_EQ(map.at(3), 9);
+  EXPECT_TRUE(arena.owns(&*map.begin()));
+}
+
+TEST(ArenaAllocatorTest, Equality) {
+  auto arena1 = LinearArena::make(64).unwrap();
+  auto arena2 = LinearArena::make(64).unwrap();
+  ArenaAllocator<int> a(arena1);
+  ArenaAllocator<float> b(arena1);
+  ArenaAllocator<int> c(arena2);
+  EXPECT_TRUE(a == b);
+  EXPECT_TRUE(a != c);
+  EXPECT_EQ(ArenaAllocator<double>(a).arena(), &arena1);
+}
+
+TEST(ArenaAllocatorTest, MoveAssignmentPropagates) {
+  auto arena1 = LinearArena::make(1024).unwrap();
+  auto arena2 = LinearArena::make(1024).unwrap();
+  ArenaVector<int> values{ArenaAllocator<int>(arena1)};
+  values.assign(8, 1);
+
+  // 別のフレームのアリーナで作り直して代入する
+  values = ArenaVector<int>(4, 2, ArenaAllocator<int>(arena2));
+  EXPECT_EQ(values.get_allocator().arena(), &arena2);
+  EXPECT_TRUE(arena2.owns(values.data()));
+  EXPECT_TRUE(std::all_of(values.begin(), values.end(),
+                          [](int v) { return v == 2; }));
+}
+
+}  // namespace
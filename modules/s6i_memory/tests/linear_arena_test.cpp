@@ -0,0 +1,102 @@
+#include <cstdint>
+
+#include "pch.h"
+
+namespace {
+
+using namespace s6i_memory;
+
+struct Vec3 {
+  float x, y, z;
+};
+
+TEST(LinearArenaTest, BasicFunctionality) {
+  auto arena_result = LinearArena::make(256);
+  ASSERT_TRUE(arena_result.is_ok());
+  auto arena = std::move(arena_result.unwrap());
+  EXPECT_TRUE(arena.is_valid());
+  EXPECT_EQ(arena.capacity(), 256u);
+  EXPECT_EQ(arena.used(), 0u);
+
+  auto a = arena.allocate(10, 1);
+  ASSERT_TRUE(a.is_ok());
+  EXPECT_EQ(arena.used(), 10u);
+  EXPECT_TRUE(arena.owns(a.unwrap()));
+
+  // アラインメントの詰め物が入る
+  auto b = arena.allocate(8, 16);
+  ASSERT_TRUE(b.is_ok());
+  EXPECT_EQ(reinterpret_cast<uintptr_t>(b.unwrap()) % 16, 0u);
+  EXPECT_GE(arena.used(), 18u);
+
+  auto v = arena.create<Vec3>(Vec3{1.0f, 2.0f, 3.0f});
+  ASSERT_TRUE(v.is_ok());
+  EXPECT_EQ(v.unwrap()->y, 2.0f);
+
+  auto ints = arena.create_array<int>(4);
+  ASSERT_TRUE(ints.is_ok());
+  for (int i = 0; i < 4; ++i) {
+    EXPECT_EQ(ints.unwrap()[i], 0);
+  }
+
+  int outside = 0;
+  EXPECT_FALSE(arena.owns(&outside));
+}
+
+TEST(LinearArenaTest, FullAndReset) {
+  auto arena = LinearArena::make(64).unwrap();
+
+  ASSERT_TRUE(arena.allocate(48, 1).is_ok());
+  auto full = arena.allocate(32, 1);
+  ASSERT_TRUE(full.is_err());
+  EXPECT_EQ(full.unwrap_err(), MemoryError::ArenaFullError);
+  EXPECT_TRUE(arena.create_array<uint64_t>(SIZE_MAX / 2).is_err());
+
+  // reset()後は先頭から使い直し、最大使用量は残る
+  arena.reset();
+  EXPECT_EQ(arena.used(), 0u);
+  EXPECT_EQ(arena.remaining(), 64u);
+  EXPECT_EQ(arena.peak(), 48u);
+  EXPECT_TRUE(arena.allocate(64, 1).is_ok());
+  EXPECT_EQ(arena.peak(), 64u);
+}
+
+TEST(LinearArenaTest, MoveSemantics) {
+  auto arena1 = LinearArena::make(128).unwrap();
+  void* p = arena1.allocate(32).unwrap();
+
+  LinearArena arena2 = std::move(arena1);
+  EXPECT_FALSE(arena1.is_valid());
+  EXPECT_TRUE(arena2.is_valid());
+  EXPECT_TRUE(arena2.owns(p));
+  EXPECT_EQ(arena2.used(), 32u);
+
+  auto invalid = arena1.allocate(8);
+  ASSERT_TRUE(invalid.is_err());
+  EXPECT_EQ(invalid.unwrap_err(), MemoryError::InvalidArenaError);
+}
+
+TEST(FrameArenaTest, PreviousFrameSurvives) {
+  auto arena_result = FrameArena::make(128);
+  ASSERT_TRUE(arena_result.is_ok());
+  auto frames = std::move(arena_result.unwrap());
+  EXPECT_EQ(frames.frame(), 0u);
+
+  int* value = frames.current().create<int>(42).unwrap();
+  frames.next_frame();
+  EXPECT_EQ(frames.frame(), 1u);
+  EXPECT_EQ(frames.current().used(), 0u);
+
+  // 1フレーム前のデータは読める
+  EXPECT_TRUE(frames.previous().owns(value));
+  EXPECT_EQ(*value, 42);
+  frames.current().create<int>(7).unwrap();
+
+  // 2フレーム後に同じアリーナが捨てられて再利用される
+  frames.next_frame();
+  EXPECT_TRUE(frames.current().owns(value));
+  EXPECT_EQ(frames.current().used(), 0u);
+  EXPECT_EQ(frames.previous().used(), sizeof(int));
+}
+
+}  // namespace
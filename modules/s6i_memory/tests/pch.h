@@ -0,0 +1,4 @@
+#pragma once
+
+#include <gtest/gtest.h>
+#include <s6i_memory/prelude.h>
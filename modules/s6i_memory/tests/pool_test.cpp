@@ -0,0 +1,188 @@
+#include <atomic>
+#include <set>
+#include <thread>
+#include <vector>
+
+#include "pch.h"
+
+namespace {
+
+using namespace s6i_memory;
+
+struct Particle {
+  float x, y;
+  int life;
+
+  Particle(float x, float y, int life) : x(x), y(y), life(life) {}
+};
+
+/** 生存数を数える型（デストラクターが呼ばれることを確かめる） */
+struct Tracked {
+  static inline std::atomic<int> s_alive{0};
+  Tracked() { s_alive.fetch_add(1); }
+  ~Tracked() { s_alive.fetch_sub(1); }
+};
+
+TEST(PoolTest, BasicFunctionality) {
+  PoolDesc desc;
+  desc.m_capacity = 64;
+  desc.m_chunk_size = 16;
+  auto pool_result = Pool<Particle>::make(desc);
+  ASSERT_TRUE(pool_result.is_ok());
+  auto pool = std::move(pool_result.unwrap());
+  EXPECT_TRUE(pool.is_valid());
+  EXPECT_EQ(pool.capacity(), 64u);
+  EXPECT_EQ(pool.chunk_count(), 0u);
+
+  auto particle = pool.create(1.0f, 2.0f, 30);
+  ASSERT_TRUE(particle.is_ok());
+  EXPECT_EQ(particle.unwrap()->life, 30);
+  EXPECT_EQ(pool.chunk_count(), 1u);
+
+  // 戻した領域が再利用される
+  Particle* p = particle.unwrap();
+  pool.destroy(p);
+  EXPECT_EQ(pool.create(0.0f, 0.0f, 1).unwrap(), p);
+  pool.destroy(p);
+}
+
+TEST(PoolTest, RunsDestructors) {
+  auto pool = Pool<Tracked>::make().unwrap();
+  std::vector<Tracked*> objects;
+  for (int i = 0; i < 10; ++i) {
+    objects.push_back(pool.create().unwrap());
+  }
+  EXPECT_EQ(Tracked::s_alive.load(), 10);
+  for (Tracked* object : objects) {
+    pool.destroy(object);
+  }
+  EXPECT_EQ(Tracked::s_alive.load(), 0);
+}
+
+TEST(PoolTest, CapacityExhausted) {
+  for (uint32_t cache_size : {0u, 4u}) {
+    PoolDesc desc;
+    desc.m_capacity = 10;
+    desc.m_chunk_size = 4;
+    desc.m_cache_size = cache_size;
+    auto pool = Pool<int>::make(desc).unwrap();
+    EXPECT_EQ(pool.capacity(), 12u);
+
+    std::set<int*> objects;
+    for (int i = 0; i < 12; ++i) {
+      objects.insert(pool.create(i).unwrap());
+    }
+    EXPECT_EQ(objects.size(), 12u);
+    EXPECT_EQ(pool.chunk_count(), 3u);
+
+    auto full = pool.create(0);
+    ASSERT_TRUE(full.is_err());
+    EXPECT_EQ(full.unwrap_err(), MemoryError::PoolFullError);
+
+    pool.destroy(*objects.begin());
+    EXPECT_TRUE(pool.create(0).is_ok());
+  }
+}
+
+TEST(PoolTest, ManyPoolsOnOneThread) {
+  // スレッドが覚えておけるより多いPoolを交互に使っても、容量を使い切れる
+  PoolDesc desc;
+  desc.m_capacity = 4;
+  desc.m_chunk_size = 4;
+  desc.m_thread_count = 1;
+  desc.m_cache_size = 4;
+  std::vector<Pool<int>> pools;
+  for (size_t i = 0; i < detail::POOL_CACHE_ENTRY_COUNT + 1; ++i) {
+    pools.push_back(Pool<int>::make(desc).unwrap());
+  }
+
+  std::vector<std::vector<int*>> objects(pools.size());
+  for (int round = 0; round < 4; ++round) {
+    for (size_t i = 0; i < pools.size(); ++i) {
+      objects[i].push_back(pools[i].create(round).unwrap());
+    }
+  }
+  for (size_t i = 0; i < pools.size(); ++i) {
+    EXPECT_TRUE(pools[i].create(0).is_err());
+    for (int* object : objects[i]) {
+      pools[i].destroy(object);
+    }
+    pools[i].flush_local();
+  }
+}
+
+TEST(PoolTest, InvalidDesc) {
+  PoolDesc desc;
+  desc.m_capacity = 0;
+  auto pool = Pool<int>::make(desc);
+  ASSERT_TRUE(pool.is_err());
+  EXPECT_EQ(pool.unwrap_err(), MemoryError::InvalidPoolError);
+}
+
+TEST(PoolTest, ConcurrentChurn) {
+  constexpr int THREAD_COUNT = 8;
+  constexpr int ROUNDS = 200;
+  constexpr int BATCH = 32;
+  PoolDesc desc;
+  desc.m_capacity = THREAD_COUNT * BATCH * 2;
+  desc.m_chunk_size = 64;
+  desc.m_thread_count = THREAD_COUNT / 2;  // 半分はキャッシュなし
+  desc.m_cache_size = 8;
+  auto pool = Pool<Tracked>::make(desc).unwrap();
+
+  std::atomic<bool> failed{false};
+  std::vector<std::thread> threads;
+  for (int t = 0; t < THREAD_COUNT; ++t) {
+    threads.emplace_back([&]() {
+      std::vector<Tracked*> objects;
+      for (int round = 0; round < ROUNDS; ++round) {
+        for (int i = 0; i < BATCH; ++i) {
+          auto object = pool.create();
+          if (object.is_err()) {
+            failed = true;
+            continue;
+          }
+          objects.push_back(object.unwrap());
+        }
+        for (Tracked* object : objects) {
+          pool.destroy(object);
+        }
+        objects.clear();
+      }
+      pool.flush_local();
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  EXPECT_FALSE(failed.load());
+  EXPECT_EQ(Tracked::s_alive.load(), 0);
+
+  // 全スレッドがキャッシュを返したので、容量いっぱいまで使える
+  std::set<Tracked*> objects;
+  for (size_t i = 0; i < pool.capacity(); ++i) {
+    objects.insert(pool.create().unwrap());
+  }
+  EXPECT_EQ(objects.size(), pool.capacity());
+  for (Tracked* object : objects) {
+    pool.destroy(object);
+  }
+}
+
+TEST(PoolTest, MoveSemantics) {
+  auto pool1 = Pool<int>::make().unwrap();
+  int* value = pool1.create(5).unwrap();
+
+  Pool<int> pool2 = std::move(pool1);
+  EXPECT_FALSE(pool1.is_valid());
+  EXPECT_TRUE(pool2.is_valid());
+  EXPECT_EQ(*value, 5);
+  pool2.destroy(value);
+  EXPECT_EQ(pool2.create(6).unwrap(), value);
+
+  auto invalid = pool1.create(0);
+  ASSERT_TRUE(invalid.is_err());
+  EXPECT_EQ(invalid.unwrap_err(), MemoryError::InvalidPoolError);
+}
+
+}  // namespace
@@ -0,0 +1,79 @@
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include "pch.h"
+
+namespace {
+
+using namespace s6i_memory;
+
+TEST(ThreadArenasTest, BasicFunctionality) {
+  auto arenas_result = ThreadArenas::make(2, 256);
+  ASSERT_TRUE(arenas_result.is_ok());
+  auto arenas = std::move(arenas_result.unwrap());
+  EXPECT_EQ(arenas.thread_count(), 2u);
+
+  // 同じスレッドには同じアリーナ
+  LinearArena* local = arenas.local().unwrap();
+  EXPECT_EQ(arenas.local().unwrap(), local);
+  EXPECT_EQ(local->capacity(), 256u);
+
+  local->allocate(100, 1).unwrap();
+  EXPECT_EQ(arenas.used(), 100u);
+  arenas.reset();
+  EXPECT_EQ(arenas.used(), 0u);
+}
+
+TEST(ThreadArenasTest, SeparateArenaPerThread) {
+  constexpr size_t THREAD_COUNT = 4;
+  auto arenas = ThreadArenas::make(THREAD_COUNT, 1024).unwrap();
+
+  std::vector<LinearArena*> seen(THREAD_COUNT, nullptr);
+  std::vector<std::thread> threads;
+  for (size_t i = 0; i < THREAD_COUNT; ++i) {
+    threads.emplace_back([&arenas, &seen, i]() {
+      LinearArena* arena = arenas.local().unwrap();
+      for (int n = 0; n < 16; ++n) {
+        arena->create<int>(n).unwrap();
+      }
+      seen[i] = arena;
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  for (size_t i = 0; i < THREAD_COUNT; ++i) {
+    for (size_t j = i + 1; j < THREAD_COUNT; ++j) {
+      EXPECT_NE(seen[i], seen[j]);
+    }
+  }
+  EXPECT_EQ(arenas.used(), THREAD_COUNT * 16 * sizeof(int));
+}
+
+TEST(ThreadArenasTest, NoThreadSlot) {
+  auto arenas = ThreadArenas::make(1, 64).unwrap();
+  ASSERT_TRUE(arenas.local().is_ok());
+
+  std::thread([&arenas]() {
+    auto local = arenas.local();
+    ASSERT_TRUE(local.is_err());
+    EXPECT_EQ(local.unwrap_err(), MemoryError::NoThreadSlotError);
+  }).join();
+}
+
+TEST(ThreadArenasTest, MoveSemantics) {
+  auto arenas1 = ThreadArenas::make(1, 64).unwrap();
+  LinearArena* local = arenas1.local().unwrap();
+
+  // 別のThreadArenasを使ってもキャッシュと取り違えない
+  auto other = ThreadArenas::make(1, 64).unwrap();
+  EXPECT_NE(other.local().unwrap(), local);
+
+  ThreadArenas arenas2 = std::move(arenas1);
+  EXPECT_FALSE(arenas1.is_valid());
+  EXPECT_EQ(arenas2.local().unwrap(), local);
+  EXPECT_EQ(arenas1.local().unwrap_err(), MemoryError::InvalidArenaError);
+}
+
+}  // namespace
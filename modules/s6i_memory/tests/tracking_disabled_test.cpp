@@ -0,0 +1,61 @@
+// cpp_baseの設定に関わらず、リリースビルドと同じく追跡を取り除いてビルドする
+// （この実行ファイルの翻訳単位はこれだけなので、ODR違反にはならない）
+#undef S6I_MEMORY_TRACKING
+#define S6I_MEMORY_TRACKING 0
+
+#include <gtest/gtest.h>
+#include <s6i_memory/prelude.h>
+#include <memory>
+#include <type_traits>
+
+// 追跡が無効ならoperator newは置き換えない
+S6I_MEMORY_TRACK_GLOBAL_NEW();
+
+namespace {
+
+using namespace s6i_memory;
+
+static_assert(!tracking::is_enabled());
+
+// タグと場所は空の型になる
+static_assert(std::is_empty_v<tracking::MemoryTag>);
+static_assert(std::is_empty_v<tracking::AllocSite>);
+
+// アロケーターに追跡用のメンバーが増えない
+struct LinearArenaLayout {
+  std::unique_ptr<std::byte[]> m_buffer;
+  size_t m_capacity;
+  size_t m_offset;
+  size_t m_peak;
+};
+static_assert(sizeof(LinearArena) == sizeof(LinearArenaLayout));
+static_assert(std::is_trivially_destructible_v<tracking::TagScope>);
+
+// 記録する関数は定数式として評価でき、何の副作用も持たない
+constexpr bool record_in_constant_expression() {
+  tracking::on_allocate(tracking::ARENA_TAG, 16, tracking::AllocSite("a"));
+  tracking::on_free(tracking::ARENA_TAG, 16);
+  tracking::set_budget(tracking::POOL_TAG, 1024);
+  tracking::end_frame();
+  return true;
+}
+static_assert(record_in_constant_expression());
+
+TEST(TrackingDisabledTest, NothingIsRecorded) {
+  const auto tag = tracking::register_tag("tracking_disabled_test", 16);
+  auto arena = LinearArena::make(1024, tag).unwrap();
+  arena.allocate(128).unwrap();
+  auto pool = Pool<int>::make().unwrap();
+  pool.destroy(pool.create(1).unwrap());
+  {
+    tracking::TagScope scope(tag);
+    auto value = std::make_unique<int>(1);
+  }
+  tracking::end_frame();
+
+  EXPECT_TRUE(tracking::tag_stats().empty());
+  EXPECT_TRUE(tracking::top_sites(10).empty());
+  EXPECT_EQ(tracking::tag_stats(tag).m_live_bytes, 0u);
+}
+
+}  // namespace
@@ -0,0 +1,247 @@
+#include <gtest/gtest.h>
+#include <s6i_memory/prelude.h>
+#include <algorithm>
+#include <cstring>
+#include <memory>
+#include <thread>
+#include <vector>
+
+static_assert(S6I_MEMORY_TRACKING,
+              "tracking_test requires S6I_MEMORY_TRACKING=1");
+
+// このテストの実行ファイルではoperator newも追跡する
+S6I_MEMORY_TRACK_GLOBAL_NEW();
+
+namespace {
+
+using namespace s6i_memory;
+
+TEST(TrackingTest, RegisterTag) {
+  const auto tag = tracking::register_tag("tracking_test.register", 1024);
+  EXPECT_NE(tag.m_index, tracking::GLOBAL_TAG.m_index);
+  // 同じ名前なら同じタグ
+  EXPECT_EQ(tracking::register_tag("tracking_test.register").m_index,
+            tag.m_index);
+
+  const auto stats = tracking::tag_stats(tag);
+  EXPECT_STREQ(stats.m_name, "tracking_test.register");
+  EXPECT_EQ(stats.m_budget_bytes, 1024u);
+  EXPECT_EQ(stats.m_live_bytes, 0u);
+}
+
+TEST(TrackingTest, ArenaLiveAndPeakBytes) {
+  const auto tag = tracking::register_tag("tracking_test.arena");
+  {
+    auto arena = LinearArena::make(1024, tag).unwrap();
+    arena.allocate(100, 1).unwrap();
+    arena.allocate(28, 1).unwrap();
+    EXPECT_EQ(tracking::tag_stats(tag).m_live_bytes, 128u);
+    EXPECT_EQ(tracking::tag_stats(tag).m_allocations, 2u);
+    tracking::end_frame();
+
+    arena.reset();
+    arena.allocate(16, 1).unwrap();
+    tracking::end_frame();
+    const auto stats = tracking::tag_stats(tag);
+    EXPECT_EQ(stats.m_live_bytes, 16u);
+    EXPECT_EQ(stats.m_peak_bytes, 128u);
+    EXPECT_EQ(stats.m_frame_allocations, 1u);
+  }
+  // アリーナを破棄すると残りも解放したことになる
+  EXPECT_EQ(tracking::tag_stats(tag).m_live_bytes, 0u);
+}
+
+TEST(TrackingTest, PoolAcrossThreads) {
+  const auto tag = tracking::register_tag("tracking_test.pool");
+  PoolDesc desc;
+  desc.m_tag = tag;
+  auto pool = Pool<uint64_t>::make(desc).unwrap();
+
+  std::vector<uint64_t*> objects;
+  for (int i = 0; i < 10; ++i) {
+    objects.push_back(pool.create(i).unwrap());
+  }
+  EXPECT_EQ(tracking::tag_stats(tag).m_live_bytes, 10 * sizeof(uint64_t));
+
+  // 別のスレッドで解放しても合計は合う
+  std::thread([&]() {
+    for (uint64_t* object : objects) {
+      pool.destroy(object);
+    }
+    pool.flush_local();
+  }).join();
+  EXPECT_EQ(tracking::tag_stats(tag).m_live_bytes, 0u);
+  EXPECT_EQ(tracking::tag_stats(tag).m_allocations, 10u);
+}
+
+TEST(TrackingTest, GlobalNewUsesScopeTag) {
+  const auto tag = tracking::register_tag("tracking_test.global");
+  std::vector<int> values;
+  {
+    tracking::TagScope scope(tag);
+    values.resize(64);
+  }
+  EXPECT_EQ(tracking::tag_stats(tag).m_live_bytes, 64 * sizeof(int));
+
+  // スコープの外で解放しても、確保したときのタグから引かれる
+  values = std::vector<int>();
+  EXPECT_EQ(tracking::tag_stats(tag).m_live_bytes, 0u);
+  EXPECT_EQ(tracking::tag_stats(tag).m_allocations, 1u);
+}
+
+TEST(TrackingTest, GlobalNewOverloads) {
+  struct alignas(128) Aligned {
+    std::byte m_bytes[128];
+  };
+  const auto tag = tracking::register_tag("tracking_test.overloads");
+  std::unique_ptr<Aligned[]> aligned;
+  std::unique_ptr<int> nothrow;
+  std::unique_ptr<Aligned> aligned_nothrow;
+  {
+    tracking::TagScope scope(tag);
+    aligned = std::make_unique<Aligned[]>(3);
+    nothrow.reset(new (std::nothrow) int(1));
+    aligned_nothrow.reset(new (std::nothrow) Aligned());
+  }
+  EXPECT_EQ(reinterpret_cast<uintptr_t>(aligned.get()) % alignof(Aligned), 0u);
+  EXPECT_EQ(reinterpret_cast<uintptr_t>(aligned_nothrow.get()) %
+                alignof(Aligned),
+            0u);
+  EXPECT_EQ(tracking::tag_stats(tag).m_live_bytes,
+            4 * sizeof(Aligned) + sizeof(int));
+
+  aligned.reset();
+  nothrow.reset();
+  aligned_nothrow.reset();
+  EXPECT_EQ(tracking::tag_stats(tag).m_live_bytes, 0u);
+  EXPECT_EQ(tracking::tag_stats(tag).m_allocations, 3u);
+}
+
+TEST(TrackingTest, SiteHistogram) {
+  auto arena = LinearArena::make(4096).unwrap();
+  for (int i = 0; i < 1000; ++i) {
+    arena.allocate(1, 1).unwrap();
+  }
+  const auto sites = tracking::top_sites(1);
+  ASSERT_EQ(sites.size(), 1u);
+  EXPECT_EQ(sites[0].m_allocations, 1000u);
+  EXPECT_EQ(sites[0].m_bytes, 1000u);
+  // 呼び出し元のファイルが記録される
+  EXPECT_NE(std::strstr(sites[0].m_label, "tracking_test.cpp"), nullptr);
+  EXPECT_GT(sites[0].m_line, 0u);
+}
+
+struct TrackedParticle {
+  float m_position[2];
+};
+
+TEST(TrackingTest, TypedSites) {
+  auto arena = LinearArena::make(4096).unwrap();
+  auto pool = Pool<TrackedParticle>::make().unwrap();
+  std::vector<TrackedParticle*> particles;
+  for (int i = 0; i < 30; ++i) {
+    arena.create<TrackedParticle>().unwrap();
+    particles.push_back(pool.create().unwrap());
+  }
+  for (int i = 0; i < 20; ++i) {
+    particles.push_back(
+        pool.create_at(tracking::AllocSite::current()).unwrap());
+  }
+  const uint32_t create_at_line = __LINE__ - 2;
+  ArenaVector<int> values{ArenaAllocator<int>(arena)};
+  const uint32_t allocator_line = __LINE__ - 1;
+  values.reserve(8);
+  for (TrackedParticle* particle : particles) {
+    pool.destroy(particle);
+  }
+
+  auto find = [](auto predicate) {
+    const auto sites = tracking::top_sites(100);
+    return std::find_if(sites.begin(), sites.end(), predicate) != sites.end();
+  };
+  // create()はTごとにまとめる（アリーナとプールで同じ場所になる）
+  EXPECT_TRUE(find([](const tracking::SiteStats& site) {
+    return std::strstr(site.m_label, "TrackedParticle") &&
+           site.m_allocations == 60;
+  }));
+  // create_at()とアロケーターは指定した場所に記録する
+  EXPECT_TRUE(find([&](const tracking::SiteStats& site) {
+    return std::strstr(site.m_label, "tracking_test.cpp") &&
+           site.m_line == create_at_line && site.m_allocations == 20;
+  }));
+  EXPECT_TRUE(find([&](const tracking::SiteStats& site) {
+    return std::strstr(site.m_label, "tracking_test.cpp") &&
+           site.m_line == allocator_line && site.m_allocations == 1;
+  }));
+}
+
+int g_budget_warnings = 0;
+
+void count_budget_warnings(void* /*userdata*/,
+                           int /*category*/,
+                           SDL_LogPriority priority,
+                           const char* message) {
+  if (priority == SDL_LOG_PRIORITY_WARN &&
+      std::strstr(message, "tracking_test.budget")) {
+    ++g_budget_warnings;
+  }
+}
+
+TEST(TrackingTest, BudgetLogsOncePerOverrun) {
+  SDL_LogOutputFunction previous = nullptr;
+  void* previous_userdata = nullptr;
+  SDL_LogGetOutputFunction(&previous, &previous_userdata);
+  SDL_LogSetOutputFunction(count_budget_warnings, nullptr);
+
+  const auto tag = tracking::register_tag("tracking_test.budget", 64);
+  auto arena = LinearArena::make(1024, tag).unwrap();
+
+  // 超えている間は最初のフレームだけ警告する
+  arena.allocate(128, 1).unwrap();
+  tracking::end_frame();
+  tracking::end_frame();
+  EXPECT_EQ(g_budget_warnings, 1);
+
+  // 予算内に戻った後にまた超えたら、もう1度警告する
+  arena.reset();
+  tracking::end_frame();
+  arena.allocate(128, 1).unwrap();
+  tracking::end_frame();
+  EXPECT_EQ(g_budget_warnings, 2);
+
+  // 予算を上げれば警告しない
+  tracking::set_budget(tag, 4096);
+  arena.allocate(128, 1).unwrap();
+  tracking::end_frame();
+  EXPECT_EQ(g_budget_warnings, 2);
+  EXPECT_EQ(tracking::tag_stats(tag).m_budget_bytes, 4096u);
+
+  SDL_LogSetOutputFunction(previous, previous_userdata);
+}
+
+TEST(TrackingTest, FullSiteTableFallsBackToOther) {
+  const auto tag = tracking::register_tag("tracking_test.other");
+  constexpr size_t count = 2 * tracking::detail::ThreadBuffer::SITE_CAPACITY;
+  // 別のスレッドで埋め、他のテストの場所の表を汚さない
+  std::thread([&]() {
+    static const char s_sites[count] = {};
+    for (size_t i = 0; i < count; ++i) {
+      tracking::on_allocate(tag, 1,
+                            tracking::AllocSite::from_address(&s_sites[i]));
+      tracking::on_free(tag, 1);
+    }
+  }).join();
+
+  EXPECT_GE(tracking::dropped_sites(),
+            count - tracking::detail::ThreadBuffer::SITE_CAPACITY);
+  const auto sites = tracking::top_sites(count);
+  auto other = std::find_if(sites.begin(), sites.end(), [](const auto& site) {
+    return std::strcmp(site.m_label, "(other)") == 0;
+  });
+  ASSERT_NE(other, sites.end());
+  EXPECT_EQ(other->m_allocations, tracking::dropped_sites());
+  EXPECT_EQ(tracking::tag_stats(tag).m_allocations, count);
+  tracking::dump(1);
+}
+
+}  // namespace
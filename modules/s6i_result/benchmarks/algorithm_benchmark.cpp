@@ -0,0 +1,136 @@
+#include <benchmark/benchmark.h>
+#include <vector>
+#include "s6i_result/algorithm.h"
+
+namespace {
+
+using ResultVec = std::vector<s6i_result::Result<int, int>>;
+
+constexpr size_t ELEMENT_COUNT = 1 << 20;
+
+ResultVec make_inputs(size_t count, bool with_error) {
+  ResultVec results;
+  results.reserve(count);
+  for (size_t i = 0; i < count; ++i) {
+    if (with_error && i == count - 1) {
+      results.push_back(s6i_result::make_err(-1));
+    } else {
+      results.push_back(s6i_result::make_ok(static_cast<int>(i)));
+    }
+  }
+  return results;
+}
+
+// 比較用: 予約せずにpush_backする素朴なループ
+s6i_result::Result<std::vector<int>, int> naive_collect(ResultVec& results) {
+  std::vector<int> values;
+  for (auto& r : results) {
+    if (r.is_err()) {
+      return s6i_result::make_err(r.unwrap_err());
+    }
+    values.push_back(r.unwrap());
+  }
+  return s6i_result::make_ok(std::move(values));
+}
+
+void BM_CollectNaive(benchmark::State& state) {
+  auto inputs = make_inputs(ELEMENT_COUNT, false);
+  for (auto _ : state) {
+    auto r = naive_collect(inputs);
+    benchmark::DoNotOptimize(r.ref_ok().data());
+  }
+  state.SetItemsProcessed(static_cast<int64_t>(state.iterations()) *
+                          static_cast<int64_t>(ELEMENT_COUNT));
+}
+BENCHMARK(BM_CollectNaive)->Unit(benchmark::kMillisecond);
+
+void BM_Collect(benchmark::State& state) {
+  auto inputs = make_inputs(ELEMENT_COUNT, false);
+  for (auto _ : state) {
+    auto r = s6i_result::collect(inputs);
+    benchmark::DoNotOptimize(r.ref_ok().data());
+  }
+  state.SetItemsProcessed(static_cast<int64_t>(state.iterations()) *
+                          static_cast<int64_t>(ELEMENT_COUNT));
+}
+BENCHMARK(BM_Collect)->Unit(benchmark::kMillisecond);
+
+void BM_CollectInto(benchmark::State& state) {
+  auto inputs = make_inputs(ELEMENT_COUNT, false);
+  std::vector<int> storage(ELEMENT_COUNT);
+  for (auto _ : state) {
+    auto r =
+        s6i_result::collect_into(inputs.begin(), inputs.end(), storage.data());
+    benchmark::DoNotOptimize(r.ref_ok());
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(static_cast<int64_t>(state.iterations()) *
+                          static_cast<int64_t>(ELEMENT_COUNT));
+}
+BENCHMARK(BM_CollectInto)->Unit(benchmark::kMillisecond);
+
+// 末尾が失敗の場合（すべて走査してから破棄する最悪ケース）
+void BM_CollectErrorAtEnd(benchmark::State& state) {
+  auto inputs = make_inputs(ELEMENT_COUNT, true);
+  for (auto _ : state) {
+    auto r = s6i_result::collect(inputs);
+    benchmark::DoNotOptimize(r.is_err());
+  }
+  state.SetItemsProcessed(static_cast<int64_t>(state.iterations()) *
+                          static_cast<int64_t>(ELEMENT_COUNT));
+}
+BENCHMARK(BM_CollectErrorAtEnd)->Unit(benchmark::kMillisecond);
+
+void BM_PartitionNaive(benchmark::State& state) {
+  auto inputs = make_inputs(ELEMENT_COUNT, false);
+  for (size_t i = 0; i < inputs.size(); i += 4) {
+    inputs[i] = s6i_result::make_err(static_cast<int>(i));
+  }
+  for (auto _ : state) {
+    std::vector<int> values;
+    std::vector<int> errors;
+    for (auto& r : inputs) {
+      if (r.is_ok()) {
+        values.push_back(r.ref_ok());
+      } else {
+        errors.push_back(r.ref_err());
+      }
+    }
+    benchmark::DoNotOptimize(values.data());
+    benchmark::DoNotOptimize(errors.data());
+  }
+  state.SetItemsProcessed(static_cast<int64_t>(state.iterations()) *
+                          static_cast<int64_t>(ELEMENT_COUNT));
+}
+BENCHMARK(BM_PartitionNaive)->Unit(benchmark::kMillisecond);
+
+void BM_Partition(benchmark::State& state) {
+  auto inputs = make_inputs(ELEMENT_COUNT, false);
+  for (size_t i = 0; i < inputs.size(); i += 4) {
+    inputs[i] = s6i_result::make_err(static_cast<int>(i));
+  }
+  for (auto _ : state) {
+    auto out = s6i_result::partition(inputs);
+    benchmark::DoNotOptimize(out.first.data());
+    benchmark::DoNotOptimize(out.second.data());
+  }
+  state.SetItemsProcessed(static_cast<int64_t>(state.iterations()) *
+                          static_cast<int64_t>(ELEMENT_COUNT));
+}
+BENCHMARK(BM_Partition)->Unit(benchmark::kMillisecond);
+
+void BM_TryTransform(benchmark::State& state) {
+  std::vector<int> inputs(ELEMENT_COUNT, 1);
+  for (auto _ : state) {
+    auto r = s6i_result::try_transform(
+        inputs, [](int x) -> s6i_result::Result<int, int> {
+          return s6i_result::make_ok(x + 1);
+        });
+    benchmark::DoNotOptimize(r.ref_ok().data());
+  }
+  state.SetItemsProcessed(static_cast<int64_t>(state.iterations()) *
+                          static_cast<int64_t>(ELEMENT_COUNT));
+}
+BENCHMARK(BM_TryTransform)->Unit(benchmark::kMillisecond);
+
+}  // namespace
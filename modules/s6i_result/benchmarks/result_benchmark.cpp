@@ -0,0 +1,95 @@
+#include <benchmark/benchmark.h>
+#include <cstring>
+#include <variant>
+#include <vector>
+#include "s6i_result/result.h"
+
+namespace {
+
+enum class BenchError {
+  LockError,
+  WaitError,
+};
+
+}  // namespace
+
+template <>
+struct s6i_result::NicheTraits<BenchError> {
+  static constexpr bool enabled = true;
+  static constexpr BenchError value = static_cast<BenchError>(-1);
+};
+
+namespace {
+
+// 比較用: 旧実装と同じstd::variantによる格納
+template <typename T, typename E>
+class VariantResult {
+ public:
+  VariantResult(s6i_result::Ok<T>&& ok) : m_value(std::move(ok)) {}
+  VariantResult(s6i_result::Err<E>&& err) : m_value(std::move(err)) {}
+
+  bool is_ok() const {
+    return std::holds_alternative<s6i_result::Ok<T>>(m_value);
+  }
+
+ private:
+  std::variant<s6i_result::Ok<T>, s6i_result::Err<E>> m_value;
+};
+
+using UnitResult = s6i_result::Result<std::monostate, BenchError>;
+using VariantUnitResult = VariantResult<std::monostate, BenchError>;
+
+// 呼び出し規約の差を測るため、インライン展開を抑止する
+template <typename R>
+#if defined(_MSC_VER)
+__declspec(noinline)
+#else
+__attribute__((noinline))
+#endif
+R make_unit(int i) {
+  if (i < 0) {
+    return s6i_result::make_err(BenchError::LockError);
+  }
+  return s6i_result::make_ok(std::monostate{});
+}
+
+template <typename R>
+void BM_ReturnUnitResult(benchmark::State& state) {
+  int i = 0;
+  int ok_count = 0;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(i);
+    ok_count += make_unit<R>(i++).is_ok();
+  }
+  benchmark::DoNotOptimize(ok_count);
+  state.counters["sizeof"] = sizeof(R);
+}
+BENCHMARK_TEMPLATE(BM_ReturnUnitResult, VariantUnitResult);
+BENCHMARK_TEMPLATE(BM_ReturnUnitResult, UnitResult);
+
+template <typename R>
+void BM_CopyResultArray(benchmark::State& state) {
+  const auto count = static_cast<size_t>(state.range(0));
+  std::vector<R> src;
+  src.reserve(count);
+  for (size_t i = 0; i < count; ++i) {
+    if (i % 7 == 0) {
+      src.push_back(s6i_result::make_err(BenchError::WaitError));
+    } else {
+      src.push_back(s6i_result::make_ok(std::monostate{}));
+    }
+  }
+  std::vector<R> dst = src;
+  for (auto _ : state) {
+    dst = src;
+    benchmark::DoNotOptimize(dst.data());
+    benchmark::ClobberMemory();
+  }
+  state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) *
+                          static_cast<int64_t>(count * sizeof(R)));
+  state.counters["sizeof"] = sizeof(R);
+}
+BENCHMARK_TEMPLATE(BM_CopyResultArray, VariantUnitResult)->Arg(1 << 16);
+BENCHMARK_TEMPLATE(BM_CopyResultArray, UnitResult)->Arg(1 << 16);
+
+}  // namespace
@@ -0,0 +1,262 @@
+#pragma once
+
+#include <iterator>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "result.h"
+
+namespace s6i_result {
+
+namespace detail {
+
+/** @brief イテレータが指すResultの型 */
+template <typename It>
+using iter_result_t = typename std::iterator_traits<It>::value_type;
+
+/**
+ * @brief 範囲の要素数が安価に求まる場合は予約し、それ以外は何もしない
+ */
+template <typename It, typename Container>
+void reserve_for(It first, It last, Container& c) {
+  using Category = typename std::iterator_traits<It>::iterator_category;
+  if constexpr (std::is_base_of_v<std::forward_iterator_tag, Category>) {
+    c.reserve(static_cast<size_t>(std::distance(first, last)));
+  }
+}
+
+/**
+ * @brief 参照元が右辺値なら成功値をムーブ、左辺値ならコピー元の参照を返す
+ */
+template <typename R>
+decltype(auto) take_ok(R&& r) {
+  if constexpr (std::is_lvalue_reference_v<R>) {
+    return std::as_const(r).ref_ok();
+  } else {
+    return r.unwrap();
+  }
+}
+
+/** @brief take_okの失敗値版 */
+template <typename R>
+decltype(auto) take_err(R&& r) {
+  if constexpr (std::is_lvalue_reference_v<R>) {
+    return std::as_const(r).ref_err();
+  } else {
+    return r.unwrap_err();
+  }
+}
+
+/** @brief 範囲が右辺値ならムーブイテレータ、左辺値なら通常のイテレータ */
+template <typename Range>
+auto range_begin(Range&& range) {
+  if constexpr (std::is_lvalue_reference_v<Range>) {
+    return std::begin(range);
+  } else {
+    return std::make_move_iterator(std::begin(range));
+  }
+}
+
+template <typename Range>
+auto range_end(Range&& range) {
+  if constexpr (std::is_lvalue_reference_v<Range>) {
+    return std::end(range);
+  } else {
+    return std::make_move_iterator(std::end(range));
+  }
+}
+
+}  // namespace detail
+
+/**
+ * @brief Resultの範囲から成功値をoutへ書き出す
+ *
+ * 中間コンテナを作らず、呼び出し側が用意した領域へ直接書き出します。
+ * 最初に見つかった失敗値で処理を打ち切るため、
+ * その場合はそれまでの成功値だけがoutに書き込まれています。
+ * ムーブイテレータを渡すと成功値はムーブされます。
+ *
+ * @param first 範囲の先頭
+ * @param last 範囲の終端
+ * @param out 成功値の書き出し先
+ * @return 成功時: 書き込み終えた位置のout、失敗時: 最初の失敗値
+ */
+template <typename InputIt, typename OutputIt>
+auto collect_into(InputIt first, InputIt last, OutputIt out)
+    -> Result<OutputIt, typename detail::iter_result_t<InputIt>::error_type> {
+  for (; first != last; ++first) {
+    auto&& r = *first;
+    if (r.is_err()) {
+      return make_err(detail::take_err(std::forward<decltype(r)>(r)));
+    }
+    *out = detail::take_ok(std::forward<decltype(r)>(r));
+    ++out;
+  }
+  return make_ok(std::move(out));
+}
+
+/**
+ * @brief Resultの範囲を1つのResult<std::vector<T>, E>にまとめる
+ *
+ * 出力は一度だけ予約し、最初に見つかった失敗値で処理を打ち切ります。
+ *
+ * @param first 範囲の先頭
+ * @param last 範囲の終端
+ * @return 成功時: すべての成功値、失敗時: 最初の失敗値
+ */
+template <typename InputIt>
+auto collect(InputIt first, InputIt last)
+    -> Result<std::vector<typename detail::iter_result_t<InputIt>::value_type>,
+              typename detail::iter_result_t<InputIt>::error_type> {
+  using T = typename detail::iter_result_t<InputIt>::value_type;
+  using E = typename detail::iter_result_t<InputIt>::error_type;
+  static_assert(!std::is_void_v<T> && !std::is_reference_v<T>,
+                "collect requires an object value type");
+
+  std::vector<T> values;
+  detail::reserve_for(first, last, values);
+  auto r = collect_into(first, last, std::back_inserter(values));
+  if (r.is_err()) {
+    return Result<std::vector<T>, E>(detail::InPlaceErr{}, r.unwrap_err());
+  }
+  return Result<std::vector<T>, E>(detail::InPlaceOk{}, std::move(values));
+}
+
+/**
+ * @brief Resultの範囲を1つのResult<std::vector<T>, E>にまとめる
+ *
+ * 右辺値の範囲を渡すと成功値はムーブされます。
+ *
+ * @param range Resultの範囲
+ * @return 成功時: すべての成功値、失敗時: 最初の失敗値
+ */
+template <typename Range>
+auto collect(Range&& range) {
+  return collect(detail::range_begin(std::forward<Range>(range)),
+                 detail::range_end(std::forward<Range>(range)));
+}
+
+/**
+ * @brief Resultの範囲を成功値と失敗値に振り分ける
+ *
+ * 先に成功値の数を数えてから、それぞれの出力を一度だけ予約します。
+ *
+ * @param first 範囲の先頭
+ * @param last 範囲の終端
+ * @return 成功値の配列と失敗値の配列の組
+ */
+template <typename ForwardIt>
+auto partition(ForwardIt first, ForwardIt last)
+    -> std::pair<
+        std::vector<typename detail::iter_result_t<ForwardIt>::value_type>,
+        std::vector<typename detail::iter_result_t<ForwardIt>::error_type>> {
+  using T = typename detail::iter_result_t<ForwardIt>::value_type;
+  using E = typename detail::iter_result_t<ForwardIt>::error_type;
+  static_assert(!std::is_void_v<T> && !std::is_reference_v<T>,
+                "partition requires an object value type");
+
+  size_t ok_count = 0;
+  size_t total = 0;
+  for (auto it = first; it != last; ++it, ++total) {
+    ok_count += (*it).is_ok() ? 1 : 0;
+  }
+
+  std::pair<std::vector<T>, std::vector<E>> out;
+  out.first.reserve(ok_count);
+  out.second.reserve(total - ok_count);
+  for (; first != last; ++first) {
+    auto&& r = *first;
+    if (r.is_ok()) {
+      out.first.push_back(detail::take_ok(std::forward<decltype(r)>(r)));
+    } else {
+      out.second.push_back(detail::take_err(std::forward<decltype(r)>(r)));
+    }
+  }
+  return out;
+}
+
+/**
+ * @brief Resultの範囲を成功値と失敗値に振り分ける
+ *
+ * 右辺値の範囲を渡すと成功値・失敗値はムーブされます。
+ *
+ * @param range Resultの範囲
+ * @return 成功値の配列と失敗値の配列の組
+ */
+template <typename Range>
+auto partition(Range&& range) {
+  return partition(detail::range_begin(std::forward<Range>(range)),
+                   detail::range_end(std::forward<Range>(range)));
+}
+
+/**
+ * @brief 範囲の各要素に関数を適用し、成功値をoutへ書き出す
+ *
+ * 中間コンテナを作らず、最初の失敗で処理を打ち切ります。
+ *
+ * @param first 範囲の先頭
+ * @param last 範囲の終端
+ * @param out 成功値の書き出し先
+ * @param f Result<U, E>を返す関数
+ * @return 成功時: 書き込み終えた位置のout、失敗時: 最初の失敗値
+ */
+template <typename InputIt, typename OutputIt, typename F>
+auto try_transform_into(InputIt first, InputIt last, OutputIt out, F&& f)
+    -> Result<OutputIt,
+              typename std::invoke_result_t<
+                  F&,
+                  typename std::iterator_traits<InputIt>::reference>::
+                  error_type> {
+  for (; first != last; ++first) {
+    auto r = f(*first);
+    if (r.is_err()) {
+      return make_err(r.unwrap_err());
+    }
+    *out = r.unwrap();
+    ++out;
+  }
+  return make_ok(std::move(out));
+}
+
+/**
+ * @brief 範囲の各要素に関数を適用し、Result<std::vector<U>, E>にまとめる
+ *
+ * 出力は一度だけ予約し、最初の失敗で処理を打ち切ります。
+ *
+ * @param first 範囲の先頭
+ * @param last 範囲の終端
+ * @param f Result<U, E>を返す関数
+ * @return 成功時: すべての変換結果、失敗時: 最初の失敗値
+ */
+template <typename InputIt, typename F>
+auto try_transform(InputIt first, InputIt last, F&& f) {
+  using R = std::invoke_result_t<
+      F&, typename std::iterator_traits<InputIt>::reference>;
+  using U = typename R::value_type;
+  using E = typename R::error_type;
+  static_assert(!std::is_void_v<U> && !std::is_reference_v<U>,
+                "try_transform requires an object value type");
+
+  std::vector<U> values;
+  detail::reserve_for(first, last, values);
+  auto r = try_transform_into(first, last, std::back_inserter(values), f);
+  if (r.is_err()) {
+    return Result<std::vector<U>, E>(detail::InPlaceErr{}, r.unwrap_err());
+  }
+  return Result<std::vector<U>, E>(detail::InPlaceOk{}, std::move(values));
+}
+
+/**
+ * @brief 範囲の各要素に関数を適用し、Result<std::vector<U>, E>にまとめる
+ * @param range 入力の範囲
+ * @param f Result<U, E>を返す関数
+ * @return 成功時: すべての変換結果、失敗時: 最初の失敗値
+ */
+template <typename Range, typename F>
+auto try_transform(Range&& range, F&& f) {
+  return try_transform(detail::range_begin(std::forward<Range>(range)),
+                       detail::range_end(std::forward<Range>(range)),
+                       std::forward<F>(f));
+}
+
+}  // namespace s6i_result
@@ -0,0 +1,105 @@
+#pragma once
+
+#include <cassert>
+#include <cstddef>
+
+namespace s6i_result {
+
+/**
+ * @brief エラー伝播時に記録される文脈情報
+ */
+struct ContextFrame {
+  const char* m_message = nullptr;  ///< 文脈の説明（文字列リテラル）
+  const char* m_file = nullptr;     ///< 記録したソースファイル
+  int m_line = 0;                   ///< 記録した行番号
+};
+
+/**
+ * @brief スレッドごとのエラー文脈リングバッファ
+ *
+ * エラーが伝播した経路をContextFrameとして記録します。
+ * 記録はエラー経路でのみ行われ、成功経路には一切コストがかかりません。
+ * 固定長のthread_localなリングに書き込むため、ヒープ確保も行いません。
+ * 容量を超えた場合は古いものから上書きされます。
+ *
+ * メッセージやファイル名はポインタのまま保持するため、
+ * 文字列リテラルなど寿命が十分に長い文字列を渡す必要があります。
+ *
+ * リングは自動では空になりません。エラーを作る場所ではS6I_ERR_CTXで
+ * 新しい経路を始めてください（それまでの文脈を破棄します）。
+ * S6I_ERR_CTXで始まらないエラー（他のモジュールが返したものなど）を
+ * 処理した後はclear()し、次のエラーに古い経路が混ざらないようにします。
+ */
+class ErrorContext {
+ public:
+  /** @brief 1スレッドあたりに保持できる文脈の数 */
+  static constexpr size_t CAPACITY = 16;
+
+  /**
+   * @brief 文脈を記録
+   * @param message 文脈の説明
+   * @param file ソースファイル
+   * @param line 行番号
+   */
+  static void push(const char* message, const char* file, int line) {
+    Ring& r = ring();
+    r.m_frames[r.m_count % CAPACITY] = ContextFrame{message, file, line};
+    ++r.m_count;
+  }
+
+  /**
+   * @brief それまでの文脈を破棄し、新しいエラーの文脈を記録
+   * @param message 文脈の説明
+   * @param file ソースファイル
+   * @param line 行番号
+   */
+  static void begin(const char* message, const char* file, int line) {
+    clear();
+    push(message, file, line);
+  }
+
+  /** @brief 保持している文脈の数 */
+  static size_t size() {
+    const Ring& r = ring();
+    return r.m_count < CAPACITY ? r.m_count : CAPACITY;
+  }
+
+  /**
+   * @brief 文脈を取得
+   * @param index 0が最も新しい文脈
+   * @note index >= size()の場合はassertで停止
+   */
+  static const ContextFrame& frame(size_t index) {
+    assert(index < size() && "ErrorContext index out of range");
+    const Ring& r = ring();
+    return r.m_frames[(r.m_count - 1 - index) % CAPACITY];
+  }
+
+  /**
+   * @brief 新しいものから順に文脈を列挙
+   * @param f ContextFrameを受け取る関数
+   */
+  template <typename F>
+  static void for_each(F&& f) {
+    const size_t n = size();
+    for (size_t i = 0; i < n; ++i) {
+      f(frame(i));
+    }
+  }
+
+  /** @brief 記録した文脈を破棄 */
+  static void clear() { ring().m_count = 0; }
+
+ private:
+  struct Ring {
+    ContextFrame m_frames[CAPACITY];
+    size_t m_count = 0;
+  };
+
+  static Ring& ring() {
+    thread_local Ring s_ring;
+    return s_ring;
+  }
+};
+
+}  // namespace s6i_result
@@ -0,0 +1,29 @@
+#pragma once
+
+namespace s6i_result {
+
+/**
+ * @brief 失敗値の型Eが持つ「未使用の値（ニッチ）」を宣言するための特性クラス
+ *
+ * 既定ではニッチを持たないものとして扱います。
+ * 列挙型などで決して使われない値がある場合は、この特性を特殊化することで
+ * Result<T, E>はその値を成功状態のタグとして利用し、
+ * タグ用の領域を省略できるようになります。
+ *
+ * @code
+ * template <>
+ * struct s6i_result::NicheTraits<MyError> {
+ *   static constexpr bool enabled = true;
+ *   static constexpr MyError value = static_cast<MyError>(-1);
+ * };
+ * @endcode
+ *
+ * @tparam E 失敗値の型
+ */
+template <typename E>
+struct NicheTraits {
+  /** @brief ニッチを利用できるかどうか */
+  static constexpr bool enabled = false;
+};
+
+}  // namespace s6i_result
@@ -1,3 +1,6 @@
 #pragma once
 
+#include "algorithm.h"
+#include "context.h"
 #include "result.h"
+#include "try.h"
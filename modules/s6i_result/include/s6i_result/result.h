@@ -1,8 +1,11 @@
 #pragma once
 
 #include <cassert>
+#include <functional>
+#include <memory>
+#include <type_traits>
 #include <utility>
-#include <variant>
+#include "storage.h"
 
 namespace s6i_result {
 
@@ -14,19 +17,66 @@ namespace s6i_result {
 template <typename T>
 struct Ok {
   T m_value;
-  explicit Ok(const T& v) : m_value(v) {}
-  explicit Ok(T&& v) : m_value(std::move(v)) {}
+  constexpr explicit Ok(const T& v) : m_value(v) {}
+  constexpr explicit Ok(T&& v) : m_value(std::move(v)) {}
 };
 
+/**
+ * @brief 値を持たない成功を表す型
+ */
+template <>
+struct Ok<void> {};
+
+/**
+ * @brief 参照を成功値として表す型
+ *
+ * @tparam T 参照先の型
+ */
+template <typename T>
+struct Ok<T&> {
+  T& m_value;
+  constexpr explicit Ok(T& v) : m_value(v) {}
+};
+
+namespace detail {
+
+/** @brief std::reference_wrapper<T>をT&に、それ以外をdecayした型に変換 */
+template <typename T>
+struct UnwrapRefDecay {
+  using type = std::decay_t<T>;
+};
+
+template <typename T>
+struct UnwrapRefDecay<std::reference_wrapper<T>> {
+  using type = T&;
+};
+
+template <typename T>
+using unwrap_ref_decay_t =
+    typename UnwrapRefDecay<std::decay_t<T>>::type;
+
+}  // namespace detail
+
 /**
  * @brief 型TからOk<T>を生成するヘルパー関数
+ *
+ * std::ref()で包んだ値を渡すと参照を保持するOk<T&>を生成します。
+ *
  * @tparam T 成功値の型
  * @param value 成功値
  * @return Ok<T> 生成されたOk型
  */
 template <typename T>
-inline Ok<T> make_ok(T&& value) {
-  return Ok<T>(std::forward<T>(value));
+constexpr Ok<detail::unwrap_ref_decay_t<T>> make_ok(T&& value) {
+  return Ok<detail::unwrap_ref_decay_t<T>>(std::forward<T>(value));
+}
+
+/**
+ * @brief 値を持たないOk<void>を生成するヘルパー関数
+ * @return Ok<void> 生成されたOk型
+ */
+constexpr Ok<void> make_ok() {
+  return Ok<void>{};
 }
 
 /**
@@ -37,8 +87,8 @@ inline Ok<T> make_ok(T&& value) {
 template <typename E>
 struct Err {
   E m_value;
-  explicit Err(const E& e) : m_value(e) {}
-  explicit Err(E&& e) : m_value(std::move(e)) {}
+  constexpr explicit Err(const E& e) : m_value(e) {}
+  constexpr explicit Err(E&& e) : m_value(std::move(e)) {}
 };
 
 /**
@@ -48,55 +98,190 @@ struct Err {
  * @return Err<E> 生成されたErr型
  */
 template <typename E>
-inline Err<E> make_err(E&& error) {
-  return Err<E>(std::forward<E>(error));
+constexpr Err<std::decay_t<E>> make_err(E&& error) {
+  return Err<std::decay_t<E>>(std::forward<E>(error));
 }
 
+namespace detail {
+
+/** @brief void用の格納型 */
+struct Unit {};
+
+/**
+ * @brief 成功値の型Tと格納型の対応
+ *
+ * voidはUnitとして、T&はポインタとして格納し、
+ * 取り出す際に元の型へ戻します。
+ */
+template <typename T>
+struct ValueTraits {
+  using stored_type = T;
+  using reference = T&;
+  using const_reference = const T&;
+
+  static constexpr const T& from_ok(const Ok<T>& ok) { return ok.m_value; }
+  static constexpr T&& from_ok(Ok<T>&& ok) { return std::move(ok.m_value); }
+
+  static constexpr T& get(T& v) { return v; }
+  static constexpr const T& get(const T& v) { return v; }
+  static constexpr T&& take(T& v) { return std::move(v); }
+
+  template <typename F>
+  static constexpr auto invoke(F&& f, T& v)
+      -> decltype(std::forward<F>(f)(v)) {
+    return std::forward<F>(f)(v);
+  }
+  template <typename F>
+  static constexpr auto invoke(F&& f, const T& v)
+      -> decltype(std::forward<F>(f)(v)) {
+    return std::forward<F>(f)(v);
+  }
+  template <typename F>
+  static constexpr auto invoke(F&& f, T&& v)
+      -> decltype(std::forward<F>(f)(std::move(v))) {
+    return std::forward<F>(f)(std::move(v));
+  }
+};
+
+template <>
+struct ValueTraits<void> {
+  using stored_type = Unit;
+  using reference = void;
+  using const_reference = void;
+
+  static constexpr Unit from_ok(const Ok<void>&) { return Unit{}; }
+
+  static constexpr void get(const Unit&) {}
+  static constexpr void take(Unit&) {}
+
+  template <typename F>
+  static constexpr auto invoke(F&& f, const Unit&)
+      -> decltype(std::forward<F>(f)()) {
+    return std::forward<F>(f)();
+  }
+};
+
+template <typename T>
+struct ValueTraits<T&> {
+  using stored_type = T*;
+  using reference = T&;
+  using const_reference = T&;
+
+  static constexpr T* from_ok(const Ok<T&>& ok) {
+    return std::addressof(ok.m_value);
+  }
+
+  static constexpr T& get(T* v) { return *v; }
+  static constexpr T& take(T* v) { return *v; }
+
+  template <typename F>
+  static constexpr auto invoke(F&& f, T* v)
+      -> decltype(std::forward<F>(f)(*v)) {
+    return std::forward<F>(f)(*v);
+  }
+};
+
+}  // namespace detail
+
 /**
  * @brief Result型
  *
  * 成功値(T)もしくは失敗値(E)のいずれかを保持する型です。
+ * T, Eがともにトリビアルコピー可能であればResultもトリビアルコピー可能になり、
+ * Tが空の型でEがニッチ（NicheTraits）を持つ場合は
+ * sizeof(Result<T, E>) == sizeof(E)となります。
+ *
+ * Tにはvoid（値を持たない成功）や参照型T&も指定できます。
+ *
+ * コンビネータ(map, and_thenなど)は左辺値に対しては値を参照で渡し、
+ * 右辺値に対しては値をムーブで渡すため、
+ * 右辺値のまま連鎖させれば成功値・失敗値はコピーされません。
  *
  * @tparam T 成功値の型
  * @tparam E 失敗値の型
  */
 template <typename T, typename E>
-class Result {
+class Result : private detail::EnableCopyMoveFor<
+                   typename detail::ValueTraits<T>::stored_type,
+                   E> {
  private:
-  std::variant<Ok<T>, Err<E>> m_value;
+  using Traits = detail::ValueTraits<T>;
+  using Stored = typename Traits::stored_type;
+
+  detail::Storage<Stored, E> m_storage;
+
+  template <typename, typename>
+  friend class Result;
+
+  template <typename F, typename S>
+  using invoke_result_t =
+      decltype(Traits::invoke(std::declval<F>(), std::declval<S>()));
+
+  template <typename F, typename S>
+  using invoke_err_result_t = decltype(std::declval<F>()(std::declval<S>()));
+
+  /** @brief 関数の戻り値(voidを含む)から成功のResult<U, E>を構築 */
+  template <typename U, typename F, typename S>
+  static constexpr Result<U, E> make_mapped(F&& f, S&& value) {
+    if constexpr (std::is_void_v<U>) {
+      Traits::invoke(std::forward<F>(f), std::forward<S>(value));
+      return Result<U, E>(detail::InPlaceOk{});
+    } else {
+      return Result<U, E>(detail::InPlaceOk{},
+                          Traits::invoke(std::forward<F>(f),
+                                         std::forward<S>(value)));
+    }
+  }
 
  public:
+  using value_type = T;
+  using error_type = E;
+
   /** @brief 成功値からResultを構築 */
-  Result(const Ok<T>& ok) : m_value(ok) {}
+  constexpr Result(const Ok<T>& ok)
+      : m_storage(detail::InPlaceOk{}, Traits::from_ok(ok)) {}
   /** @brief 成功値からResultを構築（ムーブ） */
-  Result(Ok<T>&& ok) : m_value(std::move(ok)) {}
+  constexpr Result(Ok<T>&& ok)
+      : m_storage(detail::InPlaceOk{}, Traits::from_ok(std::move(ok))) {}
   /** @brief 失敗値からResultを構築 */
-  Result(const Err<E>& err) : m_value(err) {}
+  constexpr Result(const Err<E>& err)
+      : m_storage(detail::InPlaceErr{}, err.m_value) {}
   /** @brief 失敗値からResultを構築（ムーブ） */
-  Result(Err<E>&& err) : m_value(std::move(err)) {}
+  constexpr Result(Err<E>&& err)
+      : m_storage(detail::InPlaceErr{}, std::move(err.m_value)) {}
+
+  /** @brief 成功値を格納領域に直接構築 */
+  template <typename... Args>
+  constexpr explicit Result(detail::InPlaceOk, Args&&... args)
+      : m_storage(detail::InPlaceOk{}, std::forward<Args>(args)...) {}
+  /** @brief 失敗値を格納領域に直接構築 */
+  template <typename... Args>
+  constexpr explicit Result(detail::InPlaceErr, Args&&... args)
+      : m_storage(detail::InPlaceErr{}, std::forward<Args>(args)...) {}
 
   /** @brief 成功値を保持しているかどうかを判定 */
-  bool is_ok() const { return std::holds_alternative<Ok<T>>(m_value); }
+  constexpr bool is_ok() const { return m_storage.is_ok(); }
 
   /** @brief 失敗値を保持しているかどうかを判定 */
-  bool is_err() const { return std::holds_alternative<Err<E>>(m_value); }
+  constexpr bool is_err() const { return !m_storage.is_ok(); }
 
   /**
    * @brief 成功値を取得（ムーブ）
    * @note 失敗値を保持している場合はassertで停止
    */
-  T unwrap() {
+  constexpr T unwrap() {
     assert(is_ok() && "Called unwrap on an Err value");
-    return std::move(std::get<Ok<T>>(m_value).m_value);
+    return Traits::take(m_storage.ok());
   }
 
   /**
    * @brief 成功値もしくはデフォルト値を取得（ムーブ）
    * @param default_value 失敗時に返す値
    */
-  T unwrap_or(T&& default_value) {
+  template <typename U = T, typename = std::enable_if_t<!std::is_void_v<U>>>
+  constexpr T unwrap_or(std::add_rvalue_reference_t<U> default_value) {
     if (is_ok()) {
-      return std::move(std::get<Ok<T>>(m_value).m_value);
+      return Traits::take(m_storage.ok());
     }
     return std::forward<T>(default_value);
   }
@@ -105,110 +290,243 @@ class Result {
    * @brief 成功値への参照を取得
    * @note 失敗値を保持している場合はassertで停止
    */
-  T& ref_ok() {
+  constexpr typename Traits::reference ref_ok() {
     assert(is_ok() && "Called ref_ok on an Err value");
-    return std::get<Ok<T>>(m_value).m_value;
+    return Traits::get(m_storage.ok());
   }
 
   /**
    * @brief 成功値へのconst参照を取得
    * @note 失敗値を保持している場合はassertで停止
    */
-  const T& ref_ok() const {
+  constexpr typename Traits::const_reference ref_ok() const {
     assert(is_ok() && "Called ref_ok on an Err value");
-    return std::get<Ok<T>>(m_value).m_value;
+    return Traits::get(m_storage.ok());
   }
 
   /**
    * @brief 失敗値を取得（ムーブ）
    * @note 成功値を保持している場合はassertで停止
    */
-  E unwrap_err() {
+  constexpr E unwrap_err() {
     assert(is_err() && "Called unwrap_err on an Ok value");
-    return std::move(std::get<Err<E>>(m_value).m_value);
+    return std::move(m_storage.err());
   }
 
   /**
    * @brief 失敗値への参照を取得
    * @note 成功値を保持している場合はassertで停止
    */
-  E& ref_err() {
+  constexpr E& ref_err() {
     assert(is_err() && "Called ref_err on an Ok value");
-    return std::get<Err<E>>(m_value).m_value;
+    return m_storage.err();
   }
 
   /**
    * @brief 失敗値へのconst参照を取得
    * @note 成功値を保持している場合はassertで停止
    */
-  const E& ref_err() const {
+  constexpr const E& ref_err() const {
     assert(is_err() && "Called ref_err on an Ok value");
-    return std::get<Err<E>>(m_value).m_value;
+    return m_storage.err();
   }
 
   /**
    * @brief 成功値に関数を適用
-   * @param f 適用する関数
+   * @param f 適用する関数（成功値への参照を受け取る）
+   */
+  template <typename F>
+  constexpr auto map(F&& f) & -> Result<invoke_result_t<F, Stored&>, E> {
+    using U = invoke_result_t<F, Stored&>;
+    if (is_ok()) {
+      return make_mapped<U>(std::forward<F>(f), m_storage.ok());
+    }
+    return Result<U, E>(detail::InPlaceErr{}, m_storage.err());
+  }
+
+  /**
+   * @brief 成功値に関数を適用
+   * @param f 適用する関数（成功値へのconst参照を受け取る）
+   */
+  template <typename F>
+  constexpr auto map(F&& f) const&
+      -> Result<invoke_result_t<F, const Stored&>, E> {
+    using U = invoke_result_t<F, const Stored&>;
+    if (is_ok()) {
+      return make_mapped<U>(std::forward<F>(f), m_storage.ok());
+    }
+    return Result<U, E>(detail::InPlaceErr{}, m_storage.err());
+  }
+
+  /**
+   * @brief 成功値に関数を適用（成功値・失敗値をムーブ）
+   * @param f 適用する関数（成功値を右辺値で受け取る）
+   */
+  template <typename F>
+  constexpr auto map(F&& f) && -> Result<invoke_result_t<F, Stored&&>, E> {
+    using U = invoke_result_t<F, Stored&&>;
+    if (is_ok()) {
+      return make_mapped<U>(std::forward<F>(f), std::move(m_storage.ok()));
+    }
+    return Result<U, E>(detail::InPlaceErr{}, std::move(m_storage.err()));
+  }
+
+  /**
+   * @brief 失敗値に関数を適用
+   * @param f 適用する関数（失敗値への参照を受け取る）
    */
   template <typename F>
-  auto map(F&& f) -> Result<decltype(f(std::declval<T>())), E> {
-    Result self = std::move(*this);
-    if (self.is_ok()) {
-      return make_ok(f(std::get<Ok<T>>(self.m_value).m_value));
+  constexpr auto map_err(F&& f) & -> Result<T, invoke_err_result_t<F, E&>> {
+    using R = Result<T, invoke_err_result_t<F, E&>>;
+    if (is_err()) {
+      return R(detail::InPlaceErr{}, std::forward<F>(f)(m_storage.err()));
     }
-    return Err<E>(std::get<Err<E>>(self.m_value).m_value);
+    return R(detail::InPlaceOk{}, m_storage.ok());
   }
 
   /**
    * @brief 失敗値に関数を適用
+   * @param f 適用する関数（失敗値へのconst参照を受け取る）
+   */
+  template <typename F>
+  constexpr auto map_err(F&& f) const&
+      -> Result<T, invoke_err_result_t<F, const E&>> {
+    using R = Result<T, invoke_err_result_t<F, const E&>>;
+    if (is_err()) {
+      return R(detail::InPlaceErr{}, std::forward<F>(f)(m_storage.err()));
+    }
+    return R(detail::InPlaceOk{}, m_storage.ok());
+  }
+
+  /**
+   * @brief 失敗値に関数を適用（成功値・失敗値をムーブ）
+   * @param f 適用する関数（失敗値を右辺値で受け取る）
+   */
+  template <typename F>
+  constexpr auto map_err(F&& f) && -> Result<T, invoke_err_result_t<F, E&&>> {
+    using R = Result<T, invoke_err_result_t<F, E&&>>;
+    if (is_err()) {
+      return R(detail::InPlaceErr{},
+               std::forward<F>(f)(std::move(m_storage.err())));
+    }
+    return R(detail::InPlaceOk{}, std::move(m_storage.ok()));
+  }
+
+  /**
+   * @brief 成功値に関数を適用
    * @param f 適用する関数
+   * @return 自身への参照
    */
   template <typename F>
-  auto map_err(F&& f) -> Result<T, decltype(f(std::declval<E>()))> {
-    Result self = std::move(*this);
-    if (self.is_err()) {
-      return make_err(f(std::get<Err<E>>(self.m_value).m_value));
+  constexpr Result& inspect_ok(F&& f) & {
+    if (is_ok()) {
+      Traits::invoke(std::forward<F>(f), m_storage.ok());
     }
-    return Ok<T>(std::get<Ok<T>>(self.m_value).m_value);
+    return *this;
   }
 
   /**
    * @brief 成功値に関数を適用
    * @param f 適用する関数
+   * @return 自身へのconst参照
    */
   template <typename F>
-  Result inspect_ok(F&& f) {
-    Result self = std::move(*this);
-    if (self.is_ok()) {
-      f(std::get<Ok<T>>(self.m_value).m_value);
+  constexpr const Result& inspect_ok(F&& f) const& {
+    if (is_ok()) {
+      Traits::invoke(std::forward<F>(f), m_storage.ok());
     }
-    return self;
+    return *this;
+  }
+
+  /**
+   * @brief 成功値に関数を適用
+   * @param f 適用する関数
+   * @return ムーブされた自身
+   */
+  template <typename F>
+  constexpr Result inspect_ok(F&& f) && {
+    if (is_ok()) {
+      Traits::invoke(std::forward<F>(f), m_storage.ok());
+    }
+    return std::move(*this);
   }
 
   /**
    * @brief 失敗値に関数を適用
    * @param f 適用する関数
+   * @return 自身への参照
    */
   template <typename F>
-  Result inspect_err(F&& f) {
-    Result self = std::move(*this);
-    if (self.is_err()) {
-      f(std::get<Err<E>>(self.m_value).m_value);
+  constexpr Result& inspect_err(F&& f) & {
+    if (is_err()) {
+      std::forward<F>(f)(m_storage.err());
     }
-    return self;
+    return *this;
+  }
+
+  /**
+   * @brief 失敗値に関数を適用
+   * @param f 適用する関数
+   * @return 自身へのconst参照
+   */
+  template <typename F>
+  constexpr const Result& inspect_err(F&& f) const& {
+    if (is_err()) {
+      std::forward<F>(f)(m_storage.err());
+    }
+    return *this;
+  }
+
+  /**
+   * @brief 失敗値に関数を適用
+   * @param f 適用する関数
+   * @return ムーブされた自身
+   */
+  template <typename F>
+  constexpr Result inspect_err(F&& f) && {
+    if (is_err()) {
+      std::forward<F>(f)(m_storage.err());
+    }
+    return std::move(*this);
+  }
+
+  /**
+   * @brief 成功値に関数を適用し、新しいResultを生成
+   * @param f Result<U, E>を返す関数（成功値への参照を受け取る）
+   */
+  template <typename F>
+  constexpr auto and_then(F&& f) & -> invoke_result_t<F, Stored&> {
+    using R = invoke_result_t<F, Stored&>;
+    if (is_ok()) {
+      return Traits::invoke(std::forward<F>(f), m_storage.ok());
+    }
+    return R(detail::InPlaceErr{}, m_storage.err());
   }
 
   /**
    * @brief 成功値に関数を適用し、新しいResultを生成
-   * @param f Result<U, E>を返す関数
+   * @param f Result<U, E>を返す関数（成功値へのconst参照を受け取る）
    */
   template <typename F>
-  auto and_then(F&& f) -> decltype(f(std::declval<T>())) {
-    Result self = std::move(*this);
-    if (self.is_ok()) {
-      return f(std::get<Ok<T>>(self.m_value).m_value);
+  constexpr auto and_then(F&& f) const& -> invoke_result_t<F, const Stored&> {
+    using R = invoke_result_t<F, const Stored&>;
+    if (is_ok()) {
+      return Traits::invoke(std::forward<F>(f), m_storage.ok());
+    }
+    return R(detail::InPlaceErr{}, m_storage.err());
+  }
+
+  /**
+   * @brief 成功値に関数を適用し、新しいResultを生成（成功値・失敗値をムーブ）
+   * @param f Result<U, E>を返す関数（成功値を右辺値で受け取る）
+   */
+  template <typename F>
+  constexpr auto and_then(F&& f) && -> invoke_result_t<F, Stored&&> {
+    using R = invoke_result_t<F, Stored&&>;
+    if (is_ok()) {
+      return Traits::invoke(std::forward<F>(f), std::move(m_storage.ok()));
     }
-    return Err<E>(std::get<Err<E>>(self.m_value).m_value);
+    return R(detail::InPlaceErr{}, std::move(m_storage.err()));
   }
 };
 
@@ -0,0 +1,240 @@
+#pragma once
+
+#include <cassert>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include "niche.h"
+
+namespace s6i_result::detail {
+
+/** @brief 成功値を直接構築するためのタグ */
+struct InPlaceOk {};
+/** @brief 失敗値を直接構築するためのタグ */
+struct InPlaceErr {};
+
+/**
+ * @brief 失敗値のニッチにタグを詰め込めるかどうか
+ *
+ * 成功値が空の型（std::monostateなど）で、失敗値がニッチを持つ場合に限り、
+ * 成功値の領域とタグを省略できます。
+ */
+template <typename T, typename E>
+inline constexpr bool use_niche_v =
+    std::is_empty_v<T> && !std::is_final_v<T> &&
+    std::is_trivially_copyable_v<T> &&
+    std::is_default_constructible_v<T> && NicheTraits<E>::enabled &&
+    std::is_trivially_copyable_v<E>;
+
+/** @brief T, Eがともにトリビアルコピー可能かどうか */
+template <typename T, typename E>
+inline constexpr bool both_trivially_copyable_v =
+    std::is_trivially_copyable_v<T> && std::is_trivially_copyable_v<E>;
+
+/**
+ * @brief 共用体とタグによるResultの格納領域
+ *
+ * T, Eがともにトリビアルコピー可能な場合は特殊メンバ関数をすべて既定とし、
+ * 格納領域自体もトリビアルコピー可能（レジスタ渡し可能）になります。
+ *
+ * @tparam T 成功値の型
+ * @tparam E 失敗値の型
+ * @tparam Trivial T, Eがともにトリビアルコピー可能かどうか
+ */
+template <typename T,
+          typename E,
+          bool Trivial = both_trivially_copyable_v<T, E>>
+class UnionStorage {
+ public:
+  template <typename... Args>
+  constexpr explicit UnionStorage(InPlaceOk, Args&&... args)
+      : m_ok(std::forward<Args>(args)...), m_is_ok(true) {}
+
+  template <typename... Args>
+  constexpr explicit UnionStorage(InPlaceErr, Args&&... args)
+      : m_err(std::forward<Args>(args)...), m_is_ok(false) {}
+
+  UnionStorage(const UnionStorage& other) : m_is_ok(other.m_is_ok) {
+    if (m_is_ok) {
+      ::new (static_cast<void*>(&m_ok)) T(other.m_ok);
+    } else {
+      ::new (static_cast<void*>(&m_err)) E(other.m_err);
+    }
+  }
+
+  // 規約の例外: std::vectorの再配置(move_if_noexcept)でコピーされないよう指定
+  UnionStorage(UnionStorage&& other) noexcept(
+      std::is_nothrow_move_constructible_v<T> &&
+      std::is_nothrow_move_constructible_v<E>)
+      : m_is_ok(other.m_is_ok) {
+    if (m_is_ok) {
+      ::new (static_cast<void*>(&m_ok)) T(std::move(other.m_ok));
+    } else {
+      ::new (static_cast<void*>(&m_err)) E(std::move(other.m_err));
+    }
+  }
+
+  UnionStorage& operator=(const UnionStorage& other) {
+    if (this == &other) {
+      return *this;
+    }
+    if (m_is_ok && other.m_is_ok) {
+      m_ok = other.m_ok;
+    } else if (!m_is_ok && !other.m_is_ok) {
+      m_err = other.m_err;
+    } else {
+      destroy();
+      ::new (static_cast<void*>(this)) UnionStorage(other);
+    }
+    return *this;
+  }
+
+  // 規約の例外: ムーブコンストラクターと揃えてnoexceptを付ける
+  UnionStorage& operator=(UnionStorage&& other) noexcept(
+      std::is_nothrow_move_constructible_v<T> &&
+      std::is_nothrow_move_constructible_v<E> &&
+      std::is_nothrow_move_assignable_v<T> &&
+      std::is_nothrow_move_assignable_v<E>) {
+    if (this == &other) {
+      return *this;
+    }
+    if (m_is_ok && other.m_is_ok) {
+      m_ok = std::move(other.m_ok);
+    } else if (!m_is_ok && !other.m_is_ok) {
+      m_err = std::move(other.m_err);
+    } else {
+      destroy();
+      ::new (static_cast<void*>(this)) UnionStorage(std::move(other));
+    }
+    return *this;
+  }
+
+  ~UnionStorage() { destroy(); }
+
+  constexpr bool is_ok() const { return m_is_ok; }
+
+  constexpr T& ok() { return m_ok; }
+  constexpr const T& ok() const { return m_ok; }
+  constexpr E& err() { return m_err; }
+  constexpr const E& err() const { return m_err; }
+
+ private:
+  void destroy() {
+    if (m_is_ok) {
+      m_ok.~T();
+    } else {
+      m_err.~E();
+    }
+  }
+
+  union {
+    T m_ok;
+    E m_err;
+  };
+  bool m_is_ok;
+};
+
+/**
+ * @brief T, Eがともにトリビアルコピー可能な場合の格納領域
+ */
+template <typename T, typename E>
+class UnionStorage<T, E, true> {
+ public:
+  template <typename... Args>
+  constexpr explicit UnionStorage(InPlaceOk, Args&&... args)
+      : m_ok(std::forward<Args>(args)...), m_is_ok(true) {}
+
+  template <typename... Args>
+  constexpr explicit UnionStorage(InPlaceErr, Args&&... args)
+      : m_err(std::forward<Args>(args)...), m_is_ok(false) {}
+
+  constexpr bool is_ok() const { return m_is_ok; }
+
+  constexpr T& ok() { return m_ok; }
+  constexpr const T& ok() const { return m_ok; }
+  constexpr E& err() { return m_err; }
+  constexpr const E& err() const { return m_err; }
+
+ private:
+  union {
+    T m_ok;
+    E m_err;
+  };
+  bool m_is_ok;
+};
+
+/**
+ * @brief 失敗値のニッチをタグとして使う格納領域
+ *
+ * 成功値は空の型なので基底クラスとして保持し（空基底最適化）、
+ * 失敗値がNicheTraits<E>::valueのときを成功状態とみなします。
+ * そのためsizeof(NicheStorage<T, E>) == sizeof(E)となります。
+ */
+template <typename T, typename E>
+class NicheStorage : private T {
+ public:
+  template <typename... Args>
+  constexpr explicit NicheStorage(InPlaceOk, Args&&... args)
+      : T(std::forward<Args>(args)...), m_err(NicheTraits<E>::value) {}
+
+  template <typename... Args>
+  constexpr explicit NicheStorage(InPlaceErr, Args&&... args)
+      : T(), m_err(std::forward<Args>(args)...) {
+    assert(!(m_err == NicheTraits<E>::value) &&
+           "Niche value cannot be stored as an error");
+  }
+
+  constexpr bool is_ok() const { return m_err == NicheTraits<E>::value; }
+
+  constexpr T& ok() { return *this; }
+  constexpr const T& ok() const { return *this; }
+  constexpr E& err() { return m_err; }
+  constexpr const E& err() const { return m_err; }
+
+ private:
+  E m_err;
+};
+
+/**
+ * @brief T, Eに応じて最適な格納領域を選択
+ */
+template <typename T, typename E>
+using Storage = std::conditional_t<use_niche_v<T, E>,
+                                   NicheStorage<T, E>,
+                                   UnionStorage<T, E>>;
+
+/**
+ * @brief コピー/ムーブ可否をT, Eに合わせるための空の基底クラス
+ *
+ * 格納領域はコピーコンストラクタを常に宣言しているため、
+ * この基底クラスでResultのコピー/ムーブを明示的に削除します。
+ */
+template <bool Copy, bool Move>
+struct EnableCopyMove {};
+
+template <>
+struct EnableCopyMove<false, true> {
+  EnableCopyMove() = default;
+  EnableCopyMove(const EnableCopyMove&) = delete;
+  EnableCopyMove(EnableCopyMove&&) = default;
+  EnableCopyMove& operator=(const EnableCopyMove&) = delete;
+  EnableCopyMove& operator=(EnableCopyMove&&) = default;
+};
+
+template <>
+struct EnableCopyMove<false, false> {
+  EnableCopyMove() = default;
+  EnableCopyMove(const EnableCopyMove&) = delete;
+  EnableCopyMove(EnableCopyMove&&) = delete;
+  EnableCopyMove& operator=(const EnableCopyMove&) = delete;
+  EnableCopyMove& operator=(EnableCopyMove&&) = delete;
+};
+
+template <typename T, typename E>
+using EnableCopyMoveFor =
+    EnableCopyMove<std::is_copy_constructible_v<T> &&
+                       std::is_copy_constructible_v<E>,
+                   std::is_move_constructible_v<T> &&
+                       std::is_move_constructible_v<E>>;
+
+}  // namespace s6i_result::detail
@@ -0,0 +1,84 @@
+#pragma once
+
+#include <utility>
+#include "context.h"
+#include "result.h"
+
+#define S6I_RESULT_CONCAT_IMPL(a, b) a##b
+#define S6I_RESULT_CONCAT(a, b) S6I_RESULT_CONCAT_IMPL(a, b)
+#define S6I_RESULT_TMP S6I_RESULT_CONCAT(s6i_try_result_, __LINE__)
+
+/**
+ * @brief Resultが失敗値を保持していれば、その失敗値で即座にreturnする
+ *
+ * 成功値は破棄されます（Result<void, E>の伝播に使います）。
+ * 呼び出し元の関数はResult<U, E>（Eは同じ型）を返す必要があります。
+ *
+ * @code
+ * S6I_TRY(cond.wait(guard));
+ * @endcode
+ */
+#define S6I_TRY(expr)                                             \
+  do {                                                            \
+    auto&& s6i_try_result = (expr);                               \
+    if (s6i_try_result.is_err()) {                                \
+      return ::s6i_result::make_err(s6i_try_result.unwrap_err()); \
+    }                                                             \
+  } while (false)
+
+/**
+ * @brief 失敗値を作り、ErrorContextに新しいエラーの経路を始める
+ *
+ * それまでに記録された文脈（処理済みの古いエラーのもの）は破棄されます。
+ *
+ * @code
+ * return S6I_ERR_CTX(ConfigError::InvalidValue, "parse value");
+ * @endcode
+ *
+ * @param error 失敗値
+ * @param message 文脈の説明（文字列リテラル）
+ */
+#define S6I_ERR_CTX(error, message)                                \
+  (::s6i_result::ErrorContext::begin(message, __FILE__, __LINE__), \
+   ::s6i_result::make_err(error))
+
+/**
+ * @brief S6I_TRYに加え、失敗時にErrorContextへ文脈を記録する
+ * @param message 文脈の説明（文字列リテラル）
+ */
+#define S6I_TRY_CTX(expr, message)                                   \
+  do {                                                               \
+    auto&& s6i_try_result = (expr);                                  \
+    if (s6i_try_result.is_err()) {                                   \
+      ::s6i_result::ErrorContext::push(message, __FILE__, __LINE__); \
+      return ::s6i_result::make_err(s6i_try_result.unwrap_err());    \
+    }                                                                \
+  } while (false)
+
+/**
+ * @brief 成功値をlhsに束縛し、失敗値を保持していれば即座にreturnする
+ *
+ * lhsには変数宣言（auto guardなど）もしくは既存の変数を指定できます。
+ *
+ * @code
+ * S6I_TRY_ASSIGN(auto guard, mutex.lock());
+ * @endcode
+ */
+#define S6I_TRY_ASSIGN(lhs, expr)                               \
+  auto&& S6I_RESULT_TMP = (expr);                               \
+  if (S6I_RESULT_TMP.is_err()) {                                \
+    return ::s6i_result::make_err(S6I_RESULT_TMP.unwrap_err()); \
+  }                                                             \
+  lhs = S6I_RESULT_TMP.unwrap()
+
+/**
+ * @brief S6I_TRY_ASSIGNに加え、失敗時にErrorContextへ文脈を記録する
+ * @param message 文脈の説明（文字列リテラル）
+ */
+#define S6I_TRY_ASSIGN_CTX(lhs, expr, message)                     \
+  auto&& S6I_RESULT_TMP = (expr);                                  \
+  if (S6I_RESULT_TMP.is_err()) {                                   \
+    ::s6i_result::ErrorContext::push(message, __FILE__, __LINE__); \
+    return ::s6i_result::make_err(S6I_RESULT_TMP.unwrap_err());    \
+  }                                                                \
+  lhs = S6I_RESULT_TMP.unwrap()
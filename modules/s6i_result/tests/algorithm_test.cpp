@@ -0,0 +1,133 @@
+#include "s6i_result/algorithm.h"
+#include <gtest/gtest.h>
+#include <array>
+#include <list>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace {
+
+using s6i_result::Result;
+
+std::vector<Result<int, std::string>> make_results(int count, int err_at) {
+  std::vector<Result<int, std::string>> results;
+  for (int i = 0; i < count; ++i) {
+    if (i == err_at) {
+      results.push_back(s6i_result::make_err("error " + std::to_string(i)));
+    } else {
+      results.push_back(s6i_result::make_ok(i));
+    }
+  }
+  return results;
+}
+
+// すべて成功した場合は成功値の配列になることを確認
+TEST(AlgorithmTest, CollectAllOk) {
+  const auto results = make_results(10, -1);
+  auto collected = s6i_result::collect(results);
+  ASSERT_TRUE(collected.is_ok());
+  auto values = collected.unwrap();
+  ASSERT_EQ(values.size(), 10u);
+  EXPECT_EQ(values.capacity(), 10u);
+  for (int i = 0; i < 10; ++i) {
+    EXPECT_EQ(values[i], i);
+  }
+}
+
+// 最初の失敗値で打ち切られることを確認
+TEST(AlgorithmTest, CollectFirstError) {
+  auto results = make_results(10, 3);
+  results[7] = s6i_result::make_err<std::string>("later");
+  auto collected = s6i_result::collect(results);
+  ASSERT_TRUE(collected.is_err());
+  EXPECT_EQ(collected.unwrap_err(), "error 3");
+}
+
+// 右辺値の範囲から成功値がムーブされることを確認
+TEST(AlgorithmTest, CollectMovesFromRvalueRange) {
+  std::vector<Result<std::unique_ptr<int>, std::string>> results;
+  std::vector<int*> raw;
+  for (int i = 0; i < 4; ++i) {
+    auto p = std::make_unique<int>(i);
+    raw.push_back(p.get());
+    results.push_back(s6i_result::make_ok(std::move(p)));
+  }
+  auto collected = s6i_result::collect(std::move(results));
+  ASSERT_TRUE(collected.is_ok());
+  auto values = collected.unwrap();
+  ASSERT_EQ(values.size(), 4u);
+  for (size_t i = 0; i < values.size(); ++i) {
+    EXPECT_EQ(values[i].get(), raw[i]);
+  }
+}
+
+// 予約できないイテレータでも動作することを確認
+TEST(AlgorithmTest, CollectFromList) {
+  std::list<Result<int, std::string>> results;
+  results.push_back(s6i_result::make_ok(1));
+  results.push_back(s6i_result::make_ok(2));
+  auto collected = s6i_result::collect(results.begin(), results.end());
+  ASSERT_TRUE(collected.is_ok());
+  EXPECT_EQ(collected.unwrap(), (std::vector<int>{1, 2}));
+}
+
+// 呼び出し側の領域へ直接書き出すことを確認
+TEST(AlgorithmTest, CollectIntoCallerStorage) {
+  const auto results = make_results(5, -1);
+  std::array<int, 5> storage{};
+  auto written =
+      s6i_result::collect_into(results.begin(), results.end(), storage.data());
+  ASSERT_TRUE(written.is_ok());
+  EXPECT_EQ(written.unwrap(), storage.data() + storage.size());
+  EXPECT_EQ(storage, (std::array<int, 5>{0, 1, 2, 3, 4}));
+
+  const auto failing = make_results(5, 2);
+  std::array<int, 5> partial{};
+  auto failed =
+      s6i_result::collect_into(failing.begin(), failing.end(), partial.data());
+  ASSERT_TRUE(failed.is_err());
+  EXPECT_EQ(failed.unwrap_err(), "error 2");
+  // 失敗までの成功値だけが書き込まれている
+  EXPECT_EQ(partial, (std::array<int, 5>{0, 1, 0, 0, 0}));
+}
+
+// 成功値と失敗値に振り分けられることを確認
+TEST(AlgorithmTest, Partition) {
+  auto results = make_results(6, -1);
+  results[1] = s6i_result::make_err<std::string>("a");
+  results[4] = s6i_result::make_err<std::string>("b");
+
+  auto [values, errors] = s6i_result::partition(std::move(results));
+  EXPECT_EQ(values, (std::vector<int>{0, 2, 3, 5}));
+  EXPECT_EQ(values.capacity(), 4u);
+  EXPECT_EQ(errors, (std::vector<std::string>{"a", "b"}));
+  EXPECT_EQ(errors.capacity(), 2u);
+}
+
+// 変換しながらまとめられることを確認
+TEST(AlgorithmTest, TryTransform) {
+  const std::vector<int> inputs = {1, 2, 3};
+  auto doubled = s6i_result::try_transform(
+      inputs, [](int x) -> Result<int, std::string> {
+        return s6i_result::make_ok(x * 2);
+      });
+  ASSERT_TRUE(doubled.is_ok());
+  EXPECT_EQ(doubled.unwrap(), (std::vector<int>{2, 4, 6}));
+
+  int calls = 0;
+  auto failed = s6i_result::try_transform(
+      inputs, [&](int x) -> Result<int, std::string> {
+        ++calls;
+        if (x == 2) {
+          return s6i_result::make_err<std::string>("two");
+        }
+        return s6i_result::make_ok(x);
+      });
+  ASSERT_TRUE(failed.is_err());
+  EXPECT_EQ(failed.unwrap_err(), "two");
+  // 失敗以降の要素は処理されない
+  EXPECT_EQ(calls, 2);
+}
+
+}  // namespace
@@ -0,0 +1,96 @@
+#include "s6i_result/result.h"
+#include <gtest/gtest.h>
+#include <array>
+#include <cstddef>
+
+namespace {
+
+using s6i_result::Result;
+
+enum class TableError {
+  InvalidKey,
+  DuplicateKey,
+};
+
+// 基本操作が定数式で使えることを確認
+static_assert(Result<int, TableError>(s6i_result::make_ok(1)).is_ok());
+static_assert(
+    Result<int, TableError>(s6i_result::make_err(TableError::InvalidKey))
+        .is_err());
+static_assert(Result<int, TableError>(s6i_result::make_ok(42)).unwrap() == 42);
+static_assert(
+    Result<int, TableError>(s6i_result::make_err(TableError::DuplicateKey))
+        .unwrap_err() == TableError::DuplicateKey);
+static_assert(Result<int, TableError>(s6i_result::make_err(
+                                          TableError::InvalidKey))
+                  .unwrap_or(7) == 7);
+static_assert(Result<void, TableError>(s6i_result::make_ok()).is_ok());
+
+// map / and_thenが定数式で使えることを確認
+static_assert(Result<int, TableError>(s6i_result::make_ok(20))
+                  .map([](int x) { return x + 1; })
+                  .map([](int x) { return x * 2; })
+                  .unwrap() == 42);
+static_assert(Result<int, TableError>(s6i_result::make_ok(1))
+                  .and_then([](int x) -> Result<int, TableError> {
+                    if (x > 0) {
+                      return s6i_result::make_err(TableError::InvalidKey);
+                    }
+                    return s6i_result::make_ok(x);
+                  })
+                  .unwrap_err() == TableError::InvalidKey);
+static_assert(Result<int, TableError>(
+                  s6i_result::make_err(TableError::InvalidKey))
+                  .map_err([](TableError) { return 5; })
+                  .unwrap_err() == 5);
+
+// キー文字をスロット番号へ変換する
+constexpr Result<size_t, TableError> parse_key(char key) {
+  if (key >= 'a' && key <= 'z') {
+    return s6i_result::make_ok(static_cast<size_t>(key - 'a'));
+  }
+  return s6i_result::make_err(TableError::InvalidKey);
+}
+
+using KeyTable = std::array<int, 26>;
+
+// キー定義からルックアップテーブルをコンパイル時に構築・検証する
+template <size_t N>
+constexpr Result<KeyTable, TableError> build_table(const char (&keys)[N]) {
+  KeyTable table{};
+  for (auto& slot : table) {
+    slot = -1;
+  }
+  for (size_t i = 0; i + 1 < N; ++i) {
+    auto slot = parse_key(keys[i]);
+    if (slot.is_err()) {
+      return s6i_result::make_err(slot.unwrap_err());
+    }
+    const size_t index = slot.unwrap();
+    if (table[index] != -1) {
+      return s6i_result::make_err(TableError::DuplicateKey);
+    }
+    table[index] = static_cast<int>(i);
+  }
+  return s6i_result::make_ok(table);
+}
+
+constexpr auto KEY_TABLE = build_table("wasd").unwrap();
+static_assert(KEY_TABLE['w' - 'a'] == 0);
+static_assert(KEY_TABLE['a' - 'a'] == 1);
+static_assert(KEY_TABLE['s' - 'a'] == 2);
+static_assert(KEY_TABLE['d' - 'a'] == 3);
+static_assert(KEY_TABLE['x' - 'a'] == -1);
+
+static_assert(build_table("wasw").unwrap_err() == TableError::DuplicateKey);
+static_assert(build_table("wa1d").unwrap_err() == TableError::InvalidKey);
+
+// 定数式で構築したテーブルが実行時にも使えることを確認
+TEST(ConstexprTest, TableAvailableAtRuntime) {
+  EXPECT_EQ(KEY_TABLE['d' - 'a'], 3);
+  auto runtime = build_table("dsaw");
+  ASSERT_TRUE(runtime.is_ok());
+  EXPECT_EQ(runtime.unwrap()['w' - 'a'], 3);
+}
+
+}  // namespace
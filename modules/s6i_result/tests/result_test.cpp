@@ -1,6 +1,8 @@
 #include "s6i_result/result.h"
 #include <gtest/gtest.h>
+#include <memory>
 #include <string>
+#include <vector>
 
 namespace {
 
@@ -31,6 +33,55 @@ class MoveOnlyType {
   int m_value;
 };
 
+// ヒープ上のバッファを持ち、確保・コピー・ムーブの回数を数える型
+class HeapPayload {
+ public:
+  explicit HeapPayload(size_t size)
+      : m_buffer(std::make_unique<std::vector<int>>(size, 1)) {
+    ++s_allocations;
+  }
+  HeapPayload(const HeapPayload& other)
+      : m_buffer(std::make_unique<std::vector<int>>(*other.m_buffer)) {
+    ++s_allocations;
+    ++s_copies;
+  }
+  HeapPayload(HeapPayload&& other) noexcept
+      : m_buffer(std::move(other.m_buffer)) {
+    ++s_moves;
+  }
+  HeapPayload& operator=(const HeapPayload& other) {
+    m_buffer = std::make_unique<std::vector<int>>(*other.m_buffer);
+    ++s_allocations;
+    ++s_copies;
+    return *this;
+  }
+  HeapPayload& operator=(HeapPayload&& other) noexcept {
+    m_buffer = std::move(other.m_buffer);
+    ++s_moves;
+    return *this;
+  }
+
+  const int* data() const { return m_buffer->data(); }
+  size_t size() const { return m_buffer->size(); }
+
+  static void reset_counters() {
+    s_allocations = 0;
+    s_copies = 0;
+    s_moves = 0;
+  }
+
+  static int s_allocations;
+  static int s_copies;
+  static int s_moves;
+
+ private:
+  std::unique_ptr<std::vector<int>> m_buffer;
+};
+
+int HeapPayload::s_allocations = 0;
+int HeapPayload::s_copies = 0;
+int HeapPayload::s_moves = 0;
+
 // ヘルパー関数のテスト
 TEST(ResultTest, MakeOkErrTest) {
   auto ok = s6i_result::make_ok(42);
@@ -272,4 +323,148 @@ TEST(ResultTest, MoveOnlyTypeTest) {
   EXPECT_EQ(mapped.ref_ok().value(), 20);
 }
 
+// Result<void, E>のテスト
+TEST(ResultTest, VoidTest) {
+  s6i_result::Result<void, std::string> ok_result = s6i_result::make_ok();
+  s6i_result::Result<void, std::string> err_result =
+      s6i_result::make_err<std::string>("error");
+
+  EXPECT_TRUE(ok_result.is_ok());
+  EXPECT_TRUE(err_result.is_err());
+  EXPECT_EQ(err_result.ref_err(), "error");
+
+  // 引数なしの関数で成功値を変換
+  auto mapped = std::move(ok_result).map([]() { return 42; });
+  EXPECT_TRUE(mapped.is_ok());
+  EXPECT_EQ(mapped.unwrap(), 42);
+
+  // voidを返す関数でResult<void, E>へ変換
+  bool was_called = false;
+  s6i_result::Result<int, std::string> int_result = s6i_result::make_ok(1);
+  auto void_result = int_result.map([&](int) { was_called = true; });
+  static_assert(std::is_same_v<decltype(void_result),
+                               s6i_result::Result<void, std::string>>);
+  EXPECT_TRUE(was_called);
+  EXPECT_TRUE(void_result.is_ok());
+
+  auto chained = std::move(err_result).and_then(
+      []() -> s6i_result::Result<int, std::string> {
+        return s6i_result::make_ok(1);
+      });
+  EXPECT_TRUE(chained.is_err());
+  EXPECT_EQ(chained.unwrap_err(), "error");
+}
+
+// Result<T&, E>のテスト
+TEST(ResultTest, ReferenceTest) {
+  int value = 42;
+  s6i_result::Result<int&, std::string> ref_result =
+      s6i_result::make_ok(std::ref(value));
+  ASSERT_TRUE(ref_result.is_ok());
+
+  // 参照経由で元の値を変更できる
+  ref_result.ref_ok() = 100;
+  EXPECT_EQ(value, 100);
+  int& unwrapped = ref_result.unwrap();
+  EXPECT_EQ(&unwrapped, &value);
+
+  // コンビネータには参照がそのまま渡される
+  ref_result.inspect_ok([&](int& v) { EXPECT_EQ(&v, &value); });
+  auto mapped = ref_result.map([](int& v) { return v + 1; });
+  EXPECT_EQ(mapped.unwrap(), 101);
+
+  // 参照を保持したResultはトリビアルコピー可能
+  static_assert(std::is_trivially_copyable_v<s6i_result::Result<int&, int>>);
+  static_assert(sizeof(s6i_result::Result<int&, int>) <= 2 * sizeof(int*));
+}
+
+// 左辺値に対するコンビネータは元のResultを消費しないことを確認
+TEST(ResultTest, LvalueCombinatorTest) {
+  s6i_result::Result<std::string, std::string> ok_result =
+      s6i_result::make_ok<std::string>("value");
+
+  auto mapped = ok_result.map([](const std::string& s) { return s.size(); });
+  EXPECT_EQ(mapped.unwrap(), 5u);
+  // 元の値は残っている
+  EXPECT_EQ(ok_result.ref_ok(), "value");
+
+  const auto& const_result = ok_result;
+  auto const_mapped =
+      const_result.map([](const std::string& s) { return s + "!"; });
+  EXPECT_EQ(const_mapped.unwrap(), "value!");
+  EXPECT_EQ(ok_result.ref_ok(), "value");
+
+  // inspect_okは自身への参照を返す
+  auto& inspected = ok_result.inspect_ok([](std::string&) {});
+  EXPECT_EQ(&inspected, &ok_result);
+}
+
+// 右辺値のままコンビネータを連鎖させても成功値がコピーされないことを確認
+TEST(ResultTest, ChainNeverCopiesOkPayload) {
+  HeapPayload::reset_counters();
+  const int* original_data = nullptr;
+
+  auto result =
+      s6i_result::Result<HeapPayload, std::string>(
+          s6i_result::make_ok(HeapPayload(1024)))
+          .inspect_ok([&](const HeapPayload& p) { original_data = p.data(); })
+          .map([](HeapPayload&& p) { return std::move(p); })
+          .and_then([](HeapPayload&& p)
+                        -> s6i_result::Result<HeapPayload, std::string> {
+            return s6i_result::make_ok(std::move(p));
+          })
+          .map_err([](std::string&& e) { return e + "!"; })
+          .inspect_err([](const std::string&) { FAIL(); });
+
+  ASSERT_TRUE(result.is_ok());
+  EXPECT_EQ(result.ref_ok().data(), original_data);
+  EXPECT_EQ(result.ref_ok().size(), 1024u);
+  EXPECT_EQ(HeapPayload::s_allocations, 1);
+  EXPECT_EQ(HeapPayload::s_copies, 0);
+}
+
+// 右辺値のままコンビネータを連鎖させても失敗値がコピーされないことを確認
+TEST(ResultTest, ChainNeverCopiesErrPayload) {
+  HeapPayload::reset_counters();
+
+  auto result =
+      s6i_result::Result<int, HeapPayload>(
+          s6i_result::make_err(HeapPayload(1024)))
+          .map([](int x) { return x * 2; })
+          .inspect_ok([](int) { FAIL(); })
+          .and_then([](int x) -> s6i_result::Result<double, HeapPayload> {
+            return s6i_result::make_ok(static_cast<double>(x));
+          })
+          .map_err([](HeapPayload&& e) { return std::move(e); })
+          .inspect_err(
+              [](const HeapPayload& e) { EXPECT_EQ(e.size(), 1024u); });
+
+  ASSERT_TRUE(result.is_err());
+  EXPECT_EQ(HeapPayload::s_allocations, 1);
+  EXPECT_EQ(HeapPayload::s_copies, 0);
+}
+
+// ムーブオンリーでヒープを持つ成功値が連鎖を通じて同じバッファを保つことを確認
+TEST(ResultTest, ChainMoveOnlyPayload) {
+  auto buffer = std::make_unique<std::vector<int>>(256, 7);
+  const int* original_data = buffer->data();
+
+  auto result =
+      s6i_result::Result<std::unique_ptr<std::vector<int>>, std::string>(
+          s6i_result::make_ok(std::move(buffer)))
+          .map([](std::unique_ptr<std::vector<int>>&& p) {
+            (*p)[0] = 1;
+            return std::move(p);
+          })
+          .and_then([](std::unique_ptr<std::vector<int>>&& p)
+                        -> s6i_result::Result<std::unique_ptr<std::vector<int>>,
+                                              std::string> {
+            return s6i_result::make_ok(std::move(p));
+          });
+
+  ASSERT_TRUE(result.is_ok());
+  EXPECT_EQ(result.ref_ok()->data(), original_data);
+  EXPECT_EQ((*result.ref_ok())[0], 1);
+}
+
 }  // namespace
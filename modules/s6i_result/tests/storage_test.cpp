@@ -0,0 +1,129 @@
+#include <gtest/gtest.h>
+#include <memory>
+#include <string>
+#include <type_traits>
+#include <variant>
+#include "s6i_result/result.h"
+
+namespace {
+
+// ニッチを持つ失敗値の型
+enum class NicheError {
+  First,
+  Second,
+};
+
+// ニッチを持たない失敗値の型
+enum class PlainError {
+  First,
+  Second,
+};
+
+// 生存中のインスタンス数を数える型
+class Counted {
+ public:
+  explicit Counted(int value) : m_value(value) { ++s_alive; }
+  Counted(const Counted& other) : m_value(other.m_value) { ++s_alive; }
+  Counted(Counted&& other) noexcept : m_value(other.m_value) { ++s_alive; }
+  Counted& operator=(const Counted&) = default;
+  Counted& operator=(Counted&&) = default;
+  ~Counted() { --s_alive; }
+
+  int value() const { return m_value; }
+
+  static int s_alive;
+
+ private:
+  int m_value;
+};
+
+int Counted::s_alive = 0;
+
+}  // namespace
+
+template <>
+struct s6i_result::NicheTraits<NicheError> {
+  static constexpr bool enabled = true;
+  static constexpr NicheError value = static_cast<NicheError>(-1);
+};
+
+namespace {
+
+using s6i_result::Result;
+
+// 空の成功値とニッチを持つ失敗値の組み合わせではタグを持たない
+static_assert(sizeof(Result<std::monostate, NicheError>) == sizeof(NicheError));
+// ニッチを持たない場合は共用体とタグになる
+static_assert(sizeof(Result<std::monostate, PlainError>) <=
+              sizeof(PlainError) + alignof(PlainError));
+static_assert(sizeof(Result<int, int>) == 2 * sizeof(int));
+// 旧実装（std::variant<Ok<T>, Err<E>>）より大きくならない
+static_assert(sizeof(Result<std::monostate, NicheError>) <
+              sizeof(std::variant<s6i_result::Ok<std::monostate>,
+                                  s6i_result::Err<NicheError>>));
+static_assert(sizeof(Result<int, int>) <=
+              sizeof(std::variant<s6i_result::Ok<int>, s6i_result::Err<int>>));
+
+// T, Eがトリビアルコピー可能ならResultもトリビアルコピー可能
+static_assert(std::is_trivially_copyable_v<Result<int, int>>);
+static_assert(std::is_trivially_copyable_v<Result<std::monostate, NicheError>>);
+static_assert(std::is_trivially_copyable_v<Result<double, PlainError>>);
+static_assert(std::is_trivially_destructible_v<Result<int, PlainError>>);
+static_assert(!std::is_trivially_copyable_v<Result<std::string, int>>);
+
+// コピー/ムーブ可否はT, Eに従う
+static_assert(std::is_copy_constructible_v<Result<std::string, int>>);
+static_assert(!std::is_copy_constructible_v<Result<std::unique_ptr<int>, int>>);
+static_assert(std::is_move_constructible_v<Result<std::unique_ptr<int>, int>>);
+static_assert(
+    std::is_nothrow_move_constructible_v<Result<std::unique_ptr<int>, int>>);
+
+// ニッチを使った格納で成功/失敗が区別できることを確認
+TEST(StorageTest, NicheRoundTrip) {
+  Result<std::monostate, NicheError> ok = s6i_result::make_ok(std::monostate{});
+  Result<std::monostate, NicheError> err =
+      s6i_result::make_err(NicheError::Second);
+
+  EXPECT_TRUE(ok.is_ok());
+  EXPECT_FALSE(ok.is_err());
+  EXPECT_TRUE(err.is_err());
+  EXPECT_EQ(err.ref_err(), NicheError::Second);
+
+  // コピー後も状態が保たれる
+  auto copied = err;
+  EXPECT_TRUE(copied.is_err());
+  EXPECT_EQ(copied.unwrap_err(), NicheError::Second);
+
+  // 代入で状態が切り替わる
+  copied = ok;
+  EXPECT_TRUE(copied.is_ok());
+}
+
+// 成功値/失敗値の切り替え時に正しく構築・破棄されることを確認
+TEST(StorageTest, NonTrivialLifetime) {
+  Counted::s_alive = 0;
+  {
+    Result<Counted, std::string> ok = s6i_result::make_ok(Counted(1));
+    Result<Counted, std::string> err = s6i_result::make_err<std::string>("e");
+    EXPECT_EQ(Counted::s_alive, 1);
+
+    // Ok -> Err
+    ok = err;
+    EXPECT_EQ(Counted::s_alive, 0);
+    EXPECT_EQ(ok.ref_err(), "e");
+
+    // Err -> Ok
+    err = Result<Counted, std::string>(s6i_result::make_ok(Counted(2)));
+    EXPECT_EQ(Counted::s_alive, 1);
+    EXPECT_EQ(err.ref_ok().value(), 2);
+
+    // Ok -> Ok
+    auto other = err;
+    EXPECT_EQ(Counted::s_alive, 2);
+    other = std::move(err);
+    EXPECT_EQ(Counted::s_alive, 2);
+  }
+  EXPECT_EQ(Counted::s_alive, 0);
+}
+
+}  // namespace
@@ -0,0 +1,160 @@
+#include "s6i_result/try.h"
+#include <gtest/gtest.h>
+#include <cstring>
+#include <memory>
+#include <string>
+
+namespace {
+
+using s6i_result::ErrorContext;
+using s6i_result::Result;
+
+enum class TestError {
+  NotFound,
+  Invalid,
+};
+
+Result<int, TestError> parse(int value) {
+  if (value < 0) {
+    return s6i_result::make_err(TestError::Invalid);
+  }
+  return s6i_result::make_ok(value);
+}
+
+Result<void, TestError> check(bool ok) {
+  if (!ok) {
+    return s6i_result::make_err(TestError::NotFound);
+  }
+  return s6i_result::make_ok();
+}
+
+Result<int, TestError> sum(int a, int b) {
+  S6I_TRY_ASSIGN(auto x, parse(a));
+  S6I_TRY_ASSIGN(auto y, parse(b));
+  return s6i_result::make_ok(x + y);
+}
+
+Result<int, TestError> checked_twice(bool first, bool second) {
+  S6I_TRY(check(first));
+  S6I_TRY(check(second));
+  return s6i_result::make_ok(1);
+}
+
+Result<int, TestError> inner(int value) {
+  S6I_TRY_ASSIGN_CTX(auto x, parse(value), "parse value");
+  return s6i_result::make_ok(x);
+}
+
+Result<void, TestError> outer(int value) {
+  S6I_TRY_CTX(inner(value), "load config");
+  return s6i_result::make_ok();
+}
+
+Result<int, TestError> validate(int value) {
+  if (value < 0) {
+    return S6I_ERR_CTX(TestError::Invalid, "validate value");
+  }
+  return s6i_result::make_ok(value);
+}
+
+Result<int, TestError> load(int value) {
+  S6I_TRY_ASSIGN_CTX(auto x, validate(value), "load value");
+  return s6i_result::make_ok(x);
+}
+
+Result<std::unique_ptr<int>, TestError> make_ptr(bool ok) {
+  if (!ok) {
+    return s6i_result::make_err(TestError::Invalid);
+  }
+  return s6i_result::make_ok(std::make_unique<int>(7));
+}
+
+Result<int, TestError> deref(bool ok) {
+  S6I_TRY_ASSIGN(auto ptr, make_ptr(ok));
+  return s6i_result::make_ok(*ptr);
+}
+
+// 成功時は値が束縛され、失敗時は即座に伝播することを確認
+TEST(TryTest, AssignPropagates) {
+  auto ok = sum(1, 2);
+  ASSERT_TRUE(ok.is_ok());
+  EXPECT_EQ(ok.unwrap(), 3);
+
+  auto err = sum(1, -1);
+  ASSERT_TRUE(err.is_err());
+  EXPECT_EQ(err.unwrap_err(), TestError::Invalid);
+}
+
+// Result<void, E>の伝播を確認
+TEST(TryTest, VoidPropagates) {
+  EXPECT_TRUE(checked_twice(true, true).is_ok());
+
+  auto err = checked_twice(true, false);
+  ASSERT_TRUE(err.is_err());
+  EXPECT_EQ(err.unwrap_err(), TestError::NotFound);
+}
+
+// ムーブオンリーな成功値を束縛できることを確認
+TEST(TryTest, MoveOnlyValue) {
+  EXPECT_EQ(deref(true).unwrap(), 7);
+  EXPECT_TRUE(deref(false).is_err());
+}
+
+// 成功時は文脈が記録されないことを確認
+TEST(TryTest, ContextNotRecordedOnSuccess) {
+  ErrorContext::clear();
+  EXPECT_TRUE(outer(1).is_ok());
+  EXPECT_EQ(ErrorContext::size(), 0u);
+}
+
+// 失敗時は内側から順に文脈が記録されることを確認
+TEST(TryTest, ContextRecordedOnError) {
+  ErrorContext::clear();
+  EXPECT_TRUE(outer(-1).is_err());
+
+  ASSERT_EQ(ErrorContext::size(), 2u);
+  EXPECT_STREQ(ErrorContext::frame(0).m_message, "load config");
+  EXPECT_STREQ(ErrorContext::frame(1).m_message, "parse value");
+  EXPECT_NE(std::strstr(ErrorContext::frame(0).m_file, "try_test.cpp"),
+            nullptr);
+  EXPECT_GT(ErrorContext::frame(0).m_line, 0);
+
+  int count = 0;
+  ErrorContext::for_each([&](const s6i_result::ContextFrame&) { ++count; });
+  EXPECT_EQ(count, 2);
+
+  // S6I_ERR_CTXで始まらないエラーは、処理した後に破棄する
+  ErrorContext::clear();
+  EXPECT_EQ(ErrorContext::size(), 0u);
+}
+
+// S6I_ERR_CTXで作ったエラーは、処理済みの古い文脈を含まないことを確認
+TEST(TryTest, ContextStartsAtOrigin) {
+  ErrorContext::clear();
+  EXPECT_TRUE(outer(-1).is_err());
+  EXPECT_TRUE(load(-1).is_err());
+
+  ASSERT_EQ(ErrorContext::size(), 2u);
+  EXPECT_STREQ(ErrorContext::frame(0).m_message, "load value");
+  EXPECT_STREQ(ErrorContext::frame(1).m_message, "validate value");
+  ErrorContext::clear();
+}
+
+// 容量を超えた場合は古い文脈から上書きされることを確認
+TEST(TryTest, ContextRingOverwritesOldest) {
+  ErrorContext::clear();
+  for (size_t i = 0; i < ErrorContext::CAPACITY + 3; ++i) {
+    ErrorContext::push(i == 0 ? "first" : "later", __FILE__, __LINE__);
+  }
+  ErrorContext::push("last", __FILE__, __LINE__);
+
+  EXPECT_EQ(ErrorContext::size(), ErrorContext::CAPACITY);
+  EXPECT_STREQ(ErrorContext::frame(0).m_message, "last");
+  for (size_t i = 0; i < ErrorContext::size(); ++i) {
+    EXPECT_STRNE(ErrorContext::frame(i).m_message, "first");
+  }
+  ErrorContext::clear();
+  EXPECT_EQ(ErrorContext::size(), 0u);
+}
+
+}  // namespace
@@ -0,0 +1,169 @@
+#include <benchmark/benchmark.h>
+#include <cstdint>
+#include <optional>
+#include <thread>
+#include <vector>
+#include "s6i_sync/barrier.h"
+#include "s6i_sync/cond_var.h"
+#include "s6i_sync/latch.h"
+#include "s6i_sync/mutex.h"
+#include "s6i_sync/semaphore.h"
+
+namespace {
+
+using namespace s6i_sync;
+
+/**
+ * 比較用: Mutex + CondVar::broadcastで作ったバリア
+ * （フェーズごとに手作りしていたものと同じ構成）
+ */
+class LockedBarrier {
+ public:
+  explicit LockedBarrier(uint32_t count)
+      : m_count(count),
+        m_state(Mutex<State>::make().unwrap()),
+        m_cond(CondVar::make().unwrap()) {}
+
+  void arrive_and_wait() {
+    auto guard = m_state.lock().unwrap();
+    const uint32_t generation = guard->m_generation;
+    if (++guard->m_arrived == m_count) {
+      guard->m_arrived = 0;
+      ++guard->m_generation;
+      m_cond.broadcast(guard).unwrap();
+      return;
+    }
+    while (guard->m_generation == generation) {
+      m_cond.wait(guard).unwrap();
+    }
+  }
+
+ private:
+  struct State {
+    uint32_t m_arrived = 0;
+    uint32_t m_generation = 0;
+  };
+
+  uint32_t m_count;
+  Mutex<State> m_state;
+  CondVar m_cond;
+};
+
+/**
+ * 比較用: Semaphoreで作ったバリア
+ * 最後に到着したスレッドが、待っている全員の分だけreleaseする
+ * （先に抜けたスレッドが前のフェーズの分を取らないよう、
+ *   フェーズの偶奇でセマフォを使い分ける）
+ */
+class SemaphoreBarrier {
+ public:
+  explicit SemaphoreBarrier(uint32_t count)
+      : m_count(count),
+        m_state(Mutex<State>::make().unwrap()),
+        m_release{Semaphore::make().unwrap(), Semaphore::make().unwrap()} {}
+
+  void arrive_and_wait() {
+    bool last = false;
+    uint32_t phase = 0;
+    {
+      auto guard = m_state.lock().unwrap();
+      phase = guard->m_phase & 1;
+      if (++guard->m_arrived == m_count) {
+        guard->m_arrived = 0;
+        ++guard->m_phase;
+        last = true;
+      }
+    }
+    if (last) {
+      m_release[phase].release(m_count - 1).unwrap();
+    } else {
+      m_release[phase].acquire().unwrap();
+    }
+  }
+
+ private:
+  struct State {
+    uint32_t m_arrived = 0;
+    uint32_t m_phase = 0;
+  };
+
+  uint32_t m_count;
+  Mutex<State> m_state;
+  Semaphore m_release[2];
+};
+
+template <typename B>
+std::optional<B>& shared_barrier() {
+  static std::optional<B> barrier;
+  return barrier;
+}
+
+/**
+ * 全スレッドが1フェーズ進むのにかかる時間（1反復 = 1フェーズ）
+ * google benchmarkは全スレッドで同じ反復回数を実行する
+ */
+template <typename B>
+void BM_PhaseTransition(benchmark::State& state) {
+  if (state.thread_index() == 0) {
+    shared_barrier<B>().emplace(static_cast<uint32_t>(state.threads()));
+  }
+  for (auto _ : state) {
+    shared_barrier<B>()->arrive_and_wait();
+  }
+  if (state.thread_index() == 0) {
+    shared_barrier<B>().reset();
+  }
+}
+
+/** Barrier（スピン + futex） */
+struct FutexBarrier {
+  explicit FutexBarrier(uint32_t count)
+      : m_barrier(Barrier::make(count).unwrap()) {}
+
+  void arrive_and_wait() { m_barrier.arrive_and_wait().unwrap(); }
+
+  Barrier m_barrier;
+};
+
+BENCHMARK_TEMPLATE(BM_PhaseTransition, LockedBarrier)
+    ->Threads(2)
+    ->Threads(4)
+    ->Threads(16)
+    ->UseRealTime();
+BENCHMARK_TEMPLATE(BM_PhaseTransition, SemaphoreBarrier)
+    ->Threads(2)
+    ->Threads(4)
+    ->Threads(16)
+    ->UseRealTime();
+BENCHMARK_TEMPLATE(BM_PhaseTransition, FutexBarrier)
+    ->Threads(2)
+    ->Threads(4)
+    ->Threads(16)
+    ->UseRealTime();
+
+/**
+ * 1フレーム分の開始と完了の通知: Latchで開始を知らせ、
+ * 16個の仕事の完了をLatchで待つ（フレームごとに作り直す）
+ */
+void BM_LatchFanOutFanIn(benchmark::State& state) {
+  const auto workers = static_cast<uint32_t>(state.range(0));
+  for (auto _ : state) {
+    auto start = Latch::make(1).unwrap();
+    auto done = Latch::make(workers).unwrap();
+    std::vector<std::thread> threads;
+    for (uint32_t i = 0; i < workers; ++i) {
+      threads.emplace_back([&]() {
+        start.wait().unwrap();
+        done.count_down().unwrap();
+      });
+    }
+    start.count_down().unwrap();
+    done.wait().unwrap();
+    for (auto& thread : threads) {
+      thread.join();
+    }
+  }
+}
+BENCHMARK(BM_LatchFanOutFanIn)->Arg(16)->UseRealTime();
+
+}  // namespace
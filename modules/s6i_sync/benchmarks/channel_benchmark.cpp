@@ -0,0 +1,191 @@
+#include <benchmark/benchmark.h>
+#include <cstdint>
+#include <deque>
+#include <thread>
+#include <vector>
+#include "s6i_sync/channel.h"
+#include "s6i_sync/cond_var.h"
+#include "s6i_sync/mutex.h"
+
+namespace {
+
+using namespace s6i_sync;
+
+// 1回の計測で受け渡す要素数
+constexpr uint32_t ITEM_COUNT = 1 << 16;
+
+// まとめて受け渡す要素数
+constexpr size_t BATCH_SIZE = 32;
+
+constexpr size_t CHANNEL_CAPACITY = 1024;
+
+/**
+ * 比較用: Mutex<std::deque> + CondVar::broadcastで作ったチャネル
+ * （各チームが手作りしているものと同じ構成）
+ */
+class LockedChannel {
+ public:
+  LockedChannel()
+      : m_queue(Mutex<Queue>::make().unwrap()),
+        m_not_empty(CondVar::make().unwrap()),
+        m_not_full(CondVar::make().unwrap()) {}
+
+  void send(uint32_t value) {
+    auto guard = m_queue.lock().unwrap();
+    while (guard->m_items.size() >= CHANNEL_CAPACITY) {
+      m_not_full.wait(guard).unwrap();
+    }
+    guard->m_items.push_back(value);
+    m_not_empty.broadcast(guard).unwrap();
+  }
+
+  /** @brief closeされて空ならfalse */
+  bool recv(uint32_t& value) {
+    auto guard = m_queue.lock().unwrap();
+    while (guard->m_items.empty()) {
+      if (guard->m_closed) {
+        return false;
+      }
+      m_not_empty.wait(guard).unwrap();
+    }
+    value = guard->m_items.front();
+    guard->m_items.pop_front();
+    m_not_full.broadcast(guard).unwrap();
+    return true;
+  }
+
+  void close() {
+    auto guard = m_queue.lock().unwrap();
+    guard->m_closed = true;
+    m_not_empty.broadcast(guard).unwrap();
+  }
+
+ private:
+  struct Queue {
+    std::deque<uint32_t> m_items;
+    bool m_closed = false;
+  };
+
+  Mutex<Queue> m_queue;
+  CondVar m_not_empty;
+  CondVar m_not_full;
+};
+
+/**
+ * producers個の送信スレッドとconsumers個の受信スレッドで受け渡す
+ * send(channel, first, count)は[first, first + count)を送信し、
+ * recv(channel)は受信した値の合計を返す
+ */
+template <typename Make, typename Send, typename Recv, typename Close>
+void run_producers_consumers(benchmark::State& state,
+                             Make&& make,
+                             Send&& send,
+                             Recv&& recv,
+                             Close&& close) {
+  const auto producers = static_cast<uint32_t>(state.range(0));
+  const auto consumers = static_cast<uint32_t>(state.range(1));
+  const uint32_t per_producer = ITEM_COUNT / producers;
+  for (auto _ : state) {
+    auto channel = make();
+    std::vector<std::thread> threads;
+    for (uint32_t c = 0; c < consumers; ++c) {
+      threads.emplace_back(
+          [&]() { benchmark::DoNotOptimize(recv(*channel)); });
+    }
+    std::vector<std::thread> senders;
+    for (uint32_t p = 0; p < producers; ++p) {
+      senders.emplace_back(
+          [&, p]() { send(*channel, p * per_producer, per_producer); });
+    }
+    for (auto& sender : senders) {
+      sender.join();
+    }
+    close(*channel);
+    for (auto& thread : threads) {
+      thread.join();
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * per_producer * producers);
+}
+
+/** Mutex<std::deque> + CondVar::broadcast */
+void BM_LockedChannel(benchmark::State& state) {
+  run_producers_consumers(
+      state, []() { return std::make_unique<LockedChannel>(); },
+      [](LockedChannel& channel, uint32_t first, uint32_t count) {
+        for (uint32_t i = first; i < first + count; ++i) {
+          channel.send(i);
+        }
+      },
+      [](LockedChannel& channel) {
+        uint64_t sum = 0;
+        uint32_t value = 0;
+        while (channel.recv(value)) {
+          sum += value;
+        }
+        return sum;
+      },
+      [](LockedChannel& channel) { channel.close(); });
+}
+BENCHMARK(BM_LockedChannel)->Args({1, 1})->Args({8, 8})->UseRealTime();
+
+/** Channel（Vyukov）: 1要素ずつ */
+void BM_Channel(benchmark::State& state) {
+  using C = Channel<uint32_t>;
+  run_producers_consumers(
+      state,
+      []() { return std::make_unique<C>(C::make(CHANNEL_CAPACITY).unwrap()); },
+      [](C& channel, uint32_t first, uint32_t count) {
+        for (uint32_t i = first; i < first + count; ++i) {
+          channel.send(i).unwrap();
+        }
+      },
+      [](C& channel) {
+        uint64_t sum = 0;
+        for (;;) {
+          auto recv_result = channel.recv();
+          if (recv_result.is_err()) {
+            return sum;
+          }
+          sum += recv_result.unwrap();
+        }
+      },
+      [](C& channel) { channel.close().unwrap(); });
+}
+BENCHMARK(BM_Channel)->Args({1, 1})->Args({8, 8})->UseRealTime();
+
+/** Channel（Vyukov）: send_batch/recv_batchでまとめて受け渡す */
+void BM_ChannelBatch(benchmark::State& state) {
+  using C = Channel<uint32_t>;
+  run_producers_consumers(
+      state,
+      []() { return std::make_unique<C>(C::make(CHANNEL_CAPACITY).unwrap()); },
+      [](C& channel, uint32_t first, uint32_t count) {
+        uint32_t batch[BATCH_SIZE];
+        for (uint32_t i = first; i < first + count; i += BATCH_SIZE) {
+          const uint32_t n =
+              std::min<uint32_t>(BATCH_SIZE, first + count - i);
+          for (uint32_t j = 0; j < n; ++j) {
+            batch[j] = i + j;
+          }
+          channel.send_batch(batch, n).unwrap();
+        }
+      },
+      [](C& channel) {
+        uint64_t sum = 0;
+        uint32_t batch[BATCH_SIZE];
+        for (;;) {
+          auto recv_result = channel.recv_batch(batch, BATCH_SIZE);
+          if (recv_result.is_err()) {
+            return sum;
+          }
+          for (size_t j = 0; j < recv_result.unwrap(); ++j) {
+            sum += batch[j];
+          }
+        }
+      },
+      [](C& channel) { channel.close().unwrap(); });
+}
+BENCHMARK(BM_ChannelBatch)->Args({1, 1})->Args({8, 8})->UseRealTime();
+
+}  // namespace
@@ -0,0 +1,125 @@
+#include <benchmark/benchmark.h>
+#include <cstdint>
+#include <optional>
+#include <unordered_map>
+#include "s6i_sync/concurrent_map.h"
+#include "s6i_sync/mutex.h"
+
+namespace {
+
+using namespace s6i_sync;
+
+// リソースキャッシュを想定したキーの数（あらかじめすべて登録しておく）
+constexpr uint64_t KEY_COUNT = 4096;
+
+// 20回に1回（5%）書き込む
+constexpr uint64_t WRITE_INTERVAL = 20;
+
+using LockedMap = Mutex<std::unordered_map<uint64_t, uint64_t>>;
+
+std::optional<ConcurrentMap<uint64_t, uint64_t>>& shared_concurrent_map() {
+  static std::optional<ConcurrentMap<uint64_t, uint64_t>> map;
+  return map;
+}
+
+std::optional<LockedMap>& shared_locked_map() {
+  static std::optional<LockedMap> map;
+  return map;
+}
+
+/** スレッドごとに異なる擬似乱数でキーを選ぶ（xorshift） */
+class KeyGenerator {
+ public:
+  explicit KeyGenerator(int seed)
+      : m_state(0x9e3779b97f4a7c15ull * static_cast<uint64_t>(seed + 1)) {}
+
+  uint64_t next() {
+    m_state ^= m_state << 13;
+    m_state ^= m_state >> 7;
+    m_state ^= m_state << 17;
+    return m_state % KEY_COUNT;
+  }
+
+ private:
+  uint64_t m_state;
+};
+
+/** 読み込み95% / 書き込み5%: ConcurrentMap */
+void BM_ReadMostlyConcurrentMap(benchmark::State& state) {
+  if (state.thread_index() == 0) {
+    auto& map = shared_concurrent_map().emplace(
+        ConcurrentMap<uint64_t, uint64_t>::make().unwrap());
+    for (uint64_t key = 0; key < KEY_COUNT; ++key) {
+      map.insert(key, key).unwrap();
+    }
+  }
+  KeyGenerator keys(state.thread_index());
+  uint64_t i = 0;
+  for (auto _ : state) {
+    const uint64_t key = keys.next();
+    if (++i % WRITE_INTERVAL == 0) {
+      shared_concurrent_map()->insert_or_assign(key, i).unwrap();
+    } else {
+      benchmark::DoNotOptimize(shared_concurrent_map()->get(key).unwrap());
+    }
+  }
+  if (state.thread_index() == 0) {
+    shared_concurrent_map().reset();
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_ReadMostlyConcurrentMap)->ThreadRange(1, 32)->UseRealTime();
+
+/** 読み込み95% / 書き込み5%: 比較用のMutex<std::unordered_map> */
+void BM_ReadMostlyLockedMap(benchmark::State& state) {
+  if (state.thread_index() == 0) {
+    auto& map = shared_locked_map().emplace(LockedMap::make().unwrap());
+    auto guard = map.lock().unwrap();
+    for (uint64_t key = 0; key < KEY_COUNT; ++key) {
+      guard->emplace(key, key);
+    }
+  }
+  KeyGenerator keys(state.thread_index());
+  uint64_t i = 0;
+  for (auto _ : state) {
+    const uint64_t key = keys.next();
+    auto guard = shared_locked_map()->lock().unwrap();
+    if (++i % WRITE_INTERVAL == 0) {
+      (*guard)[key] = i;
+    } else {
+      auto it = guard->find(key);
+      benchmark::DoNotOptimize(it != guard->end() ? it->second : 0);
+    }
+  }
+  if (state.thread_index() == 0) {
+    shared_locked_map().reset();
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_ReadMostlyLockedMap)->ThreadRange(1, 32)->UseRealTime();
+
+/**
+ * キャッシュの典型的な使い方: 既にあるリソースをget_or_insert_withで引く
+ * （値を作る関数は最初の1回しか呼ばれない）
+ */
+void BM_GetOrInsertWithHit(benchmark::State& state) {
+  if (state.thread_index() == 0) {
+    shared_concurrent_map().emplace(
+        ConcurrentMap<uint64_t, uint64_t>::make().unwrap());
+  }
+  KeyGenerator keys(state.thread_index());
+  for (auto _ : state) {
+    const uint64_t key = keys.next();
+    benchmark::DoNotOptimize(
+        shared_concurrent_map()
+            ->get_or_insert_with(key, [key]() { return key * 2; })
+            .unwrap());
+  }
+  if (state.thread_index() == 0) {
+    shared_concurrent_map().reset();
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_GetOrInsertWithHit)->ThreadRange(1, 32)->UseRealTime();
+
+}  // namespace
@@ -0,0 +1,71 @@
+#include <benchmark/benchmark.h>
+#include <algorithm>
+#include <cstdint>
+#include <optional>
+#include <thread>
+#include "s6i_sync/cond_var.h"
+#include "s6i_sync/lock_profile.h"
+#include "s6i_sync/mutex.h"
+
+// このファイルは計測なし（s6i_sync_benchmarks）と
+// 計測あり（s6i_sync_lock_profile_benchmarks）の2通りでビルドされる
+
+namespace {
+
+using namespace s6i_sync;
+
+const char* profiling_label() {
+  return lock_profile::is_enabled() ? "profiling" : "no profiling";
+}
+
+/** 競合のないlock/unlock */
+void BM_ProfiledUncontendedLock(benchmark::State& state) {
+  auto mutex = Mutex<uint64_t>::make(0).unwrap();
+  for (auto _ : state) {
+    auto guard = mutex.lock().unwrap();
+    ++*guard;
+  }
+  state.SetLabel(profiling_label());
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_ProfiledUncontendedLock);
+
+std::optional<Mutex<uint64_t>>& shared_mutex() {
+  static std::optional<Mutex<uint64_t>> mutex;
+  return mutex;
+}
+
+/** 複数スレッドで競合するlock/unlock */
+void BM_ProfiledContendedLock(benchmark::State& state) {
+  if (state.thread_index() == 0) {
+    shared_mutex().emplace(Mutex<uint64_t>::make(0).unwrap());
+  }
+  for (auto _ : state) {
+    auto guard = shared_mutex()->lock().unwrap();
+    ++*guard;
+  }
+  if (state.thread_index() == 0) {
+    shared_mutex().reset();
+  }
+  state.SetLabel(profiling_label());
+  state.SetItemsProcessed(state.iterations());
+}
+
+const int MAX_THREADS =
+    static_cast<int>(std::max(2u, std::thread::hardware_concurrency()));
+BENCHMARK(BM_ProfiledContendedLock)->ThreadRange(1, MAX_THREADS)->UseRealTime();
+
+/** 時間切れになるだけのCondVar::wait_for（0ms） */
+void BM_ProfiledCondVarWait(benchmark::State& state) {
+  auto mutex = Mutex<bool>::make(false).unwrap();
+  auto cond = CondVar::make().unwrap();
+  auto guard = mutex.lock().unwrap();
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(cond.wait_for(guard, 0).unwrap());
+  }
+  state.SetLabel(profiling_label());
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_ProfiledCondVarWait);
+
+}  // namespace
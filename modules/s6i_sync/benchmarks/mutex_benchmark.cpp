@@ -0,0 +1,72 @@
+#include <benchmark/benchmark.h>
+#include <algorithm>
+#include <cstdint>
+#include <optional>
+#include <thread>
+#include "s6i_sync/mutex.h"
+
+namespace {
+
+using namespace s6i_sync;
+
+// 全スレッドで共有するMutex（スレッド0が計測前に作成する）
+template <typename Policy>
+std::optional<Mutex<uint64_t, Policy>>& shared_mutex() {
+  static std::optional<Mutex<uint64_t, Policy>> mutex;
+  return mutex;
+}
+
+// ロックを保持したまま指定回数だけ空回りする
+void hold_for(int64_t spins) {
+  for (int64_t i = 0; i < spins; ++i) {
+    cpu_relax();
+  }
+}
+
+/**
+ * 競合時のロック取得コスト
+ * range(0): ロックの保持時間（cpu_relaxの回数）
+ */
+template <typename Policy>
+void BM_MutexContention(benchmark::State& state) {
+  if (state.thread_index() == 0) {
+    shared_mutex<Policy>().emplace(
+        Mutex<uint64_t, Policy>::make(0).unwrap());
+  }
+  const int64_t hold = state.range(0);
+  for (auto _ : state) {
+    auto guard = shared_mutex<Policy>()->lock().unwrap();
+    ++*guard;
+    hold_for(hold);
+  }
+  if (state.thread_index() == 0) {
+    shared_mutex<Policy>().reset();
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+
+const int MAX_THREADS =
+    static_cast<int>(std::max(2u, std::thread::hardware_concurrency()));
+
+BENCHMARK_TEMPLATE(BM_MutexContention, SdlMutexPolicy)
+    ->Arg(0)
+    ->Arg(64)
+    ->ThreadRange(1, MAX_THREADS)
+    ->UseRealTime();
+BENCHMARK_TEMPLATE(BM_MutexContention, SpinMutexPolicy)
+    ->Arg(0)
+    ->Arg(64)
+    ->ThreadRange(1, MAX_THREADS)
+    ->UseRealTime();
+BENCHMARK_TEMPLATE(BM_MutexContention, AdaptiveMutexPolicy)
+    ->Arg(0)
+    ->Arg(64)
+    ->ThreadRange(1, MAX_THREADS)
+    ->UseRealTime();
+BENCHMARK_TEMPLATE(BM_MutexContention, ParkingLotMutexPolicy)
+    ->Arg(0)
+    ->Arg(64)
+    ->ThreadRange(1, MAX_THREADS)
+    ->UseRealTime();
+
+}  // namespace
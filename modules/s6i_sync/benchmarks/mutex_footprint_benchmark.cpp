@@ -0,0 +1,98 @@
+#include <SDL.h>
+#include <benchmark/benchmark.h>
+#include <atomic>
+#include <cstddef>
+#include <vector>
+#include "s6i_sync/mutex.h"
+
+namespace {
+
+using namespace s6i_sync;
+
+// SDL_mallocで確保されたバイト数（解放は数えない）
+std::atomic<size_t> g_sdl_bytes{0};
+SDL_malloc_func g_malloc = nullptr;
+
+void* counting_malloc(size_t size) {
+  g_sdl_bytes.fetch_add(size, std::memory_order_relaxed);
+  return g_malloc(size);
+}
+
+/**
+ * @brief SDL_mallocを計数版に差し替える
+ * 解放関数は元のままなので、差し替え前後のメモリは混在しても問題ない
+ */
+class SdlAllocCounter {
+ public:
+  SdlAllocCounter() {
+    SDL_GetMemoryFunctions(&g_malloc, &m_calloc, &m_realloc, &m_free);
+    SDL_SetMemoryFunctions(counting_malloc, m_calloc, m_realloc, m_free);
+  }
+
+  ~SdlAllocCounter() {
+    SDL_SetMemoryFunctions(g_malloc, m_calloc, m_realloc, m_free);
+  }
+
+  size_t bytes() const { return g_sdl_bytes.load(std::memory_order_relaxed); }
+
+ private:
+  SDL_calloc_func m_calloc = nullptr;
+  SDL_realloc_func m_realloc = nullptr;
+  SDL_free_func m_free = nullptr;
+};
+
+/**
+ * 1ロックあたりのメモリ使用量
+ * オブジェクト本体の大きさ + SDLがヒープに確保した大きさ
+ * range(0): 作成するロックの数
+ */
+template <typename Policy>
+void BM_MemoryPerLock(benchmark::State& state) {
+  using M = Mutex<uint8_t, Policy>;
+  const auto count = static_cast<size_t>(state.range(0));
+  size_t heap_bytes = 0;
+  for (auto _ : state) {
+    std::vector<M> mutexes;
+    mutexes.reserve(count);
+    SdlAllocCounter counter;
+    const size_t before = counter.bytes();
+    for (size_t i = 0; i < count; ++i) {
+      mutexes.push_back(M::make(0).unwrap());
+    }
+    heap_bytes = counter.bytes() - before;
+    benchmark::DoNotOptimize(mutexes.data());
+  }
+  state.counters["sizeof"] = sizeof(M);
+  state.counters["bytes_per_lock"] =
+      static_cast<double>(sizeof(M)) +
+      static_cast<double>(heap_bytes) / static_cast<double>(count);
+}
+BENCHMARK_TEMPLATE(BM_MemoryPerLock, SdlMutexPolicy)->Arg(1 << 14);
+BENCHMARK_TEMPLATE(BM_MemoryPerLock, ParkingLotMutexPolicy)->Arg(1 << 14);
+
+/** 作成・破棄のスループット */
+template <typename Policy>
+void BM_CreateDestroy(benchmark::State& state) {
+  for (auto _ : state) {
+    auto mutex = Mutex<uint8_t, Policy>::make(0);
+    benchmark::DoNotOptimize(mutex);
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK_TEMPLATE(BM_CreateDestroy, SdlMutexPolicy);
+BENCHMARK_TEMPLATE(BM_CreateDestroy, ParkingLotMutexPolicy);
+
+/** 競合のないロック/アンロック */
+template <typename Policy>
+void BM_UncontendedLock(benchmark::State& state) {
+  auto mutex = Mutex<uint8_t, Policy>::make(0).unwrap();
+  for (auto _ : state) {
+    auto guard = mutex.lock().unwrap();
+    ++*guard;
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK_TEMPLATE(BM_UncontendedLock, SdlMutexPolicy);
+BENCHMARK_TEMPLATE(BM_UncontendedLock, ParkingLotMutexPolicy);
+
+}  // namespace
@@ -0,0 +1,79 @@
+#include <benchmark/benchmark.h>
+#include <array>
+#include <cstdint>
+#include <optional>
+#include "s6i_sync/mutex.h"
+#include "s6i_sync/rw_lock.h"
+
+namespace {
+
+using namespace s6i_sync;
+
+// 読み込みが多い共有データ（設定やテーブルを想定）
+using Table = std::array<uint64_t, 64>;
+
+// 書き込みの頻度（この回数に1回書き込む）
+constexpr int64_t WRITE_INTERVAL = 1024;
+
+uint64_t sum(const Table& table) {
+  uint64_t total = 0;
+  for (uint64_t v : table) {
+    total += v;
+  }
+  return total;
+}
+
+std::optional<RwLock<Table>>& shared_rw_lock() {
+  static std::optional<RwLock<Table>> lock;
+  return lock;
+}
+
+std::optional<Mutex<Table>>& shared_mutex() {
+  static std::optional<Mutex<Table>> mutex;
+  return mutex;
+}
+
+/** 読み込み中心の負荷: RwLock */
+void BM_ReadMostlyRwLock(benchmark::State& state) {
+  if (state.thread_index() == 0) {
+    shared_rw_lock().emplace(RwLock<Table>::make(Table{}).unwrap());
+  }
+  int64_t i = 0;
+  for (auto _ : state) {
+    if (++i % WRITE_INTERVAL == 0) {
+      auto guard = shared_rw_lock()->write().unwrap();
+      (*guard)[static_cast<size_t>(i) % guard->size()] += 1;
+    } else {
+      auto guard = shared_rw_lock()->read().unwrap();
+      benchmark::DoNotOptimize(sum(*guard));
+    }
+  }
+  if (state.thread_index() == 0) {
+    shared_rw_lock().reset();
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_ReadMostlyRwLock)->ThreadRange(1, 64)->UseRealTime();
+
+/** 読み込み中心の負荷: 比較用のMutex */
+void BM_ReadMostlyMutex(benchmark::State& state) {
+  if (state.thread_index() == 0) {
+    shared_mutex().emplace(Mutex<Table>::make(Table{}).unwrap());
+  }
+  int64_t i = 0;
+  for (auto _ : state) {
+    auto guard = shared_mutex()->lock().unwrap();
+    if (++i % WRITE_INTERVAL == 0) {
+      (*guard)[static_cast<size_t>(i) % guard->size()] += 1;
+    } else {
+      benchmark::DoNotOptimize(sum(*guard));
+    }
+  }
+  if (state.thread_index() == 0) {
+    shared_mutex().reset();
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_ReadMostlyMutex)->ThreadRange(1, 64)->UseRealTime();
+
+}  // namespace
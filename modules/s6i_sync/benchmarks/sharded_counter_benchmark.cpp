@@ -0,0 +1,100 @@
+#include <benchmark/benchmark.h>
+#include <atomic>
+#include <cstdint>
+#include <optional>
+#include "s6i_sync/mutex.h"
+#include "s6i_sync/sharded_counter.h"
+
+namespace {
+
+using namespace s6i_sync;
+
+std::optional<ShardedCounter>& shared_sharded_counter() {
+  static std::optional<ShardedCounter> counter;
+  return counter;
+}
+
+std::optional<ShardedAccumulator<double>>& shared_accumulator() {
+  static std::optional<ShardedAccumulator<double>> accumulator;
+  return accumulator;
+}
+
+std::optional<Mutex<int>>& shared_mutex() {
+  static std::optional<Mutex<int>> mutex;
+  return mutex;
+}
+
+std::atomic<int>& shared_atomic() {
+  static std::atomic<int> counter{0};
+  return counter;
+}
+
+/** 全スレッドで1つのカウンターに加算: ShardedCounter */
+void BM_IncrementShardedCounter(benchmark::State& state) {
+  if (state.thread_index() == 0) {
+    shared_sharded_counter().emplace(ShardedCounter::make().unwrap());
+  }
+  for (auto _ : state) {
+    shared_sharded_counter()->increment();
+  }
+  if (state.thread_index() == 0) {
+    benchmark::DoNotOptimize(shared_sharded_counter()->sum());
+    shared_sharded_counter().reset();
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_IncrementShardedCounter)->ThreadRange(1, 64)->UseRealTime();
+
+/** 全スレッドで1つのカウンターに加算: std::atomic<int> */
+void BM_IncrementAtomic(benchmark::State& state) {
+  for (auto _ : state) {
+    shared_atomic().fetch_add(1, std::memory_order_relaxed);
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_IncrementAtomic)->ThreadRange(1, 64)->UseRealTime();
+
+/** 全スレッドで1つのカウンターに加算: Mutex<int> */
+void BM_IncrementMutex(benchmark::State& state) {
+  if (state.thread_index() == 0) {
+    shared_mutex().emplace(Mutex<int>::make(0).unwrap());
+  }
+  for (auto _ : state) {
+    auto guard = shared_mutex()->lock().unwrap();
+    ++*guard;
+  }
+  if (state.thread_index() == 0) {
+    shared_mutex().reset();
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_IncrementMutex)->ThreadRange(1, 64)->UseRealTime();
+
+/** 全スレッドで1つの合計に加算: ShardedAccumulator<double> */
+void BM_AddShardedAccumulator(benchmark::State& state) {
+  if (state.thread_index() == 0) {
+    shared_accumulator().emplace(
+        ShardedAccumulator<double>::make(0.0).unwrap());
+  }
+  for (auto _ : state) {
+    shared_accumulator()->add(0.5);
+  }
+  if (state.thread_index() == 0) {
+    benchmark::DoNotOptimize(shared_accumulator()->sum());
+    shared_accumulator().reset();
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_AddShardedAccumulator)->ThreadRange(1, 64)->UseRealTime();
+
+/** 読み込み側の費用: 全シャードの合計 */
+void BM_SumShardedCounter(benchmark::State& state) {
+  auto counter = ShardedCounter::make().unwrap();
+  counter.add(1);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(counter.sum());
+  }
+}
+BENCHMARK(BM_SumShardedCounter);
+
+}  // namespace
@@ -0,0 +1,102 @@
+#include <benchmark/benchmark.h>
+#include <atomic>
+#include <thread>
+#include "s6i_sync/mutex.h"
+#include "s6i_sync/seq_lock.h"
+#include "s6i_sync/snapshot.h"
+
+namespace {
+
+using namespace s6i_sync;
+
+// 毎フレーム読まれる小さな状態（カメラを想定）
+struct Camera {
+  float m_position[3] = {};
+  float m_rotation[4] = {0.0f, 0.0f, 0.0f, 1.0f};
+  float m_fov = 60.0f;
+  float m_near = 0.1f;
+  float m_far = 1000.0f;
+};
+
+Camera make_camera(int i) {
+  Camera camera;
+  camera.m_position[0] = static_cast<float>(i);
+  return camera;
+}
+
+// 計測中は常に書き込み続けるスレッド
+class ConstantWriter {
+ public:
+  template <typename F>
+  explicit ConstantWriter(F&& write)
+      : m_thread([this, write]() {
+          for (int i = 0; !m_stop.load(std::memory_order_relaxed); ++i) {
+            write(i);
+          }
+        }) {}
+
+  ~ConstantWriter() {
+    m_stop = true;
+    m_thread.join();
+  }
+
+ private:
+  std::atomic<bool> m_stop{false};
+  std::thread m_thread;
+};
+
+// 読み込みスレッドが終わる前に破棄されないよう、プロセス終了まで保持する
+SeqLock<Camera>& shared_seq_lock() {
+  static SeqLock<Camera> lock = SeqLock<Camera>::make().unwrap();
+  return lock;
+}
+
+Snapshot<Camera>& shared_snapshot() {
+  static Snapshot<Camera> snapshot = Snapshot<Camera>::make().unwrap();
+  return snapshot;
+}
+
+Mutex<Camera>& shared_mutex() {
+  static Mutex<Camera> mutex = Mutex<Camera>::make().unwrap();
+  return mutex;
+}
+
+/** 書き込み中の読み込みレイテンシ: SeqLock */
+void BM_ReadUnderWriterSeqLock(benchmark::State& state) {
+  ConstantWriter writer(
+      [](int i) { shared_seq_lock().write(make_camera(i)); });
+  for (auto _ : state) {
+    const Camera camera = shared_seq_lock().read();
+    benchmark::DoNotOptimize(camera.m_position[0]);
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_ReadUnderWriterSeqLock);
+
+/** 書き込み中の読み込みレイテンシ: Snapshot */
+void BM_ReadUnderWriterSnapshot(benchmark::State& state) {
+  ConstantWriter writer(
+      [](int i) { shared_snapshot().publish(make_camera(i)).unwrap(); });
+  for (auto _ : state) {
+    auto guard = shared_snapshot().read().unwrap();
+    benchmark::DoNotOptimize(guard->m_position[0]);
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_ReadUnderWriterSnapshot);
+
+/** 書き込み中の読み込みレイテンシ: 比較用のMutex */
+void BM_ReadUnderWriterMutex(benchmark::State& state) {
+  ConstantWriter writer([](int i) {
+    auto guard = shared_mutex().lock().unwrap();
+    *guard = make_camera(i);
+  });
+  for (auto _ : state) {
+    auto guard = shared_mutex().lock().unwrap();
+    benchmark::DoNotOptimize(guard->m_position[0]);
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_ReadUnderWriterMutex);
+
+}  // namespace
@@ -0,0 +1,134 @@
+#include <benchmark/benchmark.h>
+#include <cstdint>
+#include <deque>
+#include <thread>
+#include "s6i_sync/backoff.h"
+#include "s6i_sync/cond_var.h"
+#include "s6i_sync/mutex.h"
+#include "s6i_sync/spsc_ring.h"
+
+namespace {
+
+using namespace s6i_sync;
+
+// 1回の計測で受け渡す要素数
+constexpr uint32_t ITEM_COUNT = 1 << 16;
+
+// まとめて受け渡す要素数
+constexpr size_t BATCH_SIZE = 64;
+
+constexpr size_t RING_CAPACITY = 1024;
+
+/** 比較用: Mutex<std::deque>とCondVarで1要素ずつ受け渡す */
+void BM_DequeCondVar(benchmark::State& state) {
+  auto mutex = Mutex<std::deque<uint32_t>>::make().unwrap();
+  auto cond = CondVar::make().unwrap();
+  for (auto _ : state) {
+    std::thread producer([&]() {
+      for (uint32_t i = 0; i < ITEM_COUNT; ++i) {
+        auto guard = mutex.lock().unwrap();
+        guard->push_back(i);
+        cond.signal(guard).unwrap();
+      }
+    });
+    uint64_t sum = 0;
+    for (uint32_t received = 0; received < ITEM_COUNT; ++received) {
+      auto guard = mutex.lock().unwrap();
+      while (guard->empty()) {
+        cond.wait(guard).unwrap();
+      }
+      sum += guard->front();
+      guard->pop_front();
+    }
+    producer.join();
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetItemsProcessed(state.iterations() * ITEM_COUNT);
+}
+BENCHMARK(BM_DequeCondVar)->UseRealTime();
+
+/** SpscRing: 1要素ずつ、空・満杯のときはBackoffで待つ */
+void BM_SpscRingPolling(benchmark::State& state) {
+  auto ring = SpscRing<uint32_t, RING_CAPACITY>::make().unwrap();
+  for (auto _ : state) {
+    std::thread producer([&]() {
+      Backoff backoff;
+      for (uint32_t i = 0; i < ITEM_COUNT;) {
+        if (ring.try_push(i)) {
+          ++i;
+          backoff.reset();
+        } else {
+          backoff.snooze();
+        }
+      }
+    });
+    uint64_t sum = 0;
+    Backoff backoff;
+    for (uint32_t received = 0; received < ITEM_COUNT;) {
+      if (auto value = ring.try_pop()) {
+        sum += *value;
+        ++received;
+        backoff.reset();
+      } else {
+        backoff.snooze();
+      }
+    }
+    producer.join();
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetItemsProcessed(state.iterations() * ITEM_COUNT);
+}
+BENCHMARK(BM_SpscRingPolling)->UseRealTime();
+
+/** SpscRing: Blockingモードで1要素ずつ */
+void BM_SpscRingBlocking(benchmark::State& state) {
+  auto ring =
+      SpscRing<uint32_t, RING_CAPACITY, RingMode::Blocking>::make().unwrap();
+  for (auto _ : state) {
+    std::thread producer([&]() {
+      for (uint32_t i = 0; i < ITEM_COUNT; ++i) {
+        ring.wait_push(i).unwrap();
+      }
+    });
+    uint64_t sum = 0;
+    for (uint32_t received = 0; received < ITEM_COUNT; ++received) {
+      sum += ring.wait_pop().unwrap();
+    }
+    producer.join();
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetItemsProcessed(state.iterations() * ITEM_COUNT);
+}
+BENCHMARK(BM_SpscRingBlocking)->UseRealTime();
+
+/** SpscRing: Blockingモードでまとめて受け渡す */
+void BM_SpscRingBlockingBatch(benchmark::State& state) {
+  auto ring =
+      SpscRing<uint32_t, RING_CAPACITY, RingMode::Blocking>::make().unwrap();
+  for (auto _ : state) {
+    std::thread producer([&]() {
+      uint32_t batch[BATCH_SIZE];
+      for (uint32_t i = 0; i < ITEM_COUNT; i += BATCH_SIZE) {
+        for (size_t j = 0; j < BATCH_SIZE; ++j) {
+          batch[j] = i + static_cast<uint32_t>(j);
+        }
+        ring.wait_push_n(batch, BATCH_SIZE).unwrap();
+      }
+    });
+    uint64_t sum = 0;
+    uint32_t batch[BATCH_SIZE];
+    for (uint32_t received = 0; received < ITEM_COUNT;) {
+      const size_t n = ring.wait_pop_n(batch, BATCH_SIZE).unwrap();
+      for (size_t j = 0; j < n; ++j) {
+        sum += batch[j];
+      }
+      received += static_cast<uint32_t>(n);
+    }
+    producer.join();
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetItemsProcessed(state.iterations() * ITEM_COUNT);
+}
+BENCHMARK(BM_SpscRingBlockingBatch)->UseRealTime();
+
+}  // namespace
@@ -0,0 +1,116 @@
+#include <benchmark/benchmark.h>
+#include <atomic>
+#include <cstdint>
+#include <thread>
+#include "s6i_sync/mutex.h"
+#include "s6i_sync/seq_lock.h"
+#include "s6i_sync/triple_buffer.h"
+
+namespace {
+
+using namespace s6i_sync;
+
+// シミュレーションから描画へ毎フレーム渡す状態（エンティティ64個分の位置）
+struct Frame {
+  uint64_t m_tick = 0;
+  float m_positions[64][3] = {};
+};
+
+void fill_frame(Frame& frame, uint64_t tick) {
+  frame.m_tick = tick;
+  for (auto& position : frame.m_positions) {
+    position[0] = static_cast<float>(tick);
+  }
+}
+
+// 計測中は常に動き続ける相手側のスレッド
+class Background {
+ public:
+  template <typename F>
+  explicit Background(F&& step)
+      : m_thread([this, step]() {
+          for (uint64_t i = 1; !m_stop.load(std::memory_order_relaxed); ++i) {
+            step(i);
+          }
+        }) {}
+
+  ~Background() {
+    m_stop = true;
+    m_thread.join();
+  }
+
+ private:
+  std::atomic<bool> m_stop{false};
+  std::thread m_thread;
+};
+
+/** 書き込み中の最新値の読み込み: TripleBuffer（値は書き込み側の場所で読む） */
+void BM_ReadLatestTripleBuffer(benchmark::State& state) {
+  auto buffer = TripleBuffer<Frame>::make().unwrap();
+  Background writer([&](uint64_t i) {
+    fill_frame(buffer.back(), i);
+    buffer.publish();
+  });
+  for (auto _ : state) {
+    const Frame& frame = buffer.read();
+    benchmark::DoNotOptimize(frame.m_positions[63][0]);
+  }
+}
+BENCHMARK(BM_ReadLatestTripleBuffer);
+
+/** 書き込み中の最新値の読み込み: SeqLock（値を丸ごとコピーする） */
+void BM_ReadLatestSeqLock(benchmark::State& state) {
+  auto lock = SeqLock<Frame>::make().unwrap();
+  Background writer([&](uint64_t i) {
+    Frame frame;
+    fill_frame(frame, i);
+    lock.write(frame);
+  });
+  for (auto _ : state) {
+    const Frame frame = lock.read();
+    benchmark::DoNotOptimize(frame.m_positions[63][0]);
+  }
+}
+BENCHMARK(BM_ReadLatestSeqLock);
+
+/** 書き込み中の最新値の読み込み: Mutex（ロック中にコピーする） */
+void BM_ReadLatestMutex(benchmark::State& state) {
+  auto mutex = Mutex<Frame>::make().unwrap();
+  Background writer(
+      [&](uint64_t i) { fill_frame(*mutex.lock().unwrap(), i); });
+  for (auto _ : state) {
+    const Frame frame = *mutex.lock().unwrap();
+    benchmark::DoNotOptimize(frame.m_positions[63][0]);
+  }
+}
+BENCHMARK(BM_ReadLatestMutex);
+
+/** 読み込み中の公開: TripleBuffer（書き込み側は待たない） */
+void BM_PublishTripleBuffer(benchmark::State& state) {
+  auto buffer = TripleBuffer<Frame>::make().unwrap();
+  Background reader([&](uint64_t) {
+    benchmark::DoNotOptimize(buffer.read().m_tick);
+  });
+  uint64_t tick = 0;
+  for (auto _ : state) {
+    fill_frame(buffer.back(), ++tick);
+    buffer.publish();
+  }
+}
+BENCHMARK(BM_PublishTripleBuffer);
+
+/** 読み込み中の公開: Mutex（読み込み側のコピー中は待つ） */
+void BM_PublishMutex(benchmark::State& state) {
+  auto mutex = Mutex<Frame>::make().unwrap();
+  Background reader([&](uint64_t) {
+    const Frame frame = *mutex.lock().unwrap();
+    benchmark::DoNotOptimize(frame.m_tick);
+  });
+  uint64_t tick = 0;
+  for (auto _ : state) {
+    fill_frame(*mutex.lock().unwrap(), ++tick);
+  }
+}
+BENCHMARK(BM_PublishMutex);
+
+}  // namespace
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <cstdint>
+#include <thread>
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <intrin.h>
+#endif
+
+namespace s6i_sync {
+
+/**
+ * @brief スピン待機中であることをCPUに伝える
+ *
+ * x86ではPAUSE、ARMではYIELD命令を発行し、
+ * ハイパースレッドの相方や消費電力への影響を抑えます。
+ */
+inline void cpu_relax() {
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+  _mm_pause();
+#elif defined(__x86_64__) || defined(__i386__)
+  __builtin_ia32_pause();
+#elif defined(__aarch64__) || defined(__arm__)
+  __asm__ __volatile__("yield");
+#endif
+}
+
+/**
+ * @brief 指数バックオフ
+ *
+ * 呼び出すごとにcpu_relax()の回数を倍にし、
+ * 上限に達したらスレッドのタイムスライスを譲ります。
+ */
+class Backoff {
+ public:
+  /** @brief スピンの上限（2^SPIN_LIMIT回のcpu_relax） */
+  static constexpr uint32_t SPIN_LIMIT = 6;
+
+  /** @brief 1回分待機 */
+  void snooze() {
+    if (m_step <= SPIN_LIMIT) {
+      for (uint32_t i = 0; i < (1u << m_step); ++i) {
+        cpu_relax();
+      }
+      ++m_step;
+    } else {
+      std::this_thread::yield();
+    }
+  }
+
+  /** @brief スピンだけで待てる段階を過ぎたかどうか */
+  bool is_completed() const { return m_step > SPIN_LIMIT; }
+
+  /** @brief 待機回数をリセット */
+  void reset() { m_step = 0; }
+
+ private:
+  uint32_t m_step = 0;
+};
+
+}  // namespace s6i_sync
@@ -0,0 +1,125 @@
+#pragma once
+
+#include <s6i_result/result.h>
+#include <atomic>
+#include <cstdint>
+#include <utility>
+#include "backoff.h"
+#include "error.h"
+#include "futex.h"
+
+namespace s6i_sync {
+
+/**
+ * @brief 繰り返し使えるバリア
+ *
+ * count個のスレッドがarrive_and_wait()を呼ぶまで全員を待たせ、
+ * そろったら次のフェーズに進めます。フェーズが進むたびに世代番号を
+ * 1つ増やし、待機側はその世代番号をBackoffで少しだけ監視してから
+ * futexで眠ります。最後に到着したスレッドは眠っているスレッドが
+ * いるときだけ、1回のfutex_wake_allでまとめて起こします。
+ */
+class Barrier {
+ public:
+  /**
+   * @brief 新しいバリアを作成
+   * @param count 1フェーズに参加するスレッド数（1以上）
+   * @return 成功時: 作成されたバリア、失敗時: エラー
+   */
+  static s6i_result::Result<Barrier, SyncError> make(uint32_t count) {
+    if (count == 0) {
+      return s6i_result::make_err(SyncError::InvalidBarrierError);
+    }
+    return s6i_result::make_ok(Barrier(count));
+  }
+
+  // コピー禁止
+  Barrier(const Barrier&) = delete;
+  Barrier& operator=(const Barrier&) = delete;
+
+  // ムーブ可能（待機中のムーブは未定義）
+  Barrier(Barrier&& other)
+      : m_count(std::exchange(other.m_count, 0)),
+        m_arrived(other.m_arrived.load(std::memory_order_relaxed)),
+        m_generation(other.m_generation.load(std::memory_order_relaxed)) {}
+
+  Barrier& operator=(Barrier&& other) {
+    Barrier(std::move(other)).swap(*this);
+    return *this;
+  }
+
+  /** @brief 有効なバリアかどうか（ムーブ元は無効） */
+  bool is_valid() const { return m_count != 0; }
+
+  /** @brief 1フェーズに参加するスレッド数 */
+  uint32_t count() const { return m_count; }
+
+  /** @brief 完了したフェーズの数 */
+  uint32_t generation() const {
+    return m_generation.load(std::memory_order_acquire);
+  }
+
+  /**
+   * @brief 到着を知らせ、全員がそろうまで待つ
+   * @return 成功時: 最後に到着したスレッドならtrue（フェーズの後処理を
+   *         1スレッドだけで行うのに使えます）、失敗時: エラー
+   */
+  s6i_result::Result<bool, SyncError> arrive_and_wait() {
+    if (!is_valid()) {
+      return s6i_result::make_err(SyncError::InvalidBarrierError);
+    }
+    // 到着する前に世代番号を読む（そろうまで世代は進まない）
+    const uint32_t generation = m_generation.load(std::memory_order_acquire);
+    if (m_arrived.fetch_add(1, std::memory_order_acq_rel) + 1 == m_count) {
+      // 次のフェーズの到着は世代が進むまで始まらないので、先に0に戻す
+      m_arrived.store(0, std::memory_order_relaxed);
+      m_generation.store(generation + 1, std::memory_order_seq_cst);
+      if (m_waiters.load(std::memory_order_seq_cst) > 0) {
+        futex_wake_all(m_generation);
+      }
+      return s6i_result::make_ok(true);
+    }
+
+    Backoff backoff;
+    while (m_generation.load(std::memory_order_acquire) == generation) {
+      if (!backoff.is_completed()) {
+        backoff.snooze();
+        continue;
+      }
+      m_waiters.fetch_add(1, std::memory_order_seq_cst);
+      if (m_generation.load(std::memory_order_seq_cst) == generation) {
+        futex_wait(m_generation, generation);
+      }
+      m_waiters.fetch_sub(1, std::memory_order_relaxed);
+    }
+    return s6i_result::make_ok(false);
+  }
+
+  void swap(Barrier& other) {
+    std::swap(m_count, other.m_count);
+    const uint32_t arrived = m_arrived.load(std::memory_order_relaxed);
+    m_arrived.store(other.m_arrived.load(std::memory_order_relaxed),
+                    std::memory_order_relaxed);
+    other.m_arrived.store(arrived, std::memory_order_relaxed);
+    const uint32_t generation = m_generation.load(std::memory_order_relaxed);
+    m_generation.store(other.m_generation.load(std::memory_order_relaxed),
+                       std::memory_order_relaxed);
+    other.m_generation.store(generation, std::memory_order_relaxed);
+  }
+
+ private:
+  explicit Barrier(uint32_t count) : m_count(count) {}
+
+  uint32_t m_count = 0;
+  std::atomic<uint32_t> m_arrived{0};  ///< このフェーズに到着した数
+
+  // 待機側が監視する値（到着のたびに書き換わるm_arrivedとは別の行に置く）
+  alignas(64) std::atomic<uint32_t> m_generation{0};
+  std::atomic<uint32_t> m_waiters{0};  ///< futexで眠っている（眠りかけの）数
+};
+
+inline void swap(Barrier& lhs, Barrier& rhs) {
+  lhs.swap(rhs);
+}
+
+}  // namespace s6i_sync
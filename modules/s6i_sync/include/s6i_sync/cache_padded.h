@@ -0,0 +1,43 @@
+#pragma once
+
+#include <cstddef>
+#include <utility>
+
+namespace s6i_sync {
+
+/**
+ * @brief キャッシュラインの大きさ（バイト）
+ * x86-64と多くのARMで64バイトです
+ */
+inline constexpr size_t CACHE_LINE_SIZE = 64;
+
+/**
+ * @brief 値をキャッシュラインの境界に置き、大きさもその倍数にする
+ *
+ * 別々のスレッドが書き込む値を並べたとき、同じキャッシュラインに
+ * 乗ってしまうと、互いの書き込みのたびにラインを奪い合います（偽共有）。
+ * 配列の要素やメンバーをCachePaddedで包むと、
+ * 隣の値とは必ず別のラインになります。
+ *
+ * @tparam T 包む値の型
+ */
+template <typename T>
+struct alignas(CACHE_LINE_SIZE) CachePadded {
+  CachePadded() = default;
+
+  template <typename... Args>
+  explicit CachePadded(std::in_place_t, Args&&... args)
+      : m_value(std::forward<Args>(args)...) {}
+
+  T& get() { return m_value; }
+  const T& get() const { return m_value; }
+
+  T& operator*() { return m_value; }
+  const T& operator*() const { return m_value; }
+  T* operator->() { return &m_value; }
+  const T* operator->() const { return &m_value; }
+
+  T m_value{};
+};
+
+}  // namespace s6i_sync
@@ -0,0 +1,669 @@
+#pragma once
+
+#include <s6i_result/result.h>
+#include <s6i_result/try.h>
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "backoff.h"
+#include "error.h"
+#include "futex.h"
+#include "mutex.h"
+#include "mutex_policy.h"
+
+namespace s6i_sync {
+
+template <typename T>
+class Channel;
+
+namespace detail {
+
+/**
+ * @brief selectで待っているスレッドを起こすための印
+ * 値が変わったらfutexの待機から戻ります
+ */
+struct SelectWaker {
+  std::atomic<uint32_t> m_seq{0};
+
+  void notify() {
+    m_seq.fetch_add(1, std::memory_order_seq_cst);
+    futex_wake_one(m_seq);
+  }
+};
+
+/** @brief selectでChannelの内部に触るための窓口 */
+struct ChannelSelector;
+
+}  // namespace detail
+
+/**
+ * @brief 容量固定の多生産者・多消費者チャネル
+ *
+ * Vyukovの有界MPMCキューを使い、送受信はロックなしで行います。
+ * 各セルのシーケンス番号で空き・使用中を判定するため、
+ * 送信側と受信側はそれぞれ位置のCAS1回で要素を確保できます。
+ * send_batch/recv_batchは連続するセルを1回のCASでまとめて確保します。
+ *
+ * 空・満杯のときはしばらくスピンし、それでも進まなければfutexで眠ります。
+ * 起こすのは届いた要素数の分だけなので、
+ * Mutex + CondVar::broadcastのように全員が一斉に起きることはありません。
+ *
+ * close後の送信はChannelClosedErrorになります。
+ * 受信は残っている要素を受け取り終えてからChannelClosedErrorになります。
+ *
+ * @tparam T 要素の型
+ */
+template <typename T>
+class Channel {
+ public:
+  /**
+   * @brief 新しいChannelを作成
+   * @param capacity 容量（2の累乗、2以上）
+   * @return 成功時: 作成されたChannel、失敗時: エラー
+   */
+  static s6i_result::Result<Channel, SyncError> make(size_t capacity) {
+    if (capacity < 2 || (capacity & (capacity - 1)) != 0) {
+      return s6i_result::make_err(SyncError::InvalidChannelError);
+    }
+    S6I_TRY_ASSIGN(auto selectors, SelectorList::make());
+    return s6i_result::make_ok(Channel(capacity, std::move(selectors)));
+  }
+
+  // コピー禁止
+  Channel(const Channel&) = delete;
+  Channel& operator=(const Channel&) = delete;
+
+  // ムーブ可能（送受信中のムーブは未定義）
+  Channel(Channel&& other)
+      : m_send_pos(other.m_send_pos.load(std::memory_order_relaxed)),
+        m_recv_pos(other.m_recv_pos.load(std::memory_order_relaxed)),
+        m_mask(other.m_mask),
+        m_cells(std::move(other.m_cells)),
+        m_closed(other.m_closed.load(std::memory_order_relaxed)),
+        m_selectors(std::move(other.m_selectors)) {
+    other.m_mask = 0;
+  }
+
+  Channel& operator=(Channel&& other) {
+    Channel(std::move(other)).swap(*this);
+    return *this;
+  }
+
+  ~Channel() {
+    if (!m_cells) {
+      return;
+    }
+    const size_t send_pos = m_send_pos.load(std::memory_order_relaxed);
+    for (size_t pos = m_recv_pos.load(std::memory_order_relaxed);
+         pos != send_pos; ++pos) {
+      Cell& cell = m_cells[pos & m_mask];
+      if (cell.m_seq.load(std::memory_order_relaxed) == pos + 1) {
+        cell.get()->~T();
+      }
+    }
+  }
+
+  /** @brief 容量 */
+  size_t capacity() const { return m_cells ? m_mask + 1 : 0; }
+
+  /** @brief おおよその要素数 */
+  size_t size() const {
+    const size_t recv_pos = m_recv_pos.load(std::memory_order_acquire);
+    const size_t send_pos = m_send_pos.load(std::memory_order_acquire);
+    return send_pos > recv_pos ? send_pos - recv_pos : 0;
+  }
+
+  /** @brief closeされたかどうか */
+  bool is_closed() const { return m_closed.load(std::memory_order_acquire); }
+
+  /**
+   * @brief チャネルを閉じ、待っている送信側・受信側をすべて起こす
+   * @return 成功時: void、失敗時: エラー
+   */
+  s6i_result::Result<void, SyncError> close() {
+    if (!m_cells) {
+      return s6i_result::make_err(SyncError::InvalidChannelError);
+    }
+    m_closed.store(true, std::memory_order_seq_cst);
+    m_send_seq.fetch_add(1, std::memory_order_seq_cst);
+    futex_wake_all(m_send_seq);
+    m_recv_seq.fetch_add(1, std::memory_order_seq_cst);
+    futex_wake_all(m_recv_seq);
+    notify_selectors();
+    return s6i_result::make_ok();
+  }
+
+  /**
+   * @brief 待たずに送信する
+   * @param value 送信する値（失敗時はムーブされません）
+   * @return 成功時: void、失敗時: エラー（満杯ならChannelFullError）
+   */
+  s6i_result::Result<void, SyncError> try_send(T&& value) {
+    return try_send_impl(std::move(value));
+  }
+  s6i_result::Result<void, SyncError> try_send(const T& value) {
+    return try_send_impl(value);
+  }
+
+  /**
+   * @brief 空きができるまで待ってから送信する
+   * @param value 送信する値
+   * @return 成功時: void、失敗時: エラー
+   */
+  s6i_result::Result<void, SyncError> send(T value) {
+    Backoff backoff;
+    for (;;) {
+      const uint32_t seq = m_send_seq.load(std::memory_order_seq_cst);
+      auto send_result = try_send_impl(std::move(value));
+      if (send_result.is_ok() ||
+          send_result.unwrap_err() != SyncError::ChannelFullError) {
+        return send_result;
+      }
+      wait(backoff, m_send_seq, m_send_waiters, seq,
+           [this]() { return has_space() || is_closed(); });
+    }
+  }
+
+  /**
+   * @brief 空きがある分だけまとめて送信し、残りは空きを待って送信する
+   * @param items 送信する値の配列（コピーされます）
+   * @param count 要素数
+   * @return 成功時: void、失敗時: エラー（途中でcloseされた場合も含む）
+   */
+  s6i_result::Result<void, SyncError> send_batch(const T* items,
+                                                 size_t count) {
+    Backoff backoff;
+    while (count > 0) {
+      const uint32_t seq = m_send_seq.load(std::memory_order_seq_cst);
+      S6I_TRY_ASSIGN(const size_t n, try_send_batch(items, count));
+      items += n;
+      count -= n;
+      if (n > 0) {
+        backoff.reset();
+        continue;
+      }
+      wait(backoff, m_send_seq, m_send_waiters, seq,
+           [this]() { return has_space() || is_closed(); });
+    }
+    return s6i_result::make_ok();
+  }
+
+  /**
+   * @brief 待たずに、空きがある分だけまとめて送信する
+   * @param items 送信する値の配列（コピーされます）
+   * @param count 要素数
+   * @return 成功時: 送信した要素数、失敗時: エラー
+   */
+  s6i_result::Result<size_t, SyncError> try_send_batch(const T* items,
+                                                       size_t count) {
+    if (!m_cells) {
+      return s6i_result::make_err(SyncError::InvalidChannelError);
+    }
+    if (is_closed()) {
+      return s6i_result::make_err(SyncError::ChannelClosedError);
+    }
+    if (count == 0) {
+      return s6i_result::make_ok(size_t{0});
+    }
+    size_t pos = m_send_pos.load(std::memory_order_relaxed);
+    for (;;) {
+      // posから連続して空いているセルを数える
+      size_t n = 0;
+      while (n < count && n <= m_mask &&
+             m_cells[(pos + n) & m_mask].m_seq.load(
+                 std::memory_order_acquire) == pos + n) {
+        ++n;
+      }
+      if (n == 0) {
+        const size_t seq =
+            m_cells[pos & m_mask].m_seq.load(std::memory_order_acquire);
+        if (static_cast<intptr_t>(seq - pos) < 0) {
+          return s6i_result::make_ok(size_t{0});
+        }
+        pos = m_send_pos.load(std::memory_order_relaxed);
+        continue;
+      }
+      if (m_send_pos.compare_exchange_weak(pos, pos + n,
+                                           std::memory_order_relaxed)) {
+        for (size_t i = 0; i < n; ++i) {
+          Cell& cell = m_cells[(pos + i) & m_mask];
+          new (cell.get()) T(items[i]);
+          cell.m_seq.store(pos + i + 1, std::memory_order_release);
+        }
+        notify(m_recv_seq, m_recv_waiters, n);
+        return s6i_result::make_ok(n);
+      }
+    }
+  }
+
+  /**
+   * @brief 待たずに受信する
+   * @return 成功時: 受信した値、失敗時: エラー
+   * （空ならChannelEmptyError、closeされて空ならChannelClosedError）
+   */
+  s6i_result::Result<T, SyncError> try_recv() {
+    if (!m_cells) {
+      return s6i_result::make_err(SyncError::InvalidChannelError);
+    }
+    size_t pos = m_recv_pos.load(std::memory_order_relaxed);
+    for (;;) {
+      Cell& cell = m_cells[pos & m_mask];
+      const size_t seq = cell.m_seq.load(std::memory_order_acquire);
+      const auto diff = static_cast<intptr_t>(seq - (pos + 1));
+      if (diff == 0) {
+        if (m_recv_pos.compare_exchange_weak(pos, pos + 1,
+                                             std::memory_order_relaxed)) {
+          T* item = cell.get();
+          T value(std::move(*item));
+          item->~T();
+          cell.m_seq.store(pos + m_mask + 1, std::memory_order_release);
+          notify(m_send_seq, m_send_waiters, 1);
+          return s6i_result::make_ok(std::move(value));
+        }
+      } else if (diff < 0) {
+        return s6i_result::make_err(empty_error());
+      } else {
+        pos = m_recv_pos.load(std::memory_order_relaxed);
+      }
+    }
+  }
+
+  /**
+   * @brief 要素が届くまで待ってから受信する
+   * @return 成功時: 受信した値、失敗時: エラー
+   * （closeされて空ならChannelClosedError）
+   */
+  s6i_result::Result<T, SyncError> recv() {
+    Backoff backoff;
+    for (;;) {
+      const uint32_t seq = m_recv_seq.load(std::memory_order_seq_cst);
+      auto recv_result = try_recv();
+      if (recv_result.is_ok() ||
+          recv_result.unwrap_err() != SyncError::ChannelEmptyError) {
+        return recv_result;
+      }
+      wait(backoff, m_recv_seq, m_recv_waiters, seq,
+           [this]() { return has_item() || is_closed(); });
+    }
+  }
+
+  /**
+   * @brief 待たずに、届いている分だけまとめて受信する
+   * @param out 受信した値の格納先（ムーブ代入されます）
+   * @param max_count 受信する最大数
+   * @return 成功時: 受信した要素数（1以上）、失敗時: エラー
+   * （空ならChannelEmptyError、closeされて空ならChannelClosedError）
+   */
+  s6i_result::Result<size_t, SyncError> try_recv_batch(T* out,
+                                                       size_t max_count) {
+    if (!m_cells) {
+      return s6i_result::make_err(SyncError::InvalidChannelError);
+    }
+    if (max_count == 0) {
+      return s6i_result::make_ok(size_t{0});
+    }
+    size_t pos = m_recv_pos.load(std::memory_order_relaxed);
+    for (;;) {
+      // posから連続して埋まっているセルを数える
+      size_t n = 0;
+      while (n < max_count && n <= m_mask &&
+             m_cells[(pos + n) & m_mask].m_seq.load(
+                 std::memory_order_acquire) == pos + n + 1) {
+        ++n;
+      }
+      if (n == 0) {
+        const size_t seq =
+            m_cells[pos & m_mask].m_seq.load(std::memory_order_acquire);
+        if (static_cast<intptr_t>(seq - (pos + 1)) < 0) {
+          return s6i_result::make_err(empty_error());
+        }
+        pos = m_recv_pos.load(std::memory_order_relaxed);
+        continue;
+      }
+      if (m_recv_pos.compare_exchange_weak(pos, pos + n,
+                                           std::memory_order_relaxed)) {
+        for (size_t i = 0; i < n; ++i) {
+          Cell& cell = m_cells[(pos + i) & m_mask];
+          T* item = cell.get();
+          out[i] = std::move(*item);
+          item->~T();
+          cell.m_seq.store(pos + i + m_mask + 1, std::memory_order_release);
+        }
+        notify(m_send_seq, m_send_waiters, n);
+        return s6i_result::make_ok(n);
+      }
+    }
+  }
+
+  /**
+   * @brief 要素が1つ以上届くまで待ってから、まとめて受信する
+   * @param out 受信した値の格納先（ムーブ代入されます）
+   * @param max_count 受信する最大数（1以上）
+   * @return 成功時: 受信した要素数、失敗時: エラー
+   * （closeされて空ならChannelClosedError）
+   */
+  s6i_result::Result<size_t, SyncError> recv_batch(T* out, size_t max_count) {
+    Backoff backoff;
+    for (;;) {
+      const uint32_t seq = m_recv_seq.load(std::memory_order_seq_cst);
+      auto recv_result = try_recv_batch(out, max_count);
+      if (recv_result.is_ok() ||
+          recv_result.unwrap_err() != SyncError::ChannelEmptyError) {
+        return recv_result;
+      }
+      wait(backoff, m_recv_seq, m_recv_waiters, seq,
+           [this]() { return has_item() || is_closed(); });
+    }
+  }
+
+  void swap(Channel& other) {
+    using std::swap;
+    const size_t send_pos = m_send_pos.load(std::memory_order_relaxed);
+    m_send_pos.store(other.m_send_pos.load(std::memory_order_relaxed),
+                     std::memory_order_relaxed);
+    other.m_send_pos.store(send_pos, std::memory_order_relaxed);
+    const size_t recv_pos = m_recv_pos.load(std::memory_order_relaxed);
+    m_recv_pos.store(other.m_recv_pos.load(std::memory_order_relaxed),
+                     std::memory_order_relaxed);
+    other.m_recv_pos.store(recv_pos, std::memory_order_relaxed);
+    const bool closed = m_closed.load(std::memory_order_relaxed);
+    m_closed.store(other.m_closed.load(std::memory_order_relaxed),
+                   std::memory_order_relaxed);
+    other.m_closed.store(closed, std::memory_order_relaxed);
+    swap(m_mask, other.m_mask);
+    swap(m_cells, other.m_cells);
+    swap(m_selectors, other.m_selectors);
+  }
+
+ private:
+  /** @brief シーケンス番号付きのセル */
+  struct Cell {
+    std::atomic<size_t> m_seq{0};
+    alignas(T) unsigned char m_bytes[sizeof(T)];
+
+    T* get() { return std::launder(reinterpret_cast<T*>(m_bytes)); }
+  };
+
+  using SelectorList =
+      Mutex<std::vector<detail::SelectWaker*>, SpinMutexPolicy>;
+
+  Channel(size_t capacity, SelectorList&& selectors)
+      : m_mask(capacity - 1),
+        m_cells(std::make_unique<Cell[]>(capacity)),
+        m_selectors(std::move(selectors)) {
+    for (size_t i = 0; i < capacity; ++i) {
+      m_cells[i].m_seq.store(i, std::memory_order_relaxed);
+    }
+  }
+
+  template <typename U>
+  s6i_result::Result<void, SyncError> try_send_impl(U&& value) {
+    if (!m_cells) {
+      return s6i_result::make_err(SyncError::InvalidChannelError);
+    }
+    if (is_closed()) {
+      return s6i_result::make_err(SyncError::ChannelClosedError);
+    }
+    size_t pos = m_send_pos.load(std::memory_order_relaxed);
+    for (;;) {
+      Cell& cell = m_cells[pos & m_mask];
+      const size_t seq = cell.m_seq.load(std::memory_order_acquire);
+      const auto diff = static_cast<intptr_t>(seq - pos);
+      if (diff == 0) {
+        if (m_send_pos.compare_exchange_weak(pos, pos + 1,
+                                             std::memory_order_relaxed)) {
+          new (cell.get()) T(std::forward<U>(value));
+          cell.m_seq.store(pos + 1, std::memory_order_release);
+          notify(m_recv_seq, m_recv_waiters, 1);
+          return s6i_result::make_ok();
+        }
+      } else if (diff < 0) {
+        return s6i_result::make_err(SyncError::ChannelFullError);
+      } else {
+        pos = m_send_pos.load(std::memory_order_relaxed);
+      }
+    }
+  }
+
+  /**
+   * @brief 受信できなかったときのエラー
+   * closeを確認した後にもう一度空かどうかを見て、close前の要素を取りこぼさない
+   */
+  SyncError empty_error() const {
+    if (!is_closed() || has_item()) {
+      return SyncError::ChannelEmptyError;
+    }
+    return SyncError::ChannelClosedError;
+  }
+
+  bool has_item() const {
+    const size_t pos = m_recv_pos.load(std::memory_order_acquire);
+    return m_cells[pos & m_mask].m_seq.load(std::memory_order_acquire) ==
+           pos + 1;
+  }
+
+  bool has_space() const {
+    const size_t pos = m_send_pos.load(std::memory_order_acquire);
+    return m_cells[pos & m_mask].m_seq.load(std::memory_order_acquire) == pos;
+  }
+
+  /**
+   * @brief 相手側を待つ
+   * しばらくスピンし、それでも進まなければ待機者数を増やしてfutexで眠る。
+   * 待機者数を増やした後に条件を確かめ直すことで、notifyとの行き違いを防ぐ
+   */
+  template <typename Ready>
+  static void wait(Backoff& backoff,
+                   std::atomic<uint32_t>& seq_word,
+                   std::atomic<uint32_t>& waiters,
+                   uint32_t seq,
+                   Ready&& ready) {
+    if (!backoff.is_completed()) {
+      backoff.snooze();
+      return;
+    }
+    waiters.fetch_add(1, std::memory_order_seq_cst);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (!ready()) {
+      futex_wait(seq_word, seq);
+    }
+    waiters.fetch_sub(1, std::memory_order_relaxed);
+  }
+
+  /** @brief 眠っている相手側を、届いた要素数の分だけ起こす */
+  void notify(std::atomic<uint32_t>& seq_word,
+              std::atomic<uint32_t>& waiters,
+              size_t count) {
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    const uint32_t waiting = waiters.load(std::memory_order_relaxed);
+    if (waiting > 0) {
+      seq_word.fetch_add(1, std::memory_order_seq_cst);
+      if (count >= waiting) {
+        futex_wake_all(seq_word);
+      } else {
+        for (size_t i = 0; i < count; ++i) {
+          futex_wake_one(seq_word);
+        }
+      }
+    }
+    if (&seq_word == &m_recv_seq &&
+        m_selector_count.load(std::memory_order_relaxed) > 0) {
+      notify_selectors();
+    }
+  }
+
+  void notify_selectors() {
+    auto guard_result = m_selectors.lock();
+    if (guard_result.is_err()) {
+      return;
+    }
+    for (detail::SelectWaker* waker : *guard_result.unwrap()) {
+      waker->notify();
+    }
+  }
+
+  void add_selector(detail::SelectWaker* waker) {
+    auto guard = m_selectors.lock().unwrap();
+    guard->push_back(waker);
+    m_selector_count.fetch_add(1, std::memory_order_seq_cst);
+  }
+
+  void remove_selector(detail::SelectWaker* waker) {
+    auto guard = m_selectors.lock().unwrap();
+    guard->erase(std::find(guard->begin(), guard->end(), waker));
+    m_selector_count.fetch_sub(1, std::memory_order_relaxed);
+  }
+
+  // 送信側と受信側の位置は別のキャッシュラインに置く
+  alignas(64) std::atomic<size_t> m_send_pos{0};
+  alignas(64) std::atomic<size_t> m_recv_pos{0};
+  alignas(64) size_t m_mask = 0;
+  std::unique_ptr<Cell[]> m_cells;
+  std::atomic<bool> m_closed{false};
+  // 眠っている送信側・受信側を起こすためのfutex
+  alignas(64) std::atomic<uint32_t> m_send_seq{0};
+  std::atomic<uint32_t> m_send_waiters{0};
+  alignas(64) std::atomic<uint32_t> m_recv_seq{0};
+  std::atomic<uint32_t> m_recv_waiters{0};
+  // selectで待っているスレッド
+  std::atomic<uint32_t> m_selector_count{0};
+  SelectorList m_selectors;
+
+  friend struct detail::ChannelSelector;
+};
+
+template <typename T>
+inline void swap(Channel<T>& lhs, Channel<T>& rhs) {
+  lhs.swap(rhs);
+}
+
+namespace detail {
+
+/** @brief selectの受信ケース */
+template <typename T, typename F>
+struct RecvCase {
+  Channel<T>* m_channel;
+  F m_handler;
+};
+
+struct ChannelSelector {
+  /** @brief ケースの試行結果 */
+  enum class Poll { Ready, Empty, Closed };
+
+  template <typename T, typename F>
+  static Poll poll(RecvCase<T, F>& recv_case) {
+    auto recv_result = recv_case.m_channel->try_recv();
+    if (recv_result.is_ok()) {
+      recv_case.m_handler(recv_result.unwrap());
+      return Poll::Ready;
+    }
+    return recv_result.unwrap_err() == SyncError::ChannelEmptyError
+               ? Poll::Empty
+               : Poll::Closed;
+  }
+
+  template <typename T, typename F>
+  static void add(RecvCase<T, F>& recv_case, SelectWaker* waker) {
+    recv_case.m_channel->add_selector(waker);
+  }
+
+  template <typename T, typename F>
+  static void remove(RecvCase<T, F>& recv_case, SelectWaker* waker) {
+    recv_case.m_channel->remove_selector(waker);
+  }
+};
+
+}  // namespace detail
+
+/**
+ * @brief selectの受信ケースを作成
+ * @param channel 受信するChannel
+ * @param handler 受信した値を受け取る関数 void(T)
+ */
+template <typename T, typename F>
+detail::RecvCase<T, std::decay_t<F>> on_recv(Channel<T>& channel,
+                                             F&& handler) {
+  return {&channel, std::forward<F>(handler)};
+}
+
+/**
+ * @brief 複数のChannelのうち、最初に受信できたものを1つ処理する
+ *
+ * 受信できるまで眠り、受信したケースのhandlerを呼び出します。
+ * 偏りが出ないように、試す順番の先頭は呼び出しごとにずらします。
+ * closeされたChannelは飛ばし、すべてcloseされて空ならエラーを返します。
+ *
+ * @param cases on_recvで作成したケース
+ * @return 成功時: 処理したケースの番号、失敗時: エラー
+ */
+template <typename... Cases>
+s6i_result::Result<size_t, SyncError> select(Cases&&... cases) {
+  static_assert(sizeof...(Cases) > 0, "select requires at least one case");
+  using Selector = detail::ChannelSelector;
+  constexpr size_t CASE_COUNT = sizeof...(Cases);
+
+  static thread_local size_t s_start = 0;
+  const size_t start = s_start++ % CASE_COUNT;
+
+  // 全ケースを1周試す（Readyならその番号、なければCASE_COUNT）
+  std::array<bool, CASE_COUNT> closed{};
+  auto poll_all = [&]() {
+    for (size_t k = 0; k < CASE_COUNT; ++k) {
+      const size_t index = (start + k) % CASE_COUNT;
+      if (closed[index]) {
+        continue;
+      }
+      Selector::Poll poll = Selector::Poll::Empty;
+      size_t i = 0;
+      ((i++ == index ? (void)(poll = Selector::poll(cases)) : void()), ...);
+      if (poll == Selector::Poll::Ready) {
+        return index;
+      }
+      closed[index] = poll == Selector::Poll::Closed;
+    }
+    return CASE_COUNT;
+  };
+  auto all_closed = [&closed]() {
+    return std::all_of(closed.begin(), closed.end(),
+                       [](bool c) { return c; });
+  };
+
+  Backoff backoff;
+  while (!backoff.is_completed()) {
+    if (const size_t index = poll_all(); index < CASE_COUNT) {
+      return s6i_result::make_ok(index);
+    }
+    if (all_closed()) {
+      return s6i_result::make_err(SyncError::ChannelClosedError);
+    }
+    backoff.snooze();
+  }
+
+  // 各Channelに登録してから試し直し、届くまで眠る
+  detail::SelectWaker waker;
+  (Selector::add(cases, &waker), ...);
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  size_t index = CASE_COUNT;
+  for (;;) {
+    const uint32_t seq = waker.m_seq.load(std::memory_order_seq_cst);
+    index = poll_all();
+    if (index < CASE_COUNT || all_closed()) {
+      break;
+    }
+    futex_wait(waker.m_seq, seq);
+  }
+  (Selector::remove(cases, &waker), ...);
+  if (index == CASE_COUNT) {
+    return s6i_result::make_err(SyncError::ChannelClosedError);
+  }
+  return s6i_result::make_ok(index);
+}
+
+}  // namespace s6i_sync
@@ -0,0 +1,529 @@
+#pragma once
+
+#include <s6i_result/result.h>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <new>
+#include <optional>
+#include <tuple>
+#include <utility>
+#include "error.h"
+#include "rw_lock.h"
+
+namespace s6i_sync {
+
+namespace detail {
+
+/**
+ * @brief キーのハッシュ値をかき混ぜる（MurmurHash3のfmix64）
+ * std::hashは整数に対して恒等写像のことが多く、
+ * そのままでは上位ビット（シャード）と下位ビット（位置）が偏るため
+ */
+inline uint64_t mix_hash(uint64_t h) {
+  h ^= h >> 33;
+  h *= 0xff51afd7ed558ccdull;
+  h ^= h >> 33;
+  h *= 0xc4ceb9fe1a85ec53ull;
+  h ^= h >> 33;
+  return h;
+}
+
+/**
+ * @brief 線形探索のオープンアドレス法によるハッシュテーブル（ロックなし）
+ *
+ * 各位置の使用中フラグとハッシュ値の一部を1バイトの制御配列にまとめ、
+ * 探索はまずこの配列だけを順に見ます。キーの比較は
+ * 7ビットの指紋が一致したときだけ行います。
+ * 削除は後続の要素を前に詰める（墓標を残さない）ため、
+ * 削除を繰り返しても探索が長くなりません。
+ */
+template <typename K, typename V>
+class FlatTable {
+ public:
+  FlatTable() = default;
+
+  // コピー禁止
+  FlatTable(const FlatTable&) = delete;
+  FlatTable& operator=(const FlatTable&) = delete;
+
+  FlatTable(FlatTable&& other)
+      : m_ctrl(std::move(other.m_ctrl)),
+        m_slots(std::move(other.m_slots)),
+        m_mask(std::exchange(other.m_mask, 0)),
+        m_size(std::exchange(other.m_size, 0)) {}
+
+  FlatTable& operator=(FlatTable&& other) {
+    FlatTable(std::move(other)).swap(*this);
+    return *this;
+  }
+
+  ~FlatTable() { clear(); }
+
+  size_t size() const { return m_size; }
+  size_t capacity() const { return m_ctrl ? m_mask + 1 : 0; }
+
+  /**
+   * @brief キーに対応する値を探す
+   * @return 見つかった場合は値へのポインタ、見つからなければnullptr
+   */
+  template <typename Eq>
+  V* find(const K& key, uint64_t hash, const Eq& eq) const {
+    const size_t i = find_index(key, hash, eq);
+    return i == NPOS ? nullptr : &m_slots[i].value();
+  }
+
+  /**
+   * @brief 新しい要素を追加する（キーが存在しないことは呼び出し側が保証）
+   * @return 追加した値
+   */
+  template <typename... Args>
+  V& emplace_new(uint64_t hash, K&& key, Args&&... args) {
+    // 負荷率を3/4以下に保つ
+    if ((m_size + 1) * 4 > capacity() * 3) {
+      rehash(capacity() == 0 ? MIN_CAPACITY : capacity() * 2);
+    }
+    const size_t i = find_empty(hash);
+    m_ctrl[i] = make_tag(hash);
+    new (m_slots[i].get())
+        Entry(std::piecewise_construct, std::forward_as_tuple(std::move(key)),
+              std::forward_as_tuple(std::forward<Args>(args)...));
+    m_slots[i].m_hash = hash;
+    ++m_size;
+    return m_slots[i].value();
+  }
+
+  /**
+   * @brief キーに対応する要素を削除する
+   * @return 削除した場合はtrue
+   */
+  template <typename Eq>
+  bool erase(const K& key, uint64_t hash, const Eq& eq) {
+    size_t hole = find_index(key, hash, eq);
+    if (hole == NPOS) {
+      return false;
+    }
+    m_slots[hole].get()->~Entry();
+    // 後続の要素のうち、本来の位置から見て穴より後ろにあるものを前に詰める
+    for (size_t i = (hole + 1) & m_mask; m_ctrl[i] != EMPTY;
+         i = (i + 1) & m_mask) {
+      const size_t home = m_slots[i].m_hash & m_mask;
+      if (((i - home) & m_mask) >= ((i - hole) & m_mask)) {
+        move_slot(i, hole);
+        hole = i;
+      }
+    }
+    m_ctrl[hole] = EMPTY;
+    --m_size;
+    return true;
+  }
+
+  /** @brief すべての要素を削除する（確保済みの領域は残す） */
+  void clear() {
+    for (size_t i = 0; i < capacity(); ++i) {
+      if (m_ctrl[i] != EMPTY) {
+        m_slots[i].get()->~Entry();
+        m_ctrl[i] = EMPTY;
+      }
+    }
+    m_size = 0;
+  }
+
+  /**
+   * @brief すべての要素に関数を適用する
+   * @param f void(const K&, V&)
+   */
+  template <typename F>
+  void for_each(F&& f) const {
+    for (size_t i = 0; i < capacity(); ++i) {
+      if (m_ctrl[i] != EMPTY) {
+        f(m_slots[i].key(), m_slots[i].value());
+      }
+    }
+  }
+
+  void swap(FlatTable& other) {
+    using std::swap;
+    swap(m_ctrl, other.m_ctrl);
+    swap(m_slots, other.m_slots);
+    swap(m_mask, other.m_mask);
+    swap(m_size, other.m_size);
+  }
+
+ private:
+  using Entry = std::pair<K, V>;
+
+  static constexpr size_t MIN_CAPACITY = 8;
+  static constexpr uint8_t EMPTY = 0;
+  static constexpr size_t NPOS = ~size_t{0};
+
+  struct Slot {
+    Entry* get() { return std::launder(reinterpret_cast<Entry*>(m_bytes)); }
+    const K& key() { return get()->first; }
+    V& value() { return get()->second; }
+
+    uint64_t m_hash = 0;  ///< 詰め直しと拡張のために保持する
+    alignas(Entry) unsigned char m_bytes[sizeof(Entry)];
+  };
+
+  /** @brief 使用中を表す最上位ビットと、ハッシュ値の指紋7ビット */
+  static uint8_t make_tag(uint64_t hash) {
+    // 下位ビットは位置、上位ビットはシャードに使うため、中ほどのビットを使う
+    return static_cast<uint8_t>(0x80 | ((hash >> 48) & 0x7f));
+  }
+
+  template <typename Eq>
+  size_t find_index(const K& key, uint64_t hash, const Eq& eq) const {
+    if (m_size == 0) {
+      return NPOS;
+    }
+    const uint8_t tag = make_tag(hash);
+    for (size_t i = hash & m_mask;; i = (i + 1) & m_mask) {
+      const uint8_t ctrl = m_ctrl[i];
+      if (ctrl == EMPTY) {
+        return NPOS;
+      }
+      if (ctrl == tag && eq(m_slots[i].key(), key)) {
+        return i;
+      }
+    }
+  }
+
+  size_t find_empty(uint64_t hash) const {
+    size_t i = hash & m_mask;
+    while (m_ctrl[i] != EMPTY) {
+      i = (i + 1) & m_mask;
+    }
+    return i;
+  }
+
+  void move_slot(size_t from, size_t to) {
+    new (m_slots[to].get()) Entry(std::move(*m_slots[from].get()));
+    m_slots[from].get()->~Entry();
+    m_slots[to].m_hash = m_slots[from].m_hash;
+    m_ctrl[to] = m_ctrl[from];
+  }
+
+  void rehash(size_t capacity) {
+    FlatTable next;
+    next.m_ctrl = std::make_unique<uint8_t[]>(capacity);
+    next.m_slots = std::make_unique<Slot[]>(capacity);
+    next.m_mask = capacity - 1;
+    for (size_t i = 0; i < this->capacity(); ++i) {
+      if (m_ctrl[i] == EMPTY) {
+        continue;
+      }
+      const size_t j = next.find_empty(m_slots[i].m_hash);
+      new (next.m_slots[j].get()) Entry(std::move(*m_slots[i].get()));
+      next.m_slots[j].m_hash = m_slots[i].m_hash;
+      next.m_ctrl[j] = m_ctrl[i];
+      ++next.m_size;
+    }
+    swap(next);
+  }
+
+  std::unique_ptr<uint8_t[]> m_ctrl;  ///< 0は空き、それ以外はmake_tag()
+  std::unique_ptr<Slot[]> m_slots;
+  size_t m_mask = 0;
+  size_t m_size = 0;
+};
+
+}  // namespace detail
+
+/**
+ * @brief キーをシャードに振り分けた並行ハッシュマップ
+ *
+ * キーはハッシュ値の上位ビットでシャードに振り分けられ、
+ * 各シャードは読み書きロック（書き込み優先）とオープンアドレス法の
+ * テーブルを持ちます。ロックは別のシャードと共有しないため、
+ * 異なるシャードへの操作は互いを待ちません。
+ * シャードはキャッシュラインの境界に置き、隣のシャードのロックと
+ * 同じラインを奪い合わないようにしています。
+ *
+ * 値は常にシャードのロックの内側でだけ触れるため、取得はコピー（get）か
+ * 関数の適用（visit）で行います。リソースのハンドルやshared_ptrなど、
+ * コピーの軽い値を想定しています。
+ *
+ * @tparam K キーの型
+ * @tparam V 値の型
+ * @tparam Hash キーのハッシュ関数
+ * @tparam KeyEqual キーの比較関数
+ */
+template <typename K,
+          typename V,
+          typename Hash = std::hash<K>,
+          typename KeyEqual = std::equal_to<K>>
+class ConcurrentMap {
+ public:
+  /** @brief シャード数の既定値 */
+  static constexpr size_t DEFAULT_SHARD_COUNT = 32;
+
+  /**
+   * @brief 新しいConcurrentMapを作成
+   * @param shard_count シャード数（2の累乗）
+   * @return 成功時: 作成されたConcurrentMap、失敗時: エラー
+   */
+  static s6i_result::Result<ConcurrentMap, SyncError> make(
+      size_t shard_count = DEFAULT_SHARD_COUNT) {
+    if (shard_count == 0 || (shard_count & (shard_count - 1)) != 0) {
+      return s6i_result::make_err(SyncError::InvalidMapError);
+    }
+    return s6i_result::make_ok(ConcurrentMap(shard_count));
+  }
+
+  // コピー禁止
+  ConcurrentMap(const ConcurrentMap&) = delete;
+  ConcurrentMap& operator=(const ConcurrentMap&) = delete;
+
+  // ムーブ可能（操作中のムーブは未定義）
+  ConcurrentMap(ConcurrentMap&& other)
+      : m_shards(std::move(other.m_shards)),
+        m_shard_shift(other.m_shard_shift),
+        m_shard_count(std::exchange(other.m_shard_count, 0)),
+        m_hash(std::move(other.m_hash)),
+        m_eq(std::move(other.m_eq)) {}
+
+  ConcurrentMap& operator=(ConcurrentMap&& other) {
+    ConcurrentMap(std::move(other)).swap(*this);
+    return *this;
+  }
+
+  /** @brief 有効なマップかどうか（ムーブ元は無効） */
+  bool is_valid() const { return m_shards != nullptr; }
+
+  /** @brief シャード数 */
+  size_t shard_count() const { return m_shard_count; }
+
+  /**
+   * @brief キーに対応する値のコピーを取得
+   * @return 成功時: 値（見つからなければnullopt）、失敗時: エラー
+   */
+  s6i_result::Result<std::optional<V>, SyncError> get(const K& key) const {
+    if (!is_valid()) {
+      return s6i_result::make_err(SyncError::InvalidMapError);
+    }
+    const uint64_t hash = hash_of(key);
+    Shard& shard = shard_of(hash);
+    shard.m_lock.lock_shared();
+    const V* value = shard.m_table.find(key, hash, m_eq);
+    std::optional<V> result = value ? std::optional<V>(*value) : std::nullopt;
+    shard.m_lock.unlock_shared();
+    return s6i_result::make_ok(std::move(result));
+  }
+
+  /**
+   * @brief キーが存在するかどうか
+   * @return 成功時: 存在すればtrue、失敗時: エラー
+   */
+  s6i_result::Result<bool, SyncError> contains(const K& key) const {
+    return visit(key, [](const V&) {});
+  }
+
+  /**
+   * @brief キーに対応する値に、読み込みロックを取ったまま関数を適用する
+   * @param f void(const V&) ロック中に呼ばれるため、短く済ませること
+   * @return 成功時: 見つかった場合はtrue、失敗時: エラー
+   */
+  template <typename F>
+  s6i_result::Result<bool, SyncError> visit(const K& key, F&& f) const {
+    if (!is_valid()) {
+      return s6i_result::make_err(SyncError::InvalidMapError);
+    }
+    const uint64_t hash = hash_of(key);
+    Shard& shard = shard_of(hash);
+    shard.m_lock.lock_shared();
+    const V* value = shard.m_table.find(key, hash, m_eq);
+    if (value) {
+      std::forward<F>(f)(*value);
+    }
+    shard.m_lock.unlock_shared();
+    return s6i_result::make_ok(value != nullptr);
+  }
+
+  /**
+   * @brief 要素を追加する（既に存在する場合は何もしない）
+   * @return 成功時: 追加した場合はtrue、失敗時: エラー
+   */
+  s6i_result::Result<bool, SyncError> insert(K key, V value) {
+    if (!is_valid()) {
+      return s6i_result::make_err(SyncError::InvalidMapError);
+    }
+    const uint64_t hash = hash_of(key);
+    Shard& shard = shard_of(hash);
+    shard.m_lock.lock();
+    const bool inserted = shard.m_table.find(key, hash, m_eq) == nullptr;
+    if (inserted) {
+      shard.m_table.emplace_new(hash, std::move(key), std::move(value));
+    }
+    shard.m_lock.unlock();
+    return s6i_result::make_ok(inserted);
+  }
+
+  /**
+   * @brief 要素を追加する（既に存在する場合は値を置き換える）
+   * @return 成功時: 追加した場合はtrue（置き換えた場合はfalse）、失敗時: エラー
+   */
+  s6i_result::Result<bool, SyncError> insert_or_assign(K key, V value) {
+    if (!is_valid()) {
+      return s6i_result::make_err(SyncError::InvalidMapError);
+    }
+    const uint64_t hash = hash_of(key);
+    Shard& shard = shard_of(hash);
+    shard.m_lock.lock();
+    V* existing = shard.m_table.find(key, hash, m_eq);
+    if (existing) {
+      *existing = std::move(value);
+    } else {
+      shard.m_table.emplace_new(hash, std::move(key), std::move(value));
+    }
+    shard.m_lock.unlock();
+    return s6i_result::make_ok(existing == nullptr);
+  }
+
+  /**
+   * @brief キーに対応する値を取得し、なければ作って追加する
+   *
+   * 同じキーで同時に呼ばれても、makeが呼ばれるのは1回だけです。
+   * makeはシャードの書き込みロックを取ったまま呼ばれるため、
+   * その間は同じシャードの他のキーへの操作も待たされます。
+   * makeから同じマップを操作してはいけません。
+   *
+   * @param make V() 値を作る関数
+   * @return 成功時: 値のコピー、失敗時: エラー
+   */
+  template <typename F>
+  s6i_result::Result<V, SyncError> get_or_insert_with(const K& key, F&& make) {
+    if (!is_valid()) {
+      return s6i_result::make_err(SyncError::InvalidMapError);
+    }
+    const uint64_t hash = hash_of(key);
+    Shard& shard = shard_of(hash);
+
+    // ほとんどの呼び出しは既にある値を読むだけなので、先に読み込みロックで探す
+    shard.m_lock.lock_shared();
+    if (const V* value = shard.m_table.find(key, hash, m_eq)) {
+      V result = *value;
+      shard.m_lock.unlock_shared();
+      return s6i_result::make_ok(std::move(result));
+    }
+    shard.m_lock.unlock_shared();
+
+    // 書き込みロックを取る間に他のスレッドが追加しているかもしれない
+    shard.m_lock.lock();
+    V* value = shard.m_table.find(key, hash, m_eq);
+    if (!value) {
+      value = &shard.m_table.emplace_new(hash, K(key), std::forward<F>(make)());
+    }
+    V result = *value;
+    shard.m_lock.unlock();
+    return s6i_result::make_ok(std::move(result));
+  }
+
+  /**
+   * @brief 要素を削除する
+   * @return 成功時: 削除した場合はtrue、失敗時: エラー
+   */
+  s6i_result::Result<bool, SyncError> erase(const K& key) {
+    if (!is_valid()) {
+      return s6i_result::make_err(SyncError::InvalidMapError);
+    }
+    const uint64_t hash = hash_of(key);
+    Shard& shard = shard_of(hash);
+    shard.m_lock.lock();
+    const bool erased = shard.m_table.erase(key, hash, m_eq);
+    shard.m_lock.unlock();
+    return s6i_result::make_ok(erased);
+  }
+
+  /**
+   * @brief 要素数（他のスレッドが操作中なら目安）
+   * シャードを1つずつロックして数えます
+   */
+  size_t size() const {
+    size_t size = 0;
+    for (size_t i = 0; i < m_shard_count; ++i) {
+      m_shards[i].m_lock.lock_shared();
+      size += m_shards[i].m_table.size();
+      m_shards[i].m_lock.unlock_shared();
+    }
+    return size;
+  }
+
+  /** @brief すべての要素を削除する */
+  void clear() {
+    for (size_t i = 0; i < m_shard_count; ++i) {
+      m_shards[i].m_lock.lock();
+      m_shards[i].m_table.clear();
+      m_shards[i].m_lock.unlock();
+    }
+  }
+
+  /**
+   * @brief すべての要素に関数を適用する
+   * シャードを1つずつ読み込みロックして回るため、
+   * マップ全体のある時点の状態を見るわけではありません
+   * @param f void(const K&, const V&)
+   */
+  template <typename F>
+  void for_each(F&& f) const {
+    for (size_t i = 0; i < m_shard_count; ++i) {
+      m_shards[i].m_lock.lock_shared();
+      m_shards[i].m_table.for_each(
+          [&f](const K& key, const V& value) { f(key, value); });
+      m_shards[i].m_lock.unlock_shared();
+    }
+  }
+
+  void swap(ConcurrentMap& other) {
+    using std::swap;
+    swap(m_shards, other.m_shards);
+    swap(m_shard_shift, other.m_shard_shift);
+    swap(m_shard_count, other.m_shard_count);
+    swap(m_hash, other.m_hash);
+    swap(m_eq, other.m_eq);
+  }
+
+ private:
+  struct alignas(64) Shard {
+    detail::RawRwLock m_lock;
+    detail::FlatTable<K, V> m_table;
+  };
+
+  explicit ConcurrentMap(size_t shard_count)
+      : m_shards(std::make_unique<Shard[]>(shard_count)),
+        m_shard_shift(64 - log2(shard_count)),
+        m_shard_count(shard_count) {}
+
+  static uint32_t log2(size_t n) {
+    uint32_t bits = 0;
+    while ((size_t{1} << bits) < n) {
+      ++bits;
+    }
+    return bits;
+  }
+
+  uint64_t hash_of(const K& key) const {
+    return detail::mix_hash(static_cast<uint64_t>(m_hash(key)));
+  }
+
+  /** @brief ハッシュ値の上位ビットでシャードを選ぶ（下位ビットはテーブル内の位置） */
+  Shard& shard_of(uint64_t hash) const {
+    // シャードが1つのときはシフト量が64になるため、別に扱う
+    return m_shard_shift >= 64 ? m_shards[0] : m_shards[hash >> m_shard_shift];
+  }
+
+  std::unique_ptr<Shard[]> m_shards;
+  uint32_t m_shard_shift = 64;
+  size_t m_shard_count = 0;
+  Hash m_hash;
+  KeyEqual m_eq;
+};
+
+template <typename K, typename V, typename Hash, typename KeyEqual>
+inline void swap(ConcurrentMap<K, V, Hash, KeyEqual>& lhs,
+                 ConcurrentMap<K, V, Hash, KeyEqual>& rhs) {
+  lhs.swap(rhs);
+}
+
+}  // namespace s6i_sync
@@ -1,17 +1,35 @@
 #pragma once
 
 #include <SDL.h>
+#include <s6i_log/log.h>
 #include <s6i_result/result.h>
+#include <s6i_result/try.h>
+#include <algorithm>
+#include <atomic>
 #include <cassert>
-#include <variant>  // std::monostateのため
+#include <cstdint>
+#include <type_traits>
 #include "error.h"
 #include "mutex.h"
 
 namespace s6i_sync {
 
+/**
+ * @brief 時間制限付き待機の結果
+ */
+enum class WaitStatus {
+  Signaled,  ///< 起こされた（見せかけの起床を含む）
+  TimedOut,  ///< 時間切れ
+};
+
 /**
  * @brief 条件変数クラス
  * スレッド間の同期を制御するための条件変数を提供します
+ *
+ * SdlMutexPolicy以外のMutexと組み合わせた場合は、
+ * 初回使用時に作成する中継用のSDL_mutexを介して待機します。
+ *
+ * 時刻はSDL_GetTicks64()と同じミリ秒単位です。
  */
 class CondVar {
  public:
@@ -21,10 +39,10 @@ class CondVar {
    */
   static s6i_result::Result<CondVar, SyncError> make() {
     SDL_cond* cond = SDL_CreateCond();
-    SDL_LogInfo(SDL_LOG_CATEGORY_SYSTEM, "Create condition variable.");
+    S6I_LOG_DEBUG(SDL_LOG_CATEGORY_SYSTEM, "Create condition variable.");
     if (!cond) {
-      SDL_LogError(SDL_LOG_CATEGORY_SYSTEM,
-                   "Failed to create condition variable: %s", SDL_GetError());
+      S6I_LOG_ERROR(SDL_LOG_CATEGORY_SYSTEM,
+                    "Failed to create condition variable: %s", SDL_GetError());
       return s6i_result::make_err(SyncError::CondVarCreationError);
     }
     return s6i_result::make_ok(CondVar(cond));
@@ -35,7 +53,11 @@ class CondVar {
   CondVar& operator=(const CondVar&) = delete;
 
   // ムーブ可能
-  CondVar(CondVar&& other) : m_cond(other.m_cond) { other.m_cond = nullptr; }
+  CondVar(CondVar&& other)
+      : m_cond(other.m_cond),
+        m_relay(other.m_relay.exchange(nullptr, std::memory_order_acq_rel)) {
+    other.m_cond = nullptr;
+  }
 
   CondVar& operator=(CondVar&& other) {
     CondVar(std::move(other)).swap(*this);
@@ -43,8 +65,9 @@ class CondVar {
   }
 
   ~CondVar() {
-    SDL_LogInfo(SDL_LOG_CATEGORY_SYSTEM, "Destroy condition variable.");
+    S6I_LOG_DEBUG(SDL_LOG_CATEGORY_SYSTEM, "Destroy condition variable.");
     SDL_DestroyCond(m_cond);
+    SDL_DestroyMutex(m_relay.load(std::memory_order_acquire));
   }
 
   /**
@@ -52,17 +75,95 @@ class CondVar {
    * @param guard ロック済みのMutexGuard
    * @return 成功時: void、失敗時: エラー
    */
-  template <typename T>
-  s6i_result::Result<std::monostate, SyncError> wait(MutexGuard<T>& guard) {
-    if (!m_cond) {
-      return s6i_result::make_err(SyncError::InvalidCondVarError);
+  template <typename T, typename Policy>
+  s6i_result::Result<void, SyncError> wait(MutexGuard<T, Policy>& guard) {
+    S6I_TRY(wait_impl(guard, SDL_MUTEX_MAXWAIT));
+    return s6i_result::make_ok();
+  }
+
+  /**
+   * @brief 条件を満たすまで条件変数で待機（見せかけの起床は内部で処理）
+   * @param guard ロック済みのMutexGuard
+   * @param pred 待機を終える条件 bool(T&)
+   * @return 成功時: void、失敗時: エラー
+   */
+  template <typename T, typename Policy, typename Pred>
+  s6i_result::Result<void, SyncError> wait(MutexGuard<T, Policy>& guard,
+                                           Pred&& pred) {
+    S6I_TRY(check_guard(guard));
+    while (!pred(*guard)) {
+      S6I_TRY(wait(guard));
     }
-    if (SDL_CondWait(m_cond, guard.get_raw()) < 0) {
-      SDL_LogError(SDL_LOG_CATEGORY_SYSTEM,
-                   "Failed to wait on condition variable: %s", SDL_GetError());
-      return s6i_result::make_err(SyncError::CondVarWaitError);
+    return s6i_result::make_ok();
+  }
+
+  /**
+   * @brief 指定時間まで条件変数で待機
+   * @param guard ロック済みのMutexGuard
+   * @param timeout_ms 最大の待機時間（ミリ秒）
+   * @return 成功時: 起こされたか時間切れか、失敗時: エラー
+   */
+  template <typename T, typename Policy>
+  s6i_result::Result<WaitStatus, SyncError> wait_for(
+      MutexGuard<T, Policy>& guard,
+      uint32_t timeout_ms) {
+    // SDL_MUTEX_MAXWAITは無期限の意味になるため、1つ手前で止める
+    return wait_impl(guard, std::min(timeout_ms, SDL_MUTEX_MAXWAIT - 1));
+  }
+
+  /**
+   * @brief 条件を満たすか指定時間が過ぎるまで条件変数で待機
+   * @param guard ロック済みのMutexGuard
+   * @param timeout_ms 最大の待機時間（ミリ秒）
+   * @param pred 待機を終える条件 bool(T&)
+   * @return 成功時: 最後に評価した条件の値、失敗時: エラー
+   */
+  template <typename T, typename Policy, typename Pred>
+  s6i_result::Result<bool, SyncError> wait_for(MutexGuard<T, Policy>& guard,
+                                               uint32_t timeout_ms,
+                                               Pred&& pred) {
+    return wait_until(guard, SDL_GetTicks64() + timeout_ms,
+                      std::forward<Pred>(pred));
+  }
+
+  /**
+   * @brief 指定時刻まで条件変数で待機
+   * @param guard ロック済みのMutexGuard
+   * @param deadline_ms 待機を諦める時刻（SDL_GetTicks64()基準）
+   * @return 成功時: 起こされたか時間切れか、失敗時: エラー
+   */
+  template <typename T, typename Policy>
+  s6i_result::Result<WaitStatus, SyncError> wait_until(
+      MutexGuard<T, Policy>& guard,
+      uint64_t deadline_ms) {
+    const uint64_t now = SDL_GetTicks64();
+    if (now >= deadline_ms) {
+      return s6i_result::make_ok(WaitStatus::TimedOut);
     }
-    return s6i_result::make_ok(std::monostate{});
+    const uint64_t timeout_ms = deadline_ms - now;
+    return wait_for(guard, static_cast<uint32_t>(std::min<uint64_t>(
+                               timeout_ms, SDL_MUTEX_MAXWAIT - 1)));
+  }
+
+  /**
+   * @brief 条件を満たすか指定時刻になるまで条件変数で待機
+   * @param guard ロック済みのMutexGuard
+   * @param deadline_ms 待機を諦める時刻（SDL_GetTicks64()基準）
+   * @param pred 待機を終える条件 bool(T&)
+   * @return 成功時: 最後に評価した条件の値、失敗時: エラー
+   */
+  template <typename T, typename Policy, typename Pred>
+  s6i_result::Result<bool, SyncError> wait_until(MutexGuard<T, Policy>& guard,
+                                                 uint64_t deadline_ms,
+                                                 Pred&& pred) {
+    S6I_TRY(check_guard(guard));
+    while (!pred(*guard)) {
+      S6I_TRY_ASSIGN(const WaitStatus status, wait_until(guard, deadline_ms));
+      if (status == WaitStatus::TimedOut) {
+        return s6i_result::make_ok(static_cast<bool>(pred(*guard)));
+      }
+    }
+    return s6i_result::make_ok(true);
   }
 
   /**
@@ -71,18 +172,27 @@ class CondVar {
    * (データの競合を防ぐため、Mutexをロックした状態で呼び出す必要があります)
    * @return 成功時: void、失敗時: エラー
    */
-  template <typename T>
-  s6i_result::Result<std::monostate, SyncError> signal(
-      [[maybe_unused]] MutexGuard<T>& guard) {
+  template <typename T, typename Policy>
+  s6i_result::Result<void, SyncError> signal(
+      [[maybe_unused]] MutexGuard<T, Policy>& guard) {
     if (!m_cond) {
       return s6i_result::make_err(SyncError::InvalidCondVarError);
     }
-    if (SDL_CondSignal(m_cond) < 0) {
-      SDL_LogError(SDL_LOG_CATEGORY_SYSTEM,
-                   "Failed to signal condition variable: %s", SDL_GetError());
+    int result = 0;
+    if constexpr (std::is_same_v<Policy, SdlMutexPolicy>) {
+      result = SDL_CondSignal(m_cond);
+    } else {
+      S6I_TRY_ASSIGN(SDL_mutex * relay, get_relay());
+      SDL_LockMutex(relay);
+      result = SDL_CondSignal(m_cond);
+      SDL_UnlockMutex(relay);
+    }
+    if (result < 0) {
+      S6I_LOG_ERROR(SDL_LOG_CATEGORY_SYSTEM,
+                    "Failed to signal condition variable: %s", SDL_GetError());
       return s6i_result::make_err(SyncError::CondVarSignalError);
     }
-    return s6i_result::make_ok(std::monostate{});
+    return s6i_result::make_ok();
   }
 
   /**
@@ -91,30 +201,180 @@ class CondVar {
    * (データの競合を防ぐため、Mutexをロックした状態で呼び出す必要があります)
    * @return 成功時: void、失敗時: エラー
    */
-  template <typename T>
-  s6i_result::Result<std::monostate, SyncError> broadcast(
-      [[maybe_unused]] MutexGuard<T>& guard) {
+  template <typename T, typename Policy>
+  s6i_result::Result<void, SyncError> broadcast(
+      [[maybe_unused]] MutexGuard<T, Policy>& guard) {
     if (!m_cond) {
       return s6i_result::make_err(SyncError::InvalidCondVarError);
     }
-    if (SDL_CondBroadcast(m_cond) < 0) {
-      SDL_LogError(SDL_LOG_CATEGORY_SYSTEM,
-                   "Failed to broadcast condition variable: %s",
-                   SDL_GetError());
+    int result = 0;
+    if constexpr (std::is_same_v<Policy, SdlMutexPolicy>) {
+      result = SDL_CondBroadcast(m_cond);
+    } else {
+      S6I_TRY_ASSIGN(SDL_mutex * relay, get_relay());
+      SDL_LockMutex(relay);
+      result = SDL_CondBroadcast(m_cond);
+      SDL_UnlockMutex(relay);
+    }
+    if (result < 0) {
+      S6I_LOG_ERROR(SDL_LOG_CATEGORY_SYSTEM,
+                    "Failed to broadcast condition variable: %s",
+                    SDL_GetError());
       return s6i_result::make_err(SyncError::CondVarBroadcastError);
     }
-    return s6i_result::make_ok(std::monostate{});
+    return s6i_result::make_ok();
+  }
+
+  /**
+   * @brief ロックを持たずに、待機中のスレッドの1つを起こす
+   *
+   * 待機の条件はMutexをロックした状態で書き換えてから呼び出してください。
+   * ロックを外してから起こすため、起きたスレッドがすぐにロックを取れます。
+   * SdlMutexPolicy以外のMutexでは、中継用mutexを取ってから起こすため、
+   * 待機に入る途中のスレッドへの通知も取りこぼしません。
+   *
+   * @return 成功時: void、失敗時: エラー
+   */
+  s6i_result::Result<void, SyncError> notify_one() {
+    if (!m_cond) {
+      return s6i_result::make_err(SyncError::InvalidCondVarError);
+    }
+    int result = 0;
+    if (SDL_mutex* relay = m_relay.load(std::memory_order_acquire)) {
+      SDL_LockMutex(relay);
+      result = SDL_CondSignal(m_cond);
+      SDL_UnlockMutex(relay);
+    } else {
+      result = SDL_CondSignal(m_cond);
+    }
+    if (result < 0) {
+      S6I_LOG_ERROR(SDL_LOG_CATEGORY_SYSTEM,
+                    "Failed to signal condition variable: %s", SDL_GetError());
+      return s6i_result::make_err(SyncError::CondVarSignalError);
+    }
+    return s6i_result::make_ok();
+  }
+
+  /**
+   * @brief ロックを持たずに、待機中のすべてのスレッドを起こす
+   * 条件の書き換えについてはnotify_oneと同じです
+   * @return 成功時: void、失敗時: エラー
+   */
+  s6i_result::Result<void, SyncError> notify_all() {
+    if (!m_cond) {
+      return s6i_result::make_err(SyncError::InvalidCondVarError);
+    }
+    int result = 0;
+    if (SDL_mutex* relay = m_relay.load(std::memory_order_acquire)) {
+      SDL_LockMutex(relay);
+      result = SDL_CondBroadcast(m_cond);
+      SDL_UnlockMutex(relay);
+    } else {
+      result = SDL_CondBroadcast(m_cond);
+    }
+    if (result < 0) {
+      S6I_LOG_ERROR(SDL_LOG_CATEGORY_SYSTEM,
+                    "Failed to broadcast condition variable: %s",
+                    SDL_GetError());
+      return s6i_result::make_err(SyncError::CondVarBroadcastError);
+    }
+    return s6i_result::make_ok();
   }
 
   void swap(CondVar& other) {
     using std::swap;
     swap(m_cond, other.m_cond);
+    SDL_mutex* relay = m_relay.load(std::memory_order_acquire);
+    m_relay.store(other.m_relay.load(std::memory_order_acquire),
+                  std::memory_order_release);
+    other.m_relay.store(relay, std::memory_order_release);
   }
 
  private:
   explicit CondVar(SDL_cond* cond) : m_cond(cond) { assert(cond); }
 
+  /**
+   * @brief ガードがロックを保持しているか確認（ムーブ元のガードは無効）
+   * @return 成功時: void、失敗時: エラー
+   */
+  template <typename T, typename Policy>
+  static s6i_result::Result<void, SyncError> check_guard(
+      const MutexGuard<T, Policy>& guard) {
+    if (!guard.m_lock) {
+      return s6i_result::make_err(SyncError::InvalidMutexError);
+    }
+    return s6i_result::make_ok();
+  }
+
+  /**
+   * @brief 条件変数で待機（SDL_MUTEX_MAXWAITなら無期限）
+   * @return 成功時: 起こされたか時間切れか、失敗時: エラー
+   */
+  template <typename T, typename Policy>
+  s6i_result::Result<WaitStatus, SyncError> wait_impl(
+      MutexGuard<T, Policy>& guard,
+      uint32_t timeout_ms) {
+    if (!m_cond) {
+      return s6i_result::make_err(SyncError::InvalidCondVarError);
+    }
+    S6I_TRY(check_guard(guard));
+#if S6I_SYNC_LOCK_PROFILING
+    const uint64_t suspended = guard.profile_suspend();
+#endif
+    int result = 0;
+    if constexpr (std::is_same_v<Policy, SdlMutexPolicy>) {
+      result = SDL_CondWaitTimeout(m_cond, guard.get_raw(), timeout_ms);
+    } else {
+      // 中継用mutexを取ってからユーザーのロックを外すことで、
+      // その間のsignalを取りこぼさない
+      S6I_TRY_ASSIGN(SDL_mutex * relay, get_relay());
+      SDL_LockMutex(relay);
+      guard.m_lock->unlock();
+      result = SDL_CondWaitTimeout(m_cond, relay, timeout_ms);
+      SDL_UnlockMutex(relay);
+      guard.m_lock->lock();
+    }
+#if S6I_SYNC_LOCK_PROFILING
+    guard.profile_resume(suspended);
+#endif
+    if (result == SDL_MUTEX_TIMEDOUT) {
+      return s6i_result::make_ok(WaitStatus::TimedOut);
+    }
+    if (result < 0) {
+      S6I_LOG_ERROR(SDL_LOG_CATEGORY_SYSTEM,
+                    "Failed to wait on condition variable: %s", SDL_GetError());
+      return s6i_result::make_err(SyncError::CondVarWaitError);
+    }
+    return s6i_result::make_ok(WaitStatus::Signaled);
+  }
+
+  /**
+   * @brief 中継用のSDL_mutexを取得（未作成なら作成）
+   * @return 成功時: 中継用mutex、失敗時: エラー
+   */
+  s6i_result::Result<SDL_mutex*, SyncError> get_relay() {
+    SDL_mutex* relay = m_relay.load(std::memory_order_acquire);
+    if (relay) {
+      return s6i_result::make_ok(relay);
+    }
+    SDL_mutex* created = SDL_CreateMutex();
+    if (!created) {
+      S6I_LOG_ERROR(SDL_LOG_CATEGORY_SYSTEM,
+                    "Failed to create relay mutex: %s", SDL_GetError());
+      return s6i_result::make_err(SyncError::MutexCreationError);
+    }
+    // 他のスレッドが先に作成していればそちらを使う
+    if (!m_relay.compare_exchange_strong(relay, created,
+                                         std::memory_order_acq_rel,
+                                         std::memory_order_acquire)) {
+      SDL_DestroyMutex(created);
+      return s6i_result::make_ok(relay);
+    }
+    return s6i_result::make_ok(created);
+  }
+
   SDL_cond* m_cond = nullptr;
+  std::atomic<SDL_mutex*> m_relay{nullptr};
 };
 
 inline void swap(CondVar& lhs, CondVar& rhs) {
@@ -0,0 +1,176 @@
+#pragma once
+
+#include <SDL.h>
+#include <s6i_log/log.h>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace s6i_sync::epoch {
+
+/**
+ * @brief エポックによる遅延解放の仕組み
+ *
+ * 読み込み側はpin()の間だけ自スレッドのスロットに現在のエポックを記録し、
+ * 共有データへは一切書き込みません（スロットはスレッドごとに別のキャッシュライン）。
+ * 書き込み側は古いデータを差し替えた後にadvance()でエポックを進め、
+ * is_quiescent()がtrueになってから解放します。
+ *
+ * スロットを使い切った後のスレッドは、共有のカウンターでpinします。
+ * そのようなpinが1つでも残っている間はis_quiescent()がfalseになるため、
+ * 解放は遅れますが、読み込み側が待たされることはありません。
+ */
+
+namespace detail {
+
+/** @brief 同時にpinできるスレッド数の上限 */
+inline constexpr size_t MAX_THREADS = 256;
+
+/** @brief スレッドごとのエポック記録（0はpinされていない） */
+struct alignas(64) Slot {
+  std::atomic<uint64_t> m_epoch{0};
+  std::atomic<bool> m_in_use{false};
+};
+
+inline std::atomic<uint64_t>& global_epoch() {
+  static std::atomic<uint64_t> epoch{1};
+  return epoch;
+}
+
+inline Slot* slots() {
+  static Slot slots[MAX_THREADS];
+  return slots;
+}
+
+/** @brief スロットを持たないスレッドのpinの数 */
+inline std::atomic<uint64_t>& overflow_pins() {
+  alignas(64) static std::atomic<uint64_t> pins{0};
+  return pins;
+}
+
+/**
+ * @brief スレッドに割り当てたスロット
+ * スレッド終了時にスロットを返却します
+ * 空きがなければm_slotはnullptrで、overflow_pins()でpinします
+ */
+class LocalRecord {
+ public:
+  LocalRecord() {
+    for (size_t i = 0; i < MAX_THREADS; ++i) {
+      bool expected = false;
+      if (slots()[i].m_in_use.compare_exchange_strong(
+              expected, true, std::memory_order_acquire)) {
+        m_slot = &slots()[i];
+        return;
+      }
+    }
+    static std::atomic<bool> s_warned{false};
+    if (!s_warned.exchange(true, std::memory_order_relaxed)) {
+      S6I_LOG_WARN(SDL_LOG_CATEGORY_SYSTEM,
+                   "Too many threads using epoch::pin() (max %zu), "
+                   "reclamation is delayed while they are pinned.",
+                   MAX_THREADS);
+    }
+  }
+
+  ~LocalRecord() {
+    if (m_slot) {
+      m_slot->m_epoch.store(0, std::memory_order_release);
+      m_slot->m_in_use.store(false, std::memory_order_release);
+    }
+  }
+
+  LocalRecord(const LocalRecord&) = delete;
+  LocalRecord& operator=(const LocalRecord&) = delete;
+
+  Slot* m_slot = nullptr;
+  uint32_t m_depth = 0;
+};
+
+inline LocalRecord& local_record() {
+  thread_local LocalRecord record;
+  return record;
+}
+
+}  // namespace detail
+
+/**
+ * @brief pin中であることを表すRAIIガード
+ * 入れ子にでき、最も外側のガードが破棄されたときにpinを外します
+ */
+class Guard {
+ public:
+  Guard() : m_record(&detail::local_record()) {
+    if (m_record->m_depth++ == 0) {
+      // 書き込み側の差し替え・走査と全順序を付けるためseq_cstで記録する
+      if (m_record->m_slot) {
+        m_record->m_slot->m_epoch.store(
+            detail::global_epoch().load(std::memory_order_seq_cst),
+            std::memory_order_seq_cst);
+      } else {
+        detail::overflow_pins().fetch_add(1, std::memory_order_seq_cst);
+      }
+    }
+  }
+
+  ~Guard() {
+    if (m_record && --m_record->m_depth == 0) {
+      if (m_record->m_slot) {
+        m_record->m_slot->m_epoch.store(0, std::memory_order_release);
+      } else {
+        detail::overflow_pins().fetch_sub(1, std::memory_order_release);
+      }
+    }
+  }
+
+  Guard(Guard&& other) : m_record(other.m_record) { other.m_record = nullptr; }
+
+  Guard(const Guard&) = delete;
+  Guard& operator=(const Guard&) = delete;
+  Guard& operator=(Guard&&) = delete;
+
+ private:
+  detail::LocalRecord* m_record = nullptr;
+};
+
+/**
+ * @brief 現在のスレッドをpinする
+ * ガードが生きている間に読み込んだデータは解放されません
+ */
+inline Guard pin() {
+  return Guard();
+}
+
+/**
+ * @brief エポックを進める
+ *
+ * 共有ポインタを差し替えた後に呼び出します。
+ * 戻り値以前のエポックでpinしたスレッドだけが古いデータを参照し得ます。
+ *
+ * @return 差し替え前のエポック（is_quiescentに渡す）
+ */
+inline uint64_t advance() {
+  return detail::global_epoch().fetch_add(1, std::memory_order_seq_cst);
+}
+
+/**
+ * @brief retired以前のエポックでpinしているスレッドがいないかどうか
+ * @param retired advance()の戻り値
+ * @return trueならretiredの時点で差し替えたデータを解放できる
+ */
+inline bool is_quiescent(uint64_t retired) {
+  // スロットを持たないスレッドのエポックは分からないため、控えめに扱う
+  if (detail::overflow_pins().load(std::memory_order_seq_cst) != 0) {
+    return false;
+  }
+  for (size_t i = 0; i < detail::MAX_THREADS; ++i) {
+    const uint64_t epoch =
+        detail::slots()[i].m_epoch.load(std::memory_order_seq_cst);
+    if (epoch != 0 && epoch <= retired) {
+      return false;
+    }
+  }
+  return true;
+}
+
+}  // namespace s6i_sync::epoch
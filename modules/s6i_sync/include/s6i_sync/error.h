@@ -1,5 +1,7 @@
 #pragma once
 
+#include <s6i_result/niche.h>
+
 namespace s6i_sync {
 
 /**
@@ -22,6 +24,46 @@ enum class SyncError {
   CondVarSignalError,     ///< 条件変数のsignalに失敗
   CondVarBroadcastError,  ///< 条件変数のbroadcastに失敗
   InvalidCondVarError,    ///< 無効な条件変数への操作
+
+  // RwLock関連エラー
+  InvalidRwLockError,  ///< 無効なRwLockへの操作
+
+  // Snapshot関連エラー
+  InvalidSnapshotError,  ///< 無効なSnapshotへの操作
+
+  // SpscRing関連エラー
+  InvalidRingError,  ///< 無効なリングバッファへの操作
+
+  // Channel関連エラー
+  ChannelClosedError,   ///< closeされたChannelへの操作
+  ChannelEmptyError,    ///< Channelが空
+  ChannelFullError,     ///< Channelが満杯
+  InvalidChannelError,  ///< 無効なChannelへの操作
+
+  // Semaphore/Barrier/Latch関連エラー
+  InvalidSemaphoreError,  ///< 無効なセマフォへの操作
+  InvalidBarrierError,    ///< 無効なバリアへの操作
+  InvalidLatchError,      ///< 無効なラッチへの操作
+
+  // ConcurrentMap関連エラー
+  InvalidMapError,  ///< 無効なConcurrentMapへの操作
+
+  // ShardedCounter/ShardedAccumulator関連エラー
+  InvalidCounterError,      ///< 無効なShardedCounterへの操作
+  InvalidAccumulatorError,  ///< 無効なShardedAccumulatorへの操作
 };
 
 }  // namespace s6i_sync
+
+/**
+ * @brief SyncErrorの範囲外の値をResultのタグとして使う
+ *
+ * これによりsizeof(Result<void, SyncError>) == sizeof(SyncError)
+ * となります。
+ */
+template <>
+struct s6i_result::NicheTraits<s6i_sync::SyncError> {
+  static constexpr bool enabled = true;
+  static constexpr s6i_sync::SyncError value =
+      static_cast<s6i_sync::SyncError>(-1);
+};
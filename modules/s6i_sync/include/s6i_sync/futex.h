@@ -0,0 +1,164 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <thread>
+
+/**
+ * @brief futex_waitをSDL_cond（アドレスごとのバケット）で実装するかどうか
+ *
+ * futexもWaitOnAddressもない環境では既定で1になります。
+ * それ以外の環境でも1にすると同じ実装を使うので、テストで確かめられます。
+ */
+#ifndef S6I_SYNC_SDL_FUTEX
+#if defined(__linux__) || defined(_WIN32)
+#define S6I_SYNC_SDL_FUTEX 0
+#else
+#define S6I_SYNC_SDL_FUTEX 1
+#endif
+#endif
+
+#if S6I_SYNC_SDL_FUTEX
+#include <SDL.h>
+#elif defined(__linux__)
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#elif defined(_WIN32)
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#endif
+
+namespace s6i_sync {
+
+static_assert(sizeof(std::atomic<uint32_t>) == sizeof(uint32_t),
+              "futex requires a plain 32-bit atomic word");
+
+#if S6I_SYNC_SDL_FUTEX
+namespace detail {
+
+/**
+ * @brief 待機するアドレスをハッシュ化したバケット
+ *
+ * 値の確認と待機を同じSDL_mutexの中で行い、起こす側も同じロックを取るので、
+ * 起床を取りこぼしません。別のアドレスと同じバケットを共有することがあるため、
+ * 起こすときは常にブロードキャストします。
+ */
+struct FutexBucket {
+  SDL_mutex* m_mutex = nullptr;
+  SDL_cond* m_cond = nullptr;
+};
+
+/** @brief バケット数 = 2^FUTEX_BUCKET_BITS */
+inline constexpr unsigned FUTEX_BUCKET_BITS = 6;
+inline constexpr size_t FUTEX_BUCKET_COUNT = size_t{1} << FUTEX_BUCKET_BITS;
+
+/** @brief 作れなかったバケットはm_mutexがnullptrのまま（タイムスライスを譲る） */
+inline FutexBucket& futex_bucket_for(const void* key) {
+  // 終了時に待機中のスレッドが残っていても使えるよう、破棄しない
+  static FutexBucket* s_buckets = []() {
+    auto* buckets = new FutexBucket[FUTEX_BUCKET_COUNT];
+    for (size_t i = 0; i < FUTEX_BUCKET_COUNT; ++i) {
+      buckets[i].m_mutex = SDL_CreateMutex();
+      buckets[i].m_cond = SDL_CreateCond();
+      if (!buckets[i].m_mutex || !buckets[i].m_cond) {
+        SDL_DestroyMutex(buckets[i].m_mutex);
+        SDL_DestroyCond(buckets[i].m_cond);
+        buckets[i] = FutexBucket();
+      }
+    }
+    return buckets;
+  }();
+  // フィボナッチハッシュで上位ビットを使う
+  const auto addr = static_cast<uint64_t>(reinterpret_cast<uintptr_t>(key));
+  const uint64_t hash = addr * UINT64_C(0x9e3779b97f4a7c15);
+  return s_buckets[hash >> (64 - FUTEX_BUCKET_BITS)];
+}
+
+inline void futex_wake_bucket(const void* key) {
+  FutexBucket& bucket = futex_bucket_for(key);
+  if (bucket.m_mutex) {
+    SDL_LockMutex(bucket.m_mutex);
+    SDL_CondBroadcast(bucket.m_cond);
+    SDL_UnlockMutex(bucket.m_mutex);
+  }
+}
+
+}  // namespace detail
+#endif
+
+/**
+ * @brief wordがexpectedと等しい間、スレッドを眠らせる
+ *
+ * Linuxではfutex、WindowsではWaitOnAddressを使います。
+ * それ以外の環境ではアドレスごとのバケットのSDL_condで眠ります。
+ * 呼び出し側は必ず条件を再確認するループの中で使う必要があります
+ * （spurious wakeupはどの環境でも起こり得ます）。
+ *
+ * @param word 監視する値
+ * @param expected 眠る条件となる値
+ */
+inline void futex_wait(std::atomic<uint32_t>& word, uint32_t expected) {
+#if S6I_SYNC_SDL_FUTEX
+  detail::FutexBucket& bucket = detail::futex_bucket_for(&word);
+  if (!bucket.m_mutex) {
+    if (word.load(std::memory_order_relaxed) == expected) {
+      std::this_thread::yield();
+    }
+    return;
+  }
+  SDL_LockMutex(bucket.m_mutex);
+  if (word.load(std::memory_order_relaxed) == expected) {
+    SDL_CondWait(bucket.m_cond, bucket.m_mutex);
+  }
+  SDL_UnlockMutex(bucket.m_mutex);
+#elif defined(__linux__)
+  syscall(SYS_futex, reinterpret_cast<uint32_t*>(&word), FUTEX_WAIT_PRIVATE,
+          expected, nullptr, nullptr, 0);
+#elif defined(_WIN32)
+  WaitOnAddress(reinterpret_cast<volatile VOID*>(&word), &expected,
+                sizeof(expected), INFINITE);
+#else
+  if (word.load(std::memory_order_relaxed) == expected) {
+    std::this_thread::yield();
+  }
+#endif
+}
+
+/**
+ * @brief futex_waitで眠っているスレッドを1つ起こす
+ * @param word 監視されている値
+ */
+inline void futex_wake_one(std::atomic<uint32_t>& word) {
+#if S6I_SYNC_SDL_FUTEX
+  detail::futex_wake_bucket(&word);
+#elif defined(__linux__)
+  syscall(SYS_futex, reinterpret_cast<uint32_t*>(&word), FUTEX_WAKE_PRIVATE, 1,
+          nullptr, nullptr, 0);
+#elif defined(_WIN32)
+  WakeByAddressSingle(reinterpret_cast<PVOID>(&word));
+#endif
+}
+
+/**
+ * @brief futex_waitで眠っているスレッドをすべて起こす
+ * @param word 監視されている値
+ */
+inline void futex_wake_all(std::atomic<uint32_t>& word) {
+#if S6I_SYNC_SDL_FUTEX
+  detail::futex_wake_bucket(&word);
+#elif defined(__linux__)
+  syscall(SYS_futex, reinterpret_cast<uint32_t*>(&word), FUTEX_WAKE_PRIVATE,
+          INT32_MAX, nullptr, nullptr, 0);
+#elif defined(_WIN32)
+  WakeByAddressAll(reinterpret_cast<PVOID>(&word));
+#endif
+}
+
+}  // namespace s6i_sync
@@ -0,0 +1,142 @@
+#pragma once
+
+#include <s6i_result/result.h>
+#include <s6i_result/try.h>
+#include <atomic>
+#include <cassert>
+#include <cstdint>
+#include <utility>
+#include "backoff.h"
+#include "error.h"
+#include "futex.h"
+
+namespace s6i_sync {
+
+/**
+ * @brief 1回だけ使えるカウントダウンラッチ
+ *
+ * count_down()でカウンターを減らし、0になるとwait()中のスレッドが
+ * すべて進みます。0になった後は元に戻せません（繰り返すならBarrier）。
+ * 待機側はカウンターをBackoffで少しだけ監視してから、
+ * カウンターそのものをfutexの監視対象にして眠ります。
+ */
+class Latch {
+ public:
+  /**
+   * @brief 新しいラッチを作成
+   * @param count カウンターの初期値
+   * @return 成功時: 作成されたラッチ、失敗時: エラー
+   */
+  static s6i_result::Result<Latch, SyncError> make(uint32_t count) {
+    if (count == INVALID) {
+      return s6i_result::make_err(SyncError::InvalidLatchError);
+    }
+    return s6i_result::make_ok(Latch(count));
+  }
+
+  // コピー禁止
+  Latch(const Latch&) = delete;
+  Latch& operator=(const Latch&) = delete;
+
+  // ムーブ可能（待機中のムーブは未定義）
+  Latch(Latch&& other)
+      : m_count(other.m_count.exchange(INVALID, std::memory_order_relaxed)) {}
+
+  Latch& operator=(Latch&& other) {
+    Latch(std::move(other)).swap(*this);
+    return *this;
+  }
+
+  /** @brief 有効なラッチかどうか（ムーブ元は無効） */
+  bool is_valid() const {
+    return m_count.load(std::memory_order_relaxed) != INVALID;
+  }
+
+  /**
+   * @brief カウンターをcountだけ減らす（0になったら待機中のスレッドを起こす）
+   * @param count 減らす量（残りのカウンター以下）
+   * @return 成功時: void、失敗時: エラー
+   */
+  s6i_result::Result<void, SyncError> count_down(uint32_t count = 1) {
+    if (!is_valid()) {
+      return s6i_result::make_err(SyncError::InvalidLatchError);
+    }
+    if (count == 0) {
+      return s6i_result::make_ok();
+    }
+    const uint32_t prev = m_count.fetch_sub(count, std::memory_order_seq_cst);
+    assert(prev >= count && "Latch counted down below zero");
+    if (prev == count && m_waiters.load(std::memory_order_seq_cst) > 0) {
+      futex_wake_all(m_count);
+    }
+    return s6i_result::make_ok();
+  }
+
+  /**
+   * @brief カウンターが0かどうか（待たない）
+   * @return 成功時: 0ならtrue、失敗時: エラー
+   */
+  s6i_result::Result<bool, SyncError> try_wait() const {
+    if (!is_valid()) {
+      return s6i_result::make_err(SyncError::InvalidLatchError);
+    }
+    return s6i_result::make_ok(m_count.load(std::memory_order_acquire) == 0);
+  }
+
+  /**
+   * @brief カウンターが0になるまで待つ
+   * @return 成功時: void、失敗時: エラー
+   */
+  s6i_result::Result<void, SyncError> wait() {
+    if (!is_valid()) {
+      return s6i_result::make_err(SyncError::InvalidLatchError);
+    }
+    Backoff backoff;
+    for (;;) {
+      const uint32_t count = m_count.load(std::memory_order_acquire);
+      if (count == 0) {
+        return s6i_result::make_ok();
+      }
+      if (!backoff.is_completed()) {
+        backoff.snooze();
+        continue;
+      }
+      m_waiters.fetch_add(1, std::memory_order_seq_cst);
+      const uint32_t current = m_count.load(std::memory_order_seq_cst);
+      if (current != 0) {
+        futex_wait(m_count, current);
+      }
+      m_waiters.fetch_sub(1, std::memory_order_relaxed);
+    }
+  }
+
+  /**
+   * @brief count_down(count)してから、0になるまで待つ
+   * @return 成功時: void、失敗時: エラー
+   */
+  s6i_result::Result<void, SyncError> arrive_and_wait(uint32_t count = 1) {
+    S6I_TRY(count_down(count));
+    return wait();
+  }
+
+  void swap(Latch& other) {
+    const uint32_t count = m_count.load(std::memory_order_relaxed);
+    m_count.store(other.m_count.load(std::memory_order_relaxed),
+                  std::memory_order_relaxed);
+    other.m_count.store(count, std::memory_order_relaxed);
+  }
+
+ private:
+  static constexpr uint32_t INVALID = 0xffffffff;
+
+  explicit Latch(uint32_t count) : m_count(count) {}
+
+  std::atomic<uint32_t> m_count;
+  std::atomic<uint32_t> m_waiters{0};  ///< futexで眠っている（眠りかけの）数
+};
+
+inline void swap(Latch& lhs, Latch& rhs) {
+  lhs.swap(rhs);
+}
+
+}  // namespace s6i_sync
@@ -0,0 +1,370 @@
+#pragma once
+
+#include <SDL.h>
+#include <s6i_log/log.h>
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+/**
+ * @brief ロック競合の計測を有効にするかどうか
+ *
+ * 1にするとMutex::lock()、MutexGuardの保持時間、CondVar::waitを計測します。
+ * 0（既定）では計測用のコードとメンバーはすべて取り除かれます。
+ * 翻訳単位ごとに値が異なるとODR違反になるため、
+ * CMakeのSDL_SANDBOX_ENABLE_LOCK_PROFILINGで一括して切り替えてください。
+ */
+#ifndef S6I_SYNC_LOCK_PROFILING
+#define S6I_SYNC_LOCK_PROFILING 0
+#endif
+
+namespace s6i_sync {
+
+/**
+ * @brief ロックを取った場所
+ *
+ * 既定引数のLockSite::current()で呼び出し元のファイルと行を記録します。
+ * 文字列を渡すと、その文字列をラベルとして使います（行は0）。
+ * 計測が無効なときは空の構造体です。
+ */
+struct LockSite {
+#if S6I_SYNC_LOCK_PROFILING
+  const char* m_label = "";
+  uint32_t m_line = 0;
+
+  constexpr LockSite(const char* label, uint32_t line = 0)
+      : m_label(label), m_line(line) {}
+
+  static constexpr LockSite current(const char* file = __builtin_FILE(),
+                                    uint32_t line = __builtin_LINE()) {
+    return LockSite(file, line);
+  }
+#else
+  constexpr LockSite(const char* /*label*/, uint32_t /*line*/ = 0) {}
+
+  static constexpr LockSite current() { return LockSite(""); }
+#endif
+};
+
+namespace lock_profile {
+
+/**
+ * @brief 1つのロックの集計結果
+ * 時間はSDL_GetPerformanceCounter()の単位です
+ */
+struct LockStats {
+  const void* m_lock = nullptr;  ///< ロックのアドレス
+  const char* m_label = "";      ///< 最も待ち時間の長かった場所
+  uint32_t m_line = 0;           ///< 同上の行（ラベル指定なら0）
+  uint64_t m_acquires = 0;       ///< ロックの取得回数
+  uint64_t m_contentions = 0;    ///< 取得時に待たされた回数
+  uint64_t m_wait_ticks = 0;     ///< 取得までの待ち時間の合計
+  uint64_t m_hold_ticks = 0;     ///< 保持時間の合計
+  uint64_t m_cond_waits = 0;     ///< CondVar::waitの回数
+  uint64_t m_cond_wait_ticks = 0;  ///< CondVar::waitで眠っていた時間の合計
+};
+
+/** @brief 計測が有効かどうか */
+constexpr bool is_enabled() {
+  return S6I_SYNC_LOCK_PROFILING != 0;
+}
+
+#if S6I_SYNC_LOCK_PROFILING
+
+namespace detail {
+
+/**
+ * @brief (ロック, 場所)ごとの計測値
+ * 書き込むのは主に所有スレッドですが、
+ * ガードが他のスレッドへ移ることもあるためatomicで加算します
+ */
+struct Record {
+  std::atomic<const void*> m_lock{nullptr};
+  // 破棄されたロックの枠を再利用するため、集計中に読まれてもよいようatomicにする
+  std::atomic<const char*> m_label{""};
+  std::atomic<uint32_t> m_line{0};
+  std::atomic<uint64_t> m_acquires{0};
+  std::atomic<uint64_t> m_contentions{0};
+  std::atomic<uint64_t> m_wait_ticks{0};
+  std::atomic<uint64_t> m_hold_ticks{0};
+  std::atomic<uint64_t> m_cond_waits{0};
+  std::atomic<uint64_t> m_cond_wait_ticks{0};
+
+  void add(std::atomic<uint64_t>& counter, uint64_t value) {
+    counter.fetch_add(value, std::memory_order_relaxed);
+  }
+};
+
+/** @brief 破棄されたロックの枠の印（所有スレッドが再利用する） */
+inline const char g_tombstone = 0;
+inline const void* const TOMBSTONE = &g_tombstone;
+
+/**
+ * @brief スレッドごとの計測バッファ
+ *
+ * 開番地法のハッシュ表で、所有スレッドだけがエントリーを追加します。
+ * 探すのはMAX_PROBES個までで、見つからず空きもなければ記録を諦めて
+ * m_droppedを数えます（dump()に出力されます）。
+ * 破棄されたロックの枠はforget()で印を付け、次の追加で再利用します。
+ * 登録したバッファは解放せず、スレッド終了後は次に作られたスレッドが
+ * 集計値を引き継いで再利用します。
+ */
+struct ThreadBuffer {
+  static constexpr size_t CAPACITY = 256;
+  static constexpr size_t MAX_PROBES = 16;
+
+  Record m_records[CAPACITY];
+  std::atomic<uint64_t> m_dropped{0};  ///< 表が埋まって記録できなかった回数
+  std::atomic<bool> m_in_use{true};
+  ThreadBuffer* m_next = nullptr;
+
+  /** @brief (lock, site)のエントリーを探す（なければ追加） */
+  Record* find(const void* lock, const LockSite& site) {
+    const auto hash = reinterpret_cast<uintptr_t>(lock) ^
+                      reinterpret_cast<uintptr_t>(site.m_label) ^ site.m_line;
+    const size_t index =
+        static_cast<size_t>((hash * 0x9E3779B97F4A7C15ull) >> 32) % CAPACITY;
+    Record* reusable = nullptr;
+    for (size_t i = 0; i < MAX_PROBES; ++i) {
+      Record& record = m_records[(index + i) % CAPACITY];
+      const void* key = record.m_lock.load(std::memory_order_relaxed);
+      if (key == lock &&
+          record.m_label.load(std::memory_order_relaxed) == site.m_label &&
+          record.m_line.load(std::memory_order_relaxed) == site.m_line) {
+        return &record;
+      }
+      if (key == TOMBSTONE) {
+        if (!reusable) {
+          reusable = &record;
+        }
+        continue;
+      }
+      if (!key) {
+        if (!reusable) {
+          reusable = &record;
+        }
+        break;
+      }
+    }
+    if (!reusable) {
+      m_dropped.fetch_add(1, std::memory_order_relaxed);
+      return nullptr;
+    }
+    claim(*reusable, lock, site);
+    return reusable;
+  }
+
+  /** @brief 空き枠か破棄済みの枠を(lock, site)のエントリーにする */
+  static void claim(Record& record, const void* lock, const LockSite& site) {
+    record.m_label.store(site.m_label, std::memory_order_relaxed);
+    record.m_line.store(site.m_line, std::memory_order_relaxed);
+    record.m_acquires.store(0, std::memory_order_relaxed);
+    record.m_contentions.store(0, std::memory_order_relaxed);
+    record.m_wait_ticks.store(0, std::memory_order_relaxed);
+    record.m_hold_ticks.store(0, std::memory_order_relaxed);
+    record.m_cond_waits.store(0, std::memory_order_relaxed);
+    record.m_cond_wait_ticks.store(0, std::memory_order_relaxed);
+    record.m_lock.store(lock, std::memory_order_release);
+  }
+};
+
+/** @brief 登録済みのバッファの連結リスト（追加のみ） */
+inline std::atomic<ThreadBuffer*> g_buffers{nullptr};
+
+/** @brief 空いているバッファを再利用するか、新しく登録する */
+inline ThreadBuffer* claim_buffer() {
+  for (ThreadBuffer* buffer = g_buffers.load(std::memory_order_acquire);
+       buffer; buffer = buffer->m_next) {
+    bool in_use = false;
+    if (buffer->m_in_use.compare_exchange_strong(in_use, true,
+                                                 std::memory_order_acquire)) {
+      return buffer;
+    }
+  }
+  auto* buffer = new ThreadBuffer();
+  buffer->m_next = g_buffers.load(std::memory_order_relaxed);
+  while (!g_buffers.compare_exchange_weak(buffer->m_next, buffer,
+                                          std::memory_order_release,
+                                          std::memory_order_relaxed)) {
+  }
+  return buffer;
+}
+
+/** @brief スレッド終了時にバッファを返す */
+struct BufferHolder {
+  ThreadBuffer* m_buffer = claim_buffer();
+
+  ~BufferHolder() {
+    m_buffer->m_in_use.store(false, std::memory_order_release);
+  }
+};
+
+inline ThreadBuffer& current_buffer() {
+  static thread_local BufferHolder holder;
+  return *holder.m_buffer;
+}
+
+inline uint64_t now() {
+  return SDL_GetPerformanceCounter();
+}
+
+inline Record* find_record(const void* lock, const LockSite& site) {
+  return current_buffer().find(lock, site);
+}
+
+/**
+ * @brief 破棄するロックのエントリーを全スレッドのバッファから外す
+ * 同じアドレスに作られた別のロックと集計が混ざらないようにします
+ */
+inline void forget(const void* lock) {
+  for (ThreadBuffer* buffer = g_buffers.load(std::memory_order_acquire);
+       buffer; buffer = buffer->m_next) {
+    for (Record& record : buffer->m_records) {
+      const void* key = lock;
+      record.m_lock.compare_exchange_strong(key, TOMBSTONE,
+                                            std::memory_order_relaxed);
+    }
+  }
+}
+
+}  // namespace detail
+
+/**
+ * @brief 待ち時間の長い順に、上位n個のロックの集計を取得
+ * 全スレッドのバッファをロックごとにまとめます
+ */
+inline std::vector<LockStats> top_contended(size_t n) {
+  struct Entry {
+    LockStats m_stats;
+    uint64_t m_label_wait = 0;
+  };
+  std::vector<Entry> entries;
+  for (detail::ThreadBuffer* buffer =
+           detail::g_buffers.load(std::memory_order_acquire);
+       buffer; buffer = buffer->m_next) {
+    for (detail::Record& record : buffer->m_records) {
+      const void* lock = record.m_lock.load(std::memory_order_acquire);
+      if (!lock || lock == detail::TOMBSTONE) {
+        continue;
+      }
+      auto it = std::find_if(entries.begin(), entries.end(),
+                             [lock](const Entry& entry) {
+                               return entry.m_stats.m_lock == lock;
+                             });
+      if (it == entries.end()) {
+        entries.push_back({});
+        it = entries.end() - 1;
+        it->m_stats.m_lock = lock;
+      }
+      const uint64_t wait =
+          record.m_wait_ticks.load(std::memory_order_relaxed);
+      LockStats& stats = it->m_stats;
+      stats.m_acquires += record.m_acquires.load(std::memory_order_relaxed);
+      stats.m_contentions +=
+          record.m_contentions.load(std::memory_order_relaxed);
+      stats.m_wait_ticks += wait;
+      stats.m_hold_ticks += record.m_hold_ticks.load(std::memory_order_relaxed);
+      stats.m_cond_waits += record.m_cond_waits.load(std::memory_order_relaxed);
+      stats.m_cond_wait_ticks +=
+          record.m_cond_wait_ticks.load(std::memory_order_relaxed);
+      if (stats.m_label[0] == '\0' || wait > it->m_label_wait) {
+        stats.m_label = record.m_label.load(std::memory_order_relaxed);
+        stats.m_line = record.m_line.load(std::memory_order_relaxed);
+        it->m_label_wait = wait;
+      }
+    }
+  }
+  std::sort(entries.begin(), entries.end(),
+            [](const Entry& lhs, const Entry& rhs) {
+              if (lhs.m_stats.m_wait_ticks != rhs.m_stats.m_wait_ticks) {
+                return lhs.m_stats.m_wait_ticks > rhs.m_stats.m_wait_ticks;
+              }
+              return lhs.m_stats.m_contentions > rhs.m_stats.m_contentions;
+            });
+  std::vector<LockStats> result;
+  for (size_t i = 0; i < entries.size() && i < n; ++i) {
+    result.push_back(entries[i].m_stats);
+  }
+  return result;
+}
+
+/** @brief 表が埋まっていて記録できなかったロックの取得回数 */
+inline uint64_t dropped() {
+  uint64_t total = 0;
+  for (detail::ThreadBuffer* buffer =
+           detail::g_buffers.load(std::memory_order_acquire);
+       buffer; buffer = buffer->m_next) {
+    total += buffer->m_dropped.load(std::memory_order_relaxed);
+  }
+  return total;
+}
+
+/** @brief 集計値をすべて0に戻す（登録済みのロックと場所は残ります） */
+inline void reset() {
+  for (detail::ThreadBuffer* buffer =
+           detail::g_buffers.load(std::memory_order_acquire);
+       buffer; buffer = buffer->m_next) {
+    for (detail::Record& record : buffer->m_records) {
+      record.m_acquires.store(0, std::memory_order_relaxed);
+      record.m_contentions.store(0, std::memory_order_relaxed);
+      record.m_wait_ticks.store(0, std::memory_order_relaxed);
+      record.m_hold_ticks.store(0, std::memory_order_relaxed);
+      record.m_cond_waits.store(0, std::memory_order_relaxed);
+      record.m_cond_wait_ticks.store(0, std::memory_order_relaxed);
+    }
+    buffer->m_dropped.store(0, std::memory_order_relaxed);
+  }
+}
+
+/**
+ * @brief 待ち時間の長い順に、上位n個のロックをログに出力
+ */
+inline void dump(size_t n = 10) {
+  const double to_ms = 1000.0 / static_cast<double>(
+                                    SDL_GetPerformanceFrequency());
+  S6I_LOG_INFO(SDL_LOG_CATEGORY_SYSTEM, "Top %u contended locks:",
+               static_cast<unsigned>(n));
+  for (const LockStats& stats : top_contended(n)) {
+    const char* slash = std::strrchr(stats.m_label, '/');
+    S6I_LOG_INFO(SDL_LOG_CATEGORY_SYSTEM,
+                 "  %p %s:%u acquires=%llu contended=%llu wait=%.3fms "
+                 "hold=%.3fms cond_waits=%llu cond_wait=%.3fms",
+                 stats.m_lock, slash ? slash + 1 : stats.m_label,
+                 static_cast<unsigned>(stats.m_line),
+                 static_cast<unsigned long long>(stats.m_acquires),
+                 static_cast<unsigned long long>(stats.m_contentions),
+                 static_cast<double>(stats.m_wait_ticks) * to_ms,
+                 static_cast<double>(stats.m_hold_ticks) * to_ms,
+                 static_cast<unsigned long long>(stats.m_cond_waits),
+                 static_cast<double>(stats.m_cond_wait_ticks) * to_ms);
+  }
+  if (const uint64_t count = dropped()) {
+    S6I_LOG_INFO(SDL_LOG_CATEGORY_SYSTEM,
+                 "  (%llu acquires were not recorded: table full)",
+                 static_cast<unsigned long long>(count));
+  }
+}
+
+#else
+
+inline std::vector<LockStats> top_contended(size_t /*n*/) {
+  return {};
+}
+
+inline uint64_t dropped() {
+  return 0;
+}
+
+inline void reset() {}
+
+inline void dump(size_t /*n*/ = 10) {
+  S6I_LOG_INFO(SDL_LOG_CATEGORY_SYSTEM,
+               "Lock profiling is disabled (S6I_SYNC_LOCK_PROFILING=0).");
+}
+
+#endif
+
+}  // namespace lock_profile
+}  // namespace s6i_sync
@@ -2,19 +2,32 @@
 
 #include <SDL.h>
 #include <s6i_result/result.h>
+#include <s6i_result/try.h>
 #include <utility>
 #include "error.h"
+#include "lock_profile.h"
+#include "mutex_policy.h"
 
 namespace s6i_sync {
 
-template <typename T>
+class CondVar;
+
+template <typename T, typename Policy = SdlMutexPolicy>
 class MutexGuard;
 
 /**
  * @brief スレッドセーフな値を保持するMutexクラス
+ *
+ * ロックの実装はPolicyで選択できます。
+ * - SdlMutexPolicy: SDL_mutex（既定）
+ * - SpinMutexPolicy: 指数バックオフ付きスピンロック
+ * - AdaptiveMutexPolicy: 適応的スピンの後にfutexで眠るロック
+ * - ParkingLotMutexPolicy: パーキングロットで眠る1バイトのロック
+ *
  * @tparam T 保護する値の型
+ * @tparam Policy ロックの実装
  */
-template <typename T>
+template <typename T, typename Policy = SdlMutexPolicy>
 class Mutex {
  public:
   /**
@@ -23,15 +36,10 @@ class Mutex {
    * @return 成功時: 作成されたMutex、失敗時: エラー
    */
   template <typename... Args>
-  static s6i_result::Result<Mutex<T>, SyncError> make(Args&&... args) {
-    SDL_mutex* mutex = SDL_CreateMutex();
-    SDL_LogInfo(SDL_LOG_CATEGORY_SYSTEM, "Create mutex.");
-    if (!mutex) {
-      SDL_LogError(SDL_LOG_CATEGORY_SYSTEM, "Failed to create mutex: %s",
-                   SDL_GetError());
-      return s6i_result::make_err(SyncError::MutexCreationError);
-    }
-    return s6i_result::make_ok(Mutex(mutex, std::forward<Args>(args)...));
+  static s6i_result::Result<Mutex, SyncError> make(Args&&... args) {
+    S6I_TRY_ASSIGN(auto lock, Policy::make());
+    return s6i_result::make_ok(
+        Mutex(std::move(lock), std::forward<Args>(args)...));
   }
 
   // コピー禁止
@@ -40,70 +48,103 @@ class Mutex {
 
   // ムーブ可能
   Mutex(Mutex&& other)
-      : m_mutex(other.m_mutex), m_value(std::move(other.m_value)) {
-    other.m_mutex = nullptr;
-  }
+      : m_lock(std::move(other.m_lock)), m_value(std::move(other.m_value)) {}
 
   Mutex& operator=(Mutex&& other) {
     Mutex(std::move(other)).swap(*this);
     return *this;
   }
 
-  ~Mutex() {
-    SDL_LogInfo(SDL_LOG_CATEGORY_SYSTEM, "Destroy mutex.");
-    SDL_DestroyMutex(m_mutex);
-  }
+#if S6I_SYNC_LOCK_PROFILING
+  ~Mutex() { lock_profile::detail::forget(&m_lock); }
+#endif
 
   /**
    * @brief Mutexをロックし、保護された値へのアクセスを提供
+   * @param site ロックを取った場所（S6I_SYNC_LOCK_PROFILINGが有効なときに記録）
    * @return 成功時: MutexGuard、失敗時: エラー
    */
-  s6i_result::Result<MutexGuard<T>, SyncError> lock() {
-    if (!m_mutex) {
+  s6i_result::Result<MutexGuard<T, Policy>, SyncError> lock(
+      [[maybe_unused]] const LockSite& site = LockSite::current()) {
+    if (!m_lock.is_valid()) {
       return s6i_result::make_err(SyncError::InvalidMutexError);
     }
-    if (SDL_LockMutex(m_mutex) < 0) {
+#if S6I_SYNC_LOCK_PROFILING
+    // まずtry_lockし、失敗したら競合として待ち時間を記録する
+    const uint64_t start = lock_profile::detail::now();
+    const bool contended = !m_lock.try_lock();
+    if (contended && !m_lock.lock()) {
       return s6i_result::make_err(SyncError::MutexLockError);
     }
-    return s6i_result::make_ok(MutexGuard<T>(m_mutex, m_value));
+    const uint64_t acquired = lock_profile::detail::now();
+    lock_profile::detail::Record* record =
+        lock_profile::detail::find_record(&m_lock, site);
+    if (record) {
+      record->add(record->m_acquires, 1);
+      if (contended) {
+        record->add(record->m_contentions, 1);
+        record->add(record->m_wait_ticks, acquired - start);
+      }
+    }
+    return s6i_result::make_ok(
+        MutexGuard<T, Policy>(m_lock, m_value, record, acquired));
+#else
+    if (!m_lock.lock()) {
+      return s6i_result::make_err(SyncError::MutexLockError);
+    }
+    return s6i_result::make_ok(MutexGuard<T, Policy>(m_lock, m_value));
+#endif
   }
 
   void swap(Mutex& other) {
     using std::swap;
-    swap(m_mutex, other.m_mutex);
+    swap(m_lock, other.m_lock);
     swap(m_value, other.m_value);
   }
 
  private:
   template <typename... Args>
-  Mutex(SDL_mutex* mutex, Args&&... args)
-      : m_mutex(mutex), m_value(std::forward<Args>(args)...) {}
+  Mutex(Policy&& lock, Args&&... args)
+      : m_lock(std::move(lock)), m_value(std::forward<Args>(args)...) {}
 
-  SDL_mutex* m_mutex = nullptr;
+  Policy m_lock;
   T m_value;
 
-  friend class MutexGuard<T>;
+  friend class MutexGuard<T, Policy>;
 };
 
-template <typename T>
-inline void swap(Mutex<T>& lhs, Mutex<T>& rhs) {
+template <typename T, typename Policy>
+inline void swap(Mutex<T, Policy>& lhs, Mutex<T, Policy>& rhs) {
   lhs.swap(rhs);
 }
 
 /**
  * @brief RAIIでMutexのロック/アンロックを管理するガードクラス
  * @tparam T 保護する値の型
+ * @tparam Policy ロックの実装
  */
-template <typename T>
+template <typename T, typename Policy>
 class MutexGuard {
  public:
   MutexGuard(MutexGuard&& other)
-      : m_mutex(other.m_mutex), m_value(other.m_value) {
-    other.m_mutex = nullptr;
+      : m_lock(other.m_lock), m_value(other.m_value) {
+    other.m_lock = nullptr;
     other.m_value = nullptr;
+#if S6I_SYNC_LOCK_PROFILING
+    m_record = other.m_record;
+    m_acquired = other.m_acquired;
+    other.m_record = nullptr;
+#endif
   }
 
-  ~MutexGuard() { SDL_UnlockMutex(m_mutex); }
+  ~MutexGuard() {
+    if (m_lock) {
+#if S6I_SYNC_LOCK_PROFILING
+      profile_suspend();
+#endif
+      m_lock->unlock();
+    }
+  }
 
   // コピー禁止
   MutexGuard(const MutexGuard&) = delete;
@@ -119,25 +160,66 @@ class MutexGuard {
   const T& operator*() const { return *m_value; }
   const T* operator->() const { return m_value; }
 
-  SDL_mutex* get_raw() const { return m_mutex; }
+  /**
+   * @brief 内部のSDL_mutexを取得
+   * @note SdlMutexPolicyでのみ使用可能
+   */
+  SDL_mutex* get_raw() const { return m_lock ? m_lock->get_raw() : nullptr; }
 
   void swap(MutexGuard& other) {
     using std::swap;
-    swap(m_mutex, other.m_mutex);
+    swap(m_lock, other.m_lock);
     swap(m_value, other.m_value);
+#if S6I_SYNC_LOCK_PROFILING
+    swap(m_record, other.m_record);
+    swap(m_acquired, other.m_acquired);
+#endif
   }
 
  private:
-  MutexGuard(SDL_mutex* mutex, T& value) : m_mutex(mutex), m_value(&value) {}
+  MutexGuard(Policy& lock, T& value) : m_lock(&lock), m_value(&value) {}
 
-  SDL_mutex* m_mutex = nullptr;
+  Policy* m_lock = nullptr;
   T* m_value = nullptr;
 
-  friend class Mutex<T>;
+#if S6I_SYNC_LOCK_PROFILING
+  MutexGuard(Policy& lock,
+             T& value,
+             lock_profile::detail::Record* record,
+             uint64_t acquired)
+      : m_lock(&lock),
+        m_value(&value),
+        m_record(record),
+        m_acquired(acquired) {}
+
+  /** @brief ここまでの保持時間を記録する（CondVar::waitの前と解放時） */
+  uint64_t profile_suspend() {
+    const uint64_t now = lock_profile::detail::now();
+    if (m_record) {
+      m_record->add(m_record->m_hold_ticks, now - m_acquired);
+    }
+    return now;
+  }
+
+  /** @brief CondVar::waitで眠っていた時間を記録し、保持時間を測り直す */
+  void profile_resume(uint64_t suspended) {
+    m_acquired = lock_profile::detail::now();
+    if (m_record) {
+      m_record->add(m_record->m_cond_waits, 1);
+      m_record->add(m_record->m_cond_wait_ticks, m_acquired - suspended);
+    }
+  }
+
+  lock_profile::detail::Record* m_record = nullptr;
+  uint64_t m_acquired = 0;
+#endif
+
+  friend class Mutex<T, Policy>;
+  friend class CondVar;
 };
 
-template <typename T>
-inline void swap(MutexGuard<T>& lhs, MutexGuard<T>& rhs) {
+template <typename T, typename Policy>
+inline void swap(MutexGuard<T, Policy>& lhs, MutexGuard<T, Policy>& rhs) {
   lhs.swap(rhs);
 }
 
@@ -0,0 +1,403 @@
+#pragma once
+
+#include <SDL.h>
+#include <s6i_log/log.h>
+#include <s6i_result/result.h>
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <utility>
+#include "backoff.h"
+#include "error.h"
+#include "futex.h"
+#include "parking_lot.h"
+
+namespace s6i_sync {
+
+/**
+ * @brief SDL_mutexによるロック（既定のポリシー）
+ *
+ * OSのミューテックスをそのまま使います。
+ * CondVarはSDL_CondWaitで直接待機できます。
+ */
+class SdlMutexPolicy {
+ public:
+  /**
+   * @brief 新しいロックを作成
+   * @return 成功時: 作成されたロック、失敗時: エラー
+   */
+  static s6i_result::Result<SdlMutexPolicy, SyncError> make() {
+    SDL_mutex* mutex = SDL_CreateMutex();
+    S6I_LOG_DEBUG(SDL_LOG_CATEGORY_SYSTEM, "Create mutex.");
+    if (!mutex) {
+      S6I_LOG_ERROR(SDL_LOG_CATEGORY_SYSTEM, "Failed to create mutex: %s",
+                    SDL_GetError());
+      return s6i_result::make_err(SyncError::MutexCreationError);
+    }
+    return s6i_result::make_ok(SdlMutexPolicy(mutex));
+  }
+
+  // コピー禁止
+  SdlMutexPolicy(const SdlMutexPolicy&) = delete;
+  SdlMutexPolicy& operator=(const SdlMutexPolicy&) = delete;
+
+  // ムーブ可能
+  SdlMutexPolicy(SdlMutexPolicy&& other) : m_mutex(other.m_mutex) {
+    other.m_mutex = nullptr;
+  }
+
+  SdlMutexPolicy& operator=(SdlMutexPolicy&& other) {
+    SdlMutexPolicy(std::move(other)).swap(*this);
+    return *this;
+  }
+
+  ~SdlMutexPolicy() {
+    S6I_LOG_DEBUG(SDL_LOG_CATEGORY_SYSTEM, "Destroy mutex.");
+    SDL_DestroyMutex(m_mutex);
+  }
+
+  /** @brief 有効なロックかどうか（ムーブ元は無効） */
+  bool is_valid() const { return m_mutex != nullptr; }
+
+  /** @brief ロックを取得（失敗時はfalse） */
+  bool lock() { return SDL_LockMutex(m_mutex) == 0; }
+
+  /** @brief ロックの取得を試みる（取得できなければfalse） */
+  bool try_lock() { return SDL_TryLockMutex(m_mutex) == 0; }
+
+  /** @brief ロックを解放 */
+  void unlock() { SDL_UnlockMutex(m_mutex); }
+
+  SDL_mutex* get_raw() const { return m_mutex; }
+
+  void swap(SdlMutexPolicy& other) {
+    using std::swap;
+    swap(m_mutex, other.m_mutex);
+  }
+
+ private:
+  explicit SdlMutexPolicy(SDL_mutex* mutex) : m_mutex(mutex) {}
+
+  SDL_mutex* m_mutex = nullptr;
+};
+
+inline void swap(SdlMutexPolicy& lhs, SdlMutexPolicy& rhs) {
+  lhs.swap(rhs);
+}
+
+/**
+ * @brief 指数バックオフ付きのスピンロック
+ *
+ * OSに処理を戻さずに待つため、ごく短いクリティカルセクション向けです。
+ * ロックの状態は1ワードのみで、作成・破棄にコストはかかりません。
+ */
+class SpinMutexPolicy {
+ public:
+  /**
+   * @brief 新しいロックを作成
+   * @return 常に成功
+   */
+  static s6i_result::Result<SpinMutexPolicy, SyncError> make() {
+    return s6i_result::make_ok(SpinMutexPolicy(UNLOCKED));
+  }
+
+  // コピー禁止
+  SpinMutexPolicy(const SpinMutexPolicy&) = delete;
+  SpinMutexPolicy& operator=(const SpinMutexPolicy&) = delete;
+
+  // ムーブ可能（ロック中のムーブは未定義）
+  SpinMutexPolicy(SpinMutexPolicy&& other)
+      : m_state(other.m_state.exchange(INVALID, std::memory_order_relaxed)) {}
+
+  SpinMutexPolicy& operator=(SpinMutexPolicy&& other) {
+    SpinMutexPolicy(std::move(other)).swap(*this);
+    return *this;
+  }
+
+  /** @brief 有効なロックかどうか（ムーブ元は無効） */
+  bool is_valid() const {
+    return m_state.load(std::memory_order_relaxed) != INVALID;
+  }
+
+  /** @brief ロックを取得 */
+  bool lock() {
+    Backoff backoff;
+    for (;;) {
+      if (try_lock()) {
+        return true;
+      }
+      // 解放されるまでは読み取りだけで待ち、キャッシュラインの奪い合いを避ける
+      while (m_state.load(std::memory_order_relaxed) != UNLOCKED) {
+        backoff.snooze();
+      }
+    }
+  }
+
+  /** @brief ロックの取得を試みる（取得できなければfalse） */
+  bool try_lock() {
+    uint32_t expected = UNLOCKED;
+    return m_state.compare_exchange_strong(expected, LOCKED,
+                                           std::memory_order_acquire,
+                                           std::memory_order_relaxed);
+  }
+
+  /** @brief ロックを解放 */
+  void unlock() { m_state.store(UNLOCKED, std::memory_order_release); }
+
+  void swap(SpinMutexPolicy& other) {
+    const uint32_t state = m_state.load(std::memory_order_relaxed);
+    m_state.store(other.m_state.load(std::memory_order_relaxed),
+                  std::memory_order_relaxed);
+    other.m_state.store(state, std::memory_order_relaxed);
+  }
+
+ private:
+  static constexpr uint32_t UNLOCKED = 0;
+  static constexpr uint32_t LOCKED = 1;
+  static constexpr uint32_t INVALID = 0xffffffff;
+
+  explicit SpinMutexPolicy(uint32_t state) : m_state(state) {}
+
+  std::atomic<uint32_t> m_state{UNLOCKED};
+};
+
+inline void swap(SpinMutexPolicy& lhs, SpinMutexPolicy& rhs) {
+  lhs.swap(rhs);
+}
+
+/**
+ * @brief 適応的にスピンしてからfutexで眠るロック
+ *
+ * 短時間で解放されるロックはスピンだけで取得し、
+ * それ以上かかる場合はfutex(Linux)/WaitOnAddress(Windows)で眠ります。
+ * スピン回数は直近の取得にかかった回数から適応的に決まります。
+ */
+class AdaptiveMutexPolicy {
+ public:
+  /** @brief スピン回数の上限 */
+  static constexpr int32_t MAX_SPIN = 100;
+
+  /**
+   * @brief 新しいロックを作成
+   * @return 常に成功
+   */
+  static s6i_result::Result<AdaptiveMutexPolicy, SyncError> make() {
+    return s6i_result::make_ok(AdaptiveMutexPolicy(UNLOCKED));
+  }
+
+  // コピー禁止
+  AdaptiveMutexPolicy(const AdaptiveMutexPolicy&) = delete;
+  AdaptiveMutexPolicy& operator=(const AdaptiveMutexPolicy&) = delete;
+
+  // ムーブ可能（ロック中のムーブは未定義）
+  AdaptiveMutexPolicy(AdaptiveMutexPolicy&& other)
+      : m_state(other.m_state.exchange(INVALID, std::memory_order_relaxed)),
+        m_spins(other.m_spins.load(std::memory_order_relaxed)) {}
+
+  AdaptiveMutexPolicy& operator=(AdaptiveMutexPolicy&& other) {
+    AdaptiveMutexPolicy(std::move(other)).swap(*this);
+    return *this;
+  }
+
+  /** @brief 有効なロックかどうか（ムーブ元は無効） */
+  bool is_valid() const {
+    return m_state.load(std::memory_order_relaxed) != INVALID;
+  }
+
+  /** @brief ロックを取得 */
+  bool lock() {
+    if (try_lock()) {
+      return true;
+    }
+
+    // 直近の実績から今回のスピン回数を決める
+    const int32_t spins = m_spins.load(std::memory_order_relaxed);
+    const int32_t max_count = std::min(MAX_SPIN, spins * 2 + 10);
+    for (int32_t count = 0; count < max_count; ++count) {
+      cpu_relax();
+      if (m_state.load(std::memory_order_relaxed) == UNLOCKED && try_lock()) {
+        m_spins.store(spins + (count - spins) / 8, std::memory_order_relaxed);
+        return true;
+      }
+    }
+    m_spins.store(spins + (max_count - spins) / 8, std::memory_order_relaxed);
+
+    // 待機者ありとして眠る
+    uint32_t state = m_state.exchange(CONTENDED, std::memory_order_acquire);
+    while (state != UNLOCKED) {
+      futex_wait(m_state, CONTENDED);
+      state = m_state.exchange(CONTENDED, std::memory_order_acquire);
+    }
+    return true;
+  }
+
+  /** @brief ロックの取得を試みる（取得できなければfalse） */
+  bool try_lock() {
+    uint32_t expected = UNLOCKED;
+    return m_state.compare_exchange_strong(expected, LOCKED,
+                                           std::memory_order_acquire,
+                                           std::memory_order_relaxed);
+  }
+
+  /** @brief ロックを解放し、待機者がいれば1つ起こす */
+  void unlock() {
+    if (m_state.exchange(UNLOCKED, std::memory_order_release) == CONTENDED) {
+      futex_wake_one(m_state);
+    }
+  }
+
+  void swap(AdaptiveMutexPolicy& other) {
+    const uint32_t state = m_state.load(std::memory_order_relaxed);
+    m_state.store(other.m_state.load(std::memory_order_relaxed),
+                  std::memory_order_relaxed);
+    other.m_state.store(state, std::memory_order_relaxed);
+    const int32_t spins = m_spins.load(std::memory_order_relaxed);
+    m_spins.store(other.m_spins.load(std::memory_order_relaxed),
+                  std::memory_order_relaxed);
+    other.m_spins.store(spins, std::memory_order_relaxed);
+  }
+
+ private:
+  static constexpr uint32_t UNLOCKED = 0;
+  static constexpr uint32_t LOCKED = 1;
+  static constexpr uint32_t CONTENDED = 2;
+  static constexpr uint32_t INVALID = 0xffffffff;
+
+  explicit AdaptiveMutexPolicy(uint32_t state) : m_state(state) {}
+
+  std::atomic<uint32_t> m_state{UNLOCKED};
+  std::atomic<int32_t> m_spins{0};
+};
+
+inline void swap(AdaptiveMutexPolicy& lhs, AdaptiveMutexPolicy& rhs) {
+  lhs.swap(rhs);
+}
+
+/**
+ * @brief グローバルなパーキングロットで待機する1バイトのロック
+ *
+ * 待機キューはparking_lotが持つため、ロック自体の状態は1バイトのみです。
+ * OSのリソースを確保しないため、作成・破棄にコストはかかりません。
+ * 小さなオブジェクトごとにロックを持たせる用途に向いています。
+ */
+class ParkingLotMutexPolicy {
+ public:
+  /** @brief 眠る前にスピンする回数 */
+  static constexpr uint32_t SPIN_LIMIT = 40;
+
+  /**
+   * @brief 新しいロックを作成
+   * @return 常に成功
+   */
+  static s6i_result::Result<ParkingLotMutexPolicy, SyncError> make() {
+    return s6i_result::make_ok(ParkingLotMutexPolicy(UNLOCKED));
+  }
+
+  // コピー禁止
+  ParkingLotMutexPolicy(const ParkingLotMutexPolicy&) = delete;
+  ParkingLotMutexPolicy& operator=(const ParkingLotMutexPolicy&) = delete;
+
+  // ムーブ可能（ロック中のムーブは未定義）
+  ParkingLotMutexPolicy(ParkingLotMutexPolicy&& other)
+      : m_state(other.m_state.exchange(INVALID, std::memory_order_relaxed)) {}
+
+  ParkingLotMutexPolicy& operator=(ParkingLotMutexPolicy&& other) {
+    ParkingLotMutexPolicy(std::move(other)).swap(*this);
+    return *this;
+  }
+
+  /** @brief 有効なロックかどうか（ムーブ元は無効） */
+  bool is_valid() const {
+    return m_state.load(std::memory_order_relaxed) != INVALID;
+  }
+
+  /** @brief ロックを取得 */
+  bool lock() {
+    if (try_lock()) {
+      return true;
+    }
+
+    uint32_t spins = 0;
+    uint8_t state = m_state.load(std::memory_order_relaxed);
+    for (;;) {
+      // 解放されていれば待機者の有無にかかわらず取得を試みる
+      if (!(state & LOCKED_BIT)) {
+        if (m_state.compare_exchange_weak(state, state | LOCKED_BIT,
+                                          std::memory_order_acquire,
+                                          std::memory_order_relaxed)) {
+          return true;
+        }
+        continue;
+      }
+
+      // 待機者がいなければしばらくスピンする
+      if (!(state & PARKED_BIT) && spins < SPIN_LIMIT) {
+        ++spins;
+        cpu_relax();
+        state = m_state.load(std::memory_order_relaxed);
+        continue;
+      }
+
+      // 待機者ありの印を付けてから眠る
+      if (!(state & PARKED_BIT)) {
+        if (!m_state.compare_exchange_weak(state, state | PARKED_BIT,
+                                           std::memory_order_relaxed,
+                                           std::memory_order_relaxed)) {
+          continue;
+        }
+      }
+      parking_lot::park(this, [this]() {
+        return m_state.load(std::memory_order_relaxed) ==
+               (LOCKED_BIT | PARKED_BIT);
+      });
+      spins = 0;
+      state = m_state.load(std::memory_order_relaxed);
+    }
+  }
+
+  /** @brief ロックの取得を試みる（取得できなければfalse） */
+  bool try_lock() {
+    uint8_t expected = UNLOCKED;
+    return m_state.compare_exchange_strong(expected, LOCKED_BIT,
+                                           std::memory_order_acquire,
+                                           std::memory_order_relaxed);
+  }
+
+  /** @brief ロックを解放し、待機者がいれば1つ起こす */
+  void unlock() {
+    uint8_t expected = LOCKED_BIT;
+    if (m_state.compare_exchange_strong(expected, UNLOCKED,
+                                        std::memory_order_release,
+                                        std::memory_order_relaxed)) {
+      return;
+    }
+    // 待機者がいる: 残りの待機者の有無に合わせて解放する
+    parking_lot::unpark_one(this, [this](bool has_more) {
+      m_state.store(has_more ? PARKED_BIT : UNLOCKED,
+                    std::memory_order_release);
+    });
+  }
+
+  void swap(ParkingLotMutexPolicy& other) {
+    const uint8_t state = m_state.load(std::memory_order_relaxed);
+    m_state.store(other.m_state.load(std::memory_order_relaxed),
+                  std::memory_order_relaxed);
+    other.m_state.store(state, std::memory_order_relaxed);
+  }
+
+ private:
+  static constexpr uint8_t UNLOCKED = 0;
+  static constexpr uint8_t LOCKED_BIT = 1;
+  static constexpr uint8_t PARKED_BIT = 2;
+  static constexpr uint8_t INVALID = 0xff;
+
+  explicit ParkingLotMutexPolicy(uint8_t state) : m_state(state) {}
+
+  std::atomic<uint8_t> m_state{UNLOCKED};
+};
+
+inline void swap(ParkingLotMutexPolicy& lhs, ParkingLotMutexPolicy& rhs) {
+  lhs.swap(rhs);
+}
+
+}  // namespace s6i_sync
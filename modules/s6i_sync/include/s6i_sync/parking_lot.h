@@ -0,0 +1,205 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include "backoff.h"
+#include "futex.h"
+
+namespace s6i_sync::parking_lot {
+
+/**
+ * @brief グローバルなパーキングロット
+ *
+ * 待機中のスレッドをアドレス（キー）ごとにハッシュ化したバケットへ登録し、
+ * 同期オブジェクト側には待機キューを持たせません。
+ * そのため、ロック自体の状態は1バイトで済みます。
+ * 待機者はスレッドごとの1ワードでfutex(Linux)/WaitOnAddress(Windows)に眠ります。
+ */
+
+namespace detail {
+
+/** @brief スレッドごとの待機情報 */
+struct Parker {
+  static constexpr uint32_t UNPARKED = 0;
+  static constexpr uint32_t PARKED = 1;
+
+  std::atomic<uint32_t> m_state{UNPARKED};
+  const void* m_key = nullptr;
+  Parker* m_next = nullptr;
+};
+
+inline Parker& this_parker() {
+  thread_local Parker parker;
+  return parker;
+}
+
+/**
+ * @brief 待機キューを保持するバケット
+ *
+ * バケットのロックは保持時間がごく短いため、スピンで取得します。
+ */
+struct alignas(64) Bucket {
+  void lock() {
+    Backoff backoff;
+    while (m_locked.exchange(true, std::memory_order_acquire)) {
+      while (m_locked.load(std::memory_order_relaxed)) {
+        backoff.snooze();
+      }
+    }
+  }
+
+  void unlock() { m_locked.store(false, std::memory_order_release); }
+
+  std::atomic<bool> m_locked{false};
+  Parker* m_head = nullptr;
+  Parker* m_tail = nullptr;
+};
+
+/** @brief バケット数 = 2^BUCKET_BITS */
+inline constexpr unsigned BUCKET_BITS = 8;
+inline constexpr size_t BUCKET_COUNT = size_t{1} << BUCKET_BITS;
+
+inline Bucket& bucket_for(const void* key) {
+  static Bucket buckets[BUCKET_COUNT];
+  // フィボナッチハッシュで上位ビットを使う
+  const auto addr = static_cast<uint64_t>(reinterpret_cast<uintptr_t>(key));
+  const uint64_t hash = addr * UINT64_C(0x9e3779b97f4a7c15);
+  return buckets[hash >> (64 - BUCKET_BITS)];
+}
+
+}  // namespace detail
+
+/**
+ * @brief keyで待機する
+ *
+ * バケットのロック中にvalidateを呼び出し、falseならば待機せずに戻ります。
+ * unpark_one/unpark_allは同じバケットのロックを取るため、
+ * validateの判定から待機までの間に起床通知を取りこぼすことはありません。
+ *
+ * @param key 待機するアドレス
+ * @param validate 待機を続けるかどうかの判定
+ * @return 待機して起こされた場合はtrue、validateがfalseの場合はfalse
+ */
+template <typename Validate>
+bool park(const void* key, Validate&& validate) {
+  detail::Parker& self = detail::this_parker();
+  detail::Bucket& bucket = detail::bucket_for(key);
+
+  bucket.lock();
+  if (!validate()) {
+    bucket.unlock();
+    return false;
+  }
+  self.m_key = key;
+  self.m_next = nullptr;
+  self.m_state.store(detail::Parker::PARKED, std::memory_order_relaxed);
+  if (bucket.m_tail) {
+    bucket.m_tail->m_next = &self;
+  } else {
+    bucket.m_head = &self;
+  }
+  bucket.m_tail = &self;
+  bucket.unlock();
+
+  while (self.m_state.load(std::memory_order_acquire) ==
+         detail::Parker::PARKED) {
+    futex_wait(self.m_state, detail::Parker::PARKED);
+  }
+  return true;
+}
+
+/**
+ * @brief keyで待機しているスレッドを1つ起こす
+ *
+ * 起こす前にバケットのロック中でcallbackを呼び出します。
+ * callbackにはまだ他の待機者が残っているかどうかが渡されます。
+ *
+ * @param key 待機しているアドレス
+ * @param callback void(bool has_more)
+ * @return スレッドを起こした場合はtrue
+ */
+template <typename Callback>
+bool unpark_one(const void* key, Callback&& callback) {
+  detail::Bucket& bucket = detail::bucket_for(key);
+
+  bucket.lock();
+  detail::Parker* prev = nullptr;
+  detail::Parker* found = bucket.m_head;
+  while (found && found->m_key != key) {
+    prev = found;
+    found = found->m_next;
+  }
+  if (found) {
+    if (prev) {
+      prev->m_next = found->m_next;
+    } else {
+      bucket.m_head = found->m_next;
+    }
+    if (bucket.m_tail == found) {
+      bucket.m_tail = prev;
+    }
+  }
+  bool has_more = false;
+  for (detail::Parker* p = found ? found->m_next : nullptr; p; p = p->m_next) {
+    if (p->m_key == key) {
+      has_more = true;
+      break;
+    }
+  }
+  callback(has_more);
+  bucket.unlock();
+
+  if (!found) {
+    return false;
+  }
+  found->m_state.store(detail::Parker::UNPARKED, std::memory_order_release);
+  futex_wake_one(found->m_state);
+  return true;
+}
+
+/**
+ * @brief keyで待機しているスレッドをすべて起こす
+ * @param key 待機しているアドレス
+ * @return 起こしたスレッドの数
+ */
+inline size_t unpark_all(const void* key) {
+  detail::Bucket& bucket = detail::bucket_for(key);
+
+  // 起こすスレッドをバケットから外し、ロックの外で起こす
+  detail::Parker* woken = nullptr;
+  bucket.lock();
+  detail::Parker* prev = nullptr;
+  detail::Parker* p = bucket.m_head;
+  while (p) {
+    detail::Parker* next = p->m_next;
+    if (p->m_key == key) {
+      if (prev) {
+        prev->m_next = next;
+      } else {
+        bucket.m_head = next;
+      }
+      if (bucket.m_tail == p) {
+        bucket.m_tail = prev;
+      }
+      p->m_next = woken;
+      woken = p;
+    } else {
+      prev = p;
+    }
+    p = next;
+  }
+  bucket.unlock();
+
+  size_t count = 0;
+  while (woken) {
+    detail::Parker* next = woken->m_next;
+    woken->m_state.store(detail::Parker::UNPARKED, std::memory_order_release);
+    futex_wake_one(woken->m_state);
+    woken = next;
+    ++count;
+  }
+  return count;
+}
+
+}  // namespace s6i_sync::parking_lot
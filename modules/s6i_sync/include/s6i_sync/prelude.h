@@ -1,5 +1,24 @@
 #pragma once
 
+#include "backoff.h"
+#include "barrier.h"
+#include "cache_padded.h"
+#include "channel.h"
+#include "concurrent_map.h"
 #include "cond_var.h"
+#include "epoch.h"
 #include "error.h"
+#include "futex.h"
+#include "latch.h"
+#include "lock_profile.h"
 #include "mutex.h"
+#include "mutex_policy.h"
+#include "parking_lot.h"
+#include "rw_lock.h"
+#include "semaphore.h"
+#include "seq_lock.h"
+#include "sharded_counter.h"
+#include "snapshot.h"
+#include "spsc_ring.h"
+#include "thread.h"
+#include "triple_buffer.h"
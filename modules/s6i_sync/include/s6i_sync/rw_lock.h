@@ -0,0 +1,353 @@
+#pragma once
+
+#include <s6i_result/result.h>
+#include <atomic>
+#include <cassert>
+#include <cstdint>
+#include <utility>
+#include "backoff.h"
+#include "error.h"
+#include "futex.h"
+#include "mutex_policy.h"
+
+namespace s6i_sync {
+
+template <typename T>
+class ReadGuard;
+
+template <typename T>
+class WriteGuard;
+
+namespace detail {
+
+/**
+ * @brief 書き込み優先の読み書きロック本体
+ *
+ * 状態は1ワードで、下位30ビットが読み込み中のスレッド数、
+ * WRITERビットが書き込み中（または書き込み待ち）を表します。
+ * WRITERビットが立っている間は新たな読み込みを受け付けないため、
+ * 書き込みが読み込みに飢えさせられることはありません。
+ * 書き込み同士はAdaptiveMutexPolicyで直列化し、
+ * 待機中の書き込みがあればWRITERビットを立てたまま引き継ぎます。
+ */
+class RawRwLock {
+ public:
+  RawRwLock() = default;
+
+  // コピー禁止
+  RawRwLock(const RawRwLock&) = delete;
+  RawRwLock& operator=(const RawRwLock&) = delete;
+
+  // ムーブ可能（ロック中のムーブは未定義）
+  RawRwLock(RawRwLock&& other)
+      : m_state(other.m_state.exchange(INVALID, std::memory_order_relaxed)),
+        m_writers(other.m_writers.load(std::memory_order_relaxed)),
+        m_writer(std::move(other.m_writer)) {}
+
+  RawRwLock& operator=(RawRwLock&& other) {
+    RawRwLock(std::move(other)).swap(*this);
+    return *this;
+  }
+
+  /** @brief 有効なロックかどうか（ムーブ元は無効） */
+  bool is_valid() const {
+    return m_state.load(std::memory_order_relaxed) != INVALID;
+  }
+
+  /** @brief 読み込みロックを取得 */
+  void lock_shared() {
+    Backoff backoff;
+    uint32_t state = m_state.load(std::memory_order_relaxed);
+    for (;;) {
+      if (!(state & WRITER)) {
+        assert((state & READER_MASK) != READER_MASK && "Too many readers");
+        if (m_state.compare_exchange_weak(state, state + 1,
+                                          std::memory_order_acquire,
+                                          std::memory_order_relaxed)) {
+          return;
+        }
+        continue;
+      }
+      // 書き込みがすぐ終わる場合に備えて少しだけスピンする
+      if (!backoff.is_completed()) {
+        backoff.snooze();
+        state = m_state.load(std::memory_order_relaxed);
+        continue;
+      }
+      // 待機中の印を付けてから眠る
+      if (!(state & READERS_WAITING)) {
+        if (!m_state.compare_exchange_weak(state, state | READERS_WAITING,
+                                           std::memory_order_relaxed,
+                                           std::memory_order_relaxed)) {
+          continue;
+        }
+        state |= READERS_WAITING;
+      }
+      futex_wait(m_state, state);
+      state = m_state.load(std::memory_order_relaxed);
+    }
+  }
+
+  /** @brief 読み込みロックの取得を試みる（取得できなければfalse） */
+  bool try_lock_shared() {
+    uint32_t state = m_state.load(std::memory_order_relaxed);
+    while (!(state & WRITER)) {
+      if (m_state.compare_exchange_weak(state, state + 1,
+                                        std::memory_order_acquire,
+                                        std::memory_order_relaxed)) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  /** @brief 読み込みロックを解放 */
+  void unlock_shared() {
+    const uint32_t prev = m_state.fetch_sub(1, std::memory_order_release);
+    // 最後の読み込みが書き込みを待たせていたら起こす
+    if ((prev & WRITER) && (prev & READER_MASK) == 1) {
+      futex_wake_all(m_state);
+    }
+  }
+
+  /** @brief 書き込みロックを取得 */
+  void lock() {
+    m_writers.fetch_add(1, std::memory_order_relaxed);
+    m_writer.lock();
+    // 以降の読み込みを締め出し、読み込み中のスレッドが抜けるのを待つ
+    uint32_t state = m_state.fetch_or(WRITER, std::memory_order_acquire);
+    state |= WRITER;
+    while (state & READER_MASK) {
+      futex_wait(m_state, state);
+      state = m_state.load(std::memory_order_acquire);
+    }
+  }
+
+  /** @brief 書き込みロックの取得を試みる（取得できなければfalse） */
+  bool try_lock() {
+    if (!m_writer.try_lock()) {
+      return false;
+    }
+    uint32_t expected = 0;
+    if (!m_state.compare_exchange_strong(expected, WRITER,
+                                         std::memory_order_acquire,
+                                         std::memory_order_relaxed)) {
+      m_writer.unlock();
+      return false;
+    }
+    m_writers.fetch_add(1, std::memory_order_relaxed);
+    return true;
+  }
+
+  /** @brief 書き込みロックを解放 */
+  void unlock() {
+    // 待機中の書き込みがあれば、WRITERビットを立てたまま引き継ぐ
+    if (m_writers.fetch_sub(1, std::memory_order_relaxed) > 1) {
+      m_writer.unlock();
+      return;
+    }
+    const uint32_t prev = m_state.exchange(0, std::memory_order_release);
+    if (prev & READERS_WAITING) {
+      futex_wake_all(m_state);
+    }
+    m_writer.unlock();
+  }
+
+  void swap(RawRwLock& other) {
+    const uint32_t state = m_state.load(std::memory_order_relaxed);
+    m_state.store(other.m_state.load(std::memory_order_relaxed),
+                  std::memory_order_relaxed);
+    other.m_state.store(state, std::memory_order_relaxed);
+    const uint32_t writers = m_writers.load(std::memory_order_relaxed);
+    m_writers.store(other.m_writers.load(std::memory_order_relaxed),
+                    std::memory_order_relaxed);
+    other.m_writers.store(writers, std::memory_order_relaxed);
+    m_writer.swap(other.m_writer);
+  }
+
+ private:
+  static constexpr uint32_t READER_MASK = (1u << 30) - 1;
+  static constexpr uint32_t WRITER = 1u << 30;
+  static constexpr uint32_t READERS_WAITING = 1u << 31;
+  static constexpr uint32_t INVALID = 0xffffffff;
+
+  std::atomic<uint32_t> m_state{0};
+  std::atomic<uint32_t> m_writers{0};  ///< 書き込み中 + 書き込み待ちの数
+  AdaptiveMutexPolicy m_writer = AdaptiveMutexPolicy::make().unwrap();
+};
+
+}  // namespace detail
+
+/**
+ * @brief 読み込みが多い値を保持する読み書きロック
+ *
+ * read()は複数のスレッドから同時に取得でき、write()は排他的に取得します。
+ * 書き込み優先のため、書き込みを待っている間は新たな読み込みを待たせます。
+ *
+ * @tparam T 保護する値の型
+ */
+template <typename T>
+class RwLock {
+ public:
+  /**
+   * @brief 新しいRwLockを作成
+   * @param args Tのコンストラクタに渡す引数
+   * @return 常に成功
+   */
+  template <typename... Args>
+  static s6i_result::Result<RwLock, SyncError> make(Args&&... args) {
+    return s6i_result::make_ok(RwLock(std::forward<Args>(args)...));
+  }
+
+  // コピー禁止
+  RwLock(const RwLock&) = delete;
+  RwLock& operator=(const RwLock&) = delete;
+
+  // ムーブ可能
+  RwLock(RwLock&& other)
+      : m_lock(std::move(other.m_lock)), m_value(std::move(other.m_value)) {}
+
+  RwLock& operator=(RwLock&& other) {
+    RwLock(std::move(other)).swap(*this);
+    return *this;
+  }
+
+  /**
+   * @brief 読み込みロックを取得し、値への読み取り専用アクセスを提供
+   * @return 成功時: ReadGuard、失敗時: エラー
+   */
+  s6i_result::Result<ReadGuard<T>, SyncError> read() {
+    if (!m_lock.is_valid()) {
+      return s6i_result::make_err(SyncError::InvalidRwLockError);
+    }
+    m_lock.lock_shared();
+    return s6i_result::make_ok(ReadGuard<T>(m_lock, m_value));
+  }
+
+  /**
+   * @brief 書き込みロックを取得し、値へのアクセスを提供
+   * @return 成功時: WriteGuard、失敗時: エラー
+   */
+  s6i_result::Result<WriteGuard<T>, SyncError> write() {
+    if (!m_lock.is_valid()) {
+      return s6i_result::make_err(SyncError::InvalidRwLockError);
+    }
+    m_lock.lock();
+    return s6i_result::make_ok(WriteGuard<T>(m_lock, m_value));
+  }
+
+  void swap(RwLock& other) {
+    using std::swap;
+    m_lock.swap(other.m_lock);
+    swap(m_value, other.m_value);
+  }
+
+ private:
+  template <typename... Args>
+  explicit RwLock(Args&&... args) : m_value(std::forward<Args>(args)...) {}
+
+  detail::RawRwLock m_lock;
+  T m_value;
+};
+
+template <typename T>
+inline void swap(RwLock<T>& lhs, RwLock<T>& rhs) {
+  lhs.swap(rhs);
+}
+
+/**
+ * @brief RAIIで読み込みロックを管理するガードクラス
+ * @tparam T 保護する値の型
+ */
+template <typename T>
+class ReadGuard {
+ public:
+  ReadGuard(ReadGuard&& other) : m_lock(other.m_lock), m_value(other.m_value) {
+    other.m_lock = nullptr;
+    other.m_value = nullptr;
+  }
+
+  ~ReadGuard() {
+    if (m_lock) {
+      m_lock->unlock_shared();
+    }
+  }
+
+  // コピー禁止
+  ReadGuard(const ReadGuard&) = delete;
+  ReadGuard& operator=(const ReadGuard&) = delete;
+
+  ReadGuard& operator=(ReadGuard&& rhs) {
+    ReadGuard(std::move(rhs)).swap(*this);
+    return *this;
+  }
+
+  const T& operator*() const { return *m_value; }
+  const T* operator->() const { return m_value; }
+
+  void swap(ReadGuard& other) {
+    using std::swap;
+    swap(m_lock, other.m_lock);
+    swap(m_value, other.m_value);
+  }
+
+ private:
+  ReadGuard(detail::RawRwLock& lock, const T& value)
+      : m_lock(&lock), m_value(&value) {}
+
+  detail::RawRwLock* m_lock = nullptr;
+  const T* m_value = nullptr;
+
+  friend class RwLock<T>;
+};
+
+/**
+ * @brief RAIIで書き込みロックを管理するガードクラス
+ * @tparam T 保護する値の型
+ */
+template <typename T>
+class WriteGuard {
+ public:
+  WriteGuard(WriteGuard&& other)
+      : m_lock(other.m_lock), m_value(other.m_value) {
+    other.m_lock = nullptr;
+    other.m_value = nullptr;
+  }
+
+  ~WriteGuard() {
+    if (m_lock) {
+      m_lock->unlock();
+    }
+  }
+
+  // コピー禁止
+  WriteGuard(const WriteGuard&) = delete;
+  WriteGuard& operator=(const WriteGuard&) = delete;
+
+  WriteGuard& operator=(WriteGuard&& rhs) {
+    WriteGuard(std::move(rhs)).swap(*this);
+    return *this;
+  }
+
+  T& operator*() { return *m_value; }
+  T* operator->() { return m_value; }
+  const T& operator*() const { return *m_value; }
+  const T* operator->() const { return m_value; }
+
+  void swap(WriteGuard& other) {
+    using std::swap;
+    swap(m_lock, other.m_lock);
+    swap(m_value, other.m_value);
+  }
+
+ private:
+  WriteGuard(detail::RawRwLock& lock, T& value)
+      : m_lock(&lock), m_value(&value) {}
+
+  detail::RawRwLock* m_lock = nullptr;
+  T* m_value = nullptr;
+
+  friend class RwLock<T>;
+};
+
+}  // namespace s6i_sync
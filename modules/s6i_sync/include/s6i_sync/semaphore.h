@@ -0,0 +1,157 @@
+#pragma once
+
+#include <s6i_result/result.h>
+#include <atomic>
+#include <cassert>
+#include <cstdint>
+#include <utility>
+#include "backoff.h"
+#include "error.h"
+#include "futex.h"
+
+namespace s6i_sync {
+
+/**
+ * @brief 計数セマフォ
+ *
+ * acquire()は値が正になるまで待って1減らし、release()は値を増やします。
+ * 値が0のときはBackoffで少しだけスピンし、それでも増えなければ
+ * 値そのものをfutexの監視対象にして眠ります。
+ * release()は眠っているスレッドがいるときだけカーネルを呼びます。
+ */
+class Semaphore {
+ public:
+  /** @brief 値の上限 */
+  static constexpr uint32_t MAX_VALUE = 0x7fffffff;
+
+  /**
+   * @brief 新しいセマフォを作成
+   * @param initial 初期値（MAX_VALUE以下）
+   * @return 成功時: 作成されたセマフォ、失敗時: エラー
+   */
+  static s6i_result::Result<Semaphore, SyncError> make(uint32_t initial = 0) {
+    if (initial > MAX_VALUE) {
+      return s6i_result::make_err(SyncError::InvalidSemaphoreError);
+    }
+    return s6i_result::make_ok(Semaphore(initial));
+  }
+
+  // コピー禁止
+  Semaphore(const Semaphore&) = delete;
+  Semaphore& operator=(const Semaphore&) = delete;
+
+  // ムーブ可能（待機中のムーブは未定義）
+  Semaphore(Semaphore&& other)
+      : m_value(other.m_value.exchange(INVALID, std::memory_order_relaxed)) {}
+
+  Semaphore& operator=(Semaphore&& other) {
+    Semaphore(std::move(other)).swap(*this);
+    return *this;
+  }
+
+  /** @brief 有効なセマフォかどうか（ムーブ元は無効） */
+  bool is_valid() const {
+    return m_value.load(std::memory_order_relaxed) != INVALID;
+  }
+
+  /** @brief 現在の値（他のスレッドが操作中なら目安） */
+  uint32_t value() const {
+    const uint32_t value = m_value.load(std::memory_order_relaxed);
+    return value == INVALID ? 0 : value;
+  }
+
+  /**
+   * @brief 値が正になるまで待ち、1減らす
+   * @return 成功時: void、失敗時: エラー
+   */
+  s6i_result::Result<void, SyncError> acquire() {
+    if (!is_valid()) {
+      return s6i_result::make_err(SyncError::InvalidSemaphoreError);
+    }
+    Backoff backoff;
+    for (;;) {
+      if (try_decrement()) {
+        return s6i_result::make_ok();
+      }
+      if (!backoff.is_completed()) {
+        backoff.snooze();
+        continue;
+      }
+      // 待機中であることを示してから、値を確認し直して眠る
+      m_waiters.fetch_add(1, std::memory_order_seq_cst);
+      if (m_value.load(std::memory_order_seq_cst) == 0) {
+        futex_wait(m_value, 0);
+      }
+      m_waiters.fetch_sub(1, std::memory_order_relaxed);
+    }
+  }
+
+  /**
+   * @brief 値が正なら1減らす（待たない）
+   * @return 成功時: 減らせたかどうか、失敗時: エラー
+   */
+  s6i_result::Result<bool, SyncError> try_acquire() {
+    if (!is_valid()) {
+      return s6i_result::make_err(SyncError::InvalidSemaphoreError);
+    }
+    return s6i_result::make_ok(try_decrement());
+  }
+
+  /**
+   * @brief 値をcountだけ増やし、待機中のスレッドを起こす
+   * @param count 増やす量
+   * @return 成功時: void、失敗時: エラー
+   */
+  s6i_result::Result<void, SyncError> release(uint32_t count = 1) {
+    if (!is_valid()) {
+      return s6i_result::make_err(SyncError::InvalidSemaphoreError);
+    }
+    if (count == 0) {
+      return s6i_result::make_ok();
+    }
+    [[maybe_unused]] const uint32_t prev =
+        m_value.fetch_add(count, std::memory_order_seq_cst);
+    assert(prev + count <= MAX_VALUE && "Semaphore overflow");
+    if (m_waiters.load(std::memory_order_seq_cst) > 0) {
+      if (count == 1) {
+        futex_wake_one(m_value);
+      } else {
+        futex_wake_all(m_value);
+      }
+    }
+    return s6i_result::make_ok();
+  }
+
+  void swap(Semaphore& other) {
+    const uint32_t value = m_value.load(std::memory_order_relaxed);
+    m_value.store(other.m_value.load(std::memory_order_relaxed),
+                  std::memory_order_relaxed);
+    other.m_value.store(value, std::memory_order_relaxed);
+  }
+
+ private:
+  static constexpr uint32_t INVALID = 0xffffffff;
+
+  explicit Semaphore(uint32_t initial) : m_value(initial) {}
+
+  bool try_decrement() {
+    uint32_t value = m_value.load(std::memory_order_relaxed);
+    while (value > 0) {
+      if (m_value.compare_exchange_weak(value, value - 1,
+                                        std::memory_order_acquire,
+                                        std::memory_order_relaxed)) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  std::atomic<uint32_t> m_value;
+  std::atomic<uint32_t> m_waiters{0};  ///< futexで眠っている（眠りかけの）数
+};
+
+inline void swap(Semaphore& lhs, Semaphore& rhs) {
+  lhs.swap(rhs);
+}
+
+}  // namespace s6i_sync
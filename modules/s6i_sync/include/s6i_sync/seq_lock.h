@@ -0,0 +1,173 @@
+#pragma once
+
+#include <s6i_result/result.h>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+#include <utility>
+#include "backoff.h"
+#include "error.h"
+
+namespace s6i_sync {
+
+/**
+ * @brief 読み込み側が共有メモリへ一切書き込まない小さな値のセル
+ *
+ * 書き込み側はシーケンス番号を奇数にしてから値を書き換え、偶数に戻します。
+ * 読み込み側は前後でシーケンス番号が一致するまでコピーをやり直すため、
+ * キャッシュラインの奪い合いが起こらず、読み込み数に比例してスケールします。
+ * 値はワード単位のatomicで保持するため、途中の読み込みもデータ競合になりません。
+ *
+ * 書き込み同士はシーケンス番号で排他されます（複数の書き込み側も可）。
+ * 書き込み頻度が高いと読み込みがやり直し続けるため、
+ * カメラや入力状態など、毎フレーム1回程度の更新を想定しています。
+ *
+ * @tparam T 保持する値の型（トリビアルコピー可能であること）
+ */
+template <typename T>
+class SeqLock {
+  static_assert(std::is_trivially_copyable_v<T>,
+                "SeqLock requires a trivially copyable type");
+  static_assert(std::is_default_constructible_v<T>,
+                "SeqLock requires a default constructible type");
+
+ public:
+  /**
+   * @brief 新しいSeqLockを作成
+   * @param args Tのコンストラクタに渡す引数
+   * @return 常に成功
+   */
+  template <typename... Args>
+  static s6i_result::Result<SeqLock, SyncError> make(Args&&... args) {
+    return s6i_result::make_ok(SeqLock(T(std::forward<Args>(args)...)));
+  }
+
+  // コピー禁止
+  SeqLock(const SeqLock&) = delete;
+  SeqLock& operator=(const SeqLock&) = delete;
+
+  // ムーブ可能（読み書き中のムーブは未定義）
+  SeqLock(SeqLock&& other) : SeqLock(other.read()) {}
+
+  SeqLock& operator=(SeqLock&& other) {
+    SeqLock(std::move(other)).swap(*this);
+    return *this;
+  }
+
+  /**
+   * @brief 値のコピーを取得
+   * 書き込み中であれば、書き込みが終わるまでやり直します
+   */
+  T read() const {
+    Backoff backoff;
+    for (;;) {
+      const uint32_t seq1 = m_seq.load(std::memory_order_acquire);
+      if (seq1 & 1) {
+        backoff.snooze();
+        continue;
+      }
+      Words words;
+      for (size_t i = 0; i < WORD_COUNT; ++i) {
+        words[i] = m_words[i].load(std::memory_order_relaxed);
+      }
+      std::atomic_thread_fence(std::memory_order_acquire);
+      if (m_seq.load(std::memory_order_relaxed) == seq1) {
+        return from_words(words);
+      }
+    }
+  }
+
+  /**
+   * @brief 値を書き込む
+   * @param value 新しい値
+   */
+  void write(const T& value) {
+    const uint32_t seq = begin_write();
+    store_words(value);
+    m_seq.store(seq + 2, std::memory_order_release);
+  }
+
+  /**
+   * @brief 現在の値をもとに値を更新する
+   * @param f void(T&) 値を書き換える関数
+   */
+  template <typename F>
+  void update(F&& f) {
+    const uint32_t seq = begin_write();
+    Words words;
+    for (size_t i = 0; i < WORD_COUNT; ++i) {
+      words[i] = m_words[i].load(std::memory_order_relaxed);
+    }
+    T value = from_words(words);
+    std::forward<F>(f)(value);
+    store_words(value);
+    m_seq.store(seq + 2, std::memory_order_release);
+  }
+
+  void swap(SeqLock& other) {
+    swap_relaxed(m_seq, other.m_seq);
+    for (size_t i = 0; i < WORD_COUNT; ++i) {
+      swap_relaxed(m_words[i], other.m_words[i]);
+    }
+  }
+
+ private:
+  static constexpr size_t WORD_COUNT =
+      (sizeof(T) + sizeof(uint64_t) - 1) / sizeof(uint64_t);
+
+  struct Words {
+    uint64_t& operator[](size_t i) { return m_data[i]; }
+    uint64_t m_data[WORD_COUNT];
+  };
+
+  explicit SeqLock(const T& value) { store_words(value); }
+
+  static T from_words(Words& words) {
+    T value;
+    std::memcpy(&value, words.m_data, sizeof(T));
+    return value;
+  }
+
+  /** @brief シーケンス番号を奇数にして書き込みを開始（書き込み同士も排他） */
+  uint32_t begin_write() {
+    Backoff backoff;
+    uint32_t seq = m_seq.load(std::memory_order_relaxed);
+    for (;;) {
+      if (!(seq & 1) &&
+          m_seq.compare_exchange_weak(seq, seq + 1, std::memory_order_acquire,
+                                      std::memory_order_relaxed)) {
+        // 以降の値の書き込みが、奇数のシーケンス番号より先に見えないようにする
+        std::atomic_thread_fence(std::memory_order_release);
+        return seq;
+      }
+      backoff.snooze();
+      seq = m_seq.load(std::memory_order_relaxed);
+    }
+  }
+
+  template <typename U>
+  static void swap_relaxed(std::atomic<U>& lhs, std::atomic<U>& rhs) {
+    const U value = lhs.load(std::memory_order_relaxed);
+    lhs.store(rhs.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    rhs.store(value, std::memory_order_relaxed);
+  }
+
+  void store_words(const T& value) {
+    Words words{};
+    std::memcpy(words.m_data, &value, sizeof(T));
+    for (size_t i = 0; i < WORD_COUNT; ++i) {
+      m_words[i].store(words[i], std::memory_order_relaxed);
+    }
+  }
+
+  std::atomic<uint32_t> m_seq{0};
+  std::atomic<uint64_t> m_words[WORD_COUNT];
+};
+
+template <typename T>
+inline void swap(SeqLock<T>& lhs, SeqLock<T>& rhs) {
+  lhs.swap(rhs);
+}
+
+}  // namespace s6i_sync
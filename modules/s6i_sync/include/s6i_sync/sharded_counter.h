@@ -0,0 +1,299 @@
+#pragma once
+
+#include <s6i_result/result.h>
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <utility>
+#include "backoff.h"
+#include "cache_padded.h"
+#include "error.h"
+
+namespace s6i_sync {
+
+namespace detail {
+
+/**
+ * @brief 現在のスレッドの通し番号
+ * 最初に呼ばれたときに割り当て、シャードの選択に使います。
+ * 番号は終了したスレッドのものも再利用しないため、シャード数以下の
+ * スレッドが別々のシャードを使うのは、それまでに作られたスレッドが
+ * シャード数以下のときだけです。スレッドを作っては捨てると、
+ * 生きているスレッド同士が同じシャードを共有することがあります
+ * （加算はatomicなので値は失われません）。
+ */
+inline uint32_t this_thread_index() {
+  static std::atomic<uint32_t> s_next{0};
+  static thread_local const uint32_t s_index =
+      s_next.fetch_add(1, std::memory_order_relaxed);
+  return s_index;
+}
+
+inline bool is_power_of_two(size_t n) {
+  return n != 0 && (n & (n - 1)) == 0;
+}
+
+}  // namespace detail
+
+/**
+ * @brief スレッドごとのシャードに分けて数えるカウンター
+ *
+ * 各スレッドは自分のシャード（キャッシュライン1本）だけに加算するため、
+ * 1つのatomicに全員が加算するときのようなラインの奪い合いが起きません。
+ * シャード数より多くのスレッドが加算すると同じシャードを共有しますが、
+ * 加算はatomicなので値は失われません。
+ *
+ * sum()は全シャードを足し合わせます。加算中に読んだ場合は
+ * その途中のどこかの値になります（統計の表示などを想定）。
+ * ムーブ元への操作は未定義です。
+ */
+class ShardedCounter {
+ public:
+  /** @brief シャード数の既定値 */
+  static constexpr size_t DEFAULT_SHARD_COUNT = 64;
+
+  /**
+   * @brief 新しいShardedCounterを作成
+   * @param shard_count シャード数（2の累乗）
+   * @return 成功時: 作成されたShardedCounter、失敗時: エラー
+   */
+  static s6i_result::Result<ShardedCounter, SyncError> make(
+      size_t shard_count = DEFAULT_SHARD_COUNT) {
+    if (!detail::is_power_of_two(shard_count)) {
+      return s6i_result::make_err(SyncError::InvalidCounterError);
+    }
+    return s6i_result::make_ok(ShardedCounter(shard_count));
+  }
+
+  // コピー禁止
+  ShardedCounter(const ShardedCounter&) = delete;
+  ShardedCounter& operator=(const ShardedCounter&) = delete;
+
+  // ムーブ可能（操作中のムーブは未定義）
+  ShardedCounter(ShardedCounter&& other)
+      : m_shards(std::move(other.m_shards)),
+        m_mask(std::exchange(other.m_mask, 0)) {}
+
+  ShardedCounter& operator=(ShardedCounter&& other) {
+    ShardedCounter(std::move(other)).swap(*this);
+    return *this;
+  }
+
+  /** @brief 有効なカウンターかどうか（ムーブ元は無効） */
+  bool is_valid() const { return m_shards != nullptr; }
+
+  /** @brief シャード数 */
+  size_t shard_count() const { return m_shards ? m_mask + 1 : 0; }
+
+  /**
+   * @brief 現在のスレッドのシャードに加算する
+   * @param n 加算する値（負の値も可）
+   */
+  void add(int64_t n) {
+    assert(is_valid() && "ShardedCounter is not valid");
+    m_shards[detail::this_thread_index() & m_mask]->fetch_add(
+        n, std::memory_order_relaxed);
+  }
+
+  /** @brief 1加算する */
+  void increment() { add(1); }
+
+  /** @brief 全シャードの合計 */
+  int64_t sum() const {
+    int64_t total = 0;
+    for (size_t i = 0; i < shard_count(); ++i) {
+      total += m_shards[i]->load(std::memory_order_relaxed);
+    }
+    return total;
+  }
+
+  /**
+   * @brief 0に戻し、戻す前の合計を返す
+   * 加算と同時に呼んでも、加算された値はどちらかに必ず数えられます
+   */
+  int64_t reset() {
+    int64_t total = 0;
+    for (size_t i = 0; i < shard_count(); ++i) {
+      total += m_shards[i]->exchange(0, std::memory_order_relaxed);
+    }
+    return total;
+  }
+
+  void swap(ShardedCounter& other) {
+    using std::swap;
+    swap(m_shards, other.m_shards);
+    swap(m_mask, other.m_mask);
+  }
+
+ private:
+  explicit ShardedCounter(size_t shard_count)
+      : m_shards(std::make_unique<CachePadded<std::atomic<int64_t>>[]>(
+            shard_count)),
+        m_mask(shard_count - 1) {}
+
+  std::unique_ptr<CachePadded<std::atomic<int64_t>>[]> m_shards;
+  size_t m_mask = 0;
+};
+
+inline void swap(ShardedCounter& lhs, ShardedCounter& rhs) {
+  lhs.swap(rhs);
+}
+
+/**
+ * @brief スレッドごとのシャードに分けて値を集計するアキュムレーター
+ *
+ * ShardedCounterを任意の型と演算に広げたものです。
+ * 各シャードは値と小さなスピンロックをキャッシュライン1本に持ち、
+ * add()は現在のスレッドのシャードだけを更新します。
+ * シャードを共有するスレッドがいなければ、ロックは常に一度で取れます。
+ *
+ * sum()は単位元から始めて全シャードをOpで畳み込みます。
+ * Opは結合的かつ可換であること（加算、最大値、件数と合計の組など）。
+ * ムーブ元への操作は未定義です。
+ *
+ * @tparam T 集計する値の型
+ * @tparam Op 値を合わせる演算 T(const T&, const T&)
+ */
+template <typename T, typename Op = std::plus<T>>
+class ShardedAccumulator {
+ public:
+  /** @brief シャード数の既定値 */
+  static constexpr size_t DEFAULT_SHARD_COUNT = 64;
+
+  /**
+   * @brief 新しいShardedAccumulatorを作成
+   * @param identity 演算の単位元（各シャードの初期値、reset後の値）
+   * @param shard_count シャード数（2の累乗）
+   * @param op 値を合わせる演算
+   * @return 成功時: 作成されたShardedAccumulator、失敗時: エラー
+   */
+  static s6i_result::Result<ShardedAccumulator, SyncError> make(
+      T identity = T{},
+      size_t shard_count = DEFAULT_SHARD_COUNT,
+      Op op = Op{}) {
+    if (!detail::is_power_of_two(shard_count)) {
+      return s6i_result::make_err(SyncError::InvalidAccumulatorError);
+    }
+    return s6i_result::make_ok(
+        ShardedAccumulator(std::move(identity), shard_count, std::move(op)));
+  }
+
+  // コピー禁止
+  ShardedAccumulator(const ShardedAccumulator&) = delete;
+  ShardedAccumulator& operator=(const ShardedAccumulator&) = delete;
+
+  // ムーブ可能（操作中のムーブは未定義）
+  ShardedAccumulator(ShardedAccumulator&& other)
+      : m_shards(std::move(other.m_shards)),
+        m_mask(std::exchange(other.m_mask, 0)),
+        m_identity(std::move(other.m_identity)),
+        m_op(std::move(other.m_op)) {}
+
+  ShardedAccumulator& operator=(ShardedAccumulator&& other) {
+    ShardedAccumulator(std::move(other)).swap(*this);
+    return *this;
+  }
+
+  /** @brief 有効なアキュムレーターかどうか（ムーブ元は無効） */
+  bool is_valid() const { return m_shards != nullptr; }
+
+  /** @brief シャード数 */
+  size_t shard_count() const { return m_shards ? m_mask + 1 : 0; }
+
+  /**
+   * @brief 現在のスレッドのシャードに値を合わせる
+   * @param value 合わせる値
+   */
+  void add(const T& value) {
+    update([&](T& current) { current = m_op(current, value); });
+  }
+
+  /**
+   * @brief 現在のスレッドのシャードの値を直接書き換える
+   * @param f void(T&) シャードのロック中に呼ばれるため、短く済ませること
+   */
+  template <typename F>
+  void update(F&& f) {
+    assert(is_valid() && "ShardedAccumulator is not valid");
+    Shard& shard = *m_shards[detail::this_thread_index() & m_mask];
+    shard.lock();
+    std::forward<F>(f)(shard.m_value);
+    shard.unlock();
+  }
+
+  /** @brief 全シャードを畳み込んだ値 */
+  T sum() const {
+    T total = m_identity;
+    for (size_t i = 0; i < shard_count(); ++i) {
+      Shard& shard = *m_shards[i];
+      shard.lock();
+      total = m_op(total, shard.m_value);
+      shard.unlock();
+    }
+    return total;
+  }
+
+  /** @brief 全シャードを単位元に戻し、戻す前の値を畳み込んで返す */
+  T reset() {
+    T total = m_identity;
+    for (size_t i = 0; i < shard_count(); ++i) {
+      Shard& shard = *m_shards[i];
+      shard.lock();
+      total = m_op(total, shard.m_value);
+      shard.m_value = m_identity;
+      shard.unlock();
+    }
+    return total;
+  }
+
+  void swap(ShardedAccumulator& other) {
+    using std::swap;
+    swap(m_shards, other.m_shards);
+    swap(m_mask, other.m_mask);
+    swap(m_identity, other.m_identity);
+    swap(m_op, other.m_op);
+  }
+
+ private:
+  struct Shard {
+    void lock() {
+      Backoff backoff;
+      while (m_locked.exchange(true, std::memory_order_acquire)) {
+        while (m_locked.load(std::memory_order_relaxed)) {
+          backoff.snooze();
+        }
+      }
+    }
+
+    void unlock() { m_locked.store(false, std::memory_order_release); }
+
+    std::atomic<bool> m_locked{false};
+    T m_value;
+  };
+
+  ShardedAccumulator(T identity, size_t shard_count, Op op)
+      : m_shards(std::make_unique<CachePadded<Shard>[]>(shard_count)),
+        m_mask(shard_count - 1),
+        m_identity(std::move(identity)),
+        m_op(std::move(op)) {
+    for (size_t i = 0; i < shard_count; ++i) {
+      m_shards[i]->m_value = m_identity;
+    }
+  }
+
+  std::unique_ptr<CachePadded<Shard>[]> m_shards;
+  size_t m_mask = 0;
+  T m_identity;
+  Op m_op;
+};
+
+template <typename T, typename Op>
+inline void swap(ShardedAccumulator<T, Op>& lhs,
+                 ShardedAccumulator<T, Op>& rhs) {
+  lhs.swap(rhs);
+}
+
+}  // namespace s6i_sync
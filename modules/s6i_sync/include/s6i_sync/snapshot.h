@@ -0,0 +1,195 @@
+#pragma once
+
+#include <s6i_result/result.h>
+#include <atomic>
+#include <cstdint>
+#include <utility>
+#include <vector>
+#include "epoch.h"
+#include "error.h"
+#include "mutex_policy.h"
+
+namespace s6i_sync {
+
+template <typename T>
+class SnapshotGuard;
+
+/**
+ * @brief ポインタの差し替えで値を公開するRCU風のセル
+ *
+ * 書き込み側は新しい値を確保してポインタを差し替え、
+ * 古い値はそれを読んでいるスレッドがいなくなってから解放します（epoch.h）。
+ * 読み込み側はロックを取らず、共有データへも書き込みません。
+ * SeqLockと違い、Tはトリビアルコピー可能でなくても構いません。
+ *
+ * @tparam T 保持する値の型
+ */
+template <typename T>
+class Snapshot {
+ public:
+  /**
+   * @brief 新しいSnapshotを作成
+   * @param args Tのコンストラクタに渡す引数
+   * @return 常に成功
+   */
+  template <typename... Args>
+  static s6i_result::Result<Snapshot, SyncError> make(Args&&... args) {
+    return s6i_result::make_ok(Snapshot(new T(std::forward<Args>(args)...)));
+  }
+
+  // コピー禁止
+  Snapshot(const Snapshot&) = delete;
+  Snapshot& operator=(const Snapshot&) = delete;
+
+  // ムーブ可能（読み書き中のムーブは未定義）
+  Snapshot(Snapshot&& other)
+      : m_current(other.m_current.exchange(nullptr, std::memory_order_acq_rel)),
+        m_retired(std::move(other.m_retired)) {}
+
+  Snapshot& operator=(Snapshot&& other) {
+    Snapshot(std::move(other)).swap(*this);
+    return *this;
+  }
+
+  /**
+   * @brief 破棄する
+   * 読み込み中のスレッドがいないことは呼び出し側が保証します
+   */
+  ~Snapshot() {
+    delete m_current.load(std::memory_order_acquire);
+    for (auto& retired : m_retired) {
+      delete retired.m_value;
+    }
+  }
+
+  /**
+   * @brief 現在の値への読み取り専用アクセスを提供
+   * ガードが生きている間、値は解放されません
+   * @return 成功時: SnapshotGuard、失敗時: エラー
+   */
+  s6i_result::Result<SnapshotGuard<T>, SyncError> read() const {
+    epoch::Guard pin = epoch::pin();
+    const T* value = m_current.load(std::memory_order_seq_cst);
+    if (!value) {
+      return s6i_result::make_err(SyncError::InvalidSnapshotError);
+    }
+    return s6i_result::make_ok(SnapshotGuard<T>(std::move(pin), value));
+  }
+
+  /**
+   * @brief 新しい値を公開する
+   * @param args Tのコンストラクタに渡す引数
+   * @return 成功時: void、失敗時: エラー
+   */
+  template <typename... Args>
+  s6i_result::Result<void, SyncError> publish(Args&&... args) {
+    if (!m_writer.is_valid() || !m_current.load(std::memory_order_relaxed)) {
+      return s6i_result::make_err(SyncError::InvalidSnapshotError);
+    }
+    T* next = new T(std::forward<Args>(args)...);
+    m_writer.lock();
+    replace(next);
+    m_writer.unlock();
+    return s6i_result::make_ok();
+  }
+
+  /**
+   * @brief 現在の値のコピーを書き換えて公開する
+   * @param f void(T&) 値を書き換える関数
+   * @return 成功時: void、失敗時: エラー
+   */
+  template <typename F>
+  s6i_result::Result<void, SyncError> update(F&& f) {
+    if (!m_writer.is_valid() || !m_current.load(std::memory_order_relaxed)) {
+      return s6i_result::make_err(SyncError::InvalidSnapshotError);
+    }
+    m_writer.lock();
+    T* next = new T(*m_current.load(std::memory_order_relaxed));
+    std::forward<F>(f)(*next);
+    replace(next);
+    m_writer.unlock();
+    return s6i_result::make_ok();
+  }
+
+  /** @brief 解放待ちの古い値の数 */
+  size_t retired_count() {
+    m_writer.lock();
+    const size_t count = m_retired.size();
+    m_writer.unlock();
+    return count;
+  }
+
+  void swap(Snapshot& other) {
+    using std::swap;
+    T* current = m_current.load(std::memory_order_relaxed);
+    m_current.store(other.m_current.load(std::memory_order_relaxed),
+                    std::memory_order_relaxed);
+    other.m_current.store(current, std::memory_order_relaxed);
+    swap(m_retired, other.m_retired);
+  }
+
+ private:
+  struct Retired {
+    T* m_value;
+    uint64_t m_epoch;
+  };
+
+  explicit Snapshot(T* value) : m_current(value) {}
+
+  /** @brief ポインタを差し替え、解放できる古い値を解放（m_writerのロック中） */
+  void replace(T* next) {
+    T* prev = m_current.exchange(next, std::memory_order_seq_cst);
+    m_retired.push_back({prev, epoch::advance()});
+
+    size_t kept = 0;
+    for (auto& retired : m_retired) {
+      if (epoch::is_quiescent(retired.m_epoch)) {
+        delete retired.m_value;
+      } else {
+        m_retired[kept++] = retired;
+      }
+    }
+    m_retired.resize(kept);
+  }
+
+  std::atomic<T*> m_current{nullptr};
+  std::vector<Retired> m_retired;
+  SpinMutexPolicy m_writer = SpinMutexPolicy::make().unwrap();
+};
+
+template <typename T>
+inline void swap(Snapshot<T>& lhs, Snapshot<T>& rhs) {
+  lhs.swap(rhs);
+}
+
+/**
+ * @brief Snapshotの値を読んでいる間、その値を解放させないガードクラス
+ * @tparam T 保持する値の型
+ */
+template <typename T>
+class SnapshotGuard {
+ public:
+  SnapshotGuard(SnapshotGuard&& other)
+      : m_pin(std::move(other.m_pin)), m_value(other.m_value) {
+    other.m_value = nullptr;
+  }
+
+  // コピー禁止
+  SnapshotGuard(const SnapshotGuard&) = delete;
+  SnapshotGuard& operator=(const SnapshotGuard&) = delete;
+  SnapshotGuard& operator=(SnapshotGuard&&) = delete;
+
+  const T& operator*() const { return *m_value; }
+  const T* operator->() const { return m_value; }
+
+ private:
+  SnapshotGuard(epoch::Guard&& pin, const T* value)
+      : m_pin(std::move(pin)), m_value(value) {}
+
+  epoch::Guard m_pin;
+  const T* m_value = nullptr;
+
+  friend class Snapshot<T>;
+};
+
+}  // namespace s6i_sync
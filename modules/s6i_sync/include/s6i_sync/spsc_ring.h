@@ -0,0 +1,435 @@
+#pragma once
+
+#include <SDL.h>
+#include <s6i_log/log.h>
+#include <s6i_result/result.h>
+#include <s6i_result/try.h>
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <optional>
+#include <utility>
+#include <variant>
+#include "backoff.h"
+#include "cond_var.h"
+#include "error.h"
+#include "mutex.h"
+
+namespace s6i_sync {
+
+/**
+ * @brief SpscRingの待ち方
+ */
+enum class RingMode {
+  Polling,   ///< 空・満杯のときは失敗を返すだけ（try系のみ）
+  Blocking,  ///< 空・満杯のときはCondVarで待てる（wait系も使える）
+};
+
+/**
+ * @brief 1生産者・1消費者の固定長リングバッファ
+ *
+ * 生産者はtailだけを、消費者はheadだけを書き換えるため、
+ * ロックもCASも使わず、各操作は待ちなしで終わります。
+ * headとtailは別のキャッシュラインに置き、
+ * 相手側の位置は手元にキャッシュして、必要なときだけ読み直します。
+ *
+ * push_n/pop_nでまとめて受け渡すと、位置の公開が1回で済みます。
+ *
+ * Blockingモードでは、空・満杯のときだけCondVarで眠ります。
+ * 相手が眠っていないときの追加コストはフェンス1回とフラグの読み込みだけです。
+ *
+ * 生産者・消費者はそれぞれ1スレッドに限ります。
+ *
+ * @tparam T 要素の型
+ * @tparam N 容量（2の累乗）
+ * @tparam Mode 待ち方
+ */
+template <typename T, size_t N, RingMode Mode = RingMode::Polling>
+class SpscRing {
+  static_assert(N >= 2 && (N & (N - 1)) == 0,
+                "SpscRing capacity must be a power of two");
+
+ public:
+  /**
+   * @brief 新しいSpscRingを作成
+   * @return 成功時: 作成されたSpscRing、失敗時: エラー
+   */
+  static s6i_result::Result<SpscRing, SyncError> make() {
+    std::unique_ptr<Waiter> waiter;
+    if constexpr (Mode == RingMode::Blocking) {
+      S6I_TRY_ASSIGN(auto mutex, Mutex<std::monostate>::make());
+      S6I_TRY_ASSIGN(auto cond, CondVar::make());
+      waiter.reset(new Waiter{std::move(mutex), std::move(cond)});
+    }
+    return s6i_result::make_ok(SpscRing(std::move(waiter)));
+  }
+
+  // コピー禁止
+  SpscRing(const SpscRing&) = delete;
+  SpscRing& operator=(const SpscRing&) = delete;
+
+  // ムーブ可能（読み書き中のムーブは未定義）
+  SpscRing(SpscRing&& other)
+      : m_tail(other.m_tail.load(std::memory_order_relaxed)),
+        m_cached_head(other.m_cached_head),
+        m_head(other.m_head.load(std::memory_order_relaxed)),
+        m_cached_tail(other.m_cached_tail),
+        m_waiting(other.m_waiting.load(std::memory_order_relaxed)),
+        m_slots(std::move(other.m_slots)),
+        m_waiter(std::move(other.m_waiter)) {
+    other.m_tail.store(0, std::memory_order_relaxed);
+    other.m_head.store(0, std::memory_order_relaxed);
+    other.m_waiting.store(0, std::memory_order_relaxed);
+    other.m_cached_head = 0;
+    other.m_cached_tail = 0;
+  }
+
+  SpscRing& operator=(SpscRing&& other) {
+    SpscRing(std::move(other)).swap(*this);
+    return *this;
+  }
+
+  ~SpscRing() {
+    if (!m_slots) {
+      return;
+    }
+    const size_t tail = m_tail.load(std::memory_order_relaxed);
+    for (size_t i = m_head.load(std::memory_order_relaxed); i != tail; ++i) {
+      slot(i)->~T();
+    }
+  }
+
+  /** @brief 容量 */
+  static constexpr size_t capacity() { return N; }
+
+  /** @brief おおよその要素数 */
+  size_t size() const {
+    return m_tail.load(std::memory_order_acquire) -
+           m_head.load(std::memory_order_acquire);
+  }
+
+  bool empty() const { return size() == 0; }
+
+  /**
+   * @brief 要素を1つ積む（生産者のみ）
+   * @param value 積む値（失敗時はムーブされません）
+   * @return 満杯ならfalse
+   */
+  bool try_push(T&& value) { return try_emplace(std::move(value)); }
+  bool try_push(const T& value) { return try_emplace(value); }
+
+  /**
+   * @brief 要素を直接構築して積む（生産者のみ）
+   * @return 満杯ならfalse
+   */
+  template <typename... Args>
+  bool try_emplace(Args&&... args) {
+    if (!m_slots) {
+      return false;
+    }
+    const size_t tail = m_tail.load(std::memory_order_relaxed);
+    if (tail - m_cached_head >= N) {
+      m_cached_head = m_head.load(std::memory_order_acquire);
+      if (tail - m_cached_head >= N) {
+        return false;
+      }
+    }
+    new (slot(tail)) T(std::forward<Args>(args)...);
+    m_tail.store(tail + 1, std::memory_order_release);
+    notify(CONSUMER_WAITING);
+    return true;
+  }
+
+  /**
+   * @brief 要素をまとめて積む（生産者のみ）
+   * @param items 積む値の配列（コピーされます）
+   * @param count 要素数
+   * @return 積めた要素数（空きが足りなければcountより少ない）
+   */
+  size_t push_n(const T* items, size_t count) {
+    if (!m_slots) {
+      return 0;
+    }
+    const size_t tail = m_tail.load(std::memory_order_relaxed);
+    if (N - (tail - m_cached_head) < count) {
+      m_cached_head = m_head.load(std::memory_order_acquire);
+    }
+    const size_t n = std::min(count, N - (tail - m_cached_head));
+    if (n == 0) {
+      return 0;
+    }
+    for (size_t i = 0; i < n; ++i) {
+      new (slot(tail + i)) T(items[i]);
+    }
+    m_tail.store(tail + n, std::memory_order_release);
+    notify(CONSUMER_WAITING);
+    return n;
+  }
+
+  /**
+   * @brief 要素を1つ取り出す（消費者のみ）
+   * @return 取り出した値、空ならstd::nullopt
+   */
+  std::optional<T> try_pop() {
+    if (!m_slots) {
+      return std::nullopt;
+    }
+    const size_t head = m_head.load(std::memory_order_relaxed);
+    if (head == m_cached_tail) {
+      m_cached_tail = m_tail.load(std::memory_order_acquire);
+      if (head == m_cached_tail) {
+        return std::nullopt;
+      }
+    }
+    T* item = slot(head);
+    std::optional<T> value(std::move(*item));
+    item->~T();
+    m_head.store(head + 1, std::memory_order_release);
+    notify(PRODUCER_WAITING);
+    return value;
+  }
+
+  /**
+   * @brief 要素をまとめて取り出す（消費者のみ）
+   * @param out 取り出した値の格納先（ムーブ代入されます）
+   * @param max_count 取り出す最大数
+   * @return 取り出した要素数
+   */
+  size_t pop_n(T* out, size_t max_count) {
+    if (!m_slots) {
+      return 0;
+    }
+    const size_t head = m_head.load(std::memory_order_relaxed);
+    if (m_cached_tail - head < max_count) {
+      m_cached_tail = m_tail.load(std::memory_order_acquire);
+    }
+    const size_t n = std::min(max_count, m_cached_tail - head);
+    if (n == 0) {
+      return 0;
+    }
+    for (size_t i = 0; i < n; ++i) {
+      T* item = slot(head + i);
+      out[i] = std::move(*item);
+      item->~T();
+    }
+    m_head.store(head + n, std::memory_order_release);
+    notify(PRODUCER_WAITING);
+    return n;
+  }
+
+  /**
+   * @brief 空きができるまで待ってから要素を積む（生産者のみ、Blockingモード）
+   * @param value 積む値
+   * @return 成功時: void、失敗時: エラー
+   */
+  s6i_result::Result<void, SyncError> wait_push(T value) {
+    static_assert(Mode == RingMode::Blocking,
+                  "wait_push requires RingMode::Blocking");
+    if (!m_slots) {
+      return s6i_result::make_err(SyncError::InvalidRingError);
+    }
+    Backoff backoff;
+    while (!try_emplace(std::move(value))) {
+      S6I_TRY(
+          wait(backoff, PRODUCER_WAITING, [this]() { return !is_full(); }));
+    }
+    return s6i_result::make_ok();
+  }
+
+  /**
+   * @brief すべて積み終わるまで待ちながら要素を積む（生産者のみ、Blockingモード）
+   * @param items 積む値の配列（コピーされます）
+   * @param count 要素数
+   * @return 成功時: void、失敗時: エラー
+   */
+  s6i_result::Result<void, SyncError> wait_push_n(const T* items,
+                                                  size_t count) {
+    static_assert(Mode == RingMode::Blocking,
+                  "wait_push_n requires RingMode::Blocking");
+    if (!m_slots) {
+      return s6i_result::make_err(SyncError::InvalidRingError);
+    }
+    Backoff backoff;
+    for (;;) {
+      const size_t n = push_n(items, count);
+      items += n;
+      count -= n;
+      if (count == 0) {
+        return s6i_result::make_ok();
+      }
+      if (n > 0) {
+        backoff.reset();
+      }
+      S6I_TRY(
+          wait(backoff, PRODUCER_WAITING, [this]() { return !is_full(); }));
+    }
+  }
+
+  /**
+   * @brief 要素が届くまで待ってから1つ取り出す（消費者のみ、Blockingモード）
+   * @return 成功時: 取り出した値、失敗時: エラー
+   */
+  s6i_result::Result<T, SyncError> wait_pop() {
+    static_assert(Mode == RingMode::Blocking,
+                  "wait_pop requires RingMode::Blocking");
+    if (!m_slots) {
+      return s6i_result::make_err(SyncError::InvalidRingError);
+    }
+    Backoff backoff;
+    for (;;) {
+      if (auto value = try_pop()) {
+        return s6i_result::make_ok(std::move(*value));
+      }
+      S6I_TRY(
+          wait(backoff, CONSUMER_WAITING, [this]() { return !is_drained(); }));
+    }
+  }
+
+  /**
+   * @brief 要素が1つ以上届くまで待ってから、まとめて取り出す
+   * （消費者のみ、Blockingモード）
+   * @param out 取り出した値の格納先（ムーブ代入されます）
+   * @param max_count 取り出す最大数（1以上）
+   * @return 成功時: 取り出した要素数、失敗時: エラー
+   */
+  s6i_result::Result<size_t, SyncError> wait_pop_n(T* out, size_t max_count) {
+    static_assert(Mode == RingMode::Blocking,
+                  "wait_pop_n requires RingMode::Blocking");
+    if (!m_slots) {
+      return s6i_result::make_err(SyncError::InvalidRingError);
+    }
+    Backoff backoff;
+    for (;;) {
+      if (const size_t n = pop_n(out, max_count); n > 0) {
+        return s6i_result::make_ok(n);
+      }
+      S6I_TRY(
+          wait(backoff, CONSUMER_WAITING, [this]() { return !is_drained(); }));
+    }
+  }
+
+  void swap(SpscRing& other) {
+    using std::swap;
+    const size_t tail = m_tail.load(std::memory_order_relaxed);
+    m_tail.store(other.m_tail.load(std::memory_order_relaxed),
+                 std::memory_order_relaxed);
+    other.m_tail.store(tail, std::memory_order_relaxed);
+    const size_t head = m_head.load(std::memory_order_relaxed);
+    m_head.store(other.m_head.load(std::memory_order_relaxed),
+                 std::memory_order_relaxed);
+    other.m_head.store(head, std::memory_order_relaxed);
+    swap(m_cached_head, other.m_cached_head);
+    swap(m_cached_tail, other.m_cached_tail);
+    swap(m_slots, other.m_slots);
+    swap(m_waiter, other.m_waiter);
+    const uint32_t waiting = m_waiting.load(std::memory_order_relaxed);
+    m_waiting.store(other.m_waiting.load(std::memory_order_relaxed),
+                    std::memory_order_relaxed);
+    other.m_waiting.store(waiting, std::memory_order_relaxed);
+  }
+
+ private:
+  /** @brief 要素1つ分の未初期化領域 */
+  struct Slot {
+    alignas(T) unsigned char m_bytes[sizeof(T)];
+  };
+
+  /** @brief Blockingモードで眠るためのロックと条件変数 */
+  struct Waiter {
+    Mutex<std::monostate> m_mutex;
+    CondVar m_cond;
+  };
+
+  static constexpr uint32_t PRODUCER_WAITING = 1;
+  static constexpr uint32_t CONSUMER_WAITING = 2;
+
+  explicit SpscRing(std::unique_ptr<Waiter>&& waiter)
+      : m_slots(std::make_unique<Slot[]>(N)), m_waiter(std::move(waiter)) {}
+
+  T* slot(size_t index) const {
+    return std::launder(
+        reinterpret_cast<T*>(m_slots[index & (N - 1)].m_bytes));
+  }
+
+  bool is_full() const {
+    return m_tail.load(std::memory_order_relaxed) -
+               m_head.load(std::memory_order_acquire) >=
+           N;
+  }
+
+  bool is_drained() const {
+    return m_head.load(std::memory_order_relaxed) ==
+           m_tail.load(std::memory_order_acquire);
+  }
+
+  /**
+   * @brief 相手側を待つ
+   * しばらくスピンし、それでも進まなければ待機中の印を付けてCondVarで眠る。
+   * 印を付けた後に条件を確かめ直すことで、相手側のnotifyとの行き違いを防ぐ
+   */
+  template <typename Ready>
+  s6i_result::Result<void, SyncError> wait(Backoff& backoff,
+                                           uint32_t bit,
+                                           Ready&& ready) {
+    if (!backoff.is_completed()) {
+      backoff.snooze();
+      return s6i_result::make_ok();
+    }
+    S6I_TRY_ASSIGN(auto guard, m_waiter->m_mutex.lock());
+    m_waiting.fetch_or(bit, std::memory_order_seq_cst);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    while (!ready()) {
+      auto wait_result = m_waiter->m_cond.wait(guard);
+      if (wait_result.is_err()) {
+        m_waiting.fetch_and(~bit, std::memory_order_relaxed);
+        return wait_result;
+      }
+    }
+    m_waiting.fetch_and(~bit, std::memory_order_relaxed);
+    backoff.reset();
+    return s6i_result::make_ok();
+  }
+
+  /** @brief 眠っている相手側を起こす（Blockingモードのみ） */
+  void notify(uint32_t bit) {
+    if constexpr (Mode == RingMode::Blocking) {
+      std::atomic_thread_fence(std::memory_order_seq_cst);
+      if (!(m_waiting.load(std::memory_order_relaxed) & bit)) {
+        return;
+      }
+      auto guard_result = m_waiter->m_mutex.lock();
+      if (guard_result.is_err()) {
+        S6I_LOG_ERROR(SDL_LOG_CATEGORY_SYSTEM,
+                      "Failed to lock ring waiter mutex.");
+        return;
+      }
+      auto guard = guard_result.unwrap();
+      if (m_waiter->m_cond.broadcast(guard).is_err()) {
+        S6I_LOG_ERROR(SDL_LOG_CATEGORY_SYSTEM, "Failed to wake ring waiter.");
+      }
+    } else {
+      (void)bit;
+    }
+  }
+
+  // 生産者側のキャッシュライン
+  alignas(64) std::atomic<size_t> m_tail{0};
+  size_t m_cached_head = 0;
+  // 消費者側のキャッシュライン
+  alignas(64) std::atomic<size_t> m_head{0};
+  size_t m_cached_tail = 0;
+  // 待機中の印（Blockingモードのみ使う）
+  alignas(64) std::atomic<uint32_t> m_waiting{0};
+  std::unique_ptr<Slot[]> m_slots;
+  std::unique_ptr<Waiter> m_waiter;
+};
+
+template <typename T, size_t N, RingMode Mode>
+inline void swap(SpscRing<T, N, Mode>& lhs, SpscRing<T, N, Mode>& rhs) {
+  lhs.swap(rhs);
+}
+
+}  // namespace s6i_sync
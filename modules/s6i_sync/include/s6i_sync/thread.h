@@ -0,0 +1,221 @@
+#pragma once
+
+#include <SDL.h>
+#include <s6i_log/log.h>
+#include <s6i_result/result.h>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <type_traits>
+#include <utility>
+#include "error.h"
+
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace s6i_sync {
+
+/** @brief m_affinity_maskで指定できるCPUの数（CPU 0〜63） */
+inline constexpr uint32_t MAX_AFFINITY_CPU_COUNT = 64;
+
+/**
+ * @brief スレッドの作成設定
+ */
+struct ThreadDesc {
+  /** @brief スレッド名（デバッガやプロファイラに表示される） */
+  const char* m_name = "s6i_thread";
+  /** @brief スタックサイズ（0はSDLの既定値） */
+  size_t m_stack_size = 0;
+  /** @brief スレッドの優先度 */
+  SDL_ThreadPriority m_priority = SDL_THREAD_PRIORITY_NORMAL;
+  /**
+   * @brief 実行を許可するCPUのビットマスク（0は固定しない）
+   * ビットiがCPU iに対応するため、CPU 64以降には固定できません。
+   * 現状はLinuxでのみ有効です。
+   */
+  uint64_t m_affinity_mask = 0;
+};
+
+namespace detail {
+
+/**
+ * @brief 現在のスレッドを指定したCPUに固定する
+ * @param mask 実行を許可するCPUのビットマスク
+ * @return 固定できた場合はtrue
+ */
+inline bool set_current_thread_affinity(uint64_t mask) {
+#if defined(__linux__)
+  cpu_set_t set;
+  CPU_ZERO(&set);
+  for (uint32_t cpu = 0; cpu < MAX_AFFINITY_CPU_COUNT; ++cpu) {
+    if (mask & (uint64_t{1} << cpu)) {
+      CPU_SET(cpu, &set);
+    }
+  }
+  return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+#else
+  (void)mask;
+  return false;
+#endif
+}
+
+/** @brief スレッドの戻り値の格納先 */
+template <typename R>
+struct ThreadResult {
+  virtual ~ThreadResult() = default;
+
+  std::optional<std::conditional_t<std::is_void_v<R>, char, R>> m_result;
+};
+
+/**
+ * @brief スレッドに渡す関数と戻り値の格納先
+ * Threadが保持し、join後に破棄します
+ */
+template <typename R, typename F>
+struct ThreadState : ThreadResult<R> {
+  ThreadState(const ThreadDesc& desc, F&& f)
+      : m_priority(desc.m_priority),
+        m_affinity_mask(desc.m_affinity_mask),
+        m_func(std::move(f)) {}
+
+  static int entry(void* data) {
+    auto* state = static_cast<ThreadState*>(data);
+    if (state->m_priority != SDL_THREAD_PRIORITY_NORMAL &&
+        SDL_SetThreadPriority(state->m_priority) < 0) {
+      S6I_LOG_WARN(SDL_LOG_CATEGORY_SYSTEM, "Failed to set thread priority: %s",
+                   SDL_GetError());
+    }
+    if (state->m_affinity_mask != 0 &&
+        !set_current_thread_affinity(state->m_affinity_mask)) {
+      S6I_LOG_WARN(SDL_LOG_CATEGORY_SYSTEM, "Failed to set thread affinity.");
+    }
+    if constexpr (std::is_void_v<R>) {
+      state->m_func();
+      state->m_result.emplace();
+    } else {
+      state->m_result.emplace(state->m_func());
+    }
+    return 0;
+  }
+
+  SDL_ThreadPriority m_priority;
+  uint64_t m_affinity_mask;
+  F m_func;
+};
+
+}  // namespace detail
+
+/**
+ * @brief SDL_Threadを所有するスレッドクラス
+ *
+ * 破棄時に終了していなければjoinします。
+ * 関数の戻り値はjoin()で受け取ります。
+ *
+ * @tparam R スレッドで実行する関数の戻り値の型
+ */
+template <typename R = void>
+class Thread {
+ public:
+  /**
+   * @brief 新しいスレッドを作成して実行を開始
+   * @param desc 作成設定
+   * @param f スレッドで実行する関数（引数なし、Rを返す）
+   * @return 成功時: 作成されたスレッド、失敗時: エラー
+   */
+  template <typename F>
+  static s6i_result::Result<Thread, SyncError> make(const ThreadDesc& desc,
+                                                    F&& f) {
+    using State = detail::ThreadState<R, std::decay_t<F>>;
+    static_assert(std::is_same_v<std::invoke_result_t<std::decay_t<F>&>, R>,
+                  "Thread function must return R");
+
+    auto state =
+        std::make_unique<State>(desc, std::decay_t<F>(std::forward<F>(f)));
+    SDL_Thread* thread = SDL_CreateThreadWithStackSize(
+        &State::entry, desc.m_name, desc.m_stack_size, state.get());
+    S6I_LOG_INFO(SDL_LOG_CATEGORY_SYSTEM, "Create thread: %s", desc.m_name);
+    if (!thread) {
+      S6I_LOG_ERROR(SDL_LOG_CATEGORY_SYSTEM, "Failed to create thread: %s",
+                    SDL_GetError());
+      return s6i_result::make_err(SyncError::ThreadCreationError);
+    }
+    return s6i_result::make_ok(Thread(thread, std::move(state)));
+  }
+
+  // コピー禁止
+  Thread(const Thread&) = delete;
+  Thread& operator=(const Thread&) = delete;
+
+  // ムーブ可能
+  Thread(Thread&& other)
+      : m_thread(other.m_thread), m_state(std::move(other.m_state)) {
+    other.m_thread = nullptr;
+  }
+
+  Thread& operator=(Thread&& other) {
+    Thread(std::move(other)).swap(*this);
+    return *this;
+  }
+
+  ~Thread() {
+    if (m_thread) {
+      SDL_WaitThread(m_thread, nullptr);
+    }
+  }
+
+  /**
+   * @brief スレッドの終了を待ち、戻り値を受け取る
+   * @return 成功時: 関数の戻り値、失敗時: エラー
+   */
+  s6i_result::Result<R, SyncError> join() {
+    if (!m_thread) {
+      return s6i_result::make_err(SyncError::InvalidThreadError);
+    }
+    SDL_WaitThread(m_thread, nullptr);
+    m_thread = nullptr;
+    auto state = std::move(m_state);
+    if (!state || !state->m_result) {
+      return s6i_result::make_err(SyncError::ThreadJoinError);
+    }
+    if constexpr (std::is_void_v<R>) {
+      return s6i_result::make_ok();
+    } else {
+      return s6i_result::make_ok(std::move(*state->m_result));
+    }
+  }
+
+  /** @brief 実行中（join前）のスレッドかどうか */
+  bool is_joinable() const { return m_thread != nullptr; }
+
+  /** @brief SDLのスレッドID（無効なスレッドでは0） */
+  SDL_threadID id() const { return m_thread ? SDL_GetThreadID(m_thread) : 0; }
+
+  /** @brief スレッド名（無効なスレッドではnullptr） */
+  const char* name() const {
+    return m_thread ? SDL_GetThreadName(m_thread) : nullptr;
+  }
+
+  void swap(Thread& other) {
+    using std::swap;
+    swap(m_thread, other.m_thread);
+    swap(m_state, other.m_state);
+  }
+
+ private:
+  Thread(SDL_Thread* thread,
+         std::unique_ptr<detail::ThreadResult<R>>&& state)
+      : m_thread(thread), m_state(std::move(state)) {}
+
+  SDL_Thread* m_thread = nullptr;
+  std::unique_ptr<detail::ThreadResult<R>> m_state;
+};
+
+template <typename R>
+inline void swap(Thread<R>& lhs, Thread<R>& rhs) {
+  lhs.swap(rhs);
+}
+
+}  // namespace s6i_sync
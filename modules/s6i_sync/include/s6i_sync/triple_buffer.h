@@ -0,0 +1,166 @@
+#pragma once
+
+#include <s6i_result/result.h>
+#include <atomic>
+#include <cstdint>
+#include <type_traits>
+#include <utility>
+#include "error.h"
+
+namespace s6i_sync {
+
+/**
+ * @brief 1書き込み・1読み込みで最新の値だけを受け渡す三重バッファ
+ *
+ * 書き込み側の作業用（back）、読み込み側の表示用（front）、
+ * 受け渡し用（middle）の3つの値を持ち、公開と取得はどちらも
+ * middleとの添字の交換1回で終わります。どちらの側も相手を待たず、
+ * 読み込み側は取りこぼした途中の値を飛ばして常に最新の値を受け取ります。
+ *
+ * シミュレーションの状態を描画スレッドへ渡すなど、
+ * 毎フレーム丸ごと書き換える値を想定しています。
+ * 値はコピーせず、書き込み側は前に公開した値とは限らない
+ * backをそのまま書き換えます（必要なら全体を書き直してください）。
+ *
+ * 書き込み側・読み込み側はそれぞれ1スレッドに限ります。
+ *
+ * @tparam T 受け渡す値の型（コピー構築可能であること）
+ */
+template <typename T>
+class TripleBuffer {
+  static_assert(std::is_copy_constructible_v<T>,
+                "TripleBuffer requires a copy constructible type");
+
+ public:
+  /**
+   * @brief 新しいTripleBufferを作成
+   * 3つの値はすべてT(args...)のコピーで初期化されます
+   * @param args Tのコンストラクタに渡す引数
+   * @return 常に成功
+   */
+  template <typename... Args>
+  static s6i_result::Result<TripleBuffer, SyncError> make(Args&&... args) {
+    return s6i_result::make_ok(TripleBuffer(T(std::forward<Args>(args)...)));
+  }
+
+  // コピー禁止
+  TripleBuffer(const TripleBuffer&) = delete;
+  TripleBuffer& operator=(const TripleBuffer&) = delete;
+
+  // ムーブ可能（読み書き中のムーブは未定義）
+  TripleBuffer(TripleBuffer&& other)
+      : m_slots{Slot(std::move(other.m_slots[0].m_value)),
+                Slot(std::move(other.m_slots[1].m_value)),
+                Slot(std::move(other.m_slots[2].m_value))},
+        m_back(other.m_back),
+        m_middle(other.m_middle.load(std::memory_order_relaxed)),
+        m_front(other.m_front) {}
+
+  TripleBuffer& operator=(TripleBuffer&& other) {
+    TripleBuffer(std::move(other)).swap(*this);
+    return *this;
+  }
+
+  // --- 書き込み側 ---
+
+  /**
+   * @brief 書き込み側の作業用の値
+   * publish()するまで読み込み側からは見えません
+   */
+  T& back() { return m_slots[m_back].m_value; }
+
+  /**
+   * @brief back()を公開し、空いている値を次のback()にする
+   * まだ読まれていない前回の値は上書きされます
+   */
+  void publish() {
+    // backの書き込みを読み込み側へ渡し（release）、
+    // 読み込み側が手放した値の読み込みが済んでから書き換える（acquire）
+    const uint8_t prev =
+        m_middle.exchange(m_back | DIRTY, std::memory_order_acq_rel);
+    m_back = prev & INDEX_MASK;
+  }
+
+  /**
+   * @brief 値を書き込んで公開する
+   * @param value 新しい値
+   */
+  void write(const T& value) {
+    back() = value;
+    publish();
+  }
+
+  // --- 読み込み側 ---
+
+  /**
+   * @brief 新しく公開された値があればfront()にする
+   * @return front()が新しい値になった場合はtrue
+   */
+  bool fetch() {
+    if (!(m_middle.load(std::memory_order_relaxed) & DIRTY)) {
+      return false;
+    }
+    const uint8_t prev = m_middle.exchange(m_front, std::memory_order_acq_rel);
+    m_front = prev & INDEX_MASK;
+    return true;
+  }
+
+  /**
+   * @brief 読み込み側の値（最後にfetch()した値）
+   * 次にfetch()するまで書き換えられません
+   */
+  const T& front() const { return m_slots[m_front].m_value; }
+
+  /**
+   * @brief fetch()してから最新の値を返す
+   */
+  const T& read() {
+    fetch();
+    return front();
+  }
+
+  /** @brief 読み込み側がまだ受け取っていない値があるかどうか */
+  bool has_update() const {
+    return (m_middle.load(std::memory_order_relaxed) & DIRTY) != 0;
+  }
+
+  void swap(TripleBuffer& other) {
+    using std::swap;
+    for (int i = 0; i < SLOT_COUNT; ++i) {
+      swap(m_slots[i].m_value, other.m_slots[i].m_value);
+    }
+    swap(m_back, other.m_back);
+    const uint8_t middle = m_middle.load(std::memory_order_relaxed);
+    m_middle.store(other.m_middle.load(std::memory_order_relaxed),
+                   std::memory_order_relaxed);
+    other.m_middle.store(middle, std::memory_order_relaxed);
+    swap(m_front, other.m_front);
+  }
+
+ private:
+  static constexpr int SLOT_COUNT = 3;
+  static constexpr uint8_t INDEX_MASK = 0x3;
+  static constexpr uint8_t DIRTY = 0x4;  ///< middleがまだ読まれていない
+
+  // 書き込み側と読み込み側が同時に触る値を別のキャッシュラインに置く
+  struct Slot {
+    explicit Slot(const T& value) : m_value(value) {}
+    explicit Slot(T&& value) : m_value(std::move(value)) {}
+    alignas(64) T m_value;
+  };
+
+  explicit TripleBuffer(const T& value)
+      : m_slots{Slot(value), Slot(value), Slot(value)} {}
+
+  Slot m_slots[SLOT_COUNT];
+  alignas(64) uint8_t m_back = 0;   ///< 書き込み側だけが触る
+  alignas(64) std::atomic<uint8_t> m_middle{1};
+  alignas(64) uint8_t m_front = 2;  ///< 読み込み側だけが触る
+};
+
+template <typename T>
+inline void swap(TripleBuffer<T>& lhs, TripleBuffer<T>& rhs) {
+  lhs.swap(rhs);
+}
+
+}  // namespace s6i_sync
@@ -0,0 +1,71 @@
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include "pch.h"
+
+namespace {
+
+using namespace s6i_sync;
+
+TEST(BarrierTest, BasicFunctionality) {
+  auto barrier_result = Barrier::make(1);
+  ASSERT_TRUE(barrier_result.is_ok());
+  auto barrier = std::move(barrier_result.unwrap());
+  EXPECT_EQ(barrier.count(), 1u);
+
+  // 1スレッドならすぐに進み、自分が最後の到着になる
+  auto arrive_result = barrier.arrive_and_wait();
+  ASSERT_TRUE(arrive_result.is_ok());
+  EXPECT_TRUE(arrive_result.unwrap());
+  EXPECT_EQ(barrier.generation(), 1u);
+
+  auto invalid_result = Barrier::make(0);
+  ASSERT_TRUE(invalid_result.is_err());
+  EXPECT_EQ(invalid_result.unwrap_err(), SyncError::InvalidBarrierError);
+}
+
+// フェーズごとに全員がそろってから次へ進み、最後の到着は毎回1つだけ
+TEST(BarrierTest, Phases) {
+  const uint32_t num_threads = 6;
+  const int num_phases = 500;
+  auto barrier = Barrier::make(num_threads).unwrap();
+  std::vector<std::atomic<uint32_t>> arrived(num_phases);
+  std::vector<std::atomic<uint32_t>> leaders(num_phases);
+
+  std::vector<std::thread> threads;
+  for (uint32_t t = 0; t < num_threads; ++t) {
+    threads.emplace_back([&]() {
+      for (int phase = 0; phase < num_phases; ++phase) {
+        ++arrived[phase];
+        auto arrive_result = barrier.arrive_and_wait();
+        ASSERT_TRUE(arrive_result.is_ok());
+        // 自分が進んだ時点で、全員がこのフェーズに到着している
+        ASSERT_EQ(arrived[phase].load(), num_threads);
+        if (arrive_result.unwrap()) {
+          ++leaders[phase];
+        }
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  for (int phase = 0; phase < num_phases; ++phase) {
+    EXPECT_EQ(leaders[phase].load(), 1u) << "phase " << phase;
+  }
+  EXPECT_EQ(barrier.generation(), static_cast<uint32_t>(num_phases));
+}
+
+TEST(BarrierTest, MoveSemantics) {
+  auto barrier1 = Barrier::make(1).unwrap();
+  Barrier barrier2 = std::move(barrier1);
+  EXPECT_FALSE(barrier1.is_valid());
+
+  auto invalid_result = barrier1.arrive_and_wait();
+  ASSERT_TRUE(invalid_result.is_err());
+  EXPECT_EQ(invalid_result.unwrap_err(), SyncError::InvalidBarrierError);
+  EXPECT_TRUE(barrier2.arrive_and_wait().is_ok());
+}
+
+}  // namespace
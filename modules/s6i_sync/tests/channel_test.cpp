@@ -0,0 +1,230 @@
+#include <atomic>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "pch.h"
+
+namespace {
+
+using namespace s6i_sync;
+
+TEST(ChannelTest, BasicFunctionality) {
+  auto channel_result = Channel<int>::make(4);
+  ASSERT_TRUE(channel_result.is_ok());
+  auto channel = std::move(channel_result.unwrap());
+  EXPECT_EQ(channel.capacity(), 4u);
+
+  for (int i = 0; i < 4; ++i) {
+    ASSERT_TRUE(channel.try_send(i).is_ok());
+  }
+  auto full_result = channel.try_send(4);
+  ASSERT_TRUE(full_result.is_err());
+  EXPECT_EQ(full_result.unwrap_err(), SyncError::ChannelFullError);
+  EXPECT_EQ(channel.size(), 4u);
+
+  for (int i = 0; i < 4; ++i) {
+    auto recv_result = channel.try_recv();
+    ASSERT_TRUE(recv_result.is_ok());
+    EXPECT_EQ(recv_result.unwrap(), i);
+  }
+  auto empty_result = channel.try_recv();
+  ASSERT_TRUE(empty_result.is_err());
+  EXPECT_EQ(empty_result.unwrap_err(), SyncError::ChannelEmptyError);
+}
+
+// closeしても残りの要素は受信でき、受信し終えるとChannelClosedError
+TEST(ChannelTest, Close) {
+  auto channel = Channel<std::unique_ptr<int>>::make(4).unwrap();
+  ASSERT_TRUE(channel.send(std::make_unique<int>(1)).is_ok());
+  ASSERT_TRUE(channel.close().is_ok());
+  EXPECT_TRUE(channel.is_closed());
+
+  auto send_result = channel.send(std::make_unique<int>(2));
+  ASSERT_TRUE(send_result.is_err());
+  EXPECT_EQ(send_result.unwrap_err(), SyncError::ChannelClosedError);
+
+  auto recv_result = channel.recv();
+  ASSERT_TRUE(recv_result.is_ok());
+  EXPECT_EQ(*recv_result.unwrap(), 1);
+
+  auto closed_result = channel.recv();
+  ASSERT_TRUE(closed_result.is_err());
+  EXPECT_EQ(closed_result.unwrap_err(), SyncError::ChannelClosedError);
+}
+
+// 眠っている受信側はcloseで起こされる
+TEST(ChannelTest, CloseWakesReceivers) {
+  auto channel = Channel<int>::make(4).unwrap();
+  std::vector<std::thread> receivers;
+  std::atomic<int> closed_count{0};
+  for (int i = 0; i < 4; ++i) {
+    receivers.emplace_back([&]() {
+      auto recv_result = channel.recv();
+      if (recv_result.is_err() &&
+          recv_result.unwrap_err() == SyncError::ChannelClosedError) {
+        ++closed_count;
+      }
+    });
+  }
+  SDL_Delay(20);
+  ASSERT_TRUE(channel.close().is_ok());
+  for (auto& receiver : receivers) {
+    receiver.join();
+  }
+  EXPECT_EQ(closed_count.load(), 4);
+}
+
+TEST(ChannelTest, Batch) {
+  auto channel = Channel<int>::make(8).unwrap();
+
+  const int input[10] = {0, 1, 2, 3, 4, 5, 6, 7, 8, 9};
+  auto send_result = channel.try_send_batch(input, 10);
+  ASSERT_TRUE(send_result.is_ok());
+  EXPECT_EQ(send_result.unwrap(), 8u);
+
+  int output[10] = {};
+  auto recv_result = channel.try_recv_batch(output, 3);
+  ASSERT_TRUE(recv_result.is_ok());
+  EXPECT_EQ(recv_result.unwrap(), 3u);
+  EXPECT_EQ(output[2], 2);
+
+  ASSERT_TRUE(channel.send_batch(input + 8, 2).is_ok());
+  recv_result = channel.recv_batch(output, 10);
+  ASSERT_TRUE(recv_result.is_ok());
+  ASSERT_EQ(recv_result.unwrap(), 7u);
+  for (int i = 0; i < 7; ++i) {
+    EXPECT_EQ(output[i], i + 3);
+  }
+}
+
+// 複数の送信側・受信側で、すべての要素がちょうど1回ずつ届く
+TEST(ChannelTest, MultiProducerMultiConsumer) {
+  auto channel = Channel<uint32_t>::make(16).unwrap();
+  const uint32_t num_producers = 4;
+  const uint32_t items_per_producer = 20000;
+  const uint32_t num_items = num_producers * items_per_producer;
+  std::vector<std::atomic<int>> received(num_items);
+
+  std::vector<std::thread> consumers;
+  for (int i = 0; i < 4; ++i) {
+    consumers.emplace_back([&, i]() {
+      uint32_t batch[8];
+      for (;;) {
+        if (i % 2 == 0) {
+          auto recv_result = channel.recv();
+          if (recv_result.is_err()) {
+            return;
+          }
+          ++received[recv_result.unwrap()];
+        } else {
+          auto recv_result = channel.recv_batch(batch, 8);
+          if (recv_result.is_err()) {
+            return;
+          }
+          for (size_t j = 0; j < recv_result.unwrap(); ++j) {
+            ++received[batch[j]];
+          }
+        }
+      }
+    });
+  }
+
+  std::vector<std::thread> producers;
+  for (uint32_t p = 0; p < num_producers; ++p) {
+    producers.emplace_back([&, p]() {
+      const uint32_t first = p * items_per_producer;
+      if (p % 2 == 0) {
+        for (uint32_t i = 0; i < items_per_producer; ++i) {
+          ASSERT_TRUE(channel.send(first + i).is_ok());
+        }
+      } else {
+        std::vector<uint32_t> items(items_per_producer);
+        for (uint32_t i = 0; i < items_per_producer; ++i) {
+          items[i] = first + i;
+        }
+        for (uint32_t i = 0; i < items_per_producer; i += 10) {
+          ASSERT_TRUE(channel.send_batch(&items[i], 10).is_ok());
+        }
+      }
+    });
+  }
+  for (auto& producer : producers) {
+    producer.join();
+  }
+  ASSERT_TRUE(channel.close().is_ok());
+  for (auto& consumer : consumers) {
+    consumer.join();
+  }
+
+  for (uint32_t i = 0; i < num_items; ++i) {
+    ASSERT_EQ(received[i].load(), 1) << "item " << i;
+  }
+}
+
+TEST(ChannelTest, Select) {
+  auto numbers = Channel<int>::make(4).unwrap();
+  auto words = Channel<std::string>::make(4).unwrap();
+
+  ASSERT_TRUE(words.send("hello").is_ok());
+  int number = 0;
+  std::string word;
+  auto select_result =
+      select(on_recv(numbers, [&](int v) { number = v; }),
+             on_recv(words, [&](std::string v) { word = std::move(v); }));
+  ASSERT_TRUE(select_result.is_ok());
+  EXPECT_EQ(select_result.unwrap(), 1u);
+  EXPECT_EQ(word, "hello");
+
+  // 届くまで眠り、届いたケースを処理する
+  std::thread sender([&]() {
+    SDL_Delay(20);
+    ASSERT_TRUE(numbers.send(42).is_ok());
+  });
+  select_result =
+      select(on_recv(numbers, [&](int v) { number = v; }),
+             on_recv(words, [&](std::string v) { word = std::move(v); }));
+  sender.join();
+  ASSERT_TRUE(select_result.is_ok());
+  EXPECT_EQ(select_result.unwrap(), 0u);
+  EXPECT_EQ(number, 42);
+
+  // closeされたChannelは飛ばし、すべてcloseされたらエラー
+  ASSERT_TRUE(numbers.close().is_ok());
+  std::thread closer([&]() {
+    SDL_Delay(20);
+    ASSERT_TRUE(words.close().is_ok());
+  });
+  select_result =
+      select(on_recv(numbers, [&](int v) { number = v; }),
+             on_recv(words, [&](std::string v) { word = std::move(v); }));
+  closer.join();
+  ASSERT_TRUE(select_result.is_err());
+  EXPECT_EQ(select_result.unwrap_err(), SyncError::ChannelClosedError);
+}
+
+TEST(ChannelTest, InvalidCapacity) {
+  for (size_t capacity : {0u, 1u, 3u, 12u}) {
+    auto channel_result = Channel<int>::make(capacity);
+    ASSERT_TRUE(channel_result.is_err());
+    EXPECT_EQ(channel_result.unwrap_err(), SyncError::InvalidChannelError);
+  }
+}
+
+TEST(ChannelTest, MoveSemantics) {
+  auto channel1 = Channel<int>::make(4).unwrap();
+  ASSERT_TRUE(channel1.send(1).is_ok());
+  Channel<int> channel2 = std::move(channel1);
+  EXPECT_EQ(channel1.capacity(), 0u);
+
+  auto invalid_result = channel1.try_recv();
+  ASSERT_TRUE(invalid_result.is_err());
+  EXPECT_EQ(invalid_result.unwrap_err(), SyncError::InvalidChannelError);
+
+  auto recv_result = channel2.recv();
+  ASSERT_TRUE(recv_result.is_ok());
+  EXPECT_EQ(recv_result.unwrap(), 1);
+}
+
+}  // namespace
@@ -0,0 +1,174 @@
+#include <atomic>
+#include <memory>
+#include <random>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "pch.h"
+
+namespace {
+
+using namespace s6i_sync;
+
+TEST(ConcurrentMapTest, BasicFunctionality) {
+  auto map_result = ConcurrentMap<int, std::string>::make();
+  ASSERT_TRUE(map_result.is_ok());
+  auto map = std::move(map_result.unwrap());
+  using Map = ConcurrentMap<int, std::string>;
+  EXPECT_EQ(map.shard_count(), Map::DEFAULT_SHARD_COUNT);
+  EXPECT_EQ(map.size(), 0u);
+
+  EXPECT_TRUE(map.insert(1, "one").unwrap());
+  EXPECT_FALSE(map.insert(1, "uno").unwrap());  // 既にあれば置き換えない
+  EXPECT_EQ(map.get(1).unwrap(), "one");
+  EXPECT_FALSE(map.get(2).unwrap().has_value());
+  EXPECT_TRUE(map.contains(1).unwrap());
+  EXPECT_FALSE(map.contains(2).unwrap());
+
+  EXPECT_FALSE(map.insert_or_assign(1, "uno").unwrap());
+  EXPECT_EQ(map.get(1).unwrap(), "uno");
+  EXPECT_TRUE(map.insert_or_assign(2, "two").unwrap());
+  EXPECT_EQ(map.size(), 2u);
+
+  size_t length = 0;
+  EXPECT_TRUE(
+      map.visit(2, [&](const std::string& value) { length = value.size(); })
+          .unwrap());
+  EXPECT_EQ(length, 3u);
+
+  EXPECT_TRUE(map.erase(1).unwrap());
+  EXPECT_FALSE(map.erase(1).unwrap());
+  EXPECT_FALSE(map.contains(1).unwrap());
+  EXPECT_EQ(map.size(), 1u);
+
+  map.clear();
+  EXPECT_EQ(map.size(), 0u);
+}
+
+TEST(ConcurrentMapTest, InvalidShardCount) {
+  for (size_t shard_count : {0u, 3u, 12u}) {
+    auto map_result = ConcurrentMap<int, int>::make(shard_count);
+    ASSERT_TRUE(map_result.is_err());
+    EXPECT_EQ(map_result.unwrap_err(), SyncError::InvalidMapError);
+  }
+}
+
+TEST(ConcurrentMapTest, MoveSemantics) {
+  auto map1 = ConcurrentMap<int, int>::make(4).unwrap();
+  map1.insert(1, 10).unwrap();
+
+  ConcurrentMap<int, int> map2 = std::move(map1);
+  EXPECT_FALSE(map1.is_valid());
+  EXPECT_TRUE(map2.is_valid());
+  EXPECT_EQ(map2.get(1).unwrap(), 10);
+
+  auto result = map1.get(1);
+  ASSERT_TRUE(result.is_err());
+  EXPECT_EQ(result.unwrap_err(), SyncError::InvalidMapError);
+  EXPECT_EQ(map1.size(), 0u);
+}
+
+// 標準のunordered_mapと同じ操作をして、拡張と削除の詰め直しで要素を失わない
+TEST(ConcurrentMapTest, MatchesUnorderedMap) {
+  for (size_t shards : {1u, 8u}) {
+    auto map = ConcurrentMap<uint32_t, uint32_t>::make(shards).unwrap();
+    std::unordered_map<uint32_t, uint32_t> expected;
+    std::mt19937 rng(12345);
+    for (int i = 0; i < 50000; ++i) {
+      const uint32_t key = rng() % 2000;
+      switch (rng() % 3) {
+        case 0:
+          EXPECT_EQ(map.insert_or_assign(key, i).unwrap(),
+                    expected.count(key) == 0);
+          expected[key] = i;
+          break;
+        case 1:
+          EXPECT_EQ(map.erase(key).unwrap(), expected.erase(key) == 1);
+          break;
+        default: {
+          auto value = map.get(key).unwrap();
+          auto it = expected.find(key);
+          ASSERT_EQ(value.has_value(), it != expected.end());
+          if (value) {
+            EXPECT_EQ(*value, it->second);
+          }
+          break;
+        }
+      }
+    }
+    EXPECT_EQ(map.size(), expected.size());
+
+    size_t visited = 0;
+    map.for_each([&](uint32_t key, uint32_t value) {
+      ++visited;
+      EXPECT_EQ(expected.at(key), value);
+    });
+    EXPECT_EQ(visited, expected.size());
+  }
+}
+
+// 同じキーで同時に呼んでも、値を作るのは1回だけ
+TEST(ConcurrentMapTest, GetOrInsertWithComputesOnce) {
+  auto map = ConcurrentMap<int, std::shared_ptr<int>>::make().unwrap();
+  const int num_threads = 8;
+  const int num_keys = 256;
+  std::atomic<int> created{0};
+  std::atomic<bool> mismatch{false};
+
+  std::vector<std::thread> threads;
+  for (int t = 0; t < num_threads; ++t) {
+    threads.emplace_back([&]() {
+      for (int key = 0; key < num_keys; ++key) {
+        auto value = map.get_or_insert_with(key, [&]() {
+                          created.fetch_add(1);
+                          return std::make_shared<int>(key);
+                        }).unwrap();
+        if (*value != key) {
+          mismatch = true;
+        }
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  EXPECT_EQ(created.load(), num_keys);
+  EXPECT_FALSE(mismatch.load());
+  EXPECT_EQ(map.size(), static_cast<size_t>(num_keys));
+}
+
+TEST(ConcurrentMapTest, ConcurrentInsertAndErase) {
+  auto map = ConcurrentMap<std::string, int>::make(8).unwrap();
+  const int num_threads = 4;
+  const int per_thread = 5000;
+
+  std::vector<std::thread> threads;
+  for (int t = 0; t < num_threads; ++t) {
+    threads.emplace_back([&, t]() {
+      for (int i = 0; i < per_thread; ++i) {
+        const std::string key = std::to_string(t) + ":" + std::to_string(i);
+        map.insert(key, i).unwrap();
+        // 奇数番目は追加した直後に消す
+        if (i % 2 == 1) {
+          map.erase(key).unwrap();
+        }
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  EXPECT_EQ(map.size(), static_cast<size_t>(num_threads * per_thread / 2));
+  for (int t = 0; t < num_threads; ++t) {
+    for (int i = 0; i < per_thread; ++i) {
+      const std::string key = std::to_string(t) + ":" + std::to_string(i);
+      EXPECT_EQ(map.contains(key).unwrap(), i % 2 == 0);
+    }
+  }
+}
+
+}  // namespace
@@ -1,6 +1,8 @@
+#include <algorithm>
 #include <deque>
 #include <string>
 #include <thread>
+#include <vector>
 
 #include "pch.h"
 
@@ -8,6 +10,12 @@ namespace {
 
 using namespace s6i_sync;
 
+// wait/signal/broadcastの戻り値はSyncErrorと同じ大きさに収まる
+static_assert(sizeof(s6i_result::Result<void, SyncError>) ==
+              sizeof(SyncError));
+static_assert(
+    std::is_trivially_copyable_v<s6i_result::Result<void, SyncError>>);
+
 TEST(CondVarTest, BasicFunctionality) {
   // 条件変数の作成
   auto cond_result = CondVar::make();
@@ -204,4 +212,190 @@ TEST(CondVarTest, Broadcast) {
   EXPECT_EQ(woken_threads.load(), num_threads);
 }
 
+TEST(CondVarTest, WaitForTimesOut) {
+  auto cond = CondVar::make().unwrap();
+  auto mutex = Mutex<bool>::make(false).unwrap();
+  auto guard = mutex.lock().unwrap();
+
+  const uint64_t start = SDL_GetTicks64();
+  auto wait_result = cond.wait_for(guard, 20);
+  ASSERT_TRUE(wait_result.is_ok());
+  EXPECT_EQ(wait_result.unwrap(), WaitStatus::TimedOut);
+  EXPECT_GE(SDL_GetTicks64() - start, 19u);
+
+  // 過ぎた時刻を指定するとすぐに時間切れ
+  auto until_result = cond.wait_until(guard, 0);
+  ASSERT_TRUE(until_result.is_ok());
+  EXPECT_EQ(until_result.unwrap(), WaitStatus::TimedOut);
+
+  // 条件付きの待機は、時間切れなら最後の条件の値を返す
+  auto pred_result =
+      cond.wait_for(guard, 10, [](bool& ready) { return ready; });
+  ASSERT_TRUE(pred_result.is_ok());
+  EXPECT_FALSE(pred_result.unwrap());
+}
+
+TEST(CondVarTest, PredicateWait) {
+  auto cond = CondVar::make().unwrap();
+  auto mutex = Mutex<int>::make(0).unwrap();
+
+  std::thread producer([&]() {
+    for (int i = 0; i < 5; ++i) {
+      SDL_Delay(2);
+      auto guard = mutex.lock().unwrap();
+      ++*guard;
+      ASSERT_TRUE(cond.broadcast(guard).is_ok());
+    }
+  });
+
+  {
+    auto guard = mutex.lock().unwrap();
+    // 途中の起床は条件で吸収される
+    ASSERT_TRUE(
+        cond.wait(guard, [](int& count) { return count >= 3; }).is_ok());
+    EXPECT_GE(*guard, 3);
+
+    auto wait_result =
+        cond.wait_for(guard, 5000, [](int& count) { return count == 5; });
+    ASSERT_TRUE(wait_result.is_ok());
+    EXPECT_TRUE(wait_result.unwrap());
+  }
+  producer.join();
+}
+
+// ムーブ元のガードでは待機できない
+template <typename Policy>
+void wait_with_moved_guard() {
+  auto cond = CondVar::make().unwrap();
+  auto mutex = Mutex<bool, Policy>::make(false).unwrap();
+  auto guard = mutex.lock().unwrap();
+  auto moved = std::move(guard);
+
+  auto wait_result = cond.wait(guard);
+  ASSERT_TRUE(wait_result.is_err());
+  EXPECT_EQ(wait_result.unwrap_err(), SyncError::InvalidMutexError);
+  auto for_result = cond.wait_for(guard, 10);
+  ASSERT_TRUE(for_result.is_err());
+  EXPECT_EQ(for_result.unwrap_err(), SyncError::InvalidMutexError);
+  auto pred_result =
+      cond.wait_for(guard, 10, [](bool& ready) { return ready; });
+  ASSERT_TRUE(pred_result.is_err());
+  EXPECT_EQ(pred_result.unwrap_err(), SyncError::InvalidMutexError);
+
+  // ムーブ先のガードはそのまま使える
+  EXPECT_EQ(cond.wait_for(moved, 1).unwrap(), WaitStatus::TimedOut);
+}
+
+TEST(CondVarTest, WaitWithMovedGuard) {
+  wait_with_moved_guard<SdlMutexPolicy>();
+  wait_with_moved_guard<SpinMutexPolicy>();
+}
+
+// ロックを外してから起こしても取りこぼさない
+template <typename Policy>
+void notify_without_guard() {
+  auto cond = CondVar::make().unwrap();
+  auto mutex = Mutex<int, Policy>::make(0).unwrap();
+  const int num_rounds = 200;
+
+  std::thread worker([&]() {
+    for (int i = 1; i <= num_rounds; ++i) {
+      auto guard = mutex.lock().unwrap();
+      ASSERT_TRUE(
+          cond.wait(guard, [i](int& round) { return round >= i; }).is_ok());
+    }
+  });
+
+  for (int i = 1; i <= num_rounds; ++i) {
+    {
+      auto guard = mutex.lock().unwrap();
+      *guard = i;
+    }
+    if (i % 2 == 0) {
+      ASSERT_TRUE(cond.notify_one().is_ok());
+    } else {
+      ASSERT_TRUE(cond.notify_all().is_ok());
+    }
+  }
+  worker.join();
+}
+
+TEST(CondVarTest, NotifyWithoutGuard) {
+  notify_without_guard<SdlMutexPolicy>();
+  notify_without_guard<SpinMutexPolicy>();
+}
+
+// 時間切れまでの待機時間のばらつき
+TEST(CondVarTest, TimeoutJitter) {
+  auto cond = CondVar::make().unwrap();
+  auto mutex = Mutex<bool>::make(false).unwrap();
+  auto guard = mutex.lock().unwrap();
+
+  const uint32_t timeout_ms = 5;
+  const int num_samples = 20;
+  const uint64_t frequency = SDL_GetPerformanceFrequency();
+  std::vector<double> late_ms;
+  for (int i = 0; i < num_samples; ++i) {
+    const uint64_t start = SDL_GetPerformanceCounter();
+    ASSERT_EQ(cond.wait_for(guard, timeout_ms).unwrap(), WaitStatus::TimedOut);
+    const uint64_t elapsed = SDL_GetPerformanceCounter() - start;
+    late_ms.push_back(static_cast<double>(elapsed) * 1000.0 /
+                          static_cast<double>(frequency) -
+                      timeout_ms);
+  }
+  std::sort(late_ms.begin(), late_ms.end());
+  const double median = late_ms[late_ms.size() / 2];
+  const double worst = late_ms.back();
+  RecordProperty("timeout_late_median_us", static_cast<int>(median * 1000));
+  RecordProperty("timeout_late_max_us", static_cast<int>(worst * 1000));
+
+  // 早く戻ることはなく、遅れも1フレーム（16ms）未満に収まる
+  EXPECT_GE(late_ms.front(), -1.0);
+  EXPECT_LT(median, 16.0);
+}
+
+// notifyしてから待機側が起きるまでの時間のばらつき
+TEST(CondVarTest, WakeupJitter) {
+  auto cond = CondVar::make().unwrap();
+  auto mutex = Mutex<uint64_t>::make(0).unwrap();
+
+  const int num_samples = 50;
+  const uint64_t frequency = SDL_GetPerformanceFrequency();
+  std::vector<double> latency_ms;
+  std::thread waiter([&]() {
+    for (int i = 0; i < num_samples; ++i) {
+      auto guard = mutex.lock().unwrap();
+      ASSERT_TRUE(cond.wait(guard, [](uint64_t& sent) { return sent != 0; })
+                      .is_ok());
+      const uint64_t elapsed = SDL_GetPerformanceCounter() - *guard;
+      latency_ms.push_back(static_cast<double>(elapsed) * 1000.0 /
+                           static_cast<double>(frequency));
+      *guard = 0;
+    }
+  });
+
+  for (int i = 0; i < num_samples; ++i) {
+    SDL_Delay(1);
+    {
+      auto guard = mutex.lock().unwrap();
+      *guard = SDL_GetPerformanceCounter();
+    }
+    ASSERT_TRUE(cond.notify_one().is_ok());
+    // 待機側が受け取るまで待つ
+    for (;;) {
+      auto guard = mutex.lock().unwrap();
+      if (*guard == 0) {
+        break;
+      }
+    }
+  }
+  waiter.join();
+
+  std::sort(latency_ms.begin(), latency_ms.end());
+  const double median = latency_ms[latency_ms.size() / 2];
+  RecordProperty("wakeup_median_us", static_cast<int>(median * 1000));
+  RecordProperty("wakeup_max_us", static_cast<int>(latency_ms.back() * 1000));
+  EXPECT_LT(median, 16.0);
+}
+
 }  // namespace
@@ -0,0 +1,64 @@
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include "pch.h"
+
+namespace {
+
+using namespace s6i_sync;
+
+TEST(LatchTest, BasicFunctionality) {
+  auto latch_result = Latch::make(3);
+  ASSERT_TRUE(latch_result.is_ok());
+  auto latch = std::move(latch_result.unwrap());
+
+  EXPECT_FALSE(latch.try_wait().unwrap());
+  ASSERT_TRUE(latch.count_down().is_ok());
+  ASSERT_TRUE(latch.count_down(2).is_ok());
+  EXPECT_TRUE(latch.try_wait().unwrap());
+  // 0になった後はすぐに戻る
+  EXPECT_TRUE(latch.wait().is_ok());
+
+  auto zero = Latch::make(0).unwrap();
+  EXPECT_TRUE(zero.wait().is_ok());
+}
+
+// 全員がcount_downするまで待ち、0になったら全員が進む
+TEST(LatchTest, WaitersAreReleased) {
+  const int num_threads = 4;
+  auto start = Latch::make(1).unwrap();
+  auto done = Latch::make(num_threads).unwrap();
+  std::atomic<int> started{0};
+
+  std::vector<std::thread> threads;
+  for (int i = 0; i < num_threads; ++i) {
+    threads.emplace_back([&]() {
+      ASSERT_TRUE(start.wait().is_ok());
+      ++started;
+      ASSERT_TRUE(done.arrive_and_wait().is_ok());
+    });
+  }
+  SDL_Delay(20);
+  EXPECT_EQ(started.load(), 0);
+  ASSERT_TRUE(start.count_down().is_ok());
+  ASSERT_TRUE(done.wait().is_ok());
+  EXPECT_EQ(started.load(), num_threads);
+  for (auto& thread : threads) {
+    thread.join();
+  }
+}
+
+TEST(LatchTest, MoveSemantics) {
+  auto latch1 = Latch::make(1).unwrap();
+  Latch latch2 = std::move(latch1);
+  EXPECT_FALSE(latch1.is_valid());
+
+  auto invalid_result = latch1.count_down();
+  ASSERT_TRUE(invalid_result.is_err());
+  EXPECT_EQ(invalid_result.unwrap_err(), SyncError::InvalidLatchError);
+  ASSERT_TRUE(latch2.count_down().is_ok());
+  EXPECT_TRUE(latch2.try_wait().unwrap());
+}
+
+}  // namespace
@@ -0,0 +1,153 @@
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <optional>
+#include <thread>
+#include <vector>
+
+#include "pch.h"
+
+static_assert(S6I_SYNC_LOCK_PROFILING,
+              "lock_profile_test requires S6I_SYNC_LOCK_PROFILING=1");
+
+namespace {
+
+using namespace s6i_sync;
+
+TEST(LockProfileTest, RecordsAcquireAndHold) {
+  lock_profile::reset();
+  auto mutex = Mutex<int>::make(0).unwrap();
+  for (int i = 0; i < 3; ++i) {
+    auto guard = mutex.lock().unwrap();
+    SDL_Delay(1);
+  }
+
+  // ロックのアドレスは公開していないので、取得回数が3のものを探す
+  const auto all = lock_profile::top_contended(1000);
+  auto it = std::find_if(all.begin(), all.end(), [](const auto& stats) {
+    return stats.m_acquires == 3;
+  });
+  ASSERT_NE(it, all.end());
+  EXPECT_EQ(it->m_contentions, 0u);
+  EXPECT_EQ(it->m_wait_ticks, 0u);
+  EXPECT_GT(it->m_hold_ticks, 0u);
+  // 呼び出し元のファイルが記録される
+  EXPECT_NE(std::strstr(it->m_label, "lock_profile_test.cpp"), nullptr);
+  EXPECT_GT(it->m_line, 0u);
+}
+
+TEST(LockProfileTest, RecordsContentionAndLabel) {
+  lock_profile::reset();
+  auto mutex = Mutex<int>::make(0).unwrap();
+
+  std::atomic<bool> locked{false};
+  std::thread holder([&]() {
+    auto guard = mutex.lock("holder").unwrap();
+    locked = true;
+    SDL_Delay(20);
+  });
+  while (!locked.load()) {
+    SDL_Delay(1);
+  }
+  { auto guard = mutex.lock("waiter").unwrap(); }
+  holder.join();
+
+  const auto top = lock_profile::top_contended(1);
+  ASSERT_EQ(top.size(), 1u);
+  EXPECT_EQ(top[0].m_acquires, 2u);
+  EXPECT_EQ(top[0].m_contentions, 1u);
+  EXPECT_GT(top[0].m_wait_ticks, 0u);
+  // 最も待たされた場所がラベルになる
+  EXPECT_STREQ(top[0].m_label, "waiter");
+  EXPECT_EQ(top[0].m_line, 0u);
+
+  lock_profile::dump(1);
+}
+
+TEST(LockProfileTest, CondVarWaitIsNotHoldTime) {
+  lock_profile::reset();
+  auto mutex = Mutex<bool>::make(false).unwrap();
+  auto cond = CondVar::make().unwrap();
+  {
+    auto guard = mutex.lock("cond").unwrap();
+    ASSERT_EQ(cond.wait_for(guard, 20).unwrap(), WaitStatus::TimedOut);
+  }
+
+  const auto all = lock_profile::top_contended(1000);
+  auto it = std::find_if(all.begin(), all.end(), [](const auto& stats) {
+    return std::strcmp(stats.m_label, "cond") == 0;
+  });
+  ASSERT_NE(it, all.end());
+  EXPECT_EQ(it->m_cond_waits, 1u);
+  // 眠っていた時間は保持時間に含めない
+  EXPECT_GT(it->m_cond_wait_ticks, it->m_hold_ticks);
+}
+
+TEST(LockProfileTest, TopNOrdering) {
+  lock_profile::reset();
+  auto busy = Mutex<int>::make(0).unwrap();
+  auto quiet = Mutex<int>::make(0).unwrap();
+
+  for (int round = 0; round < 3; ++round) {
+    std::atomic<bool> locked{false};
+    std::thread holder([&]() {
+      auto guard = busy.lock("busy").unwrap();
+      locked = true;
+      SDL_Delay(5);
+    });
+    while (!locked.load()) {
+      SDL_Delay(1);
+    }
+    { auto guard = busy.lock("busy").unwrap(); }
+    holder.join();
+    { auto guard = quiet.lock("quiet").unwrap(); }
+  }
+
+  const auto top = lock_profile::top_contended(2);
+  ASSERT_EQ(top.size(), 2u);
+  EXPECT_STREQ(top[0].m_label, "busy");
+  EXPECT_EQ(top[0].m_contentions, 3u);
+  EXPECT_EQ(top[1].m_contentions, 0u);
+}
+
+TEST(LockProfileTest, DestroyedLockIsForgotten) {
+  lock_profile::reset();
+  std::optional<Mutex<int>> mutex(Mutex<int>::make(0).unwrap());
+  for (int i = 0; i < 5; ++i) {
+    auto guard = mutex->lock("reused").unwrap();
+  }
+  // 同じアドレスに作り直したロックに、前のロックの集計が混ざらない
+  mutex.reset();
+  mutex.emplace(Mutex<int>::make(0).unwrap());
+  { auto guard = mutex->lock("reused").unwrap(); }
+
+  const auto all = lock_profile::top_contended(1000);
+  auto it = std::find_if(all.begin(), all.end(), [](const auto& stats) {
+    return std::strcmp(stats.m_label, "reused") == 0;
+  });
+  ASSERT_NE(it, all.end());
+  EXPECT_EQ(it->m_acquires, 1u);
+}
+
+TEST(LockProfileTest, FullTableCountsDropped) {
+  lock_profile::reset();
+  constexpr size_t count = 2 * lock_profile::detail::ThreadBuffer::CAPACITY;
+  std::vector<Mutex<int>> mutexes;
+  mutexes.reserve(count);
+  for (size_t i = 0; i < count; ++i) {
+    mutexes.push_back(Mutex<int>::make(0).unwrap());
+    auto guard = mutexes.back().lock("many").unwrap();
+  }
+  EXPECT_GE(lock_profile::dropped(),
+            count - lock_profile::detail::ThreadBuffer::CAPACITY);
+  lock_profile::dump(1);
+
+  // 破棄したロックの枠は再利用できる
+  mutexes.clear();
+  lock_profile::reset();
+  auto mutex = Mutex<int>::make(0).unwrap();
+  { auto guard = mutex.lock("after").unwrap(); }
+  EXPECT_EQ(lock_profile::dropped(), 0u);
+}
+
+}  // namespace
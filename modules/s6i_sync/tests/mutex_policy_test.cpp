@@ -0,0 +1,227 @@
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include "pch.h"
+
+namespace {
+
+using namespace s6i_sync;
+
+template <typename Policy>
+class MutexPolicyTest : public ::testing::Test {};
+
+using Policies = ::testing::Types<SdlMutexPolicy,
+                                  SpinMutexPolicy,
+                                  AdaptiveMutexPolicy,
+                                  ParkingLotMutexPolicy>;
+TYPED_TEST_SUITE(MutexPolicyTest, Policies);
+
+TYPED_TEST(MutexPolicyTest, BasicFunctionality) {
+  auto mutex_result = Mutex<int, TypeParam>::make(42);
+  ASSERT_TRUE(mutex_result.is_ok());
+  auto mutex = std::move(mutex_result.unwrap());
+
+  {
+    auto guard_result = mutex.lock();
+    ASSERT_TRUE(guard_result.is_ok());
+    auto guard = guard_result.unwrap();
+    EXPECT_EQ(*guard, 42);
+    *guard = 100;
+  }
+
+  {
+    auto guard_result = mutex.lock();
+    ASSERT_TRUE(guard_result.is_ok());
+    auto guard = guard_result.unwrap();
+    EXPECT_EQ(*guard, 100);
+  }
+}
+
+TYPED_TEST(MutexPolicyTest, ThreadSafety) {
+  auto mutex_result = Mutex<int, TypeParam>::make(0);
+  ASSERT_TRUE(mutex_result.is_ok());
+  auto mutex = std::move(mutex_result.unwrap());
+
+  const int num_threads = 8;
+  const int increments = 10000;
+  std::vector<std::thread> threads;
+  for (int i = 0; i < num_threads; ++i) {
+    threads.emplace_back([&]() {
+      for (int j = 0; j < increments; ++j) {
+        auto guard_result = mutex.lock();
+        ASSERT_TRUE(guard_result.is_ok());
+        auto guard = guard_result.unwrap();
+        ++*guard;
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  auto guard_result = mutex.lock();
+  ASSERT_TRUE(guard_result.is_ok());
+  EXPECT_EQ(*guard_result.unwrap(), num_threads * increments);
+}
+
+TYPED_TEST(MutexPolicyTest, MovedFromIsInvalid) {
+  auto mutex_result = Mutex<int, TypeParam>::make(42);
+  ASSERT_TRUE(mutex_result.is_ok());
+  auto mutex1 = std::move(mutex_result.unwrap());
+  Mutex<int, TypeParam> mutex2 = std::move(mutex1);
+
+  auto guard_result = mutex1.lock();
+  ASSERT_TRUE(guard_result.is_err());
+  EXPECT_EQ(guard_result.unwrap_err(), SyncError::InvalidMutexError);
+
+  auto guard2_result = mutex2.lock();
+  ASSERT_TRUE(guard2_result.is_ok());
+  EXPECT_EQ(*guard2_result.unwrap(), 42);
+}
+
+TYPED_TEST(MutexPolicyTest, TryLock) {
+  auto policy_result = TypeParam::make();
+  ASSERT_TRUE(policy_result.is_ok());
+  auto policy = std::move(policy_result.unwrap());
+
+  ASSERT_TRUE(policy.try_lock());
+  std::thread other([&]() { EXPECT_FALSE(policy.try_lock()); });
+  other.join();
+  policy.unlock();
+  EXPECT_TRUE(policy.try_lock());
+  policy.unlock();
+}
+
+TYPED_TEST(MutexPolicyTest, CondVarInterop) {
+  auto cond_result = CondVar::make();
+  ASSERT_TRUE(cond_result.is_ok());
+  auto cond = std::move(cond_result.unwrap());
+
+  auto mutex_result = Mutex<int, TypeParam>::make(0);
+  ASSERT_TRUE(mutex_result.is_ok());
+  auto mutex = std::move(mutex_result.unwrap());
+
+  const int num_items = 1000;
+  std::thread consumer([&]() {
+    auto guard_result = mutex.lock();
+    ASSERT_TRUE(guard_result.is_ok());
+    auto guard = guard_result.unwrap();
+    while (*guard < num_items) {
+      auto wait_result = cond.wait(guard);
+      ASSERT_TRUE(wait_result.is_ok());
+    }
+  });
+
+  for (int i = 0; i < num_items; ++i) {
+    auto guard_result = mutex.lock();
+    ASSERT_TRUE(guard_result.is_ok());
+    auto guard = guard_result.unwrap();
+    ++*guard;
+    auto signal_result = cond.signal(guard);
+    ASSERT_TRUE(signal_result.is_ok());
+  }
+
+  consumer.join();
+}
+
+// スピン系のロックはOSのリソースを持たず、1ワードに収まる
+static_assert(sizeof(SpinMutexPolicy) == sizeof(uint32_t));
+static_assert(sizeof(Mutex<int, SpinMutexPolicy>) == 2 * sizeof(uint32_t));
+
+// パーキングロットのロックは1バイトに収まる
+static_assert(sizeof(ParkingLotMutexPolicy) == 1);
+static_assert(sizeof(Mutex<uint8_t, ParkingLotMutexPolicy>) == 2);
+
+TEST(ParkingLotTest, ParkRejectedByValidate) {
+  int key = 0;
+  EXPECT_FALSE(parking_lot::park(&key, []() { return false; }));
+}
+
+TEST(ParkingLotTest, UnparkOneWithoutWaiter) {
+  int key = 0;
+  bool called = false;
+  bool more = true;
+  EXPECT_FALSE(parking_lot::unpark_one(&key, [&](bool has_more) {
+    called = true;
+    more = has_more;
+  }));
+  EXPECT_TRUE(called);
+  EXPECT_FALSE(more);
+}
+
+TEST(ParkingLotTest, UnparkAllWakesEveryWaiter) {
+  int key = 0;
+  const int num_threads = 4;
+  std::atomic<int> parked{0};
+  std::atomic<int> woken{0};
+  std::atomic<bool> released{false};
+
+  std::vector<std::thread> threads;
+  for (int i = 0; i < num_threads; ++i) {
+    threads.emplace_back([&]() {
+      while (!released.load()) {
+        parking_lot::park(&key, [&]() {
+          if (released.load()) {
+            return false;
+          }
+          ++parked;
+          return true;
+        });
+      }
+      ++woken;
+    });
+  }
+
+  // 全スレッドが眠るまで待つ
+  while (parked.load() < num_threads) {
+    std::this_thread::yield();
+  }
+  released = true;
+  EXPECT_EQ(parking_lot::unpark_all(&key), static_cast<size_t>(num_threads));
+
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  EXPECT_EQ(woken.load(), num_threads);
+}
+
+// 異なるキーのロックを大量に持っても互いに干渉しない
+TEST(ParkingLotTest, ManySmallLocks) {
+  const int num_locks = 1024;
+  std::vector<Mutex<uint8_t, ParkingLotMutexPolicy>> mutexes;
+  mutexes.reserve(num_locks);
+  for (int i = 0; i < num_locks; ++i) {
+    auto mutex_result = Mutex<uint8_t, ParkingLotMutexPolicy>::make(0);
+    ASSERT_TRUE(mutex_result.is_ok());
+    mutexes.push_back(std::move(mutex_result.unwrap()));
+  }
+
+  const int num_threads = 4;
+  const int rounds = 200;
+  std::vector<std::thread> threads;
+  for (int t = 0; t < num_threads; ++t) {
+    threads.emplace_back([&]() {
+      for (int r = 0; r < rounds; ++r) {
+        for (auto& mutex : mutexes) {
+          auto guard_result = mutex.lock();
+          ASSERT_TRUE(guard_result.is_ok());
+          auto guard = guard_result.unwrap();
+          ++*guard;
+        }
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  for (auto& mutex : mutexes) {
+    auto guard_result = mutex.lock();
+    ASSERT_TRUE(guard_result.is_ok());
+    EXPECT_EQ(*guard_result.unwrap(),
+              static_cast<uint8_t>(num_threads * rounds));
+  }
+}
+
+}  // namespace
@@ -5,6 +5,11 @@ namespace {
 
 using namespace s6i_sync;
 
+#if !S6I_SYNC_LOCK_PROFILING
+// ロック計測が無効なときは、MutexGuardに計測用のメンバーが増えない
+static_assert(sizeof(MutexGuard<int>) == 2 * sizeof(void*));
+#endif
+
 TEST(MutexTest, BasicFunctionality) {
   // 基本的な作成と値の取得
   auto mutex_result = Mutex<int>::make(42);
@@ -0,0 +1,179 @@
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "pch.h"
+
+namespace {
+
+using namespace s6i_sync;
+
+TEST(RwLockTest, BasicFunctionality) {
+  auto lock_result = RwLock<std::string>::make("hello");
+  ASSERT_TRUE(lock_result.is_ok());
+  auto lock = std::move(lock_result.unwrap());
+
+  {
+    auto guard_result = lock.read();
+    ASSERT_TRUE(guard_result.is_ok());
+    auto guard = guard_result.unwrap();
+    EXPECT_EQ(*guard, "hello");
+    EXPECT_EQ(guard->size(), 5u);
+  }
+
+  {
+    auto guard_result = lock.write();
+    ASSERT_TRUE(guard_result.is_ok());
+    auto guard = guard_result.unwrap();
+    guard->append(" world");
+  }
+
+  {
+    auto guard_result = lock.read();
+    ASSERT_TRUE(guard_result.is_ok());
+    EXPECT_EQ(*guard_result.unwrap(), "hello world");
+  }
+}
+
+TEST(RwLockTest, ReadGuardIsConst) {
+  using Guard = decltype(std::declval<RwLock<int>&>().read().unwrap());
+  static_assert(std::is_same_v<decltype(*std::declval<Guard&>()), const int&>);
+  using WGuard = decltype(std::declval<RwLock<int>&>().write().unwrap());
+  static_assert(std::is_same_v<decltype(*std::declval<WGuard&>()), int&>);
+}
+
+TEST(RwLockTest, ConcurrentReaders) {
+  auto lock_result = RwLock<int>::make(42);
+  ASSERT_TRUE(lock_result.is_ok());
+  auto lock = std::move(lock_result.unwrap());
+
+  // 2つの読み込みロックを同時に保持できる
+  auto guard1_result = lock.read();
+  ASSERT_TRUE(guard1_result.is_ok());
+  auto guard1 = guard1_result.unwrap();
+
+  bool second_read = false;
+  std::thread reader([&]() {
+    auto guard_result = lock.read();
+    ASSERT_TRUE(guard_result.is_ok());
+    second_read = *guard_result.unwrap() == 42;
+  });
+  reader.join();
+  EXPECT_TRUE(second_read);
+}
+
+TEST(RwLockTest, WriterExcludesReaders) {
+  auto lock_result = RwLock<std::vector<int>>::make();
+  ASSERT_TRUE(lock_result.is_ok());
+  auto lock = std::move(lock_result.unwrap());
+
+  const int num_writers = 4;
+  const int num_readers = 4;
+  const int iterations = 2000;
+  std::atomic<bool> torn{false};
+
+  std::vector<std::thread> threads;
+  for (int i = 0; i < num_writers; ++i) {
+    threads.emplace_back([&]() {
+      for (int j = 0; j < iterations; ++j) {
+        auto guard_result = lock.write();
+        ASSERT_TRUE(guard_result.is_ok());
+        auto guard = guard_result.unwrap();
+        // 途中の状態が読み込みから見えないことを確認するため、2つずつ増やす
+        guard->push_back(j);
+        guard->push_back(j);
+      }
+    });
+  }
+  for (int i = 0; i < num_readers; ++i) {
+    threads.emplace_back([&]() {
+      for (int j = 0; j < iterations; ++j) {
+        auto guard_result = lock.read();
+        ASSERT_TRUE(guard_result.is_ok());
+        if (guard_result.unwrap()->size() % 2 != 0) {
+          torn = true;
+        }
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  EXPECT_FALSE(torn.load());
+  auto guard_result = lock.read();
+  ASSERT_TRUE(guard_result.is_ok());
+  EXPECT_EQ(guard_result.unwrap()->size(),
+            static_cast<size_t>(num_writers * iterations * 2));
+}
+
+TEST(RwLockTest, WriterPreferred) {
+  auto lock_result = RwLock<int>::make(0);
+  ASSERT_TRUE(lock_result.is_ok());
+  auto lock = std::move(lock_result.unwrap());
+
+  auto reader_guard_result = lock.read();
+  ASSERT_TRUE(reader_guard_result.is_ok());
+  auto reader_guard = reader_guard_result.unwrap();
+
+  // 書き込みを待たせる
+  std::atomic<bool> written{false};
+  std::thread writer([&]() {
+    auto guard_result = lock.write();
+    ASSERT_TRUE(guard_result.is_ok());
+    *guard_result.unwrap() = 1;
+    written = true;
+  });
+  std::this_thread::sleep_for(std::chrono::milliseconds(50));
+  EXPECT_FALSE(written.load());
+
+  // 書き込み待ちがある間は、後から来た読み込みは先に入れない
+  int seen = -1;
+  std::thread late_reader([&]() {
+    auto guard_result = lock.read();
+    ASSERT_TRUE(guard_result.is_ok());
+    seen = *guard_result.unwrap();
+  });
+  std::this_thread::sleep_for(std::chrono::milliseconds(50));
+
+  // 最初の読み込みを解放すると、書き込み、後の読み込みの順に進む
+  { auto released = std::move(reader_guard); }
+  writer.join();
+  late_reader.join();
+  EXPECT_TRUE(written.load());
+  EXPECT_EQ(seen, 1);
+}
+
+TEST(RwLockTest, MoveSemantics) {
+  auto lock_result = RwLock<int>::make(42);
+  ASSERT_TRUE(lock_result.is_ok());
+  auto lock1 = std::move(lock_result.unwrap());
+  RwLock<int> lock2 = std::move(lock1);
+
+  {
+    auto guard_result = lock2.read();
+    ASSERT_TRUE(guard_result.is_ok());
+    EXPECT_EQ(*guard_result.unwrap(), 42);
+  }
+
+  // ムーブ元への操作はエラー
+  auto read_result = lock1.read();
+  ASSERT_TRUE(read_result.is_err());
+  EXPECT_EQ(read_result.unwrap_err(), SyncError::InvalidRwLockError);
+
+  auto write_result = lock1.write();
+  ASSERT_TRUE(write_result.is_err());
+  EXPECT_EQ(write_result.unwrap_err(), SyncError::InvalidRwLockError);
+
+  // ムーブ代入
+  auto lock3_result = RwLock<int>::make(100);
+  ASSERT_TRUE(lock3_result.is_ok());
+  lock2 = std::move(lock3_result.unwrap());
+  auto guard_result = lock2.write();
+  ASSERT_TRUE(guard_result.is_ok());
+  EXPECT_EQ(*guard_result.unwrap(), 100);
+}
+
+}  // namespace
@@ -0,0 +1,91 @@
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include "pch.h"
+
+namespace {
+
+using namespace s6i_sync;
+
+TEST(SemaphoreTest, BasicFunctionality) {
+  auto semaphore_result = Semaphore::make(2);
+  ASSERT_TRUE(semaphore_result.is_ok());
+  auto semaphore = std::move(semaphore_result.unwrap());
+  EXPECT_EQ(semaphore.value(), 2u);
+
+  ASSERT_TRUE(semaphore.acquire().is_ok());
+  EXPECT_TRUE(semaphore.try_acquire().unwrap());
+  // 0なので取れない
+  EXPECT_FALSE(semaphore.try_acquire().unwrap());
+
+  ASSERT_TRUE(semaphore.release(3).is_ok());
+  EXPECT_EQ(semaphore.value(), 3u);
+
+  auto invalid_result = Semaphore::make(Semaphore::MAX_VALUE + 1);
+  ASSERT_TRUE(invalid_result.is_err());
+  EXPECT_EQ(invalid_result.unwrap_err(), SyncError::InvalidSemaphoreError);
+}
+
+// 眠っているスレッドはreleaseで起こされる
+TEST(SemaphoreTest, ReleaseWakesWaiters) {
+  auto semaphore = Semaphore::make().unwrap();
+  std::atomic<int> acquired{0};
+  std::vector<std::thread> threads;
+  for (int i = 0; i < 4; ++i) {
+    threads.emplace_back([&]() {
+      ASSERT_TRUE(semaphore.acquire().is_ok());
+      ++acquired;
+    });
+  }
+  SDL_Delay(20);
+  EXPECT_EQ(acquired.load(), 0);
+
+  ASSERT_TRUE(semaphore.release().is_ok());
+  ASSERT_TRUE(semaphore.release(3).is_ok());
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  EXPECT_EQ(acquired.load(), 4);
+  EXPECT_EQ(semaphore.value(), 0u);
+}
+
+// 同時に入れるスレッド数がセマフォの値を超えない
+TEST(SemaphoreTest, LimitsConcurrency) {
+  auto semaphore = Semaphore::make(2).unwrap();
+  std::atomic<int> inside{0};
+  std::atomic<int> max_inside{0};
+  std::vector<std::thread> threads;
+  for (int i = 0; i < 8; ++i) {
+    threads.emplace_back([&]() {
+      for (int j = 0; j < 1000; ++j) {
+        ASSERT_TRUE(semaphore.acquire().is_ok());
+        const int now = ++inside;
+        int max = max_inside.load();
+        while (now > max && !max_inside.compare_exchange_weak(max, now)) {
+        }
+        --inside;
+        ASSERT_TRUE(semaphore.release().is_ok());
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  EXPECT_LE(max_inside.load(), 2);
+  EXPECT_EQ(semaphore.value(), 2u);
+}
+
+TEST(SemaphoreTest, MoveSemantics) {
+  auto semaphore1 = Semaphore::make(1).unwrap();
+  Semaphore semaphore2 = std::move(semaphore1);
+  EXPECT_FALSE(semaphore1.is_valid());
+  EXPECT_TRUE(semaphore2.is_valid());
+
+  auto invalid_result = semaphore1.acquire();
+  ASSERT_TRUE(invalid_result.is_err());
+  EXPECT_EQ(invalid_result.unwrap_err(), SyncError::InvalidSemaphoreError);
+  EXPECT_TRUE(semaphore2.try_acquire().unwrap());
+}
+
+}  // namespace
@@ -0,0 +1,112 @@
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include "pch.h"
+
+namespace {
+
+using namespace s6i_sync;
+
+// 読み込みで途中の状態が見えないことを確かめるため、全要素を同じ値にする
+struct Camera {
+  uint64_t m_values[7] = {};
+};
+
+TEST(SeqLockTest, BasicFunctionality) {
+  auto lock_result = SeqLock<int>::make(42);
+  ASSERT_TRUE(lock_result.is_ok());
+  auto lock = std::move(lock_result.unwrap());
+  EXPECT_EQ(lock.read(), 42);
+
+  lock.write(100);
+  EXPECT_EQ(lock.read(), 100);
+
+  lock.update([](int& value) { value += 1; });
+  EXPECT_EQ(lock.read(), 101);
+}
+
+TEST(SeqLockTest, MoveSemantics) {
+  auto lock_result = SeqLock<int>::make(42);
+  ASSERT_TRUE(lock_result.is_ok());
+  auto lock1 = std::move(lock_result.unwrap());
+  SeqLock<int> lock2 = std::move(lock1);
+  EXPECT_EQ(lock2.read(), 42);
+
+  auto lock3_result = SeqLock<int>::make(7);
+  ASSERT_TRUE(lock3_result.is_ok());
+  lock2 = std::move(lock3_result.unwrap());
+  EXPECT_EQ(lock2.read(), 7);
+
+  auto lock4 = SeqLock<int>::make(3).unwrap();
+  swap(lock2, lock4);
+  EXPECT_EQ(lock2.read(), 3);
+  EXPECT_EQ(lock4.read(), 7);
+}
+
+TEST(SeqLockTest, ReadersNeverSeeTornValues) {
+  auto lock_result = SeqLock<Camera>::make();
+  ASSERT_TRUE(lock_result.is_ok());
+  auto lock = std::move(lock_result.unwrap());
+
+  std::atomic<bool> done{false};
+  std::atomic<bool> torn{false};
+
+  std::vector<std::thread> readers;
+  for (int i = 0; i < 4; ++i) {
+    readers.emplace_back([&]() {
+      uint64_t last = 0;
+      while (!done.load()) {
+        const Camera camera = lock.read();
+        for (uint64_t v : camera.m_values) {
+          if (v != camera.m_values[0]) {
+            torn = true;
+          }
+        }
+        // 単一の書き込み側なので、値は単調に増える
+        if (camera.m_values[0] < last) {
+          torn = true;
+        }
+        last = camera.m_values[0];
+      }
+    });
+  }
+
+  for (uint64_t n = 1; n <= 20000; ++n) {
+    Camera camera;
+    for (uint64_t& v : camera.m_values) {
+      v = n;
+    }
+    lock.write(camera);
+  }
+  done = true;
+  for (auto& reader : readers) {
+    reader.join();
+  }
+
+  EXPECT_FALSE(torn.load());
+  EXPECT_EQ(lock.read().m_values[0], 20000u);
+}
+
+TEST(SeqLockTest, ConcurrentWriters) {
+  auto lock_result = SeqLock<uint64_t>::make(0);
+  ASSERT_TRUE(lock_result.is_ok());
+  auto lock = std::move(lock_result.unwrap());
+
+  const int num_threads = 4;
+  const int increments = 10000;
+  std::vector<std::thread> writers;
+  for (int i = 0; i < num_threads; ++i) {
+    writers.emplace_back([&]() {
+      for (int j = 0; j < increments; ++j) {
+        lock.update([](uint64_t& value) { ++value; });
+      }
+    });
+  }
+  for (auto& writer : writers) {
+    writer.join();
+  }
+  EXPECT_EQ(lock.read(), static_cast<uint64_t>(num_threads * increments));
+}
+
+}  // namespace
@@ -0,0 +1,186 @@
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include "pch.h"
+
+namespace {
+
+using namespace s6i_sync;
+
+// 隣り合う要素が別のキャッシュラインになる
+static_assert(alignof(CachePadded<int>) == CACHE_LINE_SIZE);
+static_assert(sizeof(CachePadded<int>) == CACHE_LINE_SIZE);
+static_assert(sizeof(CachePadded<char[100]>) == 2 * CACHE_LINE_SIZE);
+
+TEST(CachePaddedTest, BasicFunctionality) {
+  CachePadded<int> values[2];
+  *values[0] = 1;
+  values[1].get() = 2;
+  EXPECT_EQ(values[0].m_value, 1);
+  EXPECT_EQ(*values[1], 2);
+
+  CachePadded<std::vector<int>> vector(std::in_place, 3, 7);
+  EXPECT_EQ(vector->size(), 3u);
+  EXPECT_EQ(vector->at(2), 7);
+}
+
+TEST(ShardedCounterTest, BasicFunctionality) {
+  auto counter_result = ShardedCounter::make(8);
+  ASSERT_TRUE(counter_result.is_ok());
+  auto counter = std::move(counter_result.unwrap());
+  EXPECT_EQ(counter.shard_count(), 8u);
+  EXPECT_EQ(counter.sum(), 0);
+
+  counter.increment();
+  counter.add(10);
+  counter.add(-3);
+  EXPECT_EQ(counter.sum(), 8);
+
+  EXPECT_EQ(counter.reset(), 8);
+  EXPECT_EQ(counter.sum(), 0);
+}
+
+TEST(ShardedCounterTest, MoveSemantics) {
+  auto counter1 = ShardedCounter::make().unwrap();
+  counter1.add(5);
+
+  ShardedCounter counter2 = std::move(counter1);
+  EXPECT_FALSE(counter1.is_valid());
+  EXPECT_EQ(counter1.sum(), 0);
+  EXPECT_TRUE(counter2.is_valid());
+  EXPECT_EQ(counter2.sum(), 5);
+}
+
+TEST(ShardedCounterTest, InvalidShardCount) {
+  for (size_t shard_count : {0u, 3u, 12u}) {
+    auto counter_result = ShardedCounter::make(shard_count);
+    ASSERT_TRUE(counter_result.is_err());
+    EXPECT_EQ(counter_result.unwrap_err(), SyncError::InvalidCounterError);
+
+    auto accumulator_result = ShardedAccumulator<int>::make(0, shard_count);
+    ASSERT_TRUE(accumulator_result.is_err());
+    EXPECT_EQ(accumulator_result.unwrap_err(),
+              SyncError::InvalidAccumulatorError);
+  }
+}
+
+// シャード数より多いスレッドが加算しても数え漏れがない
+TEST(ShardedCounterTest, ConcurrentIncrements) {
+  auto counter = ShardedCounter::make(4).unwrap();
+  const int num_threads = 8;
+  const int increments = 20000;
+
+  std::vector<std::thread> threads;
+  for (int i = 0; i < num_threads; ++i) {
+    threads.emplace_back([&]() {
+      for (int j = 0; j < increments; ++j) {
+        counter.increment();
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  EXPECT_EQ(counter.sum(), static_cast<int64_t>(num_threads) * increments);
+}
+
+// 加算と同時にresetしても、値はどちらかで必ず数えられる
+TEST(ShardedCounterTest, ResetWhileAdding) {
+  auto counter = ShardedCounter::make(4).unwrap();
+  const int num_threads = 4;
+  const int increments = 20000;
+
+  std::atomic<bool> done{false};
+  int64_t drained = 0;
+  std::thread reader([&]() {
+    while (!done.load()) {
+      drained += counter.reset();
+      std::this_thread::yield();
+    }
+  });
+
+  std::vector<std::thread> threads;
+  for (int i = 0; i < num_threads; ++i) {
+    threads.emplace_back([&]() {
+      for (int j = 0; j < increments; ++j) {
+        counter.increment();
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  done = true;
+  reader.join();
+
+  EXPECT_EQ(drained + counter.sum(),
+            static_cast<int64_t>(num_threads) * increments);
+}
+
+// フレーム時間の統計（件数・合計・最大）を集計する
+struct FrameStats {
+  int64_t m_count = 0;
+  double m_total = 0.0;
+  double m_max = 0.0;
+};
+
+struct MergeFrameStats {
+  FrameStats operator()(const FrameStats& lhs, const FrameStats& rhs) const {
+    return {lhs.m_count + rhs.m_count, lhs.m_total + rhs.m_total,
+            std::max(lhs.m_max, rhs.m_max)};
+  }
+};
+
+struct MinOp {
+  int operator()(int lhs, int rhs) const { return std::min(lhs, rhs); }
+};
+
+TEST(ShardedAccumulatorTest, BasicFunctionality) {
+  auto sum = ShardedAccumulator<double>::make(0.0, 4).unwrap();
+  sum.add(1.5);
+  sum.add(2.5);
+  EXPECT_DOUBLE_EQ(sum.sum(), 4.0);
+  EXPECT_DOUBLE_EQ(sum.reset(), 4.0);
+  EXPECT_DOUBLE_EQ(sum.sum(), 0.0);
+
+  // 単位元が0でない演算
+  auto min = ShardedAccumulator<int, MinOp>::make(1000, 4).unwrap();
+  min.add(42);
+  min.add(7);
+  EXPECT_EQ(min.sum(), 7);
+  EXPECT_EQ(min.reset(), 7);
+  EXPECT_EQ(min.sum(), 1000);
+}
+
+TEST(ShardedAccumulatorTest, ConcurrentUpdates) {
+  auto stats =
+      ShardedAccumulator<FrameStats, MergeFrameStats>::make(FrameStats{}, 4)
+          .unwrap();
+  const int num_threads = 8;
+  const int frames = 10000;
+
+  std::vector<std::thread> threads;
+  for (int i = 0; i < num_threads; ++i) {
+    threads.emplace_back([&, i]() {
+      for (int j = 0; j < frames; ++j) {
+        stats.update([&](FrameStats& current) {
+          ++current.m_count;
+          current.m_total += 1.0;
+          current.m_max = std::max(current.m_max, static_cast<double>(i));
+        });
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  const FrameStats total = stats.sum();
+  EXPECT_EQ(total.m_count, static_cast<int64_t>(num_threads) * frames);
+  EXPECT_DOUBLE_EQ(total.m_total, static_cast<double>(num_threads * frames));
+  EXPECT_DOUBLE_EQ(total.m_max, num_threads - 1);
+}
+
+}  // namespace
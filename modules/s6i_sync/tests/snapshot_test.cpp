@@ -0,0 +1,216 @@
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "pch.h"
+
+namespace {
+
+using namespace s6i_sync;
+
+// 生存中のインスタンス数を数える
+struct Tracked {
+  static std::atomic<int> s_alive;
+
+  explicit Tracked(int value) : m_value(value) { ++s_alive; }
+  Tracked(const Tracked& other) : m_value(other.m_value) { ++s_alive; }
+  ~Tracked() {
+    m_value = -1;
+    --s_alive;
+  }
+
+  int m_value;
+};
+std::atomic<int> Tracked::s_alive{0};
+
+TEST(SnapshotTest, BasicFunctionality) {
+  auto snapshot_result = Snapshot<std::string>::make("hello");
+  ASSERT_TRUE(snapshot_result.is_ok());
+  auto snapshot = std::move(snapshot_result.unwrap());
+
+  {
+    auto guard_result = snapshot.read();
+    ASSERT_TRUE(guard_result.is_ok());
+    EXPECT_EQ(*guard_result.unwrap(), "hello");
+  }
+
+  ASSERT_TRUE(snapshot.publish("world").is_ok());
+  {
+    auto guard_result = snapshot.read();
+    ASSERT_TRUE(guard_result.is_ok());
+    EXPECT_EQ(*guard_result.unwrap(), "world");
+  }
+
+  ASSERT_TRUE(snapshot.update([](std::string& s) { s += "!"; }).is_ok());
+  auto guard_result = snapshot.read();
+  ASSERT_TRUE(guard_result.is_ok());
+  EXPECT_EQ(*guard_result.unwrap(), "world!");
+}
+
+TEST(SnapshotTest, OldValueOutlivesReader) {
+  {
+    auto snapshot_result = Snapshot<Tracked>::make(1);
+    ASSERT_TRUE(snapshot_result.is_ok());
+    auto snapshot = std::move(snapshot_result.unwrap());
+
+    // 別スレッドで古い値を読んでいる間は解放されない
+    std::atomic<bool> reading{false};
+    std::atomic<bool> release{false};
+    std::atomic<int> seen{0};
+    std::thread reader([&]() {
+      auto guard_result = snapshot.read();
+      ASSERT_TRUE(guard_result.is_ok());
+      auto guard = guard_result.unwrap();
+      reading = true;
+      while (!release.load()) {
+        std::this_thread::yield();
+      }
+      seen = guard->m_value;
+    });
+    while (!reading.load()) {
+      std::this_thread::yield();
+    }
+
+    ASSERT_TRUE(snapshot.publish(2).is_ok());
+    EXPECT_EQ(snapshot.retired_count(), 1u);
+    EXPECT_EQ(Tracked::s_alive.load(), 2);
+
+    release = true;
+    reader.join();
+    EXPECT_EQ(seen.load(), 1);
+
+    // 次の公開で解放される
+    ASSERT_TRUE(snapshot.publish(3).is_ok());
+    EXPECT_EQ(snapshot.retired_count(), 0u);
+    EXPECT_EQ(Tracked::s_alive.load(), 1);
+  }
+  EXPECT_EQ(Tracked::s_alive.load(), 0);
+}
+
+TEST(SnapshotTest, ConcurrentReadersAndWriter) {
+  auto snapshot_result = Snapshot<std::vector<int>>::make(8, 0);
+  ASSERT_TRUE(snapshot_result.is_ok());
+  auto snapshot = std::move(snapshot_result.unwrap());
+
+  std::atomic<bool> done{false};
+  std::atomic<bool> torn{false};
+  std::vector<std::thread> readers;
+  for (int i = 0; i < 4; ++i) {
+    readers.emplace_back([&]() {
+      while (!done.load()) {
+        auto guard_result = snapshot.read();
+        ASSERT_TRUE(guard_result.is_ok());
+        auto guard = guard_result.unwrap();
+        for (int v : *guard) {
+          if (v != guard->front()) {
+            torn = true;
+          }
+        }
+      }
+    });
+  }
+
+  for (int n = 1; n <= 5000; ++n) {
+    ASSERT_TRUE(snapshot.publish(8, n).is_ok());
+  }
+  done = true;
+  for (auto& reader : readers) {
+    reader.join();
+  }
+  EXPECT_FALSE(torn.load());
+}
+
+TEST(SnapshotTest, MoveSemantics) {
+  auto snapshot_result = Snapshot<int>::make(42);
+  ASSERT_TRUE(snapshot_result.is_ok());
+  auto snapshot1 = std::move(snapshot_result.unwrap());
+  Snapshot<int> snapshot2 = std::move(snapshot1);
+
+  {
+    auto guard_result = snapshot2.read();
+    ASSERT_TRUE(guard_result.is_ok());
+    EXPECT_EQ(*guard_result.unwrap(), 42);
+  }
+
+  // ムーブ元への操作はエラー
+  auto read_result = snapshot1.read();
+  ASSERT_TRUE(read_result.is_err());
+  EXPECT_EQ(read_result.unwrap_err(), SyncError::InvalidSnapshotError);
+
+  auto publish_result = snapshot1.publish(1);
+  ASSERT_TRUE(publish_result.is_err());
+  EXPECT_EQ(publish_result.unwrap_err(), SyncError::InvalidSnapshotError);
+}
+
+TEST(SnapshotTest, NestedPin) {
+  auto snapshot_result = Snapshot<int>::make(1);
+  ASSERT_TRUE(snapshot_result.is_ok());
+  auto snapshot = std::move(snapshot_result.unwrap());
+
+  auto outer_result = snapshot.read();
+  ASSERT_TRUE(outer_result.is_ok());
+  auto outer = outer_result.unwrap();
+  {
+    auto inner_result = snapshot.read();
+    ASSERT_TRUE(inner_result.is_ok());
+  }
+  // 内側のガードが外れても外側のpinは残る
+  ASSERT_TRUE(snapshot.publish(2).is_ok());
+  EXPECT_EQ(snapshot.retired_count(), 1u);
+  EXPECT_EQ(*outer, 1);
+}
+
+TEST(SnapshotTest, MoreThreadsThanEpochSlots) {
+  auto snapshot_result = Snapshot<int>::make(1);
+  ASSERT_TRUE(snapshot_result.is_ok());
+  auto snapshot = std::move(snapshot_result.unwrap());
+
+  // スロットをすべて埋めたまま、スレッドを生かしておく
+  std::atomic<size_t> ready{0};
+  std::atomic<bool> done{false};
+  std::vector<std::thread> holders;
+  for (size_t i = 0; i < epoch::detail::MAX_THREADS; ++i) {
+    holders.emplace_back([&]() {
+      { auto pin = epoch::pin(); }
+      ++ready;
+      while (!done.load()) {
+        std::this_thread::yield();
+      }
+    });
+  }
+  while (ready.load() != holders.size()) {
+    std::this_thread::yield();
+  }
+
+  // スロットのないスレッドも止まらずに読め、その間は古い値を解放しない
+  std::atomic<bool> reading{false};
+  std::atomic<bool> release{false};
+  std::thread reader([&]() {
+    auto guard_result = snapshot.read();
+    ASSERT_TRUE(guard_result.is_ok());
+    auto guard = guard_result.unwrap();
+    reading = true;
+    while (!release.load()) {
+      std::this_thread::yield();
+    }
+    EXPECT_EQ(*guard, 1);
+  });
+  while (!reading.load()) {
+    std::this_thread::yield();
+  }
+  ASSERT_TRUE(snapshot.publish(2).is_ok());
+  EXPECT_EQ(snapshot.retired_count(), 1u);
+
+  release = true;
+  reader.join();
+  ASSERT_TRUE(snapshot.publish(3).is_ok());
+  EXPECT_EQ(snapshot.retired_count(), 0u);
+
+  done = true;
+  for (auto& holder : holders) {
+    holder.join();
+  }
+}
+
+}  // namespace
@@ -0,0 +1,189 @@
+#include <atomic>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "pch.h"
+
+namespace {
+
+using namespace s6i_sync;
+
+TEST(SpscRingTest, BasicFunctionality) {
+  auto ring_result = SpscRing<int, 4>::make();
+  ASSERT_TRUE(ring_result.is_ok());
+  auto ring = std::move(ring_result.unwrap());
+  EXPECT_EQ(ring.capacity(), 4u);
+  EXPECT_TRUE(ring.empty());
+
+  for (int i = 0; i < 4; ++i) {
+    EXPECT_TRUE(ring.try_push(i));
+  }
+  // 満杯
+  EXPECT_FALSE(ring.try_push(4));
+  EXPECT_EQ(ring.size(), 4u);
+
+  for (int i = 0; i < 4; ++i) {
+    auto value = ring.try_pop();
+    ASSERT_TRUE(value.has_value());
+    EXPECT_EQ(*value, i);
+  }
+  // 空
+  EXPECT_FALSE(ring.try_pop().has_value());
+  EXPECT_TRUE(ring.empty());
+}
+
+TEST(SpscRingTest, BatchPushPop) {
+  auto ring = SpscRing<int, 8>::make().unwrap();
+
+  const int input[10] = {0, 1, 2, 3, 4, 5, 6, 7, 8, 9};
+  // 空きの分だけ積める
+  EXPECT_EQ(ring.push_n(input, 10), 8u);
+  EXPECT_EQ(ring.push_n(input + 8, 2), 0u);
+
+  int output[10] = {};
+  EXPECT_EQ(ring.pop_n(output, 3), 3u);
+  EXPECT_EQ(output[0], 0);
+  EXPECT_EQ(output[2], 2);
+
+  // 先頭に戻って積める
+  EXPECT_EQ(ring.push_n(input + 8, 2), 2u);
+  EXPECT_EQ(ring.pop_n(output, 10), 7u);
+  for (int i = 0; i < 7; ++i) {
+    EXPECT_EQ(output[i], i + 3);
+  }
+  EXPECT_EQ(ring.pop_n(output, 10), 0u);
+}
+
+TEST(SpscRingTest, MoveOnlyAndDestruction) {
+  auto counter = std::make_shared<int>(0);
+  {
+    auto ring = SpscRing<std::shared_ptr<int>, 4>::make().unwrap();
+    EXPECT_TRUE(ring.try_push(counter));
+    EXPECT_TRUE(ring.try_emplace(counter));
+    EXPECT_EQ(counter.use_count(), 3);
+
+    auto value = ring.try_pop();
+    ASSERT_TRUE(value.has_value());
+    value.reset();
+    EXPECT_EQ(counter.use_count(), 2);
+  }
+  // 残っていた要素は破棄時に解放される
+  EXPECT_EQ(counter.use_count(), 1);
+
+  auto ring = SpscRing<std::unique_ptr<std::string>, 2>::make().unwrap();
+  EXPECT_TRUE(ring.try_push(std::make_unique<std::string>("ring")));
+  auto value = ring.try_pop();
+  ASSERT_TRUE(value.has_value());
+  EXPECT_EQ(**value, "ring");
+}
+
+// 2スレッドで大量に受け渡しても、順序どおりに欠けなく届く
+TEST(SpscRingTest, ConcurrentStreaming) {
+  auto ring = SpscRing<uint32_t, 64>::make().unwrap();
+  const uint32_t num_items = 200000;
+
+  // 進めないときはBackoffで譲る（CPUが少ない環境でも時間がかからないように）
+  std::thread producer([&]() {
+    Backoff backoff;
+    uint32_t next = 0;
+    uint32_t batch[16];
+    while (next < num_items) {
+      uint32_t pushed = 0;
+      if (next % 3 == 0) {
+        pushed = ring.try_push(next) ? 1 : 0;
+      } else {
+        uint32_t count = 0;
+        for (; count < 16 && next + count < num_items; ++count) {
+          batch[count] = next + count;
+        }
+        pushed = static_cast<uint32_t>(ring.push_n(batch, count));
+      }
+      next += pushed;
+      if (pushed == 0) {
+        backoff.snooze();
+      }
+    }
+  });
+
+  Backoff backoff;
+  uint32_t expected = 0;
+  uint32_t batch[16];
+  while (expected < num_items) {
+    const size_t n = ring.pop_n(batch, 16);
+    for (size_t i = 0; i < n; ++i) {
+      ASSERT_EQ(batch[i], expected);
+      ++expected;
+    }
+    if (n == 0) {
+      backoff.snooze();
+    }
+  }
+  producer.join();
+  EXPECT_TRUE(ring.empty());
+}
+
+TEST(SpscRingTest, BlockingMode) {
+  auto ring = SpscRing<uint32_t, 8, RingMode::Blocking>::make().unwrap();
+  const uint32_t num_items = 20000;
+
+  // 生産者が速い（満杯で待つ）ケース
+  std::thread producer([&]() {
+    std::vector<uint32_t> items(num_items / 2);
+    for (uint32_t i = 0; i < num_items / 2; ++i) {
+      ASSERT_TRUE(ring.wait_push(i).is_ok());
+      items[i] = num_items / 2 + i;
+    }
+    ASSERT_TRUE(ring.wait_push_n(items.data(), items.size()).is_ok());
+  });
+
+  uint32_t expected = 0;
+  while (expected < num_items / 2) {
+    auto value = ring.wait_pop();
+    ASSERT_TRUE(value.is_ok());
+    ASSERT_EQ(value.unwrap(), expected);
+    ++expected;
+  }
+  uint32_t batch[5];
+  while (expected < num_items) {
+    auto count = ring.wait_pop_n(batch, 5);
+    ASSERT_TRUE(count.is_ok());
+    const size_t n = count.unwrap();
+    ASSERT_GT(n, 0u);
+    for (size_t i = 0; i < n; ++i) {
+      ASSERT_EQ(batch[i], expected);
+      ++expected;
+    }
+  }
+  producer.join();
+
+  // 消費者が先に待つケース
+  std::thread late_producer([&]() {
+    SDL_Delay(20);
+    ASSERT_TRUE(ring.wait_push(7).is_ok());
+  });
+  auto value = ring.wait_pop();
+  ASSERT_TRUE(value.is_ok());
+  EXPECT_EQ(value.unwrap(), 7u);
+  late_producer.join();
+}
+
+TEST(SpscRingTest, MoveSemantics) {
+  auto ring1 = SpscRing<int, 4, RingMode::Blocking>::make().unwrap();
+  EXPECT_TRUE(ring1.try_push(1));
+  auto ring2 = std::move(ring1);
+
+  // ムーブ元は空で、操作は失敗する
+  EXPECT_TRUE(ring1.empty());
+  EXPECT_FALSE(ring1.try_push(2));
+  auto invalid_result = ring1.wait_pop();
+  ASSERT_TRUE(invalid_result.is_err());
+  EXPECT_EQ(invalid_result.unwrap_err(), SyncError::InvalidRingError);
+
+  auto value = ring2.wait_pop();
+  ASSERT_TRUE(value.is_ok());
+  EXPECT_EQ(value.unwrap(), 1);
+}
+
+}  // namespace
@@ -0,0 +1,125 @@
+#include <atomic>
+#include <cstring>
+#include <memory>
+#include <string>
+
+#include "pch.h"
+
+#if defined(__linux__)
+#include <sched.h>
+#endif
+
+namespace {
+
+using namespace s6i_sync;
+
+TEST(ThreadTest, ReturnsValue) {
+  auto thread_result = Thread<int>::make({}, []() { return 42; });
+  ASSERT_TRUE(thread_result.is_ok());
+  auto thread = std::move(thread_result.unwrap());
+  EXPECT_TRUE(thread.is_joinable());
+
+  auto join_result = thread.join();
+  ASSERT_TRUE(join_result.is_ok());
+  EXPECT_EQ(join_result.unwrap(), 42);
+  EXPECT_FALSE(thread.is_joinable());
+}
+
+TEST(ThreadTest, VoidThread) {
+  std::atomic<bool> ran{false};
+  auto thread_result = Thread<>::make({}, [&]() { ran = true; });
+  ASSERT_TRUE(thread_result.is_ok());
+  auto thread = std::move(thread_result.unwrap());
+  ASSERT_TRUE(thread.join().is_ok());
+  EXPECT_TRUE(ran.load());
+}
+
+TEST(ThreadTest, MoveOnlyResult) {
+  auto thread_result = Thread<std::unique_ptr<std::string>>::make(
+      {}, []() { return std::make_unique<std::string>("hello"); });
+  ASSERT_TRUE(thread_result.is_ok());
+  auto join_result = thread_result.unwrap().join();
+  ASSERT_TRUE(join_result.is_ok());
+  EXPECT_EQ(*join_result.unwrap(), "hello");
+}
+
+TEST(ThreadTest, NameAndStackSize) {
+  ThreadDesc desc;
+  desc.m_name = "s6i_worker";
+  desc.m_stack_size = 4 * 1024 * 1024;
+
+  // 既定より大きなスタックを使う
+  auto thread_result = Thread<int>::make(desc, []() {
+    volatile char buffer[2 * 1024 * 1024];
+    std::memset(const_cast<char*>(buffer), 1, sizeof(buffer));
+    return static_cast<int>(buffer[sizeof(buffer) - 1]);
+  });
+  ASSERT_TRUE(thread_result.is_ok());
+  auto thread = std::move(thread_result.unwrap());
+  EXPECT_STREQ(thread.name(), "s6i_worker");
+  EXPECT_NE(thread.id(), 0u);
+
+  auto join_result = thread.join();
+  ASSERT_TRUE(join_result.is_ok());
+  EXPECT_EQ(join_result.unwrap(), 1);
+}
+
+#if defined(__linux__)
+TEST(ThreadTest, Affinity) {
+  // 現在のプロセスで使えるCPUのうち、最初の1つに固定する
+  cpu_set_t allowed;
+  ASSERT_EQ(sched_getaffinity(0, sizeof(allowed), &allowed), 0);
+  int cpu = 0;
+  while (cpu < 64 && !CPU_ISSET(cpu, &allowed)) {
+    ++cpu;
+  }
+  ASSERT_LT(cpu, 64);
+
+  ThreadDesc desc;
+  desc.m_affinity_mask = uint64_t{1} << cpu;
+
+  auto thread_result = Thread<int>::make(desc, []() { return sched_getcpu(); });
+  ASSERT_TRUE(thread_result.is_ok());
+  auto join_result = thread_result.unwrap().join();
+  ASSERT_TRUE(join_result.is_ok());
+  EXPECT_EQ(join_result.unwrap(), cpu);
+}
+#endif
+
+TEST(ThreadTest, MoveSemantics) {
+  auto thread_result = Thread<int>::make({}, []() { return 1; });
+  ASSERT_TRUE(thread_result.is_ok());
+  auto thread1 = std::move(thread_result.unwrap());
+  Thread<int> thread2 = std::move(thread1);
+  EXPECT_FALSE(thread1.is_joinable());
+  EXPECT_EQ(thread1.id(), 0u);
+  EXPECT_EQ(thread1.name(), nullptr);
+
+  // ムーブ元のjoinはエラー
+  auto invalid_result = thread1.join();
+  ASSERT_TRUE(invalid_result.is_err());
+  EXPECT_EQ(invalid_result.unwrap_err(), SyncError::InvalidThreadError);
+
+  auto join_result = thread2.join();
+  ASSERT_TRUE(join_result.is_ok());
+  EXPECT_EQ(join_result.unwrap(), 1);
+
+  // 2回目のjoinもエラー
+  auto second_result = thread2.join();
+  ASSERT_TRUE(second_result.is_err());
+  EXPECT_EQ(second_result.unwrap_err(), SyncError::InvalidThreadError);
+}
+
+TEST(ThreadTest, JoinsOnDestruction) {
+  std::atomic<bool> finished{false};
+  {
+    auto thread_result = Thread<>::make({}, [&]() {
+      SDL_Delay(20);
+      finished = true;
+    });
+    ASSERT_TRUE(thread_result.is_ok());
+  }
+  EXPECT_TRUE(finished.load());
+}
+
+}  // namespace
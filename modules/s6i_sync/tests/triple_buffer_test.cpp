@@ -0,0 +1,125 @@
+#include <atomic>
+#include <string>
+#include <thread>
+
+#include "pch.h"
+
+namespace {
+
+using namespace s6i_sync;
+
+// 読み込みで書きかけの状態が見えないことを確かめるため、全要素を同じ値にする
+struct Frame {
+  uint64_t m_values[16] = {};
+};
+
+TEST(TripleBufferTest, BasicFunctionality) {
+  auto buffer_result = TripleBuffer<int>::make(42);
+  ASSERT_TRUE(buffer_result.is_ok());
+  auto buffer = std::move(buffer_result.unwrap());
+  EXPECT_FALSE(buffer.has_update());
+  EXPECT_FALSE(buffer.fetch());
+  EXPECT_EQ(buffer.front(), 42);
+
+  buffer.write(100);
+  EXPECT_TRUE(buffer.has_update());
+  EXPECT_EQ(buffer.front(), 42);  // fetch()するまでは変わらない
+  EXPECT_TRUE(buffer.fetch());
+  EXPECT_EQ(buffer.front(), 100);
+  EXPECT_FALSE(buffer.fetch());
+  EXPECT_EQ(buffer.front(), 100);
+
+  buffer.back() = 7;
+  buffer.publish();
+  EXPECT_EQ(buffer.read(), 7);
+}
+
+TEST(TripleBufferTest, ReaderTakesLatest) {
+  auto buffer = TripleBuffer<int>::make(0).unwrap();
+  for (int i = 1; i <= 10; ++i) {
+    buffer.write(i);
+  }
+  // 途中の値は飛ばして、最後に公開した値だけを受け取る
+  EXPECT_TRUE(buffer.fetch());
+  EXPECT_EQ(buffer.front(), 10);
+  EXPECT_FALSE(buffer.fetch());
+}
+
+TEST(TripleBufferTest, WriterDoesNotTouchFront) {
+  auto buffer = TripleBuffer<std::string>::make("initial").unwrap();
+  buffer.write("first");
+  ASSERT_TRUE(buffer.fetch());
+  const std::string* front = &buffer.front();
+
+  // 読み込み側がfetch()しない間は、何度公開してもfrontは書き換わらない
+  for (int i = 0; i < 5; ++i) {
+    EXPECT_NE(&buffer.back(), front);
+    buffer.write("next" + std::to_string(i));
+  }
+  EXPECT_EQ(buffer.front(), "first");
+  EXPECT_EQ(buffer.read(), "next4");
+}
+
+TEST(TripleBufferTest, MoveSemantics) {
+  auto buffer1 = TripleBuffer<std::string>::make("hello").unwrap();
+  buffer1.write("world");
+
+  TripleBuffer<std::string> buffer2 = std::move(buffer1);
+  EXPECT_TRUE(buffer2.has_update());
+  EXPECT_EQ(buffer2.read(), "world");
+
+  auto buffer3 = TripleBuffer<std::string>::make("other").unwrap();
+  buffer2 = std::move(buffer3);
+  EXPECT_FALSE(buffer2.has_update());
+  EXPECT_EQ(buffer2.read(), "other");
+
+  auto buffer4 = TripleBuffer<std::string>::make("swapped").unwrap();
+  buffer4.write("pending");
+  swap(buffer2, buffer4);
+  EXPECT_TRUE(buffer2.has_update());
+  EXPECT_EQ(buffer2.read(), "pending");
+  EXPECT_FALSE(buffer4.has_update());
+  EXPECT_EQ(buffer4.read(), "other");
+}
+
+TEST(TripleBufferTest, ReaderNeverSeesTornValues) {
+  auto buffer = TripleBuffer<Frame>::make().unwrap();
+  const uint64_t frames = 100000;
+
+  std::atomic<bool> torn{false};
+  std::thread reader([&]() {
+    uint64_t last = 0;
+    while (last < frames) {
+      if (!buffer.fetch()) {
+        std::this_thread::yield();
+        continue;
+      }
+      const Frame& frame = buffer.front();
+      for (uint64_t v : frame.m_values) {
+        if (v != frame.m_values[0]) {
+          torn = true;
+        }
+      }
+      // 新しい値を受け取るたびに、値は単調に増える
+      if (frame.m_values[0] <= last) {
+        torn = true;
+      }
+      last = frame.m_values[0];
+    }
+  });
+
+  for (uint64_t n = 1; n <= frames; ++n) {
+    Frame& frame = buffer.back();
+    for (uint64_t& v : frame.m_values) {
+      v = n;
+    }
+    buffer.publish();
+  }
+  reader.join();
+
+  EXPECT_FALSE(torn.load());
+  EXPECT_FALSE(buffer.has_update());
+  EXPECT_EQ(buffer.front().m_values[0], frames);
+}
+
+}  // namespace